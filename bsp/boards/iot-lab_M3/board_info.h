@@ -59,10 +59,12 @@ to return the board's description.
 
 //===== IEEE802154E timing
 
+#ifndef SLOTDURATION
 #define SLOTDURATION 20 // in miliseconds
+#endif
 
 // time-slot related
-#define PORT_TsSlotDuration                 655   //    20ms
+#define PORT_TsSlotDuration                 ((SLOTDURATION * 32768 + 500) / 1000)   // 655 for 20ms
 
 // execution speed related
 #define PORT_maxTxDataPrepare               110   //  3355us (not measured)
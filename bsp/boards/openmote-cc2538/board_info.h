@@ -70,7 +70,13 @@
 
 //===== IEEE802154E timing
 
+#ifndef SLOTDURATION
 #define SLOTDURATION 20                // in miliseconds
+#endif
+
+#if SLOTDURATION != 10 && SLOTDURATION != 20
+#error "the openmote-cc2538 supports a SLOTDURATION of 10 or 20 ms"
+#endif
 
 //===== IEEE802154E timing
 
@@ -17,7 +17,7 @@
 
 //=========================== variables =======================================
 
-#if !(_WIN32)
+#if !(_WIN32) && !BOARD_MULTI_MOTE_ENABLED
 PyObject *callbacks[MOTE_NOTIF_LAST] = {0};
 #endif
 
@@ -39,6 +39,10 @@ void board_init(void) {
     uart_init();
     radio_init();
 
+    if (notif_batch(MOTE_NOTIF_board_init, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_board_init], NULL);
     if (result == NULL) {
@@ -59,6 +63,9 @@ void board_sleep(void) {
     printf("board_sleep()...\n");
 #endif
 
+    // preserve the order of the batched notifications
+    notif_flush();
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_board_sleep], NULL);
     if (result == NULL) {
@@ -79,6 +86,9 @@ void board_reset(void) {
     printf("board_reset()... \n");
 #endif
 
+    // preserve the order of the batched notifications
+    notif_flush();
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_board_reset], NULL);
     if (result == NULL) {
@@ -100,6 +110,9 @@ void board_barrier_slot_sync(void) {
     printf("board_barrier_slot_sync()... \n");
 #endif
 
+    // preserve the order of the batched notifications
+    notif_flush();
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_board_slot_sync], NULL);
     if (result == NULL) {
@@ -122,6 +135,9 @@ void board_barrier_msg_sync(void) {
     printf("board_barrier_msg_sync()... \n");
 #endif
 
+    // preserve the order of the batched notifications
+    notif_flush();
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_board_msg_sync], NULL);
     if (result == NULL) {
@@ -143,6 +159,9 @@ void board_barrier_ack_sync(void) {
     printf("board_barrier_ack_sync()... \n");
 #endif
 
+    // preserve the order of the batched notifications
+    notif_flush();
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_board_ack_sync], NULL);
     if (result == NULL) {
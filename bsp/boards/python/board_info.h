@@ -37,11 +37,13 @@
 #define SCHEDULER_WAKEUP()
 #define SCHEDULER_ENABLE_INTERRUPT()
 
+#ifndef SLOTDURATION
 #define SLOTDURATION 10 // in miliseconds
+#endif
 
 //===== IEEE802154E timing
 // time-slot related
-#define PORT_TsSlotDuration                328    // counter counts one extra count, see datasheet
+#define PORT_TsSlotDuration                ((SLOTDURATION * 32768 + 500) / 1000)    // 328 for 10ms
 // execution speed related
 #define PORT_maxTxDataPrepare               10    //  305us (measured  82us)
 #define PORT_maxRxAckPrepare                10    //  305us (measured  83us)
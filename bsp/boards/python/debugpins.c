@@ -22,6 +22,10 @@ void debugpins_init(void) {
     printf("debugpins_init()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_init, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_init], NULL);
     if (result == NULL) {
@@ -42,6 +46,10 @@ void debugpins_frame_toggle(void) {
     printf("debugpins_frame_toggle()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_frame_toggle, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_frame_toggle], NULL);
     if (result == NULL) {
@@ -62,6 +70,10 @@ void debugpins_frame_clr(void) {
     printf("debugpins_frame_clr()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_frame_clr, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_frame_clr], NULL);
     if (result == NULL) {
@@ -82,6 +94,10 @@ void debugpins_frame_set(void) {
     printf("debugpins_frame_set()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_frame_set, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_frame_set], NULL);
     if (result == NULL) {
@@ -102,6 +118,10 @@ void debugpins_slot_toggle(void) {
     printf("debugpins_slot_toggle()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_slot_toggle, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_slot_toggle], NULL);
     if (result == NULL) {
@@ -122,6 +142,10 @@ void debugpins_slot_clr(void) {
     printf("debugpins_slot_clr()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_slot_clr, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_slot_clr], NULL);
     if (result == NULL) {
@@ -142,6 +166,10 @@ void debugpins_slot_set(void) {
     printf("debugpins_slot_set()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_slot_set, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_slot_set], NULL);
     if (result == NULL) {
@@ -162,6 +190,10 @@ void debugpins_fsm_toggle(void) {
     printf("debugpins_fsm_toggle()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_fsm_toggle, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_fsm_toggle], NULL);
     if (result == NULL) {
@@ -182,6 +214,10 @@ void debugpins_fsm_clr(void) {
     printf("debugpins_fsm_clr()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_fsm_clr, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_fsm_clr], NULL);
     if (result == NULL) {
@@ -202,6 +238,10 @@ void debugpins_fsm_set(void) {
     printf("debugpins_fsm_set()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_fsm_set, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_fsm_set], NULL);
     if (result == NULL) {
@@ -222,6 +262,10 @@ void debugpins_task_toggle(void) {
     printf("debugpins_task_toggle(... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_task_toggle, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_task_toggle], NULL);
     if (result == NULL) {
@@ -242,6 +286,10 @@ void debugpins_task_clr(void) {
     printf("debugpins_task_clr()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_task_clr, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_task_clr], NULL);
     if (result == NULL) {
@@ -262,6 +310,10 @@ void debugpins_task_set(void) {
     printf("debugpins_task_set()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_task_set, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_task_set], NULL);
     if (result == NULL) {
@@ -282,6 +334,10 @@ void debugpins_isr_toggle(void) {
     printf("debugpins_isr_toggle()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_isr_toggle, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_isr_toggle], NULL);
     if (result == NULL) {
@@ -302,6 +358,10 @@ void debugpins_isr_clr(void) {
     printf("debugpins_isr_clr()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_isr_clr, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_isr_clr], NULL);
     if (result == NULL) {
@@ -322,6 +382,10 @@ void debugpins_isr_set(void) {
     printf("debugpins_isr_set()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_isr_set, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_isr_set], NULL);
     if (result == NULL) {
@@ -342,6 +406,10 @@ void debugpins_radio_toggle(void) {
     printf("debugpins_radio_toggle()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_radio_toggle, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_radio_toggle], NULL);
     if (result == NULL) {
@@ -362,6 +430,10 @@ void debugpins_radio_clr(void) {
     printf("debugpins_radio_clr()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_radio_clr, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_radio_clr], NULL);
     if (result == NULL) {
@@ -382,6 +454,10 @@ void debugpins_radio_set(void) {
     printf("debugpins_radio_set()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_radio_set, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_radio_set], NULL);
     if (result == NULL) {
@@ -402,6 +478,10 @@ void debugpins_ka_clr(void) {
     printf("debugpins_ka_clr()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_ka_clr, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_ka_clr], NULL);
     if (result == NULL) {
@@ -422,6 +502,10 @@ void debugpins_ka_set(void) {
     printf("debugpins_ka_set()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_ka_set, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_ka_set], NULL);
     if (result == NULL) {
@@ -442,6 +526,10 @@ void debugpins_syncPacket_clr(void) {
     printf("debugpins_syncPacket_clr()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_syncPacket_clr, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_syncPacket_clr], NULL);
     if (result == NULL) {
@@ -462,6 +550,10 @@ void debugpins_syncPacket_set(void) {
     printf("debugpins_syncPacket_set()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_syncPacket_set, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_syncPacket_set], NULL);
     if (result == NULL) {
@@ -482,6 +574,10 @@ void debugpins_syncAck_clr(void) {
     printf("debugpins_syncAck_clr()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_syncAck_clr, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_syncAck_clr], NULL);
     if (result == NULL) {
@@ -502,6 +598,10 @@ void debugpins_syncAck_set(void) {
     printf("debugpins_syncAck_set()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_syncAck_set, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_syncAck_set], NULL);
     if (result == NULL) {
@@ -522,6 +622,10 @@ void debugpins_debug_clr(void) {
     printf("debugpins_debug_clr()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_debug_clr, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_debug_clr], NULL);
     if (result == NULL) {
@@ -542,6 +646,10 @@ void debugpins_debug_set(void) {
     printf("debugpins_debug_set()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_debugpins_debug_set, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_debugpins_debug_set], NULL);
     if (result == NULL) {
@@ -24,6 +24,9 @@ void eui64_get(uint8_t *addressToWrite) {
     printf("eui64_get()... \n");
 #endif
 
+    // preserve the order of the batched notifications
+    notif_flush();
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_eui64_get], NULL);
     if (result == NULL) {
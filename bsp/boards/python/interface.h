@@ -14,6 +14,8 @@
 #define OPENWSN_INTERFACE_H
 
 #include <Python.h>
+#include <stdbool.h>
+#include "mote_ctx.h"
 
 #if _WIN32
 #ifdef COMPILE_DLL
@@ -120,16 +122,47 @@ enum {
     MOTE_NOTIF_uart_writeBufferByLen_FASTSIM,
     MOTE_NOTIF_uart_readByte,
     MOTE_NOTIF_uart_setCTS,
+    // batched notifications, see notif.c
+    MOTE_NOTIF_batch,
     // last
     MOTE_NOTIF_LAST
 };
 
-#if _WIN32
+#if BOARD_MULTI_MOTE_ENABLED
+
+/// state of a single simulated mote
+typedef struct {
+    PyObject *py_callbacks[MOTE_NOTIF_LAST];    // Python BSP callbacks of this mote
+    void *state[MOTE_CTX_LAST];                 // module state, allocated on first use
+    bool running;                               // inside supply_on()
+} mote_ctx_t;
+
+mote_ctx_t *mote_ctx_new(void);
+
+void mote_ctx_free(mote_ctx_t *ctx);
+
+void mote_ctx_reset(mote_ctx_t *ctx);
+
+mote_ctx_t *mote_ctx_get(void);
+
+mote_ctx_t *mote_ctx_switch(mote_ctx_t *ctx);
+
+// the callbacks of the mote currently executing
+#define callbacks (mote_ctx_get()->py_callbacks)
+
+#elif _WIN32
 DLL_EXPORT PyObject *callbacks[MOTE_NOTIF_LAST];
 #else
 extern PyObject *callbacks[MOTE_NOTIF_LAST];
 #endif
 
+// notif
+bool notif_batch(uint8_t id, const void *args, uint8_t len);
+
+void notif_flush(void);
+
+void notif_setTimestamp(uint32_t timestamp);
+
 // radio
 void radio_intr_startOfFrame(uint32_t capturedTime);
 
@@ -23,6 +23,10 @@ void leds_init(void) {
     printf("leds_init()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_leds_init, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_init], NULL);
     if (result == NULL) {
@@ -43,6 +47,10 @@ void leds_error_on(void) {
     printf("leds_error_on()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_leds_error_on, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_error_on], NULL);
     if (result == NULL) {
@@ -63,6 +71,10 @@ void leds_error_off(void) {
     printf("leds_error_off()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_leds_error_off, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_error_off], NULL);
     if (result == NULL) {
@@ -83,6 +95,10 @@ void leds_error_toggle(void) {
     printf("leds_error_toggle()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_leds_error_toggle, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_error_toggle], NULL);
     if (result == NULL) {
@@ -104,6 +120,9 @@ uint8_t leds_error_isOn(void) {
     printf("leds_error_isOn()... \n");
 #endif
 
+    // preserve the order of the batched notifications
+    notif_flush();
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_error_isOn], NULL);
     if (result == NULL) {
@@ -127,6 +146,10 @@ void leds_error_blink(void) {
     printf("leds_error_blink()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_leds_error_blink, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_error_blink], NULL);
     if (result == NULL) {
@@ -147,6 +170,10 @@ void leds_radio_on(void) {
     printf("leds_radio_on()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_leds_radio_on, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_radio_on], NULL);
     if (result == NULL) {
@@ -167,6 +194,10 @@ void leds_radio_off(void) {
     printf("leds_radio_off()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_leds_radio_off, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_radio_off], NULL);
     if (result == NULL) {
@@ -187,6 +218,10 @@ void leds_radio_toggle(void) {
     printf("leds_radio_toggle()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_leds_radio_toggle, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_radio_toggle], NULL);
     if (result == NULL) {
@@ -208,6 +243,9 @@ uint8_t leds_radio_isOn(void) {
     printf("leds_radio_isOn()... \n");
 #endif
 
+    // preserve the order of the batched notifications
+    notif_flush();
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_radio_isOn], NULL);
     if (result == NULL) {
@@ -232,6 +270,10 @@ void leds_sync_on(void) {
     printf("leds_sync_on()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_leds_sync_on, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_sync_on], NULL);
     if (result == NULL) {
@@ -252,6 +294,10 @@ void leds_sync_off(void) {
     printf("leds_sync_off()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_leds_sync_off, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_sync_off], NULL);
     if (result == NULL) {
@@ -272,6 +318,10 @@ void leds_sync_toggle(void) {
     printf("leds_sync_toggle()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_leds_sync_toggle, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_sync_toggle], NULL);
     if (result == NULL) {
@@ -293,6 +343,9 @@ uint8_t leds_sync_isOn(void) {
     printf("leds_sync_isOn()... \n");
 #endif
 
+    // preserve the order of the batched notifications
+    notif_flush();
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_sync_isOn], NULL);
     if (result == NULL) {
@@ -317,6 +370,10 @@ void leds_debug_on(void) {
     printf("leds_debug_on()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_leds_debug_on, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_debug_on], NULL);
     if (result == NULL) {
@@ -337,6 +394,10 @@ void leds_debug_off(void) {
     printf("leds_debug_off()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_leds_debug_off, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_debug_off], NULL);
     if (result == NULL) {
@@ -357,6 +418,10 @@ void leds_debug_toggle(void) {
     printf("leds_debug_toggle()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_leds_debug_toggle, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_debug_toggle], NULL);
     if (result == NULL) {
@@ -378,6 +443,9 @@ uint8_t leds_debug_isOn(void) {
     printf("leds_debug_isOn()... \n");
 #endif
 
+    // preserve the order of the batched notifications
+    notif_flush();
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_debug_isOn], NULL);
     if (result == NULL) {
@@ -401,6 +469,10 @@ void leds_all_on(void) {
     printf("leds_all_on()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_leds_all_on, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_all_on], NULL);
     if (result == NULL) {
@@ -421,6 +493,10 @@ void leds_all_off(void) {
     printf("leds_all_off()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_leds_all_off, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_all_off], NULL);
     if (result == NULL) {
@@ -441,6 +517,10 @@ void leds_all_toggle(void) {
     printf("leds_all_toggle()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_leds_all_toggle, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_all_toggle], NULL);
     if (result == NULL) {
@@ -461,6 +541,10 @@ void leds_circular_shift(void) {
     printf("leds_circular_shift()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_leds_circular_shift, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_circular_shift], NULL);
     if (result == NULL) {
@@ -481,6 +565,10 @@ void leds_increment(void) {
     printf("leds_increment()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_leds_increment, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_leds_increment], NULL);
     if (result == NULL) {
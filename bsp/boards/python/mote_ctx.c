@@ -0,0 +1,104 @@
+/**
+\brief Python-specific definition of the per-mote state context.
+
+Every thread keeps track of the mote it is currently executing. Entry points from Python switch to the mote they are
+called on and restore the previous mote when they return, so nested calls into other motes (e.g. from within
+board_sleep()) are handled transparently. Threads that never entered a specific mote use a default context, which
+preserves the behavior of a one-mote-per-library simulation.
+*/
+
+#include "interface.h"
+
+#if BOARD_MULTI_MOTE_ENABLED
+
+#include <stdlib.h>
+
+//=========================== defines =========================================
+
+#if _WIN32
+#define MOTE_CTX_THREAD_LOCAL   __declspec(thread)
+#else
+#define MOTE_CTX_THREAD_LOCAL   __thread
+#endif
+
+//=========================== variables =======================================
+
+static mote_ctx_t mote_ctx_default;
+static MOTE_CTX_THREAD_LOCAL mote_ctx_t *mote_ctx_current;
+
+//=========================== prototypes ======================================
+
+//=========================== public ==========================================
+
+mote_ctx_t *mote_ctx_new(void) {
+    return (mote_ctx_t *) calloc(1, sizeof(mote_ctx_t));
+}
+
+void mote_ctx_free(mote_ctx_t *ctx) {
+    uint8_t i;
+
+    if (ctx == NULL) {
+        return;
+    }
+
+    for (i = 0; i < MOTE_NOTIF_LAST; i++) {
+        Py_XDECREF(ctx->py_callbacks[i]);
+    }
+    mote_ctx_reset(ctx);
+    free(ctx);
+}
+
+/**
+\brief Drop the module state of a mote, as when it is powered off. Its Python callbacks are kept.
+*/
+void mote_ctx_reset(mote_ctx_t *ctx) {
+    uint8_t i;
+
+    for (i = 0; i < MOTE_CTX_LAST; i++) {
+        free(ctx->state[i]);
+        ctx->state[i] = NULL;
+    }
+}
+
+mote_ctx_t *mote_ctx_get(void) {
+    if (mote_ctx_current == NULL) {
+        return &mote_ctx_default;
+    }
+    return mote_ctx_current;
+}
+
+/**
+\brief Make ctx the active mote context of the calling thread.
+
+\param[in] ctx The context to activate, NULL selects the default context.
+
+\returns The previously active context, to be passed back to this function when leaving the mote.
+*/
+mote_ctx_t *mote_ctx_switch(mote_ctx_t *ctx) {
+    mote_ctx_t *previous;
+
+    previous = mote_ctx_current;
+    mote_ctx_current = ctx;
+
+    return previous;
+}
+
+void *mote_ctx_getState(uint8_t slot, size_t size) {
+    mote_ctx_t *ctx;
+
+    ctx = mote_ctx_get();
+
+    if (ctx->state[slot] == NULL) {
+        ctx->state[slot] = calloc(1, size);
+        if (ctx->state[slot] == NULL) {
+            printf("[CRITICAL] mote_ctx_getState() could not allocate slot %d\n", slot);
+            abort();
+        }
+    }
+
+    return ctx->state[slot];
+}
+
+#endif /* BOARD_MULTI_MOTE_ENABLED */
+
+//=========================== private =========================================
@@ -0,0 +1,50 @@
+/**
+\brief Native simulation definition of the "board" bsp module.
+*/
+
+#include "simengine.h"
+
+// bsp modules
+#include "board.h"
+#include "debugpins.h"
+#include "leds.h"
+#include "uart.h"
+#include "radio.h"
+#include "sctimer.h"
+
+//=========================== variables =======================================
+
+//=========================== prototypes ======================================
+
+//=========================== public ==========================================
+
+void board_init(void) {
+    // initialize bsp modules
+    debugpins_init();
+    leds_init();
+    sctimer_init();
+    uart_init();
+    radio_init();
+}
+
+void board_sleep(void) {
+    // the simulation engine regains control when the mote's task queue is empty
+}
+
+void board_reset(void) {
+    // the mote is rebooted by the simulation engine once the current event has been handled
+    simengine_getMote()->resetRequested = TRUE;
+}
+
+//==== barriers, all motes are simulated in a single thread
+
+void board_barrier_slot_sync(void) {
+}
+
+void board_barrier_msg_sync(void) {
+}
+
+void board_barrier_ack_sync(void) {
+}
+
+//=========================== private =========================================
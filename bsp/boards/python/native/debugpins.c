@@ -0,0 +1,98 @@
+/**
+\brief Native simulation definition of the "debugpins" bsp module.
+
+There are no pins to drive in the simulation, all functions are no-ops.
+*/
+
+#include "debugpins.h"
+
+//=========================== defines =========================================
+
+//=========================== variables =======================================
+
+//=========================== prototypes ======================================
+
+//=========================== public ==========================================
+
+void debugpins_init(void) {
+}
+
+void debugpins_frame_toggle(void) {
+}
+
+void debugpins_frame_clr(void) {
+}
+
+void debugpins_frame_set(void) {
+}
+
+void debugpins_slot_toggle(void) {
+}
+
+void debugpins_slot_clr(void) {
+}
+
+void debugpins_slot_set(void) {
+}
+
+void debugpins_fsm_toggle(void) {
+}
+
+void debugpins_fsm_clr(void) {
+}
+
+void debugpins_fsm_set(void) {
+}
+
+void debugpins_task_toggle(void) {
+}
+
+void debugpins_task_clr(void) {
+}
+
+void debugpins_task_set(void) {
+}
+
+void debugpins_isr_toggle(void) {
+}
+
+void debugpins_isr_clr(void) {
+}
+
+void debugpins_isr_set(void) {
+}
+
+void debugpins_radio_toggle(void) {
+}
+
+void debugpins_radio_clr(void) {
+}
+
+void debugpins_radio_set(void) {
+}
+
+void debugpins_ka_clr(void) {
+}
+
+void debugpins_ka_set(void) {
+}
+
+void debugpins_syncPacket_clr(void) {
+}
+
+void debugpins_syncPacket_set(void) {
+}
+
+void debugpins_syncAck_clr(void) {
+}
+
+void debugpins_syncAck_set(void) {
+}
+
+void debugpins_debug_clr(void) {
+}
+
+void debugpins_debug_set(void) {
+}
+
+//=========================== private =========================================
@@ -0,0 +1,22 @@
+/**
+\brief Native simulation definition of the "eui64" bsp module.
+*/
+
+#include <string.h>
+
+#include "simengine.h"
+#include "eui64.h"
+
+//=========================== defines =========================================
+
+//=========================== variables =======================================
+
+//=========================== prototypes ======================================
+
+//=========================== public ==========================================
+
+void eui64_get(uint8_t *addressToWrite) {
+    memcpy(addressToWrite, simengine_getMote()->eui64, 8);
+}
+
+//=========================== private =========================================
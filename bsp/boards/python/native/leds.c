@@ -0,0 +1,131 @@
+/**
+\brief Native simulation definition of the "leds" bsp module.
+*/
+
+#include "simengine.h"
+#include "leds.h"
+
+//=========================== defines =========================================
+
+#define LEDS_ALL                    0x0f
+
+#define LED_ERROR                   0x01
+#define LED_RADIO                   0x02
+#define LED_SYNC                    0x04
+#define LED_DEBUG                   0x08
+
+//=========================== variables =======================================
+
+//=========================== prototypes ======================================
+
+//=========================== public ==========================================
+
+void leds_init(void) {
+    simengine_getMote()->leds = 0;
+}
+
+//==== error LED
+
+void leds_error_on(void) {
+    simengine_getMote()->leds |= LED_ERROR;
+}
+
+void leds_error_off(void) {
+    simengine_getMote()->leds &= ~LED_ERROR;
+}
+
+void leds_error_toggle(void) {
+    simengine_getMote()->leds ^= LED_ERROR;
+}
+
+uint8_t leds_error_isOn(void) {
+    return (simengine_getMote()->leds & LED_ERROR) ? 1 : 0;
+}
+
+void leds_error_blink(void) {
+    leds_error_on();
+}
+
+//==== radio LED
+
+void leds_radio_on(void) {
+    simengine_getMote()->leds |= LED_RADIO;
+}
+
+void leds_radio_off(void) {
+    simengine_getMote()->leds &= ~LED_RADIO;
+}
+
+void leds_radio_toggle(void) {
+    simengine_getMote()->leds ^= LED_RADIO;
+}
+
+uint8_t leds_radio_isOn(void) {
+    return (simengine_getMote()->leds & LED_RADIO) ? 1 : 0;
+}
+
+//==== sync LED
+
+void leds_sync_on(void) {
+    simengine_getMote()->leds |= LED_SYNC;
+}
+
+void leds_sync_off(void) {
+    simengine_getMote()->leds &= ~LED_SYNC;
+}
+
+void leds_sync_toggle(void) {
+    simengine_getMote()->leds ^= LED_SYNC;
+}
+
+uint8_t leds_sync_isOn(void) {
+    return (simengine_getMote()->leds & LED_SYNC) ? 1 : 0;
+}
+
+//==== debug LED
+
+void leds_debug_on(void) {
+    simengine_getMote()->leds |= LED_DEBUG;
+}
+
+void leds_debug_off(void) {
+    simengine_getMote()->leds &= ~LED_DEBUG;
+}
+
+void leds_debug_toggle(void) {
+    simengine_getMote()->leds ^= LED_DEBUG;
+}
+
+uint8_t leds_debug_isOn(void) {
+    return (simengine_getMote()->leds & LED_DEBUG) ? 1 : 0;
+}
+
+//==== bootstrapping
+
+void leds_all_on(void) {
+    simengine_getMote()->leds = LEDS_ALL;
+}
+
+void leds_all_off(void) {
+    simengine_getMote()->leds = 0;
+}
+
+void leds_all_toggle(void) {
+    simengine_getMote()->leds ^= LEDS_ALL;
+}
+
+void leds_circular_shift(void) {
+    sim_mote_t *mote;
+
+    mote = simengine_getMote();
+    mote->leds = ((mote->leds << 1) | (mote->leds >> 3)) & LEDS_ALL;
+}
+
+void leds_increment(void) {
+    sim_mote_t *mote;
+
+    mote = simengine_getMote();
+    mote->leds = (mote->leds + 1) & LEDS_ALL;
+}
+
+//=========================== private =========================================
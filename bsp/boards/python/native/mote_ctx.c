@@ -0,0 +1,66 @@
+/**
+\brief Native simulation definition of the per-mote state context.
+
+The simulation engine runs all motes from a single thread and switches the active context before handing an event
+to a mote.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "simengine.h"
+
+//=========================== variables =======================================
+
+static mote_ctx_t mote_ctx_default;
+static mote_ctx_t *mote_ctx_current;
+
+//=========================== prototypes ======================================
+
+//=========================== public ==========================================
+
+mote_ctx_t *mote_ctx_get(void) {
+    if (mote_ctx_current == NULL) {
+        return &mote_ctx_default;
+    }
+    return mote_ctx_current;
+}
+
+mote_ctx_t *mote_ctx_switch(mote_ctx_t *ctx) {
+    mote_ctx_t *previous;
+
+    previous = mote_ctx_current;
+    mote_ctx_current = ctx;
+
+    return previous;
+}
+
+/**
+\brief Release the state of all modules, as if the mote was powered off.
+*/
+void mote_ctx_clear(mote_ctx_t *ctx) {
+    uint8_t i;
+
+    for (i = 0; i < MOTE_CTX_LAST; i++) {
+        free(ctx->state[i]);
+        ctx->state[i] = NULL;
+    }
+}
+
+void *mote_ctx_getState(uint8_t slot, size_t size) {
+    mote_ctx_t *ctx;
+
+    ctx = mote_ctx_get();
+
+    if (ctx->state[slot] == NULL) {
+        ctx->state[slot] = calloc(1, size);
+        if (ctx->state[slot] == NULL) {
+            printf("[CRITICAL] mote_ctx_getState() could not allocate slot %d\n", slot);
+            abort();
+        }
+    }
+
+    return ctx->state[slot];
+}
+
+//=========================== private =========================================
@@ -0,0 +1,139 @@
+/**
+\brief Native simulation definition of the "radio" bsp module.
+
+The radio is a thin state machine on top of the simulated medium in simengine.c, which delivers the start/end of
+frame interrupts.
+*/
+
+#include <string.h>
+
+#include "simengine.h"
+#include "radio.h"
+
+//=========================== defines =========================================
+
+typedef struct {
+    radio_capture_cbt startFrame_cb;
+    radio_capture_cbt endFrame_cb;
+} radio_icb_t;
+
+//=========================== variables =======================================
+
+#define radio_icb MOTE_CTX_VAR(radio_icb_t, radio_icb)
+
+//=========================== prototypes ======================================
+
+void radio_setStartFrameCb(radio_capture_cbt cb) {
+    radio_icb.startFrame_cb = cb;
+}
+
+void radio_setEndFrameCb(radio_capture_cbt cb) {
+    radio_icb.endFrame_cb = cb;
+}
+
+//=========================== public ==========================================
+
+//===== admin
+
+void radio_init(void) {
+    sim_mote_t *mote;
+
+    mote = simengine_getMote();
+    simengine_cancel(mote, SIM_CHANNEL_RADIO);
+    mote->radioState = RADIOSTATE_RFOFF;
+}
+
+//===== reset
+
+void radio_reset(void) {
+    radio_init();
+}
+
+//===== RF admin
+
+void radio_setFrequency(uint8_t frequency, radio_freq_t tx_or_rx) {
+    sim_mote_t *mote;
+
+    (void) tx_or_rx;
+
+    mote = simengine_getMote();
+    mote->frequency = frequency;
+    mote->radioState = RADIOSTATE_FREQUENCY_SET;
+}
+
+void radio_rfOn(void) {
+    // nothing to do, the RF chain is turned on by radio_txEnable()/radio_rxEnable()
+}
+
+void radio_rfOff(void) {
+    sim_mote_t *mote;
+
+    mote = simengine_getMote();
+    // abort any frame being sent or received
+    simengine_cancel(mote, SIM_CHANNEL_RADIO);
+    mote->radioState = RADIOSTATE_RFOFF;
+}
+
+//===== TX
+
+void radio_loadPacket(const uint8_t *packet, uint16_t len) {
+    sim_mote_t *mote;
+
+    mote = simengine_getMote();
+    if (len > SIMENGINE_MAX_FRAME_LEN) {
+        len = SIMENGINE_MAX_FRAME_LEN;
+    }
+    memcpy(mote->txBuf, packet, len);
+    mote->txLen = (uint8_t) len;
+    mote->radioState = RADIOSTATE_PACKET_LOADED;
+}
+
+void radio_txEnable(void) {
+    simengine_getMote()->radioState = RADIOSTATE_TX_ENABLED;
+}
+
+void radio_txNow(void) {
+    simengine_radioStartTx(simengine_getMote());
+}
+
+//===== RX
+
+void radio_rxEnable(void) {
+    simengine_getMote()->radioState = RADIOSTATE_LISTENING;
+}
+
+void radio_rxNow(void) {
+    simengine_getMote()->radioState = RADIOSTATE_LISTENING;
+}
+
+void radio_getReceivedFrame(uint8_t *pBufRead,
+                            uint8_t *pLenRead,
+                            uint8_t maxBufLen,
+                            int8_t *pRssi,
+                            uint8_t *pLqi,
+                            bool *pCrc) {
+    sim_mote_t *mote;
+    uint8_t len;
+
+    mote = simengine_getMote();
+
+    len = (mote->rxLen > maxBufLen) ? maxBufLen : mote->rxLen;
+    memcpy(pBufRead, mote->rxBuf, len);
+
+    *pLenRead = len;
+    *pRssi = mote->rxRssi;
+    *pLqi = 0;
+    *pCrc = !mote->rxCorrupted;
+}
+
+//=========================== interrupts ======================================
+
+void radio_intr_startOfFrame(uint32_t capturedTime) {
+    radio_icb.startFrame_cb(capturedTime);
+}
+
+void radio_intr_endOfFrame(uint32_t capturedTime) {
+    radio_icb.endFrame_cb(capturedTime);
+}
+
+//=========================== private =========================================
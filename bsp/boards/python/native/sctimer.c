@@ -0,0 +1,95 @@
+/**
+\brief Native simulation definition of the "sctimer" bsp module.
+*/
+
+#include "simengine.h"
+#include "sctimer.h"
+
+//=========================== typedefs =======================================
+
+typedef struct {
+    sctimer_cbt compare_cb;
+} sctimer_icb_t;
+
+//=========================== variables =======================================
+
+#define sctimer_icb MOTE_CTX_VAR(sctimer_icb_t, sctimer_icb)
+
+//=========================== prototypes ======================================
+
+static void sctimer_scheduleCompare(sim_mote_t *mote);
+
+static void sctimer_intr_compare(sim_mote_t *mote, uint16_t arg);
+
+//=========================== callback ========================================
+
+void sctimer_set_callback(sctimer_cbt cb) {
+    sctimer_icb.compare_cb = cb;
+}
+
+//=========================== public ==========================================
+
+//===== admin
+
+void sctimer_init(void) {
+    sim_mote_t *mote;
+
+    mote = simengine_getMote();
+    mote->compareEnabled = FALSE;
+    simengine_cancel(mote, SIM_CHANNEL_SCTIMER);
+}
+
+//===== direct access
+
+PORT_RADIOTIMER_WIDTH sctimer_readCounter(void) {
+    return simengine_readCounter(simengine_getMote());
+}
+
+//===== compare
+
+void sctimer_setCompare(PORT_RADIOTIMER_WIDTH value) {
+    sim_mote_t *mote;
+
+    mote = simengine_getMote();
+    mote->compareValue = value;
+    mote->compareEnabled = TRUE;
+    sctimer_scheduleCompare(mote);
+}
+
+void sctimer_enable(void) {
+    sim_mote_t *mote;
+
+    mote = simengine_getMote();
+    if (mote->compareEnabled == FALSE) {
+        mote->compareEnabled = TRUE;
+        sctimer_scheduleCompare(mote);
+    }
+}
+
+void sctimer_disable(void) {
+    sim_mote_t *mote;
+
+    mote = simengine_getMote();
+    mote->compareEnabled = FALSE;
+    simengine_cancel(mote, SIM_CHANNEL_SCTIMER);
+}
+
+//=========================== private =========================================
+
+static void sctimer_scheduleCompare(sim_mote_t *mote) {
+    // only the last compare value counts
+    simengine_cancel(mote, SIM_CHANNEL_SCTIMER);
+    simengine_schedule(mote, simengine_counterToTime(mote, mote->compareValue), SIM_CHANNEL_SCTIMER,
+                       sctimer_intr_compare, 0);
+}
+
+//=========================== interrupts ======================================
+
+static void sctimer_intr_compare(sim_mote_t *mote, uint16_t arg) {
+    (void) arg;
+
+    mote->compareEnabled = FALSE;
+    if (sctimer_icb.compare_cb != NULL) {
+        sctimer_icb.compare_cb();
+    }
+}
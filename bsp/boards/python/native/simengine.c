@@ -0,0 +1,527 @@
+/**
+\brief Native discrete-event simulation engine for the python board.
+
+Time is kept in microseconds. Every event belongs to a mote and to one of its hardware channels; bumping the
+generation counter of a channel invalidates all events pending on it, which is how compare updates, radio resets and
+mote reboots cancel what was scheduled earlier. After each event, the tasks it posted are run to completion before the
+next event is popped, the same way board_sleep() returns control to the simulator in the Python-driven build.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "simengine.h"
+#include "board_info.h"
+#include "scheduler.h"
+
+//=========================== defines =========================================
+
+#define SIMENGINE_HEAP_INIT_SIZE    256
+
+//=========================== typedefs ========================================
+
+typedef struct {
+    uint64_t time;
+    uint64_t seq;                           // FIFO order among events scheduled at the same time
+    simengine_event_cbt cb;
+    uint32_t gen;
+    uint16_t moteId;
+    uint16_t arg;
+    uint8_t channel;
+} sim_event_t;
+
+typedef struct {
+    sim_mote_t *motes;
+    uint16_t numMotes;
+    uint8_t *pdr;                           // numMotes x numMotes, in percent
+    int8_t *rssi;                           // numMotes x numMotes
+    sim_event_t *heap;
+    uint32_t heapLen;
+    uint32_t heapSize;
+    uint64_t now;
+    uint64_t seq;
+    uint32_t prng;
+    sim_mote_t *current;
+    simengine_cbt bootCb;
+    simengine_uart_cbt uartCb;
+    simengine_stats_t stats;
+} simengine_vars_t;
+
+//=========================== variables =======================================
+
+static simengine_vars_t simengine_vars;
+
+//=========================== prototypes ======================================
+
+static void simengine_push(sim_event_t *event);
+
+static void simengine_pop(sim_event_t *event);
+
+static bool simengine_before(const sim_event_t *a, const sim_event_t *b);
+
+static uint32_t simengine_random(void);
+
+static uint64_t simengine_ticksAt(uint64_t time);
+
+static void simengine_execute(sim_mote_t *mote, simengine_event_cbt cb, uint16_t arg);
+
+static void simengine_reboot(sim_mote_t *mote);
+
+static void simengine_bootHandler(sim_mote_t *mote, uint16_t arg);
+
+static void simengine_txStartOfFrame(sim_mote_t *mote, uint16_t arg);
+
+static void simengine_txEndOfFrame(sim_mote_t *mote, uint16_t arg);
+
+static void simengine_rxStartOfFrame(sim_mote_t *mote, uint16_t arg);
+
+static void simengine_rxEndOfFrame(sim_mote_t *mote, uint16_t arg);
+
+//=========================== public ==========================================
+
+//===== harness
+
+/**
+\brief Allocate numMotes motes, none of which is linked to any other.
+
+\param[in] numMotes Number of motes to simulate.
+\param[in] seed     Seed of the medium's random number generator, for reproducible runs.
+\param[in] bootCb   Called in the context of a mote when it boots (or reboots).
+*/
+void simengine_init(uint16_t numMotes, uint32_t seed, simengine_cbt bootCb) {
+    uint16_t i;
+
+    memset(&simengine_vars, 0, sizeof(simengine_vars_t));
+
+    simengine_vars.numMotes = numMotes;
+    simengine_vars.bootCb = bootCb;
+    simengine_vars.prng = (seed == 0) ? 0x2545F491 : seed;
+
+    simengine_vars.motes = calloc(numMotes, sizeof(sim_mote_t));
+    simengine_vars.pdr = calloc((size_t) numMotes * numMotes, sizeof(uint8_t));
+    simengine_vars.rssi = calloc((size_t) numMotes * numMotes, sizeof(int8_t));
+    simengine_vars.heapSize = SIMENGINE_HEAP_INIT_SIZE;
+    simengine_vars.heap = malloc(simengine_vars.heapSize * sizeof(sim_event_t));
+
+    if (simengine_vars.motes == NULL || simengine_vars.pdr == NULL || simengine_vars.rssi == NULL ||
+        simengine_vars.heap == NULL) {
+        printf("[CRITICAL] simengine_init() could not allocate %d motes\n", numMotes);
+        abort();
+    }
+
+    for (i = 0; i < numMotes; i++) {
+        simengine_vars.motes[i].eui64[0] = 0x14;
+        simengine_vars.motes[i].eui64[1] = 0x15;
+        simengine_vars.motes[i].eui64[2] = 0x92;
+        simengine_vars.motes[i].eui64[3] = 0xcc;
+        simengine_vars.motes[i].eui64[6] = (uint8_t) ((i + 1) >> 8);
+        simengine_vars.motes[i].eui64[7] = (uint8_t) ((i + 1) & 0xff);
+        simengine_vars.motes[i].counterOffset = simengine_random();
+        simengine_vars.motes[i].radioState = RADIOSTATE_STOPPED;
+    }
+}
+
+void simengine_destroy(void) {
+    uint16_t i;
+
+    for (i = 0; i < simengine_vars.numMotes; i++) {
+        mote_ctx_clear(&simengine_vars.motes[i].ctx);
+    }
+
+    free(simengine_vars.motes);
+    free(simengine_vars.pdr);
+    free(simengine_vars.rssi);
+    free(simengine_vars.heap);
+
+    memset(&simengine_vars, 0, sizeof(simengine_vars_t));
+}
+
+/**
+\brief Set the (directional) link from src to dst; a pdr of 0 removes it.
+*/
+void simengine_setLink(uint16_t src, uint16_t dst, uint8_t pdr, int8_t rssi) {
+    if (src >= simengine_vars.numMotes || dst >= simengine_vars.numMotes || src == dst) {
+        return;
+    }
+
+    simengine_vars.pdr[src * simengine_vars.numMotes + dst] = (pdr > 100) ? 100 : pdr;
+    simengine_vars.rssi[src * simengine_vars.numMotes + dst] = rssi;
+}
+
+void simengine_setUartCb(simengine_uart_cbt cb) {
+    simengine_vars.uartCb = cb;
+}
+
+/**
+\brief Power on a mote, at the current simulated time.
+*/
+void simengine_boot(uint16_t moteId) {
+    sim_mote_t *mote;
+
+    mote = &simengine_vars.motes[moteId];
+    if (mote->isBooted) {
+        return;
+    }
+    mote->isBooted = TRUE;
+
+    simengine_execute(mote, simengine_bootHandler, 0);
+}
+
+/**
+\brief Run cb in the context of a mote, e.g. to configure it from the harness.
+*/
+void simengine_runOn(uint16_t moteId, simengine_cbt cb) {
+    sim_mote_t *mote;
+    sim_mote_t *previous;
+    mote_ctx_t *prevCtx;
+
+    mote = &simengine_vars.motes[moteId];
+
+    previous = simengine_vars.current;
+    simengine_vars.current = mote;
+    prevCtx = mote_ctx_switch(&mote->ctx);
+
+    cb();
+    scheduler_run_pending();
+
+    mote_ctx_switch(prevCtx);
+    simengine_vars.current = previous;
+
+    if (mote->resetRequested) {
+        simengine_reboot(mote);
+    }
+}
+
+/**
+\brief Process all events up to (and including) durationUs microseconds from now.
+*/
+void simengine_run(uint64_t durationUs) {
+    sim_event_t event;
+    sim_mote_t *mote;
+    uint64_t end;
+
+    end = simengine_vars.now + durationUs;
+
+    while (simengine_vars.heapLen > 0 && simengine_vars.heap[0].time <= end) {
+        simengine_pop(&event);
+
+        mote = &simengine_vars.motes[event.moteId];
+        if (event.gen != mote->gen[event.channel]) {
+            // cancelled
+            continue;
+        }
+
+        simengine_vars.now = event.time;
+        simengine_vars.stats.numEvents++;
+
+        simengine_execute(mote, event.cb, event.arg);
+    }
+
+    simengine_vars.now = end;
+}
+
+uint64_t simengine_getTime(void) {
+    return simengine_vars.now;
+}
+
+uint16_t simengine_getNumMotes(void) {
+    return simengine_vars.numMotes;
+}
+
+void simengine_getStats(simengine_stats_t *stats) {
+    memcpy(stats, &simengine_vars.stats, sizeof(simengine_stats_t));
+}
+
+//===== bsp
+
+/**
+\brief The mote currently executing, only valid when called from firmware code.
+*/
+sim_mote_t *simengine_getMote(void) {
+    if (simengine_vars.current == NULL) {
+        printf("[CRITICAL] simengine_getMote() called outside of a mote\n");
+        abort();
+    }
+    return simengine_vars.current;
+}
+
+uint32_t simengine_readCounter(sim_mote_t *mote) {
+    return (uint32_t) simengine_ticksAt(simengine_vars.now) + mote->counterOffset;
+}
+
+/**
+\brief Simulated time at which the sctimer of a mote reaches counter.
+
+Values up to half the counter range behind the current counter value are considered to be in the past and map to
+the current time, so that a compare set "too late" fires immediately, like on real hardware.
+*/
+uint64_t simengine_counterToTime(sim_mote_t *mote, uint32_t counter) {
+    uint64_t ticks;
+    uint32_t delta;
+
+    ticks = simengine_ticksAt(simengine_vars.now);
+    delta = counter - ((uint32_t) ticks + mote->counterOffset);
+
+    if (delta >= 0x80000000) {
+        return simengine_vars.now;
+    }
+
+    // first microsecond at which the counter has reached the target value
+    return ((ticks + delta) * 1000000 + SIMENGINE_TICKS_PER_SEC - 1) / SIMENGINE_TICKS_PER_SEC;
+}
+
+void simengine_schedule(sim_mote_t *mote, uint64_t time, sim_channel_t channel, simengine_event_cbt cb, uint16_t arg) {
+    sim_event_t event;
+
+    event.time = (time < simengine_vars.now) ? simengine_vars.now : time;
+    event.seq = simengine_vars.seq++;
+    event.cb = cb;
+    event.gen = mote->gen[channel];
+    event.moteId = (uint16_t) (mote - simengine_vars.motes);
+    event.arg = arg;
+    event.channel = (uint8_t) channel;
+
+    simengine_push(&event);
+}
+
+void simengine_cancel(sim_mote_t *mote, sim_channel_t channel) {
+    mote->gen[channel]++;
+}
+
+/**
+\brief Start transmitting the frame loaded in the mote's TX buffer, after the radio's TX delay.
+*/
+void simengine_radioStartTx(sim_mote_t *mote) {
+    uint64_t time;
+
+    time = simengine_counterToTime(mote, simengine_readCounter(mote) + PORT_delayTx);
+    simengine_schedule(mote, time, SIM_CHANNEL_RADIO, simengine_txStartOfFrame, 0);
+}
+
+void simengine_uartWrite(const uint8_t *buf, uint16_t len) {
+    sim_mote_t *mote;
+
+    mote = simengine_getMote();
+    simengine_vars.stats.numUartBytes += len;
+
+    if (simengine_vars.uartCb != NULL) {
+        simengine_vars.uartCb((uint16_t) (mote - simengine_vars.motes), buf, len);
+    }
+}
+
+//=========================== private =========================================
+
+//===== event queue (binary min-heap)
+
+static bool simengine_before(const sim_event_t *a, const sim_event_t *b) {
+    if (a->time != b->time) {
+        return a->time < b->time;
+    }
+    return a->seq < b->seq;
+}
+
+static void simengine_push(sim_event_t *event) {
+    sim_event_t *heap;
+    uint32_t i;
+    uint32_t parent;
+
+    if (simengine_vars.heapLen == simengine_vars.heapSize) {
+        heap = realloc(simengine_vars.heap, 2 * simengine_vars.heapSize * sizeof(sim_event_t));
+        if (heap == NULL) {
+            printf("[CRITICAL] simengine_push() could not grow the event queue\n");
+            abort();
+        }
+        simengine_vars.heap = heap;
+        simengine_vars.heapSize *= 2;
+    }
+
+    heap = simengine_vars.heap;
+    i = simengine_vars.heapLen++;
+
+    while (i > 0) {
+        parent = (i - 1) / 2;
+        if (!simengine_before(event, &heap[parent])) {
+            break;
+        }
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = *event;
+}
+
+static void simengine_pop(sim_event_t *event) {
+    sim_event_t *heap;
+    sim_event_t *last;
+    uint32_t i;
+    uint32_t child;
+
+    heap = simengine_vars.heap;
+    *event = heap[0];
+
+    simengine_vars.heapLen--;
+    last = &heap[simengine_vars.heapLen];
+
+    i = 0;
+    while ((child = 2 * i + 1) < simengine_vars.heapLen) {
+        if (child + 1 < simengine_vars.heapLen && simengine_before(&heap[child + 1], &heap[child])) {
+            child++;
+        }
+        if (!simengine_before(&heap[child], last)) {
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = *last;
+}
+
+//===== helpers
+
+static uint32_t simengine_random(void) {
+    // xorshift32
+    simengine_vars.prng ^= simengine_vars.prng << 13;
+    simengine_vars.prng ^= simengine_vars.prng >> 17;
+    simengine_vars.prng ^= simengine_vars.prng << 5;
+    return simengine_vars.prng;
+}
+
+static uint64_t simengine_ticksAt(uint64_t time) {
+    return (time * SIMENGINE_TICKS_PER_SEC) / 1000000;
+}
+
+/**
+\brief Run an event handler in the context of a mote, then drain the tasks it posted.
+*/
+static void simengine_execute(sim_mote_t *mote, simengine_event_cbt cb, uint16_t arg) {
+    sim_mote_t *previous;
+    mote_ctx_t *prevCtx;
+
+    previous = simengine_vars.current;
+    simengine_vars.current = mote;
+    prevCtx = mote_ctx_switch(&mote->ctx);
+
+    cb(mote, arg);
+    scheduler_run_pending();
+
+    mote_ctx_switch(prevCtx);
+    simengine_vars.current = previous;
+
+    if (mote->resetRequested) {
+        simengine_reboot(mote);
+    }
+}
+
+static void simengine_reboot(sim_mote_t *mote) {
+    uint8_t i;
+
+    mote_ctx_clear(&mote->ctx);
+    for (i = 0; i < SIM_CHANNEL_MAX; i++) {
+        mote->gen[i]++;
+    }
+
+    mote->resetRequested = FALSE;
+    mote->compareEnabled = FALSE;
+    mote->radioState = RADIOSTATE_STOPPED;
+    mote->txLen = 0;
+    mote->rxLen = 0;
+    mote->leds = 0;
+
+    simengine_execute(mote, simengine_bootHandler, 0);
+}
+
+//===== handlers
+
+static void simengine_bootHandler(sim_mote_t *mote, uint16_t arg) {
+    (void) mote;
+    (void) arg;
+
+    simengine_vars.bootCb();
+}
+
+static void simengine_txStartOfFrame(sim_mote_t *mote, uint16_t arg) {
+    uint16_t src;
+    uint16_t dst;
+    uint64_t airtime;
+
+    (void) arg;
+
+    src = (uint16_t) (mote - simengine_vars.motes);
+    airtime = (uint64_t) mote->txLen * SIMENGINE_US_PER_BYTE;
+
+    mote->radioState = RADIOSTATE_TRANSMITTING;
+    simengine_vars.stats.numTx++;
+
+    // every mote in range hears the start of the frame at the same time
+    for (dst = 0; dst < simengine_vars.numMotes; dst++) {
+        if (simengine_vars.pdr[src * simengine_vars.numMotes + dst] == 0 || !simengine_vars.motes[dst].isBooted) {
+            continue;
+        }
+        simengine_schedule(&simengine_vars.motes[dst], simengine_vars.now, SIM_CHANNEL_RADIO,
+                           simengine_rxStartOfFrame, src);
+    }
+
+    simengine_schedule(mote, simengine_vars.now + airtime, SIM_CHANNEL_RADIO, simengine_txEndOfFrame, 0);
+
+    radio_intr_startOfFrame(simengine_readCounter(mote));
+}
+
+static void simengine_txEndOfFrame(sim_mote_t *mote, uint16_t arg) {
+    (void) arg;
+
+    mote->radioState = RADIOSTATE_TXRX_DONE;
+
+    radio_intr_endOfFrame(simengine_readCounter(mote));
+}
+
+static void simengine_rxStartOfFrame(sim_mote_t *mote, uint16_t src) {
+    sim_mote_t *sender;
+    uint16_t dst;
+    uint8_t pdr;
+
+    sender = &simengine_vars.motes[src];
+    dst = (uint16_t) (mote - simengine_vars.motes);
+
+    if (mote->frequency != sender->frequency) {
+        return;
+    }
+
+    if (mote->radioState == RADIOSTATE_RECEIVING) {
+        // overlapping frames on the same frequency, the one being received is lost
+        mote->rxCorrupted = TRUE;
+        simengine_vars.stats.numCollisions++;
+        return;
+    }
+
+    if (mote->radioState != RADIOSTATE_LISTENING) {
+        return;
+    }
+
+    pdr = simengine_vars.pdr[src * simengine_vars.numMotes + dst];
+    if (simengine_random() % 100 >= pdr) {
+        simengine_vars.stats.numDropped++;
+        return;
+    }
+
+    memcpy(mote->rxBuf, sender->txBuf, sender->txLen);
+    mote->rxLen = sender->txLen;
+    mote->rxRssi = simengine_vars.rssi[src * simengine_vars.numMotes + dst];
+    mote->rxCorrupted = FALSE;
+    mote->radioState = RADIOSTATE_RECEIVING;
+
+    simengine_schedule(mote, simengine_vars.now + (uint64_t) mote->rxLen * SIMENGINE_US_PER_BYTE, SIM_CHANNEL_RADIO,
+                       simengine_rxEndOfFrame, src);
+
+    radio_intr_startOfFrame(simengine_readCounter(mote));
+}
+
+static void simengine_rxEndOfFrame(sim_mote_t *mote, uint16_t src) {
+    (void) src;
+
+    mote->radioState = RADIOSTATE_TXRX_DONE;
+    if (!mote->rxCorrupted) {
+        simengine_vars.stats.numRx++;
+    }
+
+    radio_intr_endOfFrame(simengine_readCounter(mote));
+}
@@ -0,0 +1,127 @@
+/**
+\brief Native discrete-event simulation engine for the python board.
+
+Replaces the Python BSP (and OpenVisualizer's simulation engine) by a pure C implementation: a single event queue
+ordered on simulated time drives all motes, each with a simulated 32 kHz sctimer and a radio attached to a shared
+medium. Motes run the regular firmware and live in their own mote context (see mote_ctx.h).
+*/
+
+#ifndef OPENWSN_SIMENGINE_H
+#define OPENWSN_SIMENGINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "mote_ctx.h"
+#include "radio.h"
+
+//=========================== define ==========================================
+
+#define SIMENGINE_TICKS_PER_SEC     32768
+#define SIMENGINE_US_PER_BYTE       32          // 250 kbps O-QPSK
+#define SIMENGINE_MAX_FRAME_LEN     127
+#define SIMENGINE_DEFAULT_RSSI      (-50)
+
+//=========================== typedef =========================================
+
+/// state of a single simulated mote
+typedef struct {
+    void *state[MOTE_CTX_LAST];             // module state, allocated on first use
+} mote_ctx_t;
+
+typedef enum {
+    SIM_CHANNEL_SCTIMER,
+    SIM_CHANNEL_RADIO,
+    SIM_CHANNEL_MAX,
+} sim_channel_t;
+
+/// simulated hardware of a single mote
+typedef struct {
+    mote_ctx_t ctx;
+    uint8_t eui64[8];
+    bool isBooted;
+    bool resetRequested;
+    uint32_t counterOffset;                 // offset of this mote's sctimer w.r.t. simulated time
+    uint32_t gen[SIM_CHANNEL_MAX];          // bumped to cancel all pending events on a channel
+    // sctimer
+    uint32_t compareValue;
+    bool compareEnabled;
+    // radio
+    radio_state_t radioState;
+    uint8_t frequency;
+    uint8_t txBuf[SIMENGINE_MAX_FRAME_LEN];
+    uint8_t txLen;
+    uint8_t rxBuf[SIMENGINE_MAX_FRAME_LEN];
+    uint8_t rxLen;
+    int8_t rxRssi;
+    bool rxCorrupted;                       // another frame collided with the one being received
+    // leds
+    uint8_t leds;
+} sim_mote_t;
+
+typedef void (*simengine_cbt)(void);
+
+typedef void (*simengine_event_cbt)(sim_mote_t *mote, uint16_t arg);
+
+typedef void (*simengine_uart_cbt)(uint16_t moteId, const uint8_t *buf, uint16_t len);
+
+typedef struct {
+    uint64_t numEvents;
+    uint64_t numTx;
+    uint64_t numRx;
+    uint64_t numCollisions;
+    uint64_t numDropped;
+    uint64_t numUartBytes;
+} simengine_stats_t;
+
+//=========================== prototypes ======================================
+
+// mote context
+mote_ctx_t *mote_ctx_get(void);
+
+mote_ctx_t *mote_ctx_switch(mote_ctx_t *ctx);
+
+void mote_ctx_clear(mote_ctx_t *ctx);
+
+// harness
+void simengine_init(uint16_t numMotes, uint32_t seed, simengine_cbt bootCb);
+
+void simengine_destroy(void);
+
+void simengine_setLink(uint16_t src, uint16_t dst, uint8_t pdr, int8_t rssi);
+
+void simengine_setUartCb(simengine_uart_cbt cb);
+
+void simengine_boot(uint16_t moteId);
+
+void simengine_runOn(uint16_t moteId, simengine_cbt cb);
+
+void simengine_run(uint64_t durationUs);
+
+uint64_t simengine_getTime(void);
+
+uint16_t simengine_getNumMotes(void);
+
+void simengine_getStats(simengine_stats_t *stats);
+
+// bsp
+sim_mote_t *simengine_getMote(void);
+
+uint32_t simengine_readCounter(sim_mote_t *mote);
+
+uint64_t simengine_counterToTime(sim_mote_t *mote, uint32_t counter);
+
+void simengine_schedule(sim_mote_t *mote, uint64_t time, sim_channel_t channel, simengine_event_cbt cb, uint16_t arg);
+
+void simengine_cancel(sim_mote_t *mote, sim_channel_t channel);
+
+void simengine_radioStartTx(sim_mote_t *mote);
+
+void simengine_uartWrite(const uint8_t *buf, uint16_t len);
+
+// interrupt handlers
+void radio_intr_startOfFrame(uint32_t capturedTime);
+
+void radio_intr_endOfFrame(uint32_t capturedTime);
+
+#endif /* OPENWSN_SIMENGINE_H */
@@ -0,0 +1,96 @@
+/**
+\brief Native simulation definition of the "uart" bsp module.
+
+Only the FASTSIM output path is supported: serial frames are handed to the simulation engine in a single call, and
+no input is ever received.
+*/
+
+#include <stdio.h>
+
+#include "simengine.h"
+#include "uart.h"
+
+//=========================== defines =========================================
+
+#define OUTPUT_BUFFER_MASK          0x3FF
+
+//=========================== typedefs ========================================
+
+typedef struct {
+    uart_tx_cbt txCb;
+    uart_rx_cbt rxCb;
+} uart_icb_t;
+
+//=========================== variables =======================================
+
+#define uart_icb MOTE_CTX_VAR(uart_icb_t, uart_icb)
+
+//=========================== prototypes ======================================
+
+void uart_setCallbacks(uart_tx_cbt txCb, uart_rx_cbt rxCb) {
+    uart_icb.txCb = txCb;
+    uart_icb.rxCb = rxCb;
+}
+
+//=========================== public ==========================================
+
+void uart_init(void) {
+}
+
+void uart_enableInterrupts(void) {
+}
+
+void uart_disableInterrupts(void) {
+}
+
+void uart_clearRxInterrupts(void) {
+}
+
+void uart_clearTxInterrupts(void) {
+}
+
+void uart_writeByte(uint8_t byteToWrite) {
+    (void) byteToWrite;
+
+    printf("[CRITICAL] uart_writeByte() should not be called\r\n");
+}
+
+void uart_writeCircularBuffer_FASTSIM(uint8_t *buffer, uint16_t *outputBufIdxR, uint16_t *outputBufIdxW) {
+    uint16_t start;
+    uint16_t end;
+
+    while (*outputBufIdxR != *outputBufIdxW) {
+        start = OUTPUT_BUFFER_MASK & *outputBufIdxR;
+        end = OUTPUT_BUFFER_MASK & *outputBufIdxW;
+
+        // up to the write index, or to the end of the buffer when wrapping around
+        if (end <= start) {
+            end = OUTPUT_BUFFER_MASK + 1;
+        }
+
+        simengine_uartWrite(&buffer[start], end - start);
+        *outputBufIdxR += end - start;
+    }
+}
+
+void uart_writeBufferByLen_FASTSIM(uint8_t *buffer, uint16_t len) {
+    simengine_uartWrite(buffer, len);
+}
+
+uint8_t uart_readByte(void) {
+    return 0;
+}
+
+void uart_setCTS(bool state) {
+    (void) state;
+}
+
+//=========================== interrupt handlers ==============================
+
+void uart_intr_tx(void) {
+    uart_icb.txCb();
+}
+
+void uart_intr_rx(void) {
+    uart_icb.rxCb();
+}
@@ -0,0 +1,134 @@
+/**
+\brief Batching of the notifications sent from the C mote to the Python BSP.
+
+Most notifications (debugpins, leds, radio and sctimer commands, ...) return nothing to the mote. When the Python BSP
+registers a callback for MOTE_NOTIF_batch, these are appended as compact binary records to a per-mote buffer instead
+of being forwarded one by one. The buffer is handed over to Python in a single call whenever the mote is about to
+interact with Python synchronously (a notification whose return value depends on earlier ones, board_sleep(), the slot
+barriers) and before an interrupt handler returns, so Python observes all notifications in the order they were issued.
+sctimer_readCounter() is called on every timer operation and does not flush: the counter does not depend on the
+batched notifications.
+
+Each record is made of a 6-byte header followed by the arguments of the notification, in host byte order:
+
+\code
+  1B     1B     4B          len B
+| id  |  len | timestamp | arguments |
+\endcode
+
+with 'id' the MOTE_NOTIF_* identifier and 'timestamp' the last sctimer value seen by the mote (returned by
+sctimer_readCounter() or captured by the radio). The Python BSP receives the records as a read-only memoryview, only
+valid for the duration of the callback.
+*/
+
+#include "interface.h"
+#include "board_info.h"
+
+//=========================== defines =========================================
+
+#define NOTIF_BUFFER_SIZE           1024
+#define NOTIF_HEADER_LEN            6
+
+//=========================== typedefs ========================================
+
+typedef struct {
+    uint8_t buffer[NOTIF_BUFFER_SIZE];
+    uint16_t len;
+    uint32_t timestamp;
+} notif_vars_t;
+
+//=========================== variables =======================================
+
+#if BOARD_MULTI_MOTE_ENABLED
+#define notif_vars MOTE_CTX_VAR(notif_vars_t, notif_vars)
+#else
+notif_vars_t notif_vars;
+#endif
+
+//=========================== prototypes ======================================
+
+//=========================== public ==========================================
+
+/**
+\brief Append a notification to the batch of the current mote.
+
+\param[in] id   The MOTE_NOTIF_* identifier of the notification.
+\param[in] args The arguments of the notification, NULL if there are none.
+\param[in] len  The length of args, in bytes.
+
+\returns TRUE when the notification was batched, FALSE when the caller has to forward it to Python itself (the Python
+BSP does not support batching).
+*/
+bool notif_batch(uint8_t id, const void *args, uint8_t len) {
+    uint8_t *record;
+
+    if (callbacks[MOTE_NOTIF_batch] == NULL) {
+        return FALSE;
+    }
+
+    if (notif_vars.len + NOTIF_HEADER_LEN + len > NOTIF_BUFFER_SIZE) {
+        notif_flush();
+    }
+
+    record = &notif_vars.buffer[notif_vars.len];
+    record[0] = id;
+    record[1] = len;
+    memcpy(&record[2], &notif_vars.timestamp, sizeof(uint32_t));
+    if (len > 0) {
+        memcpy(&record[NOTIF_HEADER_LEN], args, len);
+    }
+    notif_vars.len += NOTIF_HEADER_LEN + len;
+
+    return TRUE;
+}
+
+/**
+\brief Hand all batched notifications of the current mote over to Python.
+*/
+void notif_flush(void) {
+    PyObject *view;
+    PyObject *arglist;
+    PyObject *result;
+
+    if (notif_vars.len == 0) {
+        return;
+    }
+
+    view = PyMemoryView_FromMemory((char *) notif_vars.buffer, notif_vars.len, PyBUF_READ);
+    if (view == NULL) {
+        printf("[CRITICAL] notif_flush() could not create a memoryview\r\n");
+        notif_vars.len = 0;
+        return;
+    }
+
+    arglist = Py_BuildValue("(O)", view);
+    result = PyObject_CallObject(callbacks[MOTE_NOTIF_batch], arglist);
+    if (result == NULL) {
+        printf("[CRITICAL] notif_flush() returned NULL\r\n");
+    } else {
+        Py_DECREF(result);
+    }
+    Py_DECREF(arglist);
+
+    // the buffer is reused, make sure Python can not hold on to it
+    result = PyObject_CallMethod(view, "release", NULL);
+    if (result == NULL) {
+        // e.g. a BufferError because Python still exports the view, do not leave it pending for an unrelated call
+        printf("[CRITICAL] notif_flush() could not release the memoryview\r\n");
+        PyErr_Clear();
+    } else {
+        Py_DECREF(result);
+    }
+    Py_DECREF(view);
+
+    notif_vars.len = 0;
+}
+
+/**
+\brief Record the latest known sctimer value, used to timestamp the batched notifications.
+*/
+void notif_setTimestamp(uint32_t timestamp) {
+    notif_vars.timestamp = timestamp;
+}
+
+//=========================== private =========================================
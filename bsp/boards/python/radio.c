@@ -16,7 +16,11 @@ typedef struct {
     radio_capture_cb_t endFrame_cb;
 } radio_icb_t;
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define radio_icb MOTE_CTX_VAR(radio_icb_t, radio_icb)
+#else
 radio_icb_t radio_icb;
+#endif
 //=========================== variables =======================================
 
 //=========================== prototypes ======================================
@@ -59,6 +63,10 @@ void radio_init(void) {
     printf("radio_init()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_radio_init, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_radio_init], NULL);
     if (result == NULL) {
@@ -81,6 +89,10 @@ void radio_reset(void) {
     printf("radio_reset()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_radio_reset, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_radio_reset], NULL);
     if (result == NULL) {
@@ -106,6 +118,10 @@ void radio_setFrequency(uint8_t frequency, radio_freq_t tx_or_rx) {
     printf("radio_setFrequency (frequency = %d)... \n", frequency);
 #endif
 
+    if (notif_batch(MOTE_NOTIF_radio_setFrequency, &frequency, sizeof(frequency))) {
+        return;
+    }
+
     // forward to Python
     arglist = Py_BuildValue("(i)", frequency);
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_radio_setFrequency], arglist);
@@ -128,6 +144,10 @@ void radio_rfOn(void) {
     printf("radio_rfOn()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_radio_rfOn, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_radio_rfOn], NULL);
     if (result == NULL) {
@@ -148,6 +168,10 @@ void radio_rfOff(void) {
     printf("radio_rfOff()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_radio_rfOff, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_radio_rfOff], NULL);
     if (result == NULL) {
@@ -175,6 +199,10 @@ void radio_loadPacket(const uint8_t *packet, uint16_t len) {
     printf("radio_loadPacket (len = %d)... \n", len);
 #endif
 
+    if (notif_batch(MOTE_NOTIF_radio_loadPacket, packet, (uint8_t) len)) {
+        return;
+    }
+
     // forward to Python
     pkt = PyList_New(len);
     for (i = 0; i < len; i++) {
@@ -203,6 +231,10 @@ void radio_txEnable(void) {
     printf("radio_txEnable()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_radio_txEnable, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_radio_txEnable], NULL);
     if (result == NULL) {
@@ -223,6 +255,10 @@ void radio_txNow(void) {
     printf("radio_txNow()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_radio_txNow, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_radio_txNow], NULL);
     if (result == NULL) {
@@ -245,6 +281,10 @@ void radio_rxEnable(void) {
     printf("radio_rxEnable()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_radio_rxEnable, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_radio_rxEnable], NULL);
     if (result == NULL) {
@@ -265,6 +305,10 @@ void radio_rxNow(void) {
     printf("radio_rxNow()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_radio_rxNow, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_radio_rxNow], NULL);
     if (result == NULL) {
@@ -296,6 +340,9 @@ void radio_getReceivedFrame(uint8_t *pBufRead,
     printf("radio_getReceivedFrame() ... \n");
 #endif
 
+    // preserve the order of the batched notifications
+    notif_flush();
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_radio_getReceivedFrame], NULL);
     if (result == NULL) {
@@ -356,10 +403,12 @@ void radio_getReceivedFrame(uint8_t *pBufRead,
 //=========================== interrupts ======================================
 
 void radio_intr_startOfFrame(uint32_t capturedTime) {
+    notif_setTimestamp(capturedTime);
     radio_icb.startFrame_cb(capturedTime);
 }
 
 void radio_intr_endOfFrame(uint32_t capturedTime) {
+    notif_setTimestamp(capturedTime);
     radio_icb.endFrame_cb(capturedTime);
 }
 
@@ -15,7 +15,11 @@ typedef struct {
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define sctimer_icb MOTE_CTX_VAR(sctimer_icb_t, sctimer_icb)
+#else
 sctimer_icb_t sctimer_icb;
+#endif
 
 //=========================== prototypes ======================================
 
@@ -45,6 +49,10 @@ void sctimer_init(void) {
     printf("sctimer_init()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_sctimer_init, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_sctimer_init], NULL);
     if (result == NULL) {
@@ -68,7 +76,7 @@ PORT_RADIOTIMER_WIDTH sctimer_readCounter(void) {
     printf("sctimer_readCounter()... \n");
 #endif
 
-    // forward to Python
+    // no flush, the batched notifications do not change the counter and carry their own timestamp
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_sctimer_readCounter], NULL);
     if (result == NULL) {
         printf("[CRITICAL] sctimer_readCounter() returned NULL\r\n");
@@ -77,6 +85,8 @@ PORT_RADIOTIMER_WIDTH sctimer_readCounter(void) {
     returnVal = (PORT_TIMER_WIDTH) PyLong_AsLong(result);
     Py_DECREF(result);
 
+    notif_setTimestamp(returnVal);
+
 #ifdef TRACE_ON
     printf("returnVal=%d.\n", returnVal);
 #endif
@@ -94,6 +104,10 @@ void sctimer_setCompare(PORT_RADIOTIMER_WIDTH value) {
     printf("sctimer_setCompare(value=%d)... \n", value);
 #endif
 
+    if (notif_batch(MOTE_NOTIF_sctimer_setCompare, &value, sizeof(value))) {
+        return;
+    }
+
     // forward to Python
     arglist = Py_BuildValue("(i)", value);
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_sctimer_setCompare], arglist);
@@ -116,6 +130,10 @@ void sctimer_enable(void) {
     printf("sctimer_enable()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_sctimer_enable, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_sctimer_enable], NULL);
     if (result == NULL) {
@@ -136,6 +154,10 @@ void sctimer_disable(void) {
     printf("sctimer_disable()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_sctimer_disable, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_sctimer_disable], NULL);
     if (result == NULL) {
@@ -19,10 +19,16 @@ typedef struct {
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define uart_icb MOTE_CTX_VAR(uart_icb_t, uart_icb)
+#else
 uart_icb_t uart_icb;
+#endif
 
 //=========================== prototypes ======================================
 
+static int uart_forwardSlice(uint8_t notifId, uint8_t *buffer, uint16_t len);
+
 void uart_setCallbacks(uart_tx_cbt txCb, uart_rx_cbt rxCb) {
 
 #ifdef TRACE_ON
@@ -46,6 +52,10 @@ void uart_init(void) {
     printf("uart_init()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_uart_init, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_uart_init], NULL);
     if (result == NULL) {
@@ -66,6 +76,10 @@ void uart_enableInterrupts(void) {
     printf("uart_enableInterrupts()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_uart_enableInterrupts, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_uart_enableInterrupts], NULL);
     if (result == NULL) {
@@ -86,6 +100,10 @@ void uart_disableInterrupts(void) {
     printf("uart_disableInterrupts()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_uart_disableInterrupts, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_uart_disableInterrupts], NULL);
     if (result == NULL) {
@@ -106,6 +124,10 @@ void uart_clearRxInterrupts(void) {
     printf("uart_clearRxInterrupts()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_uart_clearRxInterrupts, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_uart_clearRxInterrupts], NULL);
     if (result == NULL) {
@@ -126,6 +148,10 @@ void uart_clearTxInterrupts(void) {
     printf("uart_clearTxInterrupts()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_uart_clearTxInterrupts, NULL, 0)) {
+        return;
+    }
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_uart_clearTxInterrupts], NULL);
     if (result == NULL) {
@@ -153,6 +179,10 @@ void uart_writeByte(uint8_t byteToWrite) {
     printf("uart_writeByte()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_uart_writeByte, &byteToWrite, sizeof(byteToWrite))) {
+        return;
+    }
+
     // forward to Python
     arglist = Py_BuildValue("(i)", byteToWrite);
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_uart_writeByte], arglist);
@@ -172,13 +202,8 @@ void uart_writeByte(uint8_t byteToWrite) {
 
 void
 uart_writeCircularBuffer_FASTSIM(uint8_t *buffer, uint16_t *outputBufIdxR, uint16_t *outputBufIdxW) {
-    PyObject *frame;
-    PyObject *arglist;
-    PyObject *result;
-    PyObject *item;
-    int res;
-    int16_t len;
-    uint16_t i;
+    uint16_t start;
+    uint16_t end;
 
 #ifdef TRACE_ON
     printf("uart_writeCircularBuffer_FASTSIM(buffer = %p, outputBufIdxR = %p, outputBufIdxW = %p)... \n",
@@ -188,37 +213,24 @@ uart_writeCircularBuffer_FASTSIM(uint8_t *buffer, uint16_t *outputBufIdxR, uint1
     );
 #endif
 
-    // forward to Python
-    len = (*outputBufIdxW) - (*outputBufIdxR);
-    if (len < 0) {
-        len = len + OUTPUT_BUFFER_MASK + 1;
-    }
+    // preserve the order of the batched notifications
+    notif_flush();
 
-    frame = PyList_New(len);
-    i = 0;
+    // forward to Python, in at most two slices when the data wraps around the end of the buffer
     while (*outputBufIdxR != *outputBufIdxW) {
+        start = OUTPUT_BUFFER_MASK & *outputBufIdxR;
+        end = OUTPUT_BUFFER_MASK & *outputBufIdxW;
+        if (end <= start) {
+            end = OUTPUT_BUFFER_MASK + 1;
+        }
 
-        // get element at outputBufIdxR
-        item = PyLong_FromLong(buffer[OUTPUT_BUFFER_MASK & *outputBufIdxR]);
-        res = PyList_SetItem(frame, i, item);
-        if (res != 0) {
-            printf("[CRITICAL] uart_writeCircularBuffer_FASTSIM() failed setting list item\r\n");
+        if (uart_forwardSlice(MOTE_NOTIF_uart_writeCircularBuffer_FASTSIM, &buffer[start], end - start) < 0) {
+            printf("[CRITICAL] uart_writeCircularBuffer_FASTSIM() returned NULL\r\n");
             return;
         }
 
-        // increment index
-        (*outputBufIdxR)++;
-        i++;
+        *outputBufIdxR += end - start;
     }
-    arglist = Py_BuildValue("(O)", frame);
-    result = PyObject_CallObject(callbacks[MOTE_NOTIF_uart_writeCircularBuffer_FASTSIM], arglist);
-    if (result == NULL) {
-        printf("[CRITICAL] uart_writeCircularBuffer_FASTSIM() returned NULL\r\n");
-        return;
-    }
-    Py_DECREF(result);
-    Py_DECREF(arglist);
-    Py_DECREF(frame);
 
 #ifdef TRACE_ON
     printf("...done.\n");
@@ -226,40 +238,19 @@ uart_writeCircularBuffer_FASTSIM(uint8_t *buffer, uint16_t *outputBufIdxR, uint1
 }
 
 void uart_writeBufferByLen_FASTSIM(uint8_t *buffer, uint16_t len) {
-    PyObject *frame;
-    PyObject *arglist;
-    PyObject *result;
-    PyObject *item;
-    uint16_t i;
-    int res;
 
 #ifdef TRACE_ON
     printf("uart_writeBufferByLen_FASTSIM (buffer = %p, len = %d)... \n", buffer, len);
 #endif
 
+    // preserve the order of the batched notifications
+    notif_flush();
+
     // forward to Python
-    frame = PyList_New(len);
-    if (frame == NULL) {
-        printf("[CRITICAL] PyList_New(%d) failed in uart_writeBufferByLen_FASTSIM\r\n", len);
-        return;
-    }
-    for (i = 0; i < len; i++) {
-        item = PyLong_FromLong(buffer[i]);
-        res = PyList_SetItem(frame, i, item);
-        if (res != 0) {
-            printf("[CRITICAL] uart_writeBufferByLen_FASTSIM() failed setting list item\r\n");
-            return;
-        }
-    }
-    arglist = Py_BuildValue("(O)", frame);
-    result = PyObject_CallObject(callbacks[MOTE_NOTIF_uart_writeBufferByLen_FASTSIM], arglist);
-    if (result == NULL) {
+    if (uart_forwardSlice(MOTE_NOTIF_uart_writeBufferByLen_FASTSIM, buffer, len) < 0) {
         printf("[CRITICAL] uart_writeBufferByLen_FASTSIM() returned NULL\r\n");
         return;
     }
-    Py_DECREF(result);
-    Py_DECREF(arglist);
-    Py_DECREF(frame);
 
 #ifdef TRACE_ON
     printf("...done.\n");
@@ -274,6 +265,9 @@ uint8_t uart_readByte(void) {
     printf("uart_readByte()... \n");
 #endif
 
+    // preserve the order of the batched notifications
+    notif_flush();
+
     // forward to Python
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_uart_readByte], NULL);
     if (result == NULL) {
@@ -310,6 +304,10 @@ void uart_setCTS(bool state) {
     printf("uart_setCTS()... \n");
 #endif
 
+    if (notif_batch(MOTE_NOTIF_uart_setCTS, &state, sizeof(state))) {
+        return;
+    }
+
     // forward to Python
     arglist = Py_BuildValue("(i)", state);
     result = PyObject_CallObject(callbacks[MOTE_NOTIF_uart_setCTS], arglist);
@@ -353,4 +351,49 @@ void uart_intr_rx(void) {
 #ifdef TRACE_ON
     printf("...done.\n");
 #endif
-}
\ No newline at end of file
+}
+
+//=========================== private =========================================
+
+/**
+\brief Hand a contiguous region of a mote's memory over to Python, without copying it.
+
+The callback receives a read-only memoryview which is released as soon as it returns; Python must copy (e.g. with
+bytes()) whatever it wants to keep.
+
+\returns 0 on success, -1 if the callback failed.
+*/
+static int uart_forwardSlice(uint8_t notifId, uint8_t *buffer, uint16_t len) {
+    PyObject *view;
+    PyObject *arglist;
+    PyObject *result;
+    int res;
+
+    view = PyMemoryView_FromMemory((char *) buffer, len, PyBUF_READ);
+    if (view == NULL) {
+        return -1;
+    }
+
+    res = 0;
+    arglist = Py_BuildValue("(O)", view);
+    result = PyObject_CallObject(callbacks[notifId], arglist);
+    if (result == NULL) {
+        res = -1;
+    } else {
+        Py_DECREF(result);
+    }
+    Py_DECREF(arglist);
+
+    // the memory belongs to the mote, make sure Python can not hold on to it
+    result = PyObject_CallMethod(view, "release", NULL);
+    if (result == NULL) {
+        // e.g. a BufferError because Python still exports the view, do not leave it pending for an unrelated call
+        printf("[CRITICAL] uart_forwardSlice() could not release the memoryview\r\n");
+        PyErr_Clear();
+    } else {
+        Py_DECREF(result);
+    }
+    Py_DECREF(view);
+
+    return res;
+}
@@ -5,12 +5,50 @@ set_property(CACHE LOG_LEVEL PROPERTY STRINGS "0" "1" "2" "3" "4" "5" "6")
 set(IEEE154E_CHANNEL "0" CACHE STRING "Pick a fiexed channel between 11 and 26, or select 0 for channel hopping")
 add_definitions(-DIEEE802154E_SINGLE_CHANNEL=${IEEE154E_CHANNEL})
 
+set(SLOTDURATION "0" CACHE STRING "Timeslot duration in ms (10, 20 or 160), select 0 for the board default")
+set_property(CACHE SLOTDURATION PROPERTY STRINGS "0" "10" "20" "160")
+if (NOT SLOTDURATION EQUAL 0)
+    add_definitions(-DSLOTDURATION=${SLOTDURATION})
+endif ()
+
+option(OPT-STRICT-TSTEMPLATE "Advertise a timeslot template per slot duration and ignore EBs with another template" OFF)
+if (OPT-STRICT-TSTEMPLATE)
+    add_definitions(-DIEEE802154E_STRICT_TSTEMPLATE=1)
+endif ()
+
 set(DEFAULT_COAP_PORT "5683" CACHE STRING "Set a default CoAP server port")
 add_definitions(-DDEFAULT_COAP_PORT=${DEFAULT_COAP_PORT})
 
 set(PACKETQUEUE_LENGTH "20" CACHE STRING "Set the size of the packet buffer")
 add_definitions(-DPACKETQUEUE_LENGTH=${PACKETQUEUE_LENGTH})
 
+set(QUEUE_WEIGHT_LOCAL "1" CACHE STRING "Share of the cells to a neighbor given to locally originated data")
+add_definitions(-DOPENQUEUE_WEIGHT_LOCAL=${QUEUE_WEIGHT_LOCAL})
+
+set(QUEUE_WEIGHT_FORWARDED "1" CACHE STRING "Share of the cells to a neighbor given to forwarded data")
+add_definitions(-DOPENQUEUE_WEIGHT_FORWARDED=${QUEUE_WEIGHT_FORWARDED})
+
+set(QUEUE_FULL_BUFFERS "0" CACHE STRING "Number of full size (130 bytes) packet buffers, select 0 to derive it from PACKETQUEUE_LENGTH")
+if (NOT QUEUE_FULL_BUFFERS EQUAL 0)
+    add_definitions(-DOPENQUEUE_NUM_FULL_BUFFERS=${QUEUE_FULL_BUFFERS})
+endif ()
+
+set(QUEUE_SMALL_BUFFERS "0" CACHE STRING "Number of small packet buffers, select 0 to derive it from PACKETQUEUE_LENGTH")
+if (NOT QUEUE_SMALL_BUFFERS EQUAL 0)
+    add_definitions(-DOPENQUEUE_NUM_SMALL_BUFFERS=${QUEUE_SMALL_BUFFERS})
+endif ()
+
+set(SLOTFRAMES "1" CACHE STRING "Maximum number of slotframes in the schedule [1 - 8]")
+add_definitions(-DSCHEDULE_MAX_SLOTFRAMES=${SLOTFRAMES})
+
+set(MSF_SLOTFRAME "0" CACHE STRING "Length of a second slotframe MSF negotiates its cells in (needs SLOTFRAMES >= 2), select 0 to use the minimal slotframe")
+if (NOT MSF_SLOTFRAME EQUAL 0)
+    add_definitions(-DMSF_SLOTFRAME_LENGTH=${MSF_SLOTFRAME})
+endif ()
+
+set(MAX_NUM_TIMERS "15" CACHE STRING "Maximum number of timers that can run concurrently [3 - 64]")
+add_definitions(-DMAX_NUM_TIMERS=${MAX_NUM_TIMERS})
+
 set(PANID "0xcafe" CACHE STRING "Set a 2-byte PAN ID")
 add_definitions(-DPANID_DEFINED=${PANID})
 
@@ -99,6 +137,11 @@ if (OPT-MSF)
     add_definitions(-DADAPTIVE_MSF)
 endif ()
 
+option(OPT-RPL-STORING "Run RPL in storing mode, routing downward traffic without source routing headers" OFF)
+if (OPT-RPL-STORING)
+    add_definitions(-DRPL_STORING_MODE)
+endif ()
+
 option(OPT-DAGROOT "Configure the build as DAGroot" OFF)
 if (OPT-DAGROOT)
     add_definitions(-DDAGROOT)
@@ -109,7 +152,41 @@ if (OPT-PRINTF)
     add_definitions(-DBOARD_OPENSERIAL_PRINTF)
 endif ()
 
+option(OPT-SCHEDULER-STATS "Keep wait and run time histograms of the scheduler tasks and report them over serial" OFF)
+if (OPT-SCHEDULER-STATS)
+    add_definitions(-DSCHEDULER_STATS_ENABLE)
+endif ()
+
 option(OPT-CRYPTO-HW "Enable hardware acceleration for crypto operations" OFF)
 if (OPT-CRYPTO-HW)
     add_definitions(-DBOARD_CRYPTOENGINE_ENABLED)
 endif ()
+
+set(AES_BACKEND "byte" CACHE STRING "Software AES-128 implementation, used when OPT-CRYPTO-HW is off: byte, ttable or bitsliced")
+set_property(CACHE AES_BACKEND PROPERTY STRINGS "byte" "ttable" "bitsliced")
+if ("${AES_BACKEND}" STREQUAL "byte")
+    add_definitions(-DAES128_BACKEND=0)
+elseif ("${AES_BACKEND}" STREQUAL "ttable")
+    add_definitions(-DAES128_BACKEND=1)
+elseif ("${AES_BACKEND}" STREQUAL "bitsliced")
+    add_definitions(-DAES128_BACKEND=2)
+else ()
+    message(FATAL_ERROR "AES_BACKEND must be one of byte, ttable or bitsliced")
+endif ()
+
+option(OPT-NATIVE-SIM "Simulate a network of motes in a standalone executable, without Python in the loop" OFF)
+if (OPT-NATIVE-SIM)
+    if (NOT "${BOARD}" STREQUAL "python")
+        message(FATAL_ERROR "OPT-NATIVE-SIM is only supported on the python board")
+    endif ()
+    set(OPT-MULTI-MOTE ON CACHE BOOL "Host several independent motes in a single instance of the Python extension" FORCE)
+    add_definitions(-DBOARD_NATIVE_SIM_ENABLED)
+endif ()
+
+option(OPT-MULTI-MOTE "Host several independent motes in a single instance of the Python extension" OFF)
+if (OPT-MULTI-MOTE)
+    if (NOT "${BOARD}" STREQUAL "python")
+        message(FATAL_ERROR "OPT-MULTI-MOTE is only supported on the python board")
+    endif ()
+    add_definitions(-DBOARD_MULTI_MOTE_ENABLED)
+endif ()
@@ -0,0 +1,7 @@
+# build the host benchmark of the software AES-128 backends
+
+if (NOT "${BOARD}" STREQUAL "python")
+    message(FATAL_ERROR "The drv_aes128_bench project runs on the host, select the python board")
+endif ()
+
+add_subdirectory(${CMAKE_SOURCE_DIR}/projects/common/02drv_aes128_bench)
@@ -8,8 +8,10 @@ ECCN 5D002 TSU - Technology / Software Unrestricted
 Source: http://is.gd/o9RSPq
 **************************************************************/
 #include <stdint.h>
+#include <string.h>
 #include "opendefs.h"
 #include "aes128.h"
+#include "aes128_backends.h"
 
 //=========================== variables =======================================
 
@@ -38,25 +40,78 @@ const unsigned char Rcon[11] = {0x8d, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40,
 
 //=========================== prototypes ======================================
 
-void expand_key(unsigned char *expandedKey, unsigned char *key);
-
 unsigned char galois_mul2(unsigned char value);
 
-void aes_enc(unsigned char *state, unsigned char *expandedKey);
+static void aes128_expand(aes128_schedule_t *schedule, uint8_t *key);
+
+static void aes128_encrypt(uint8_t *buffer, uint8_t numBlocks, aes128_schedule_t *schedule);
 
 //=========================== public ==========================================
 
 owerror_t aes128_enc(uint8_t buffer[16], uint8_t key[16]) {
-    uint8_t expandedKey[176];
+    aes128_schedule_t schedule;
 
-    expand_key(expandedKey, key);       // expand the key into 176 bytes
-    aes_enc(buffer, expandedKey);
+    aes128_expand(&schedule, key);
+    aes128_encrypt(buffer, 1, &schedule);
+
+    return E_SUCCESS;
+}
+
+void aes128_set_key(aes128_ctx_t *ctx, uint8_t *key) {
+    memcpy(ctx->key, key, 16);
+#if !BOARD_CRYPTOENGINE_ENABLED
+    aes128_expand(&ctx->schedule, ctx->key);
+#endif
+}
+
+owerror_t aes128_enc_ctx(uint8_t *buffer, aes128_ctx_t *ctx) {
+    return aes128_enc_blocks_ctx(buffer, 1, ctx);
+}
+
+owerror_t aes128_enc_blocks_ctx(uint8_t *buffer, uint8_t numBlocks, aes128_ctx_t *ctx) {
+#if BOARD_CRYPTOENGINE_ENABLED
+    uint8_t n;
+
+    for (n = 0; n < numBlocks; n++) {
+        aes128_enc(&buffer[16 * n], ctx->key);
+    }
+#else
+    aes128_encrypt(buffer, numBlocks, &ctx->schedule);
+#endif
 
     return E_SUCCESS;
 }
 
 //=========================== private =========================================
 
+static void aes128_expand(aes128_schedule_t *schedule, uint8_t *key) {
+#if AES128_BACKEND == AES128_BACKEND_TTABLE
+    aes128_ttable_expandKey(schedule->roundKeys, key);
+#elif AES128_BACKEND == AES128_BACKEND_BITSLICED
+    aes128_bitsliced_expandKey(schedule->roundKeys, key);
+#else
+    expand_key(schedule->expandedKey, key);
+#endif
+}
+
+static void aes128_encrypt(uint8_t *buffer, uint8_t numBlocks, aes128_schedule_t *schedule) {
+    uint8_t n;
+
+#if AES128_BACKEND == AES128_BACKEND_BITSLICED
+    for (n = 0; n < numBlocks; n += 2) {
+        aes128_bitsliced_enc(&buffer[16 * n], numBlocks - n >= 2 ? 2 : 1, schedule->roundKeys);
+    }
+#else
+    for (n = 0; n < numBlocks; n++) {
+#if AES128_BACKEND == AES128_BACKEND_TTABLE
+        aes128_ttable_enc(&buffer[16 * n], schedule->roundKeys);
+#else
+        aes_enc(&buffer[16 * n], schedule->expandedKey);
+#endif
+    }
+#endif
+}
+
 // expand the key
 void expand_key(unsigned char *expandedKey,
                 unsigned char *key) {
@@ -10,8 +10,72 @@ Source: http://is.gd/o9RSPq
 #ifndef OPENWSN_AES128_H
 #define OPENWSN_AES128_H
 
+#include "config.h"
+#include "opendefs.h"
+
+//=========================== define ==========================================
+
+// software AES-128 implementations, selected with AES128_BACKEND
+#define AES128_BACKEND_BYTE         0   // byte oriented S-box implementation, smallest footprint
+#define AES128_BACKEND_TTABLE       1   // 32-bit T-table implementation, fastest on 32-bit cores
+#define AES128_BACKEND_BITSLICED    2   // constant-time bitsliced implementation, two blocks per pass
+
+//=========================== typedef =========================================
+
+/// expanded key schedule, in the representation of the selected backend
+typedef struct {
+#if AES128_BACKEND == AES128_BACKEND_TTABLE
+    uint32_t roundKeys[44];
+#elif AES128_BACKEND == AES128_BACKEND_BITSLICED
+    uint32_t roundKeys[88];
+#else
+    uint8_t expandedKey[176];
+#endif
+} aes128_schedule_t;
+
+/**
+\brief AES-128 key together with its expanded key schedule.
+
+Expanding the key costs about as much as encrypting a block, so long-lived keys are expanded once with
+aes128_set_key() and the context is then passed to every block operation. With a hardware crypto engine the
+schedule is kept by the engine and only the raw key is stored.
+*/
+typedef struct {
+    uint8_t key[16];
+#if !BOARD_CRYPTOENGINE_ENABLED
+    aes128_schedule_t schedule;
+#endif
+} aes128_ctx_t;
+
 //=========================== prototypes ======================================
 
+/**
+\brief Load a key into a context and expand its key schedule.
+\param[out] ctx Context to initialize.
+\param[in] key Buffer containing the secret key (16 octets).
+*/
+void aes128_set_key(aes128_ctx_t *ctx, uint8_t *key);
+
+/**
+\brief Basic AES encryption of a single 16-octet block with a pre-expanded key.
+\param[in,out] buffer Single block plaintext. Will be overwritten by ciphertext.
+\param[in] ctx Context initialized with aes128_set_key().
+
+\returns E_SUCCESS when the encryption was successful.
+*/
+owerror_t aes128_enc_ctx(uint8_t *buffer, aes128_ctx_t *ctx);
+
+/**
+\brief AES encryption of consecutive, independent 16-octet blocks (i.e. ECB) with a pre-expanded key. Backends that
+   encrypt several blocks per pass (the bitsliced one) process them together, e.g. a CBC-MAC and a CTR block of CCM*.
+\param[in,out] buffer Plaintext blocks. Will be overwritten by ciphertext.
+\param[in] numBlocks Number of blocks in buffer.
+\param[in] ctx Context initialized with aes128_set_key().
+
+\returns E_SUCCESS when the encryption was successful.
+*/
+owerror_t aes128_enc_blocks_ctx(uint8_t *buffer, uint8_t numBlocks, aes128_ctx_t *ctx);
+
 /**
 \brief Basic AES encryption of a single 16-octet block.
 \param[in,out] buffer Single block plaintext. Will be overwritten by ciphertext.
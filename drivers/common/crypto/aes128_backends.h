@@ -0,0 +1,34 @@
+/**
+\brief Software AES-128 backends.
+
+All backends are always compiled, so that they can be compared against each other (see
+projects/common/02drv_aes128_bench); the firmware only links the one selected with AES128_BACKEND, through the
+aes128.h API.
+*/
+#ifndef OPENWSN_AES128_BACKENDS_H
+#define OPENWSN_AES128_BACKENDS_H
+
+#include <stdint.h>
+
+//=========================== variables =======================================
+
+extern const unsigned char sbox[256];
+
+//=========================== prototypes ======================================
+
+// byte oriented implementation (aes128.c)
+void expand_key(unsigned char *expandedKey, unsigned char *key);
+
+void aes_enc(unsigned char *state, unsigned char *expandedKey);
+
+// T-table implementation (aes128_ttable.c)
+void aes128_ttable_expandKey(uint32_t roundKeys[44], uint8_t key[16]);
+
+void aes128_ttable_enc(uint8_t state[16], uint32_t roundKeys[44]);
+
+// bitsliced implementation (aes128_bitsliced.c)
+void aes128_bitsliced_expandKey(uint32_t roundKeys[88], uint8_t key[16]);
+
+void aes128_bitsliced_enc(uint8_t *blocks, uint8_t numBlocks, uint32_t roundKeys[88]);
+
+#endif /* OPENWSN_AES128_BACKENDS_H */
@@ -0,0 +1,351 @@
+/**
+\brief Constant-time bitsliced implementation of AES-128 encryption.
+
+The state of two blocks is spread over eight 32-bit words, word b holding bit b of all 32 state bytes. Each block
+uses one half word, in which the byte at row r and column c sits at bit c + 4 * r. SubBytes then becomes a boolean
+circuit evaluated on whole words (the 113 gate circuit of Boyar and Peralta), ShiftRows a rotation of the 4-bit row
+groups and MixColumns a rotation of the half words by whole rows. No memory access and no branch depends on the key or
+on the data. When a single block is encrypted, the other half word is simply ignored.
+*/
+#include <stdint.h>
+#include <string.h>
+#include "aes128_backends.h"
+
+//=========================== define ==========================================
+
+/// index in the AES state of the byte kept at bit pos of the words (the mapping is its own inverse)
+#define STATE_INDEX(pos)    (((pos) & 0x10) | (((pos) >> 2) & 0x03) | (((pos) & 0x03) << 2))
+
+//=========================== prototypes ======================================
+
+static void pack(uint32_t q[8], const uint8_t *blocks, uint8_t numBlocks);
+
+static void unpack(uint8_t *blocks, uint8_t numBlocks, const uint32_t q[8]);
+
+static uint64_t transpose8(uint64_t x);
+
+static uint64_t load64(const uint8_t *p);
+
+static void store64(uint8_t *p, uint64_t x);
+
+static void add_round_key(uint32_t q[8], const uint32_t *rk);
+
+static void sub_bytes(uint32_t q[8]);
+
+static void shift_rows(uint32_t q[8]);
+
+static void mix_columns(uint32_t q[8]);
+
+//=========================== public ==========================================
+
+void aes128_bitsliced_expandKey(uint32_t roundKeys[88], uint8_t key[16]) {
+    uint8_t expandedKey[176];
+    uint8_t roundKey[32];
+    uint8_t round;
+
+    expand_key(expandedKey, key);
+    for (round = 0; round < 11; round++) {
+        // the round key is replicated in both half words
+        memcpy(&roundKey[0], &expandedKey[16 * round], 16);
+        memcpy(&roundKey[16], &expandedKey[16 * round], 16);
+        pack(&roundKeys[8 * round], roundKey, 2);
+    }
+}
+
+void aes128_bitsliced_enc(uint8_t *blocks, uint8_t numBlocks, uint32_t roundKeys[88]) {
+    uint32_t q[8];
+    uint8_t round;
+
+    pack(q, blocks, numBlocks);
+
+    add_round_key(q, &roundKeys[0]);
+    for (round = 1; round < 10; round++) {
+        sub_bytes(q);
+        shift_rows(q);
+        mix_columns(q);
+        add_round_key(q, &roundKeys[8 * round]);
+    }
+    sub_bytes(q);
+    shift_rows(q);
+    add_round_key(q, &roundKeys[80]);
+
+    unpack(blocks, numBlocks, q);
+}
+
+//=========================== private =========================================
+
+static void pack(uint32_t q[8], const uint8_t *blocks, uint8_t numBlocks) {
+    uint8_t gathered[32];
+    uint8_t pos;
+    uint8_t g;
+    uint8_t b;
+    uint64_t x;
+
+    // bit pos of each word holds the state byte at row (pos / 4) % 4, column pos % 4 of block pos / 16
+    for (pos = 0; pos < 32; pos++) {
+        gathered[pos] = pos < 16 * numBlocks ? blocks[STATE_INDEX(pos)] : 0;
+    }
+
+    memset(q, 0, 8 * sizeof(uint32_t));
+    for (g = 0; g < 4; g++) {
+        x = transpose8(load64(&gathered[8 * g]));
+        for (b = 0; b < 8; b++) {
+            q[b] |= (uint32_t) ((x >> (8 * b)) & 0xff) << (8 * g);
+        }
+    }
+}
+
+static void unpack(uint8_t *blocks, uint8_t numBlocks, const uint32_t q[8]) {
+    uint8_t gathered[32];
+    uint8_t pos;
+    uint8_t g;
+    uint8_t b;
+    uint64_t x;
+
+    for (g = 0; g < 4; g++) {
+        x = 0;
+        for (b = 0; b < 8; b++) {
+            x |= (uint64_t) ((q[b] >> (8 * g)) & 0xff) << (8 * b);
+        }
+        store64(&gathered[8 * g], transpose8(x));
+    }
+
+    for (pos = 0; pos < 16 * numBlocks; pos++) {
+        blocks[STATE_INDEX(pos)] = gathered[pos];
+    }
+}
+
+// transposes the 8x8 bit matrix whose row j is byte j of x: bit b of byte j moves to bit j of byte b
+static uint64_t transpose8(uint64_t x) {
+    uint64_t t;
+
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x = x ^ t ^ (t << 28);
+
+    return x;
+}
+
+static uint64_t load64(const uint8_t *p) {
+    uint64_t x;
+    uint8_t i;
+
+    x = 0;
+    for (i = 0; i < 8; i++) {
+        x |= (uint64_t) p[i] << (8 * i);
+    }
+
+    return x;
+}
+
+static void store64(uint8_t *p, uint64_t x) {
+    uint8_t i;
+
+    for (i = 0; i < 8; i++) {
+        p[i] = (uint8_t) (x >> (8 * i));
+    }
+}
+
+static void add_round_key(uint32_t q[8], const uint32_t *rk) {
+    uint8_t b;
+
+    for (b = 0; b < 8; b++) {
+        q[b] ^= rk[b];
+    }
+}
+
+// Boyar-Peralta S-box circuit, x0 and s0 are the most significant bits
+static void sub_bytes(uint32_t q[8]) {
+    uint32_t x0, x1, x2, x3, x4, x5, x6, x7;
+    uint32_t y1, y2, y3, y4, y5, y6, y7, y8, y9, y10, y11, y12, y13, y14, y15, y16, y17, y18, y19, y20, y21;
+    uint32_t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9, z10, z11, z12, z13, z14, z15, z16, z17;
+    uint32_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13, t14, t15, t16, t17, t18, t19, t20, t21, t22;
+    uint32_t t23, t24, t25, t26, t27, t28, t29, t30, t31, t32, t33, t34, t35, t36, t37, t38, t39, t40, t41, t42, t43;
+    uint32_t t44, t45, t46, t47, t48, t49, t50, t51, t52, t53, t54, t55, t56, t57, t58, t59, t60, t61, t62, t63, t64;
+    uint32_t t65, t66, t67;
+    uint32_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+    x0 = q[7];
+    x1 = q[6];
+    x2 = q[5];
+    x3 = q[4];
+    x4 = q[3];
+    x5 = q[2];
+    x6 = q[1];
+    x7 = q[0];
+
+    // top linear transformation
+    y14 = x3 ^ x5;
+    y13 = x0 ^ x6;
+    y9 = x0 ^ x3;
+    y8 = x0 ^ x5;
+    t0 = x1 ^ x2;
+    y1 = t0 ^ x7;
+    y4 = y1 ^ x3;
+    y12 = y13 ^ y14;
+    y2 = y1 ^ x0;
+    y5 = y1 ^ x6;
+    y3 = y5 ^ y8;
+    t1 = x4 ^ y12;
+    y15 = t1 ^ x5;
+    y20 = t1 ^ x1;
+    y6 = y15 ^ x7;
+    y10 = y15 ^ t0;
+    y11 = y20 ^ y9;
+    y7 = x7 ^ y11;
+    y17 = y10 ^ y11;
+    y19 = y10 ^ y8;
+    y16 = t0 ^ y11;
+    y21 = y13 ^ y16;
+    y18 = x0 ^ y16;
+
+    // non-linear section
+    t2 = y12 & y15;
+    t3 = y3 & y6;
+    t4 = t3 ^ t2;
+    t5 = y4 & x7;
+    t6 = t5 ^ t2;
+    t7 = y13 & y16;
+    t8 = y5 & y1;
+    t9 = t8 ^ t7;
+    t10 = y2 & y7;
+    t11 = t10 ^ t7;
+    t12 = y9 & y11;
+    t13 = y14 & y17;
+    t14 = t13 ^ t12;
+    t15 = y8 & y10;
+    t16 = t15 ^ t12;
+    t17 = t4 ^ t14;
+    t18 = t6 ^ t16;
+    t19 = t9 ^ t14;
+    t20 = t11 ^ t16;
+    t21 = t17 ^ y20;
+    t22 = t18 ^ y19;
+    t23 = t19 ^ y21;
+    t24 = t20 ^ y18;
+
+    t25 = t21 ^ t22;
+    t26 = t21 & t23;
+    t27 = t24 ^ t26;
+    t28 = t25 & t27;
+    t29 = t28 ^ t22;
+    t30 = t23 ^ t24;
+    t31 = t22 ^ t26;
+    t32 = t31 & t30;
+    t33 = t32 ^ t24;
+    t34 = t23 ^ t33;
+    t35 = t27 ^ t33;
+    t36 = t24 & t35;
+    t37 = t36 ^ t34;
+    t38 = t27 ^ t36;
+    t39 = t29 & t38;
+    t40 = t25 ^ t39;
+
+    t41 = t40 ^ t37;
+    t42 = t29 ^ t33;
+    t43 = t29 ^ t40;
+    t44 = t33 ^ t37;
+    t45 = t42 ^ t41;
+    z0 = t44 & y15;
+    z1 = t37 & y6;
+    z2 = t33 & x7;
+    z3 = t43 & y16;
+    z4 = t40 & y1;
+    z5 = t29 & y7;
+    z6 = t42 & y11;
+    z7 = t45 & y17;
+    z8 = t41 & y10;
+    z9 = t44 & y12;
+    z10 = t37 & y3;
+    z11 = t33 & y4;
+    z12 = t43 & y13;
+    z13 = t40 & y5;
+    z14 = t29 & y2;
+    z15 = t42 & y9;
+    z16 = t45 & y14;
+    z17 = t41 & y8;
+
+    // bottom linear transformation
+    t46 = z15 ^ z16;
+    t47 = z10 ^ z11;
+    t48 = z5 ^ z13;
+    t49 = z9 ^ z10;
+    t50 = z2 ^ z12;
+    t51 = z2 ^ z5;
+    t52 = z7 ^ z8;
+    t53 = z0 ^ z3;
+    t54 = z6 ^ z7;
+    t55 = z16 ^ z17;
+    t56 = z12 ^ t48;
+    t57 = t50 ^ t53;
+    t58 = z4 ^ t46;
+    t59 = z3 ^ t54;
+    t60 = t46 ^ t57;
+    t61 = z14 ^ t57;
+    t62 = t52 ^ t58;
+    t63 = t49 ^ t58;
+    t64 = z4 ^ t59;
+    t65 = t61 ^ t62;
+    t66 = z1 ^ t63;
+    s0 = t59 ^ t63;
+    s6 = t56 ^ ~t62;
+    s7 = t48 ^ ~t60;
+    t67 = t64 ^ t65;
+    s3 = t53 ^ t66;
+    s4 = t51 ^ t66;
+    s5 = t47 ^ t65;
+    s1 = t64 ^ ~s3;
+    s2 = t55 ^ ~t67;
+
+    q[7] = s0;
+    q[6] = s1;
+    q[5] = s2;
+    q[4] = s3;
+    q[3] = s4;
+    q[2] = s5;
+    q[1] = s6;
+    q[0] = s7;
+}
+
+// row r (bits 4r to 4r + 3 of each half word) is rotated by r columns
+static void shift_rows(uint32_t q[8]) {
+    uint8_t b;
+    uint32_t x;
+
+    for (b = 0; b < 8; b++) {
+        x = q[b];
+        q[b] = (x & 0x000F000F) |
+               ((x >> 1) & 0x00700070) | ((x << 3) & 0x00800080) |
+               ((x >> 2) & 0x03000300) | ((x << 2) & 0x0C000C00) |
+               ((x >> 3) & 0x10001000) | ((x << 1) & 0xE000E000);
+    }
+}
+
+// out[r] = 2.(a[r] ^ a[r + 1]) ^ a[r + 1] ^ a[r + 2] ^ a[r + 3], rows taken modulo 4
+static void mix_columns(uint32_t q[8]) {
+    uint32_t r1[8];
+    uint32_t r23[8];
+    uint32_t t[8];
+    uint8_t b;
+
+    for (b = 0; b < 8; b++) {
+        // rotate each half word by one, two and three rows
+        r1[b] = ((q[b] >> 4) & 0x0FFF0FFF) | ((q[b] << 12) & 0xF000F000);
+        r23[b] = ((q[b] >> 8) & 0x00FF00FF) | ((q[b] << 8) & 0xFF00FF00);
+        r23[b] ^= ((q[b] >> 12) & 0x000F000F) | ((q[b] << 4) & 0xFFF0FFF0);
+        t[b] = q[b] ^ r1[b];
+    }
+
+    // multiplication of t by x modulo x^8 + x^4 + x^3 + x + 1
+    q[0] = t[7] ^ r1[0] ^ r23[0];
+    q[1] = t[0] ^ t[7] ^ r1[1] ^ r23[1];
+    q[2] = t[1] ^ r1[2] ^ r23[2];
+    q[3] = t[2] ^ t[7] ^ r1[3] ^ r23[3];
+    q[4] = t[3] ^ t[7] ^ r1[4] ^ r23[4];
+    q[5] = t[4] ^ r1[5] ^ r23[5];
+    q[6] = t[5] ^ r1[6] ^ r23[6];
+    q[7] = t[6] ^ r1[7] ^ r23[7];
+}
@@ -19,29 +19,20 @@
 
 #if !BOARD_CRYPTOENGINE_ENABLED
 
-static owerror_t aes_cbc_mac(uint8_t *a,
-                             uint8_t len_a,
-                             uint8_t *m,
-                             uint8_t len_m,
-                             uint8_t *nonce,
-                             uint8_t key[16],
-                             uint8_t *mac,
-                             uint8_t len_mac,
-                             uint8_t l);
-
-static owerror_t aes_ctr_enc(uint8_t *m,
-                             uint8_t len_m,
-                             uint8_t *nonce,
-                             uint8_t key[16],
-                             uint8_t *mac,
-                             uint8_t len_mac,
-                             uint8_t l);
-
-owerror_t aes_cbc_enc_raw(uint8_t *buffer, uint8_t len, uint8_t key[16], uint8_t iv[16]);
-
-owerror_t aes_ctr_enc_raw(uint8_t *buffer, uint8_t len, uint8_t key[16], uint8_t iv[16]);
-
-static void inc_counter(uint8_t *counter);
+static void aes_ccms_transform(uint8_t *a,
+                               uint8_t len_a,
+                               uint8_t *m,
+                               uint8_t len_m,
+                               uint8_t *nonce,
+                               uint8_t l,
+                               aes128_ctx_t *ctx,
+                               uint8_t *mac,
+                               uint8_t len_mac,
+                               bool encrypt);
+
+static void format_block(uint8_t block[16], uint8_t flags, uint8_t *nonce, uint8_t l, uint16_t value);
+
+static bool is_valid_mac_length(uint8_t len_mac);
 
 #endif
 
@@ -59,22 +50,11 @@ owerror_t aes128_ccms_enc(uint8_t *a,
 #if BOARD_CRYPTOENGINE_ENABLED
     return cryptoengine_aes_ccms_enc(a, len_a, m, len_m, nonce, l, key, len_mac);
 #else
-    uint8_t mac[CBC_MAX_MAC_SIZE];
-
-    if ((len_mac > CBC_MAX_MAC_SIZE) || (l != 2)) {
-        return E_FAIL;
-    }
+    aes128_ctx_t ctx;
 
-    if (aes_cbc_mac(a, len_a, m, *len_m, nonce, key, mac, len_mac, l) == E_SUCCESS) {
-        if (aes_ctr_enc(m, *len_m, nonce, key, mac, len_mac, l) == E_SUCCESS) {
-            memcpy(&m[*len_m], mac, len_mac);
-            *len_m += len_mac;
+    aes128_set_key(&ctx, key);
 
-            return E_SUCCESS;
-        }
-    }
-
-    return E_FAIL;
+    return aes128_ccms_enc_ctx(a, len_a, m, len_m, nonce, l, &ctx, len_mac);
 #endif
 }
 
@@ -90,264 +70,183 @@ owerror_t aes128_ccms_dec(uint8_t *a,
 #if BOARD_CRYPTOENGINE_ENABLED
     return cryptoengine_aes_ccms_dec(a, len_a, m, len_m, nonce, l, key, len_mac);
 #else
-    uint8_t mac[CBC_MAX_MAC_SIZE];
-    uint8_t orig_mac[CBC_MAX_MAC_SIZE];
+    aes128_ctx_t ctx;
 
-    if ((len_mac > CBC_MAX_MAC_SIZE) || (l != 2)) {
-        return E_FAIL;
-    }
-
-    *len_m -= len_mac;
-    memcpy(mac, &m[*len_m], len_mac);
+    aes128_set_key(&ctx, key);
 
-    if (aes_ctr_enc(m, *len_m, nonce, key, mac, len_mac, l) == E_SUCCESS) {
-        if (aes_cbc_mac(a, len_a, m, *len_m, nonce, key, orig_mac, len_mac, l) == E_SUCCESS) {
-            if (memcmp(mac, orig_mac, len_mac) == 0) {
-                return E_SUCCESS;
-            }
-        }
-    }
-
-    return E_FAIL;
+    return aes128_ccms_dec_ctx(a, len_a, m, len_m, nonce, l, &ctx, len_mac);
 #endif
 }
 
-//=========================== private =========================================
-#if !BOARD_CRYPTOENGINE_ENABLED
-
-/**
-\brief CBC-MAC generation specific to CCM*.
-\param[in] a Pointer to the authentication only data.
-\param[in] len_a Length of authentication only data.
-\param[in] m Pointer to the data that is both authenticated and encrypted.
-\param[in] len_m Length of data that is both authenticated and encrypted.
-\param[in] nonce Buffer containing nonce (13 octets).
-\param[in] key Buffer containing the secret key (16 octets).
-\param[out] mac Buffer where the value of the CBC-MAC tag will be written.
-\param[in] len_mac Length of the CBC-MAC tag. Must be 4, 8 or 16 octets.
-\param[in] l CCM parameter L that allows selection of different nonce length.
-
-\returns E_SUCCESS when the generation was successful, E_FAIL otherwise. 
-*/
-static owerror_t aes_cbc_mac(uint8_t *a,
-                             uint8_t len_a,
-                             uint8_t *m,
-                             uint8_t len_m,
-                             uint8_t *nonce,
-                             uint8_t key[16],
-                             uint8_t *mac,
-                             uint8_t len_mac,
-                             uint8_t l) {
-
-    uint8_t pad_len;
-    uint8_t len;
-    uint8_t cbc_mac_iv[16];
-    uint8_t buffer[128 + 16 + 16]; // max buffer plus IV
-
-    // asserts here
-    if (!((len_mac == 0) || (len_mac == 4) || (len_mac == 8) || (len_mac == 16))) {
-        return E_FAIL;
-    }
-
-    if ((len_a > 127) || (len_m > 127) || ((len_a + len_m) > 127)) {
-        return E_FAIL;
-    }
+owerror_t aes128_ccms_enc_ctx(uint8_t *a,
+                              uint8_t len_a,
+                              uint8_t *m,
+                              uint8_t *len_m,
+                              uint8_t *nonce,
+                              uint8_t l,
+                              aes128_ctx_t *ctx,
+                              uint8_t len_mac) {
 
-    if (mac == 0) {
+#if BOARD_CRYPTOENGINE_ENABLED
+    return cryptoengine_aes_ccms_enc(a, len_a, m, len_m, nonce, l, ctx->key, len_mac);
+#else
+    if (is_valid_mac_length(len_mac) == FALSE || (l != 2) || ((uint16_t) *len_m + len_mac > 0xff)) {
         return E_FAIL;
     }
 
-    memset(cbc_mac_iv, 0x00, 16); // CBC-MAC Initialization Vector is a zero string
-
-    // IV: flags (1B) | SADDR (8B) | ASN (5B) | len(m) (2B)
-    // X0 xor IV in first 16 bytes of buffer: set buffer[:16] as IV)
-    buffer[0] = 0x00; // set flags to zero including reserved
-    buffer[0] |= 0x07 & (l - 1); // field L
-    // (len_mac - 2)/2 shifted left 3 times corresponds to (len_mac - 2) << 2
-    buffer[0] |= len_mac == 0 ? 0 : (0x07 & (len_mac - 2)) << 2; // field M
-    buffer[0] |= len_a != 0 ? 0x40 : 0; // field Adata
-
-    memcpy(&buffer[1], nonce, 13);
-
-    if (l == 3) {
-        buffer[13] = 0;
-    }
-
-    buffer[14] = 0;
-    buffer[15] = len_m;
-
-    len = 16;
-    // len(a)
-    if (len_a > 0) {
-        buffer[16] = 0;
-        buffer[17] = len_a;
-        len += 2;
-    }
-
-    //  (((x >> 4) + 1)<<4) - x   or    16 - (x % 16) ?
-    // a + padding
-    pad_len = ((((len_a + len - 16) >> 4) + 1) << 4) - (len_a + len - 16);
-    pad_len = pad_len == 16 ? 0 : pad_len;
-    memcpy(&buffer[len], a, len_a);
-    len += len_a;
-    memset(&buffer[len], 0, pad_len);
-    len += pad_len;
-
-    // m + padding
-    pad_len = (((len_m >> 4) + 1) << 4) - len_m;
-    pad_len = pad_len == 16 ? 0 : pad_len;
-    memcpy(&buffer[len], m, len_m);
-    len += len_m;
-    memset(&buffer[len], 0, pad_len);
-    len += pad_len;
-
-    aes_cbc_enc_raw(buffer, len, key, cbc_mac_iv);
-
-    // copy MAC
-    memcpy(mac, &buffer[len - 16], len_mac);
+    // the tag is written right after the ciphertext
+    aes_ccms_transform(a, len_a, m, *len_m, nonce, l, ctx, &m[*len_m], len_mac, TRUE);
+    *len_m += len_mac;
 
     return E_SUCCESS;
+#endif
 }
 
-/**
-\brief Counter (CTR) mode encryption specific to IEEE 802.15.4E.
-\param[in,out] m Pointer to the data that is both authenticated and encrypted. Data is
-   overwritten by ciphertext (i.e. plaintext in case of inverse CCM*).
-\param[in] len_m Length of data that is both authenticated and encrypted.
-\param[in] nonce Buffer containing nonce (13 octets).
-\param[in] key Buffer containing the secret key (16 octets).
-\param[in,out] mac Buffer containing the unencrypted or encrypted CBC-MAC tag, which depends
-   on weather the function is called as part of CCM* forward or inverse transformation. It
-   is overwrriten by the encrypted, i.e unencrypted, tag on return.
-\param[in] len_mac Length of the CBC-MAC tag. Must be 4, 8 or 16 octets.
-\param[in] l CCM parameter L that allows selection of different nonce length.
-
-\returns E_SUCCESS when the encryption was successful, E_FAIL otherwise. 
-*/
-static owerror_t aes_ctr_enc(uint8_t *m,
-                             uint8_t len_m,
-                             uint8_t *nonce,
-                             uint8_t key[16],
-                             uint8_t *mac,
-                             uint8_t len_mac,
-                             uint8_t l) {
-
-    uint8_t pad_len;
-    uint8_t len;
-    uint8_t iv[16];
-    uint8_t buffer[128 + 16]; // max buffer plus mac
+owerror_t aes128_ccms_dec_ctx(uint8_t *a,
+                              uint8_t len_a,
+                              uint8_t *m,
+                              uint8_t *len_m,
+                              uint8_t *nonce,
+                              uint8_t l,
+                              aes128_ctx_t *ctx,
+                              uint8_t len_mac) {
 
-    // asserts here
-    if (!((len_mac == 0) || (len_mac == 4) || (len_mac == 8) || (len_mac == 16))) {
-        return E_FAIL;
-    }
+#if BOARD_CRYPTOENGINE_ENABLED
+    return cryptoengine_aes_ccms_dec(a, len_a, m, len_m, nonce, l, ctx->key, len_mac);
+#else
+    uint8_t mac[CBC_MAX_MAC_SIZE];
 
-    if (len_m > 127) {
+    if (is_valid_mac_length(len_mac) == FALSE || (l != 2) || (*len_m < len_mac)) {
         return E_FAIL;
     }
 
-    // iv (flag (1B) | source addr (8B) | ASN (5B) | cnt (2B)
-    iv[0] = 0x00;
-    iv[0] |= 0x07 & (l - 1); // field L
-
-    memcpy(&iv[1], nonce, 13);
-    iv[14] = 0x00;
-    iv[15] = 0x00;
-
-    // first block is mac
-    memcpy(buffer, mac, len_mac);
-    memset(&buffer[len_mac], 0, 16 - len_mac);
-    len = 16;
-
-    //  (((x >> 4) + 1)<<4) - x   or    16 - (x % 16) ?
-    // m + padding
-    pad_len = (((len_m >> 4) + 1) << 4) - len_m;
-    pad_len = pad_len == 16 ? 0 : pad_len;
-    memcpy(&buffer[len], m, len_m);
-    len += len_m;
-    memset(&buffer[len], 0, pad_len);
-    len += pad_len;
+    *len_m -= len_mac;
 
-    aes_ctr_enc_raw(buffer, len, key, iv);
+    aes_ccms_transform(a, len_a, m, *len_m, nonce, l, ctx, mac, len_mac, FALSE);
 
-    memcpy(m, &buffer[16], len_m);
-    memcpy(mac, buffer, len_mac);
+    if (memcmp(mac, &m[*len_m], len_mac) == 0) {
+        return E_SUCCESS;
+    }
 
-    return E_SUCCESS;
+    return E_FAIL;
+#endif
 }
 
+//=========================== private =========================================
+#if !BOARD_CRYPTOENGINE_ENABLED
+
 /**
-\brief Raw AES-CBC encryption.
-\param[in,out] buffer Message to be encrypted. Will be overwritten by ciphertext.
-\param[in] len Message length. Must be multiple of 16 octets.
-\param[in] key Buffer containing the secret key (16 octets).
-\param[in] iv Buffer containing the Initialization Vector (16 octets).
+\brief Single pass CCM* transformation, in place.
+
+The CBC-MAC and the CTR encryption are computed together while walking once over the frame: every message block is
+absorbed in the MAC chain and XOR-ed with its key stream block as soon as it is reached, so nothing is copied to a
+staging buffer and the lengths are only bounded by their octet fields. Each MAC block is encrypted in the same
+aes128_enc_blocks_ctx() call as a counter block, which backends encrypting two blocks per pass handle at the cost of
+one. When decrypting, a block must be decrypted before it is absorbed, so its key stream is computed one block ahead.
 
-\returns E_SUCCESS when the encryption was successful. 
+\param[in] a Pointer to the authentication only data.
+\param[in] len_a Length of authentication only data.
+\param[in,out] m Pointer to the data that is both authenticated and encrypted, overwritten by the ciphertext
+   (i.e. by the plaintext when decrypting).
+\param[in] len_m Length of data that is both authenticated and encrypted, without tag.
+\param[in] nonce Buffer containing nonce (15 - l octets).
+\param[in] l CCM parameter L, i.e. the size of the length and counter fields.
+\param[in] ctx Key context initialized with aes128_set_key().
+\param[out] mac Buffer where the (encrypted) authentication tag is written.
+\param[in] len_mac Length of the authentication tag.
+\param[in] encrypt TRUE for the forward transformation, FALSE for the inverse one.
 */
-owerror_t aes_cbc_enc_raw(uint8_t *buffer, uint8_t len, uint8_t key[16], uint8_t iv[16]) {
-    uint8_t n;
+static void aes_ccms_transform(uint8_t *a,
+                               uint8_t len_a,
+                               uint8_t *m,
+                               uint8_t len_m,
+                               uint8_t *nonce,
+                               uint8_t l,
+                               aes128_ctx_t *ctx,
+                               uint8_t *mac,
+                               uint8_t len_mac,
+                               bool encrypt) {
+
+    uint8_t blocks[32];         // MAC chain followed by a counter block, encrypted together
+    uint8_t keyStream[16];      // key stream of the next message block (inverse transformation only)
+    uint8_t tagKeyStream[16];   // key stream of counter 0, which encrypts the tag
+    uint8_t flags;
+    uint8_t pos;
+    uint8_t len;
     uint8_t k;
-    uint8_t nb;
-    uint8_t *pbuf;
-    uint8_t *pxor;
-
-    nb = len >> 4;
-    pxor = iv;
-    for (n = 0; n < nb; n++) {
-        pbuf = &buffer[16 * n];
-        // may be faster if vector are aligned to 4 bytes (use long instead char in xor)
-        for (k = 0; k < 16; k++) {
-            pbuf[k] ^= pxor[k];
+    uint16_t i;
+    uint16_t counter;
+
+    // B0: flags | nonce | len(m), paired with the first key stream block needed
+    flags = 0x07 & (l - 1);                                       // field L
+    flags |= len_mac == 0 ? 0 : (0x07 & (len_mac - 2)) << 2;      // field M
+    flags |= len_a != 0 ? 0x40 : 0;                               // field Adata
+    format_block(&blocks[0], flags, nonce, l, len_m);
+    counter = (encrypt || len_m == 0) ? 0 : 1;
+    format_block(&blocks[16], 0x07 & (l - 1), nonce, l, counter);
+    aes128_enc_blocks_ctx(blocks, 2, ctx);
+    memcpy(counter == 0 ? tagKeyStream : keyStream, &blocks[16], 16);
+
+    // authentication only data, prefixed by its length and zero padded to a block boundary
+    if (len_a > 0) {
+        // len(a) on two octets, the first one is always zero here
+        blocks[1] ^= len_a;
+        pos = 2;
+        for (i = 0; i < len_a; i++) {
+            if (pos == 16) {
+                aes128_enc_ctx(blocks, ctx);
+                pos = 0;
+            }
+            blocks[pos++] ^= a[i];
         }
-        aes128_enc(pbuf, key);
-        pxor = pbuf;
+        aes128_enc_ctx(blocks, ctx);
+    }
+
+    // message, block by block
+    for (i = 0, counter = 1; i < len_m; i += 16, counter++) {
+        len = len_m - i < 16 ? len_m - i : 16;
+        if (encrypt) {
+            for (k = 0; k < len; k++) {
+                blocks[k] ^= m[i + k];
+            }
+            format_block(&blocks[16], 0x07 & (l - 1), nonce, l, counter);
+            aes128_enc_blocks_ctx(blocks, 2, ctx);
+            for (k = 0; k < len; k++) {
+                m[i + k] ^= blocks[16 + k];
+            }
+        } else {
+            for (k = 0; k < len; k++) {
+                m[i + k] ^= keyStream[k];
+                blocks[k] ^= m[i + k];
+            }
+            // key stream of the next block, or of the tag after the last one
+            format_block(&blocks[16], 0x07 & (l - 1), nonce, l, i + 16 < len_m ? counter + 1 : 0);
+            aes128_enc_blocks_ctx(blocks, 2, ctx);
+            memcpy(i + 16 < len_m ? keyStream : tagKeyStream, &blocks[16], 16);
+        }
+    }
+
+    // the tag is the MAC encrypted with the key stream of counter 0
+    for (k = 0; k < len_mac; k++) {
+        mac[k] = blocks[k] ^ tagKeyStream[k];
     }
-    return E_SUCCESS;
 }
 
 /**
-\brief Raw AES-CTR encryption.
-\param[in,out] buffer Message to be encrypted. Will be overwritten by ciphertext.
-\param[in] len Message length. Must be multiple of 16 octets.
-\param[in] key Buffer containing the secret key (16 octets).
-\param[in] iv Buffer containing the Initialization Vector (16 octets).
-
-\returns E_SUCCESS when the encryption was successful. 
+\brief Formats B0 or a counter block: flags | nonce | value, value on l octets in big endian.
 */
-owerror_t aes_ctr_enc_raw(uint8_t *buffer, uint8_t len, uint8_t key[16], uint8_t iv[16]) {
-    uint8_t n;
+static void format_block(uint8_t block[16], uint8_t flags, uint8_t *nonce, uint8_t l, uint16_t value) {
     uint8_t k;
-    uint8_t nb;
-    uint8_t *pbuf;
-    uint8_t eiv[16];
-
-    nb = len >> 4;
-    for (n = 0; n < nb; n++) {
-        pbuf = &buffer[16 * n];
-        memcpy(eiv, iv, 16);
-        aes128_enc(eiv, key);
-        // may be faster if vector are aligned to 4 bytes (use long instead char in xor)
-        for (k = 0; k < 16; k++) {
-            pbuf[k] ^= eiv[k];
-        }
-        inc_counter(iv);
-    }
 
-    return E_SUCCESS;
+    block[0] = flags;
+    memcpy(&block[1], nonce, 15 - l);
+    for (k = 0; k < l; k++) {
+        block[15 - k] = k < 2 ? (uint8_t) (value >> (8 * k)) : 0;
+    }
 }
 
-static void inc_counter(uint8_t *counter) {
-    // from openssl
-    uint32_t n = 16;
-    uint8_t c;
-    do {
-        --n;
-        c = counter[n];
-        ++c;
-        counter[n] = c;
-        if (c) return;
-    } while (n);
+static bool is_valid_mac_length(uint8_t len_mac) {
+    return (len_mac == 0) || (len_mac == 4) || (len_mac == 8) || (len_mac == 16);
 }
 
 #endif
@@ -7,6 +7,8 @@
 #ifndef OPENWSN_CCMS_H
 #define OPENWSN_CCMS_H
 
+#include "aes128.h"
+
 //=========================== prototypes ======================================
 
 /**
@@ -34,6 +36,22 @@ owerror_t aes128_ccms_enc(uint8_t *a,
                           uint8_t key[16],
                           uint8_t len_mac);
 
+/**
+\brief CCM* forward transformation with a pre-expanded key. Same as aes128_ccms_enc(), but the AES key
+   schedule is taken from ctx instead of being expanded from the raw key on every call.
+\param[in] ctx Key context initialized with aes128_set_key().
+
+\returns E_SUCCESS when the generation was successful, E_FAIL otherwise.
+*/
+owerror_t aes128_ccms_enc_ctx(uint8_t *a,
+                              uint8_t len_a,
+                              uint8_t *m,
+                              uint8_t *len_m,
+                              uint8_t *nonce,
+                              uint8_t l,
+                              aes128_ctx_t *ctx,
+                              uint8_t len_mac);
+
 /**
 \brief CCM* inverse transformation (i.e. decryption + tag verification) implemented in software. Invokes software implementation of AES.
 \param[in] a Pointer to the authentication only data.
@@ -60,4 +78,20 @@ owerror_t aes128_ccms_dec(uint8_t *a,
                           uint8_t key[16],
                           uint8_t len_mac);
 
+/**
+\brief CCM* inverse transformation with a pre-expanded key. Same as aes128_ccms_dec(), but the AES key
+   schedule is taken from ctx instead of being expanded from the raw key on every call.
+\param[in] ctx Key context initialized with aes128_set_key().
+
+\returns E_SUCCESS when decryption and verification were successful, E_FAIL otherwise.
+*/
+owerror_t aes128_ccms_dec_ctx(uint8_t *a,
+                              uint8_t len_a,
+                              uint8_t *m,
+                              uint8_t *len_m,
+                              uint8_t *nonce,
+                              uint8_t l,
+                              aes128_ctx_t *ctx,
+                              uint8_t len_mac);
+
 #endif /* OPENWSN_CCMS_H */
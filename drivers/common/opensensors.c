@@ -12,7 +12,11 @@
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define opensensors_vars MOTE_CTX_VAR(opensensors_vars_t, opensensors_vars)
+#else
 opensensors_vars_t opensensors_vars;
+#endif
 
 //=========================== prototypes ======================================
 
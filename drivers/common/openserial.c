@@ -17,7 +17,11 @@
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define openserial_vars MOTE_CTX_VAR(openserial_vars_t, openserial_vars)
+#else
 openserial_vars_t openserial_vars;
+#endif
 
 #define STATUSPRINT_PERIOD 100 // in ms
 
@@ -37,6 +41,10 @@ void statusPrint_timerCb(opentimers_id_t id);
 
 void board_resetCb(opentimers_id_t id);
 
+#if SCHEDULER_STATS_ENABLE
+bool statusPrint_scheduler(void);
+#endif
+
 // HDLC output
 void outputHdlcOpen(void);
 
@@ -89,11 +97,19 @@ void openserial_init(void) {
     openserial_vars.reset_timerId = opentimers_create(TIMER_GENERAL_PURPOSE, TASKPRIO_OPENSERIAL);
     openserial_vars.statusPrint_timerId = opentimers_create(TIMER_GENERAL_PURPOSE, TASKPRIO_OPENSERIAL);
 
-    opentimers_scheduleIn(openserial_vars.statusPrint_timerId,
-                          STATUSPRINT_PERIOD,
-                          TIME_MS,
-                          TIMER_PERIODIC,
-                          statusPrint_timerCb);
+    opentimers_scheduleInWithSlack(openserial_vars.statusPrint_timerId,
+                                   STATUSPRINT_PERIOD,
+                                   OPENTIMERS_SLACK(STATUSPRINT_PERIOD),
+                                   TIME_MS,
+                                   TIMER_PERIODIC,
+                                   statusPrint_timerCb);
+
+#if SCHEDULER_STATS_ENABLE
+    // the scheduler sits below openserial, report its statistics on its behalf
+    openserial_vars.statusScheduler.id = STATUS_SCHEDULER;
+    openserial_vars.statusScheduler.statusPrint_cb = statusPrint_scheduler;
+    openserial_appendStatusCtx(&openserial_vars.statusScheduler);
+#endif
 
     // UART
     uart_setCallbacks(isr_txByte, isr_rxByte);
@@ -595,6 +611,37 @@ void statusPrint_timerCb(opentimers_id_t id) {
     task_statusPrint();
 }
 
+#if SCHEDULER_STATS_ENABLE
+/**
+\brief Print the scheduler statistics, one record per round of status elements.
+
+The histogram of pending tasks (debugSchedulerQueue_t) is followed by the histograms of each priority and task callback
+which ran at least once (debugSchedulerTask_t). The two records are told apart by their length.
+*/
+bool statusPrint_scheduler(void) {
+    debugSchedulerQueue_t queue;
+    debugSchedulerTask_t task;
+
+    while (openserial_vars.statusScheduler_nextIdx != 0) {
+        if (scheduler_stats_getTask(openserial_vars.statusScheduler_nextIdx - 1, &task) == FALSE) {
+            break;
+        }
+        openserial_vars.statusScheduler_nextIdx++;
+        if (task.numRuns != 0) {
+            openserial_printStatus(STATUS_SCHEDULER, (uint8_t *) &task, sizeof(debugSchedulerTask_t));
+            return TRUE;
+        }
+    }
+
+    // start over
+    openserial_vars.statusScheduler_nextIdx = 1;
+
+    scheduler_stats_getQueue(&queue);
+    openserial_printStatus(STATUS_SCHEDULER, (uint8_t *) &queue, sizeof(debugSchedulerQueue_t));
+    return TRUE;
+}
+#endif
+
 void board_resetCb(opentimers_id_t id) {
     (void) id;
     board_reset();
@@ -128,6 +128,10 @@ typedef struct {
     uint8_t reset_timerId;
     uint8_t statusPrint_timerId;
     statusCtx_t *statusCtx;
+#if SCHEDULER_STATS_ENABLE
+    statusCtx_t statusScheduler;
+    uint8_t statusScheduler_nextIdx;
+#endif
     // callbacks
     getAddr_cb_t addrCb;
     getAsn_cb_t asnCb;
@@ -4,6 +4,17 @@
 This driver uses a single hardware timer, which it virtualizes to support
 at most MAX_NUM_TIMERS timers.
 
+The running general purpose timers are kept in a binary min-heap, ordered on
+their compare value relative to the last compare value, so finding the next
+timer to fire, arming a timer and cancelling it take O(log n). The TSCH and
+inhibit timers stay out of the heap and are checked first in the interrupt.
+
+General purpose timers may be given a slack, the time by which they may fire
+late. Their compare value is rounded up within the slack to a multiple of a
+power of two, so that timers with overlapping windows share a compare value,
+and a timer whose window is open is served by any interrupt which happens
+during it. Both save a wakeup of the MCU.
+
 \author Tengfei Chang <tengfei.chang@inria.fr>, April 2017.
  */
 
@@ -17,14 +28,38 @@ at most MAX_NUM_TIMERS timers.
 
 //=========================== define ==========================================
 
+#define OPENTIMERS_NOT_IN_HEAP     0xff
+
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define opentimers_vars MOTE_CTX_VAR(opentimers_vars_t, opentimers_vars)
+#else
 opentimers_vars_t opentimers_vars;
+#endif
 
 //=========================== prototypes ======================================
 
 void  opentimers_timer_callback(void);
 
+static bool opentimers_isEarlier(opentimers_id_t a, opentimers_id_t b);
+
+static void opentimers_heapPlace(uint8_t pos, opentimers_id_t id);
+
+static void opentimers_heapSiftUp(uint8_t pos);
+
+static void opentimers_heapSiftDown(uint8_t pos);
+
+static void opentimers_heapInsert(opentimers_id_t id);
+
+static void opentimers_heapRemove(opentimers_id_t id);
+
+static void opentimers_armNext(void);
+
+static void opentimers_expire(opentimers_id_t id);
+
+static PORT_TIMER_WIDTH opentimers_roundUp(PORT_TIMER_WIDTH compareValue, uint32_t slack);
+
 //=========================== public ==========================================
 
 /**
@@ -33,9 +68,13 @@ void  opentimers_timer_callback(void);
 Initializes data structures and hardware timer.
  */
 void opentimers_init(void){
+    uint8_t i;
 
     // initialize local variables
     memset(&opentimers_vars,0,sizeof(opentimers_vars_t));
+    for (i=0;i<MAX_NUM_TIMERS;i++){
+        opentimers_vars.heapPos[i] = OPENTIMERS_NOT_IN_HEAP;
+    }
 
     // set callback for sctimer module
     sctimer_set_callback(opentimers_timer_callback);
@@ -99,19 +138,32 @@ void opentimers_scheduleIn(opentimers_id_t    id,
                            time_type_t        uint_type,
                            timer_type_t       timer_type,
                            opentimers_cbt     cb){
-    uint8_t  i;
-    uint8_t  idToSchedule;
-    PORT_TIMER_WIDTH timerGap;
-    PORT_TIMER_WIDTH tempTimerGap;
+    opentimers_scheduleInWithSlack(id, duration, 0, uint_type, timer_type, cb);
+}
+
+/**
+\brief schedule a period refer to comparing value set last time, allowing the timer to fire late.
+
+Same as opentimers_scheduleIn(), but the timer may expire up to slack after current counter + duration, so that it
+can share a wakeup with other timers. The slack is kept for the next periods of a periodic timer. It is ignored for
+the TSCH and inhibit timers.
 
+\param[in] id indicates the timer id
+\param[in] duration indicates the period asked for schedule since last comparing value
+\param[in] slack indicates how late the timer may fire, in the same unit as duration
+\param[in] uint_type indicates the unit type of this schedule: ticks or ms
+\param[in] timer_type indicates the timer type of this schedule: oneshot or periodic
+\param[in] cb indicates when this scheduled timer fired, call this callback function.
+ */
+void opentimers_scheduleInWithSlack(opentimers_id_t    id,
+                                    uint32_t           duration,
+                                    uint32_t           slack,
+                                    time_type_t        uint_type,
+                                    timer_type_t       timer_type,
+                                    opentimers_cbt     cb){
     INTERRUPT_DECLARATION();
     // 1. make sure the timer exist
-    for (i=0;i<MAX_NUM_TIMERS;i++){
-        if (opentimers_vars.timersBuf[i].isUsed && i == id){
-            break;
-        }
-    }
-    if (i==MAX_NUM_TIMERS){
+    if (id>=MAX_NUM_TIMERS || opentimers_vars.timersBuf[id].isUsed==FALSE){
         // doesn't find the timer
         return;
     }
@@ -125,46 +177,44 @@ void opentimers_scheduleIn(opentimers_id_t    id,
     case TIME_MS:
         opentimers_vars.timersBuf[id].duration = duration*PORT_TICS_PER_MS;
         opentimers_vars.timersBuf[id].wraps_remaining  = (uint32_t)(duration*PORT_TICS_PER_MS)/MAX_TICKS_IN_SINGLE_CLOCK;
+        opentimers_vars.timersBuf[id].slack = slack*PORT_TICS_PER_MS;
         break;
     case TIME_TICS:
         opentimers_vars.timersBuf[id].duration = duration;
         opentimers_vars.timersBuf[id].wraps_remaining  = (uint32_t)(duration)/MAX_TICKS_IN_SINGLE_CLOCK;
+        opentimers_vars.timersBuf[id].slack = slack;
         break;
     }
 
+    if (id<TIMER_NUMBER_NON_GENERAL){
+        opentimers_vars.timersBuf[id].slack = 0;
+    }
+
     if (opentimers_vars.timersBuf[id].wraps_remaining==0){
-        opentimers_vars.timersBuf[id].currentCompareValue = opentimers_vars.timersBuf[id].duration+sctimer_readCounter();
+        opentimers_vars.timersBuf[id].firstCompareValue   = opentimers_vars.timersBuf[id].duration+sctimer_readCounter();
+        opentimers_vars.timersBuf[id].currentCompareValue = opentimers_roundUp(
+            opentimers_vars.timersBuf[id].firstCompareValue,
+            opentimers_vars.timersBuf[id].slack
+        );
     } else {
         opentimers_vars.timersBuf[id].currentCompareValue = MAX_TICKS_IN_SINGLE_CLOCK+sctimer_readCounter();
+        opentimers_vars.timersBuf[id].firstCompareValue   = opentimers_vars.timersBuf[id].currentCompareValue;
     }
 
     opentimers_vars.timersBuf[id].isrunning           = TRUE;
     opentimers_vars.timersBuf[id].callback            = cb;
 
+    if (id>=TIMER_NUMBER_NON_GENERAL){
+        // (re)position the timer in the heap
+        opentimers_heapRemove(id);
+        opentimers_heapInsert(id);
+    }
+
     // 3. find the next timer to fire
 
     // only execute update the currentCompareValue if I am not inside of ISR or the ISR itself will do this.
     if (opentimers_vars.insideISR==FALSE){
-        i = 0;
-        while (opentimers_vars.timersBuf[i].isrunning==FALSE){
-            i++;
-        }
-        timerGap     = opentimers_vars.timersBuf[i].currentCompareValue-opentimers_vars.lastCompareValue;
-        idToSchedule = i;
-        for (i=idToSchedule+1;i<MAX_NUM_TIMERS;i++){
-            if (opentimers_vars.timersBuf[i].isrunning){
-                tempTimerGap = opentimers_vars.timersBuf[i].currentCompareValue-opentimers_vars.lastCompareValue;
-                if (tempTimerGap < timerGap){
-                    // timer "i" is more close to lastCompare value
-                    timerGap     = tempTimerGap;
-                    idToSchedule = i;
-                }
-            }
-        }
-
-        // if I got here, assign the next to be fired timer to given timer
-        opentimers_vars.currentCompareValue = opentimers_vars.timersBuf[idToSchedule].currentCompareValue;
-        sctimer_setCompare(opentimers_vars.currentCompareValue);
+        opentimers_armNext();
     }
     opentimers_vars.running        = TRUE;
 
@@ -189,20 +239,10 @@ void opentimers_scheduleAbsolute(opentimers_id_t    id,
                                  PORT_TIMER_WIDTH   reference ,
                                  time_type_t        uint_type,
                                  opentimers_cbt     cb){
-    uint8_t  i;
-    uint8_t idToSchedule;
-    PORT_TIMER_WIDTH timerGap;
-    PORT_TIMER_WIDTH tempTimerGap;
-
     INTERRUPT_DECLARATION();
 
     // 1. make sure the timer exist
-    for (i=0;i<MAX_NUM_TIMERS;i++){
-        if (opentimers_vars.timersBuf[i].isUsed && i == id){
-            break;
-        }
-    }
-    if (i==MAX_NUM_TIMERS){
+    if (id>=MAX_NUM_TIMERS || opentimers_vars.timersBuf[id].isUsed==FALSE){
         // doesn't find the timer
         return;
     }
@@ -229,34 +269,23 @@ void opentimers_scheduleAbsolute(opentimers_id_t    id,
     } else {
         opentimers_vars.timersBuf[id].currentCompareValue = MAX_TICKS_IN_SINGLE_CLOCK+reference;
     }
+    opentimers_vars.timersBuf[id].firstCompareValue = opentimers_vars.timersBuf[id].currentCompareValue;
+    opentimers_vars.timersBuf[id].slack             = 0;
 
     opentimers_vars.timersBuf[id].isrunning = TRUE;
     opentimers_vars.timersBuf[id].callback  = cb;
 
+    if (id>=TIMER_NUMBER_NON_GENERAL){
+        // (re)position the timer in the heap
+        opentimers_heapRemove(id);
+        opentimers_heapInsert(id);
+    }
+
     // 3. find the next timer to fire
 
     // only execute update the currentCompareValue if I am not inside of ISR or the ISR itself will do this.
     if (opentimers_vars.insideISR==FALSE){
-        i = 0;
-        while (opentimers_vars.timersBuf[i].isrunning==FALSE){
-            i++;
-        }
-        timerGap     = opentimers_vars.timersBuf[i].currentCompareValue-opentimers_vars.lastCompareValue;
-        idToSchedule = i;
-        for (i=idToSchedule+1;i<MAX_NUM_TIMERS;i++){
-            if (opentimers_vars.timersBuf[i].isrunning){
-                tempTimerGap = opentimers_vars.timersBuf[i].currentCompareValue-opentimers_vars.lastCompareValue;
-                if (tempTimerGap < timerGap){
-                    // timer "i" is more close to lastCompare value
-                    timerGap     = tempTimerGap;
-                    idToSchedule = i;
-                }
-            }
-        }
-
-        // if I got here, assign the next to be fired timer to given timer
-        opentimers_vars.currentCompareValue = opentimers_vars.timersBuf[idToSchedule].currentCompareValue;
-        sctimer_setCompare(opentimers_vars.currentCompareValue);
+        opentimers_armNext();
     }
     opentimers_vars.running = TRUE;
 
@@ -295,6 +324,7 @@ void opentimers_cancel(opentimers_id_t id){
 
     opentimers_vars.timersBuf[id].isrunning = FALSE;
     opentimers_vars.timersBuf[id].callback  = NULL;
+    opentimers_heapRemove(id);
 
     ENABLE_INTERRUPTS();
 }
@@ -309,8 +339,13 @@ Reset the whole entry of given timer including the id.
 \returns False if the given can't be found or return Success
  */
 bool opentimers_destroy(opentimers_id_t id){
+    INTERRUPT_DECLARATION();
+
     if (id<MAX_NUM_TIMERS){
+        DISABLE_INTERRUPTS();
+        opentimers_heapRemove(id);
         memset(&opentimers_vars.timersBuf[id],0,sizeof(opentimers_t));
+        ENABLE_INTERRUPTS();
         return TRUE;
     } else {
         return FALSE;
@@ -335,6 +370,21 @@ PORT_TIMER_WIDTH opentimers_getCurrentCompareValue(void){
     return opentimers_vars.currentCompareValue;
 }
 
+/**
+\brief get the number of timer interrupts, and of timers which were served by the interrupt of another timer.
+
+The second counter is the number of wakeups saved by coalescing timers.
+ */
+void opentimers_getWakeupStats(uint32_t *numWakeups, uint32_t *numCoalesced){
+    INTERRUPT_DECLARATION();
+    DISABLE_INTERRUPTS();
+
+    *numWakeups   = opentimers_vars.numWakeups;
+    *numCoalesced = opentimers_vars.numCoalesced;
+
+    ENABLE_INTERRUPTS();
+}
+
 /**
 \brief is the given timer running?
 
@@ -350,15 +400,17 @@ bool opentimers_isRunning(opentimers_id_t id){
 /**
 \brief this is the callback function of opentimer.
 
-This function is called when sctimer interrupt happens. The function looks the
-whole timer buffer and find out the correct timer responding to the interrupt
-and call the callback recorded for that timer.
+This function is called when sctimer interrupt happens. The TSCH timer is
+handled first, in the interrupt. The general purpose timers responding to the
+interrupt are taken from the top of the heap and push their callback as a task.
  */
 void opentimers_timer_callback(void){
+    opentimers_id_t expired[MAX_NUM_TIMERS];
+    opentimers_t *top;
+    uint8_t numExpired;
+    uint8_t numServed;
     uint8_t i;
-    uint8_t idToSchedule;
-    PORT_TIMER_WIDTH timerGap;
-    PORT_TIMER_WIDTH tempTimerGap;
+    PORT_TIMER_WIDTH window;
 
     if (
         opentimers_vars.timersBuf[TIMER_INHIBIT].isrunning==TRUE &&
@@ -369,95 +421,252 @@ void opentimers_timer_callback(void){
         // the next timer selection will be done after SPLITE_TIMER_DURATION ticks
         sctimer_setCompare(sctimer_readCounter()+SPLITE_TIMER_DURATION);
         return;
+    }
+
+    opentimers_vars.numWakeups++;
+    numServed = 0;
+
+    // the TSCH timer is served right away
+    if (
+        opentimers_vars.timersBuf[TIMER_TSCH].isrunning==TRUE &&
+        opentimers_vars.currentCompareValue == opentimers_vars.timersBuf[TIMER_TSCH].currentCompareValue
+    ){
+        opentimers_vars.timersBuf[TIMER_TSCH].lastCompareValue = opentimers_vars.timersBuf[TIMER_TSCH].currentCompareValue;
+        opentimers_vars.insideISR = TRUE;
+        opentimers_vars.timersBuf[TIMER_TSCH].isrunning  = FALSE;
+        opentimers_vars.timersBuf[TIMER_TSCH].callback(TIMER_TSCH);
+        opentimers_vars.insideISR = FALSE;
+        numServed++;
+    }
+
+    if (opentimers_vars.timersBuf[TIMER_INHIBIT].currentCompareValue == opentimers_vars.currentCompareValue){
+        // this is the timer interrupt right after inhibit timer, pre call the non-tsch, non-inhibit timer interrupt here to avoid interrupt during receiving serial bytes
+        window = PRE_CALL_TIMER_WINDOW;
     } else {
-        if (opentimers_vars.timersBuf[TIMER_INHIBIT].currentCompareValue == opentimers_vars.currentCompareValue){
-            // this is the timer interrupt right after inhibit timer, pre call the non-tsch, non-inhibit timer interrupt here to avoid interrupt during receiving serial bytes
-            for (i=0;i<MAX_NUM_TIMERS;i++){
-                if (opentimers_vars.timersBuf[i].isrunning==TRUE){
-                    if (i!=TIMER_TSCH && i!=TIMER_INHIBIT && opentimers_vars.timersBuf[i].currentCompareValue - opentimers_vars.currentCompareValue < PRE_CALL_TIMER_WINDOW){
-                        opentimers_vars.timersBuf[i].currentCompareValue = opentimers_vars.currentCompareValue;
-                    }
-                }
-            }
-        }
-        for (i=0;i<MAX_NUM_TIMERS;i++){
-            if (opentimers_vars.timersBuf[i].isrunning==TRUE){
-                if (opentimers_vars.currentCompareValue == opentimers_vars.timersBuf[i].currentCompareValue){
-                    // this timer expired, mark as expired
-                    opentimers_vars.timersBuf[i].lastCompareValue    = opentimers_vars.timersBuf[i].currentCompareValue;
-                    if (i==TIMER_TSCH){
-                        opentimers_vars.insideISR = TRUE;
-                        opentimers_vars.timersBuf[i].isrunning  = FALSE;
-                        opentimers_vars.timersBuf[i].callback(i);
-                        opentimers_vars.insideISR = FALSE;
-                    } else {
-                        if (opentimers_vars.timersBuf[i].wraps_remaining==0){
-                            opentimers_vars.timersBuf[i].isrunning = FALSE;
-                            scheduler_push_task((task_cbt)(opentimers_vars.timersBuf[i].callback),(task_prio_t)opentimers_vars.timersBuf[i].timer_task_prio);
-                            if (opentimers_vars.timersBuf[i].timerType==TIMER_PERIODIC){
-                                opentimers_vars.insideISR = TRUE;
-                                opentimers_scheduleIn(
-                                    i,
-                                    opentimers_vars.timersBuf[i].duration,
-                                    TIME_TICS,
-                                    TIMER_PERIODIC,
-                                    opentimers_vars.timersBuf[i].callback
-                                );
-                                opentimers_vars.insideISR = FALSE;
-                            }
-                        } else {
-                            opentimers_vars.timersBuf[i].wraps_remaining--;
-                            if (opentimers_vars.timersBuf[i].wraps_remaining == 0){
-                                opentimers_vars.timersBuf[i].currentCompareValue = (opentimers_vars.timersBuf[i].duration+opentimers_vars.timersBuf[i].lastCompareValue) & MAX_TICKS_IN_SINGLE_CLOCK;
-                                if (opentimers_vars.timersBuf[i].currentCompareValue - opentimers_vars.currentCompareValue < PRE_CALL_TIMER_WINDOW){
-                                    // pre-call the timer here if it will be fired within PRE_CALL_TIMER_WINDOW, when wraps_remaining decrease to 0
-                                    opentimers_vars.timersBuf[i].isrunning  = FALSE;
-                                    scheduler_push_task((task_cbt)(opentimers_vars.timersBuf[i].callback),(task_prio_t)opentimers_vars.timersBuf[i].timer_task_prio);
-                                    if (opentimers_vars.timersBuf[i].timerType==TIMER_PERIODIC){
-                                        opentimers_vars.insideISR = TRUE;
-                                        opentimers_scheduleIn(
-                                            i,
-                                            opentimers_vars.timersBuf[i].duration,
-                                            TIME_TICS,
-                                            TIMER_PERIODIC,
-                                            opentimers_vars.timersBuf[i].callback
-                                        );
-                                        opentimers_vars.insideISR = FALSE;
-                                    }
-                                }
-                            } else {
-                                opentimers_vars.timersBuf[i].currentCompareValue = opentimers_vars.timersBuf[i].lastCompareValue + MAX_TICKS_IN_SINGLE_CLOCK;
-                            }
-                        }
-                    }
-                }
-            }
+        window = 1;
+    }
+
+    // collect the expired timers first, so that periodic timers re-armed below are not served twice
+    numExpired = 0;
+    while (opentimers_vars.heapSize>0){
+        top = &opentimers_vars.timersBuf[opentimers_vars.heap[0]];
+        if (
+            (PORT_TIMER_WIDTH)(top->currentCompareValue - opentimers_vars.currentCompareValue) >= window &&
+            (PORT_TIMER_WIDTH)(opentimers_vars.currentCompareValue - top->firstCompareValue) > top->slack
+        ){
+            // neither expired nor within its slack
+            break;
         }
+        expired[numExpired] = opentimers_vars.heap[0];
+        opentimers_heapRemove(expired[numExpired]);
+        opentimers_vars.timersBuf[expired[numExpired]].currentCompareValue = opentimers_vars.currentCompareValue;
+        numExpired++;
     }
+    for (i=0;i<numExpired;i++){
+        opentimers_expire(expired[i]);
+    }
+
+    numServed += numExpired;
+    if (numServed>1){
+        opentimers_vars.numCoalesced += numServed-1;
+    }
+
     opentimers_vars.lastCompareValue = opentimers_vars.currentCompareValue;
 
     // find the next timer to be fired
-    i = 0;
-    while (opentimers_vars.timersBuf[i].isrunning==FALSE && i<MAX_NUM_TIMERS){
-        i++;
-    }
-    if(i<MAX_NUM_TIMERS){
-        timerGap     = opentimers_vars.timersBuf[i].currentCompareValue-opentimers_vars.lastCompareValue;
-        idToSchedule = i;
-        for (i=idToSchedule+1;i<MAX_NUM_TIMERS;i++){
-            if (opentimers_vars.timersBuf[i].isrunning){
-                tempTimerGap = opentimers_vars.timersBuf[i].currentCompareValue-opentimers_vars.lastCompareValue;
-                if (tempTimerGap < timerGap){
-                    timerGap     = tempTimerGap;
-                    idToSchedule = i;
-                }
+    opentimers_armNext();
+}
+
+//=========================== private =========================================
+
+/**
+\brief Serve a general purpose timer which has been taken out of the heap.
+ */
+static void opentimers_expire(opentimers_id_t id){
+    opentimers_t *timer;
+
+    timer = &opentimers_vars.timersBuf[id];
+    timer->lastCompareValue = timer->currentCompareValue;
+
+    if (timer->wraps_remaining!=0){
+        timer->wraps_remaining--;
+        if (timer->wraps_remaining == 0){
+            timer->currentCompareValue = (timer->duration+timer->lastCompareValue) & MAX_TICKS_IN_SINGLE_CLOCK;
+            timer->firstCompareValue   = timer->currentCompareValue;
+            if (timer->currentCompareValue - opentimers_vars.currentCompareValue >= PRE_CALL_TIMER_WINDOW){
+                opentimers_heapInsert(id);
+                return;
             }
+            // pre-call the timer here if it will be fired within PRE_CALL_TIMER_WINDOW, when wraps_remaining decrease to 0
+        } else {
+            timer->currentCompareValue = timer->lastCompareValue + MAX_TICKS_IN_SINGLE_CLOCK;
+            timer->firstCompareValue   = timer->currentCompareValue;
+            opentimers_heapInsert(id);
+            return;
         }
+    }
+
+    timer->isrunning = FALSE;
+    scheduler_push_task((task_cbt)(timer->callback),(task_prio_t)timer->timer_task_prio);
+    if (timer->timerType==TIMER_PERIODIC){
+        opentimers_vars.insideISR = TRUE;
+        opentimers_scheduleInWithSlack(
+            id,
+            timer->duration,
+            timer->slack,
+            TIME_TICS,
+            TIMER_PERIODIC,
+            timer->callback
+        );
+        opentimers_vars.insideISR = FALSE;
+    }
+}
+
+/**
+\brief Round a compare value up to the coarsest power of two which stays within the slack.
+
+Timers with overlapping windows end up on the same compare value, hence in the same interrupt.
+ */
+static PORT_TIMER_WIDTH opentimers_roundUp(PORT_TIMER_WIDTH compareValue, uint32_t slack){
+    PORT_TIMER_WIDTH granularity;
+
+    if (slack==0){
+        return compareValue;
+    }
 
-        // reschedule the timer
-        opentimers_vars.currentCompareValue = opentimers_vars.timersBuf[idToSchedule].currentCompareValue;
-        sctimer_setCompare(opentimers_vars.currentCompareValue);
+    granularity = 1;
+    while ((uint32_t)granularity*2 <= slack && granularity < (MAX_TICKS_IN_SINGLE_CLOCK>>1)){
+        granularity <<= 1;
+    }
+
+    return (compareValue+granularity-1) & ~(PORT_TIMER_WIDTH)(granularity-1);
+}
+
+/**
+\brief Program the hardware timer with the first compare value among the running timers.
+
+The candidates are the inhibit timer, the TSCH timer and the top of the heap.
+ */
+static void opentimers_armNext(void){
+    opentimers_id_t candidates[3];
+    opentimers_id_t idToSchedule;
+    uint8_t numCandidates;
+    uint8_t i;
+
+    numCandidates = 0;
+    if (opentimers_vars.timersBuf[TIMER_INHIBIT].isrunning){
+        candidates[numCandidates++] = TIMER_INHIBIT;
+    }
+    if (opentimers_vars.timersBuf[TIMER_TSCH].isrunning){
+        candidates[numCandidates++] = TIMER_TSCH;
+    }
+    if (opentimers_vars.heapSize>0){
+        candidates[numCandidates++] = opentimers_vars.heap[0];
+    }
+
+    if (numCandidates==0){
+        opentimers_vars.running = FALSE;
+        return;
+    }
+
+    idToSchedule = candidates[0];
+    for (i=1;i<numCandidates;i++){
+        if (opentimers_isEarlier(candidates[i], idToSchedule)){
+            idToSchedule = candidates[i];
+        }
+    }
+
+    opentimers_vars.currentCompareValue = opentimers_vars.timersBuf[idToSchedule].currentCompareValue;
+    sctimer_setCompare(opentimers_vars.currentCompareValue);
+}
+
+/**
+\brief Does timer a fire before timer b?
+
+Compare values are compared on their distance from the last compare value, so that counter wraps are handled.
+ */
+static bool opentimers_isEarlier(opentimers_id_t a, opentimers_id_t b){
+    PORT_TIMER_WIDTH gapA;
+    PORT_TIMER_WIDTH gapB;
+
+    gapA = opentimers_vars.timersBuf[a].currentCompareValue-opentimers_vars.lastCompareValue;
+    gapB = opentimers_vars.timersBuf[b].currentCompareValue-opentimers_vars.lastCompareValue;
+
+    return gapA < gapB;
+}
+
+static void opentimers_heapPlace(uint8_t pos, opentimers_id_t id){
+    opentimers_vars.heap[pos] = id;
+    opentimers_vars.heapPos[id] = pos;
+}
+
+static void opentimers_heapSiftUp(uint8_t pos){
+    opentimers_id_t id;
+    uint8_t parent;
+
+    id = opentimers_vars.heap[pos];
+    while (pos>0){
+        parent = (pos-1)/2;
+        if (opentimers_isEarlier(id, opentimers_vars.heap[parent])==FALSE){
+            break;
+        }
+        opentimers_heapPlace(pos, opentimers_vars.heap[parent]);
+        pos = parent;
+    }
+    opentimers_heapPlace(pos, id);
+}
+
+static void opentimers_heapSiftDown(uint8_t pos){
+    opentimers_id_t id;
+    uint8_t child;
+
+    id = opentimers_vars.heap[pos];
+    while ((child = 2*pos+1) < opentimers_vars.heapSize){
+        if (
+            child+1 < opentimers_vars.heapSize &&
+            opentimers_isEarlier(opentimers_vars.heap[child+1], opentimers_vars.heap[child])
+        ){
+            child++;
+        }
+        if (opentimers_isEarlier(opentimers_vars.heap[child], id)==FALSE){
+            break;
+        }
+        opentimers_heapPlace(pos, opentimers_vars.heap[child]);
+        pos = child;
+    }
+    opentimers_heapPlace(pos, id);
+}
+
+static void opentimers_heapInsert(opentimers_id_t id){
+    opentimers_heapPlace(opentimers_vars.heapSize, id);
+    opentimers_vars.heapSize++;
+    opentimers_heapSiftUp(opentimers_vars.heapSize-1);
+}
+
+/**
+\brief Take a timer out of the heap, if it is in.
+ */
+static void opentimers_heapRemove(opentimers_id_t id){
+    uint8_t pos;
+    opentimers_id_t last;
+
+    pos = opentimers_vars.heapPos[id];
+    if (pos==OPENTIMERS_NOT_IN_HEAP){
+        return;
+    }
+    opentimers_vars.heapPos[id] = OPENTIMERS_NOT_IN_HEAP;
+
+    opentimers_vars.heapSize--;
+    if (pos==opentimers_vars.heapSize){
+        return;
+    }
+
+    // move the last entry into the hole, then restore the heap in whichever direction it is violated
+    last = opentimers_vars.heap[opentimers_vars.heapSize];
+    opentimers_heapPlace(pos, last);
+    if (pos>0 && opentimers_isEarlier(last, opentimers_vars.heap[(pos-1)/2])){
+        opentimers_heapSiftUp(pos);
     } else {
-        opentimers_vars.running        = FALSE;
+        opentimers_heapSiftDown(pos);
     }
-}
\ No newline at end of file
+}
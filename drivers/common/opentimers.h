@@ -18,8 +18,6 @@
 
 //=========================== define ==========================================
 
-/// Maximum number of timers that can run concurrently
-#define MAX_NUM_TIMERS             15
 #define MAX_TICKS_IN_SINGLE_CLOCK  (uint32_t)(((PORT_TIMER_WIDTH)0xFFFFFFFF)>>1)
 #define ERROR_NO_AVAILABLE_ENTRIES 255
 #define MAX_DURATION_ISR           33 // 33@32768Hz = 1ms
@@ -34,6 +32,9 @@
 #define SPLITE_TIMER_DURATION     15 // in ticks
 #define PRE_CALL_TIMER_WINDOW     PORT_TsSlotDuration
 
+/// slack given to periodic housekeeping timers, an eighth of their period
+#define OPENTIMERS_SLACK(period)  ((period)>>3)
+
 typedef void (*opentimers_cbt)(opentimers_id_t id);
 
 //=========================== typedef =========================================
@@ -59,16 +60,23 @@ typedef struct {
    bool                 hasExpired;         // in case there are more than one interrupt occur at same time
    opentimers_cbt       callback;           // function to call when elapses
    uint8_t              timer_task_prio;    // when opentimer push a task, use timer_task_prio to mark the priority
+   uint32_t             slack;              // how late the timer may fire, in ticks
+   PORT_TIMER_WIDTH     firstCompareValue;  // the compare value before rounding it up within the slack
 } opentimers_t;
 
 //=========================== module variables ================================
 
 typedef struct {
    opentimers_t         timersBuf[MAX_NUM_TIMERS];
+   opentimers_id_t      heap[MAX_NUM_TIMERS];    // running general purpose timers, the next to fire on top
+   uint8_t              heapPos[MAX_NUM_TIMERS]; // position of each timer in the heap
+   uint8_t              heapSize;
    bool                 running;
    PORT_TIMER_WIDTH     currentCompareValue;// current timeout, in ticks
    PORT_TIMER_WIDTH     lastCompareValue;   // last timeout, in ticks. This is the reference time to calculate the next to be expired timer.
    bool                 insideISR;          // whether the function of opentimer is called inside of ISR or not
+   uint32_t             numWakeups;         // number of timer interrupts
+   uint32_t             numCoalesced;       // number of timers served by the interrupt of another timer
 } opentimers_vars_t;
 
 //=========================== prototypes ======================================
@@ -80,6 +88,12 @@ void             opentimers_scheduleIn(opentimers_id_t      id,
                                        time_type_t         uint_type,
                                        timer_type_t        timer_type,
                                        opentimers_cbt      cb);
+void             opentimers_scheduleInWithSlack(opentimers_id_t      id,
+                                                uint32_t            duration,
+                                                uint32_t            slack,
+                                                time_type_t         uint_type,
+                                                timer_type_t        timer_type,
+                                                opentimers_cbt      cb);
 void             opentimers_scheduleAbsolute(opentimers_id_t      id,
                                               uint32_t            duration,
                                               PORT_TIMER_WIDTH    reference ,
@@ -92,6 +106,7 @@ bool             opentimers_destroy(opentimers_id_t id);
 
 PORT_TIMER_WIDTH opentimers_getValue(void);
 PORT_TIMER_WIDTH opentimers_getCurrentCompareValue(void);
+void             opentimers_getWakeupStats(uint32_t *numWakeups, uint32_t *numCoalesced);
 bool             opentimers_isRunning(opentimers_id_t id);
 /**
 \}
@@ -37,6 +37,14 @@
 
 #endif
 
+#if BOARD_MULTI_MOTE_ENABLED && !defined(PYTHON_BOARD)
+#error 'Multi-mote builds are only supported in simulation mode.'
+#endif
+
+#if BOARD_NATIVE_SIM_ENABLED && !BOARD_MULTI_MOTE_ENABLED
+#error 'The native simulation engine requires a multi-mote build.'
+#endif
+
 #if !BOARD_FASTSIM_ENABLED && defined(PYTHON_BOARD)
 #warning 'FASTSIM not enabled for UART communication in simulation mode.'
 
@@ -81,6 +89,63 @@
 #error "6LoWPAN fragmentation options specified, but 6LoWPAN fragmentation is not included in the build."
 #endif
 
+#if OPENQUEUE_WEIGHT_LOCAL < 1 || OPENQUEUE_WEIGHT_LOCAL > 255 || \
+    OPENQUEUE_WEIGHT_FORWARDED < 1 || OPENQUEUE_WEIGHT_FORWARDED > 255
+#error "The openqueue weights must be in the range [1 - 255]."
+#endif
+
+#if MAXNUMNEIGHBORS < 1 || MAXNUMNEIGHBORS > 127
+#error "MAXNUMNEIGHBORS must be in the range [1 - 127]."
+#endif
+
+#if RPL_STORING_MODE && (RPL_MAX_ROUTES < 1 || RPL_MAX_ROUTES > 127)
+#error "RPL_MAX_ROUTES must be in the range [1 - 127]."
+#endif
+
+#if RPL_DIO_INTERVAL_MIN < 8 || RPL_DIO_INTERVAL_MIN > 20
+#error "RPL_DIO_INTERVAL_MIN must be in the range [8 - 20]."
+#endif
+
+#if RPL_DIO_INTERVAL_DOUBLINGS < 0 || RPL_DIO_INTERVAL_MIN + RPL_DIO_INTERVAL_DOUBLINGS > 24
+#error "RPL_DIO_INTERVAL_DOUBLINGS must be positive, with an Imax of at most 2^24 ms."
+#endif
+
+#if RPL_DIO_REDUNDANCY < 0 || RPL_DIO_REDUNDANCY > 255
+#error "RPL_DIO_REDUNDANCY must be in the range [0 - 255]."
+#endif
+
+#if LINKEST_ALPHA < 1 || LINKEST_ALPHA > 16
+#error "LINKEST_ALPHA must be in the range [1 - 16]."
+#endif
+
+#if LINKEST_MIN_SAMPLES < 1 || LINKEST_MIN_SAMPLES > 255
+#error "LINKEST_MIN_SAMPLES must be in the range [1 - 255]."
+#endif
+
+#if MAX_NUM_TIMERS < 3 || MAX_NUM_TIMERS > 64
+#error "MAX_NUM_TIMERS must be in the range [3 - 64]."
+#endif
+
+#if OPENQUEUE_NUM_FULL_BUFFERS < 3 || OPENQUEUE_NUM_SMALL_BUFFERS < 1 || OPENQUEUE_NUM_CELLLISTS < 1
+#error "openqueue needs at least 3 full size buffers, 1 small buffer and 1 cell list."
+#endif
+
+#if OPENQUEUE_SMALL_BUFFER_SIZE < 40 || OPENQUEUE_SMALL_BUFFER_SIZE > 130
+#error "OPENQUEUE_SMALL_BUFFER_SIZE must be in the range [40 - 130]."
+#endif
+
+#if SCHEDULE_MAX_SLOTFRAMES < 1 || SCHEDULE_MAX_SLOTFRAMES > 8
+#error "SCHEDULE_MAX_SLOTFRAMES must be in the range [1 - 8]."
+#endif
+
+#if MSF_SLOTFRAME_LENGTH != 0 && SCHEDULE_MAX_SLOTFRAMES < 2
+#error "MSF_SLOTFRAME_LENGTH requires SCHEDULE_MAX_SLOTFRAMES >= 2."
+#endif
+
+#if AES128_BACKEND < 0 || AES128_BACKEND > 2
+#error "AES128_BACKEND must be in the range [0 - 2]."
+#endif
+
 #if OPENWSN_CJOIN_C && !OPENWSN_COAP_C
 #error "CJOIN requires the CoAP protocol."
 #endif
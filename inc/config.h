@@ -316,6 +316,50 @@
 #define DEADLINE_OPTION (0)
 #endif
 
+/**
+ * \def RPL_STORING_MODE
+ *
+ * Run RPL in storing mode (MOP 2). Every mote learns routes to the motes below it from the DAOs it relays towards the
+ * root, and forwards packets down the DODAG by looking up these routes instead of following a source routing header.
+ *
+ * Configuration options:
+ *  - RPL_MAX_ROUTES: number of downward routes a mote can store, the least recently used one is evicted when full.
+ */
+#ifndef RPL_STORING_MODE
+#define RPL_STORING_MODE (0)
+#endif
+
+#if RPL_STORING_MODE
+#ifndef RPL_MAX_ROUTES
+#define RPL_MAX_ROUTES                  16
+#endif
+#endif
+
+/**
+ * \def RPL_DIO_INTERVAL_MIN
+ *
+ * DIOs are sent on a Trickle timer (RFC 6206), which starts at Imin and doubles its interval up to Imax as long as the
+ * DODAG is consistent. A change of parent, of rank or of DODAG version, or a DIS, resets it to Imin. The parameters
+ * are advertised by the DODAG root in the configuration option of its DIOs, the other motes use the ones they hear.
+ *
+ * Configuration options:
+ *  - RPL_DIO_INTERVAL_MIN: Imin is 2^RPL_DIO_INTERVAL_MIN ms.
+ *  - RPL_DIO_INTERVAL_DOUBLINGS: Imax is Imin * 2^RPL_DIO_INTERVAL_DOUBLINGS.
+ *  - RPL_DIO_REDUNDANCY: a mote does not send its DIO if it heard this many DIOs during the interval, 0 disables
+ *  suppression.
+ */
+#ifndef RPL_DIO_INTERVAL_MIN
+#define RPL_DIO_INTERVAL_MIN            12
+#endif
+
+#ifndef RPL_DIO_INTERVAL_DOUBLINGS
+#define RPL_DIO_INTERVAL_DOUBLINGS      8
+#endif
+
+#ifndef RPL_DIO_REDUNDANCY
+#define RPL_DIO_REDUNDANCY              10
+#endif
+
 /**
  * \def ADAPTIVE_MSF
  *
@@ -353,6 +397,18 @@
 #define IEEE802154E_SINGLE_CHANNEL      0
 #endif
 
+/**
+ * \def IEEE802154E_STRICT_TSTEMPLATE
+ *
+ * Advertise the timeslot template of the slot duration in the EBs (0x00 for 10 ms, 0x01 for 20 ms and 0x02 for 160 ms)
+ * and ignore EBs that advertise another template. When disabled, every build advertises the default template 0x00 and
+ * accepts EBs with any template, so it can join networks of motes built before the templates were distinguished.
+ *
+ */
+#ifndef IEEE802154E_STRICT_TSTEMPLATE
+#define IEEE802154E_STRICT_TSTEMPLATE   (0)
+#endif
+
 /**
  * \def PACKETQUEUE_LENGTH
  *
@@ -364,6 +420,123 @@
 #define PACKETQUEUE_LENGTH              20
 #endif
 
+/**
+ * \def OPENQUEUE_WEIGHT_LOCAL
+ * \def OPENQUEUE_WEIGHT_FORWARDED
+ *
+ * Weights of the deficit round robin between locally originated and forwarded data towards a neighbor: when both have
+ * packets waiting, they get cells in a OPENQUEUE_WEIGHT_LOCAL to OPENQUEUE_WEIGHT_FORWARDED ratio. 6P and RPL control
+ * packets always go first. Acceptable values are [1 - 255].
+ *
+ */
+#ifndef OPENQUEUE_WEIGHT_LOCAL
+#define OPENQUEUE_WEIGHT_LOCAL          1
+#endif
+
+#ifndef OPENQUEUE_WEIGHT_FORWARDED
+#define OPENQUEUE_WEIGHT_FORWARDED      1
+#endif
+
+/**
+ * \def OPENQUEUE_NUM_FULL_BUFFERS
+ * \def OPENQUEUE_NUM_SMALL_BUFFERS
+ * \def OPENQUEUE_SMALL_BUFFER_SIZE
+ *
+ * The packets of the PACKETQUEUE_LENGTH queue entries are held in a pool of full size (130 bytes) and small buffers.
+ * Frames are received in full size buffers, packets built by the stack start in a small buffer and move to a full size
+ * one only when they outgrow it. Most queued frames (KAs, EBs, short application payloads) fit in a small buffer, so
+ * the same RAM holds more packets than with one full size buffer per entry.
+ *
+ * By default there is one buffer per entry, and all but 2 of them are full size: the packets relayed for other motes may
+ * fill the whole low-priority share of the queue (all but 4 entries) with full size frames, as they could before the
+ * pool, and 2 full size buffers are still left to receive frames. The RAM saved at a given queue depth then mostly
+ * comes from the smaller entries (the 6P cell lists are only allocated for 6P packets). Builds which forward little
+ * traffic can trade full size buffers for small ones. A packet which finds no small buffer left takes a full size one.
+ *
+ */
+#ifndef OPENQUEUE_NUM_FULL_BUFFERS
+#define OPENQUEUE_NUM_FULL_BUFFERS      ((PACKETQUEUE_LENGTH - 2) < 3 ? 3 : (PACKETQUEUE_LENGTH - 2))
+#endif
+
+#ifndef OPENQUEUE_NUM_SMALL_BUFFERS
+#define OPENQUEUE_NUM_SMALL_BUFFERS     \
+    (PACKETQUEUE_LENGTH > OPENQUEUE_NUM_FULL_BUFFERS ? PACKETQUEUE_LENGTH - OPENQUEUE_NUM_FULL_BUFFERS : 1)
+#endif
+
+#ifndef OPENQUEUE_SMALL_BUFFER_SIZE
+#define OPENQUEUE_SMALL_BUFFER_SIZE     80
+#endif
+
+/**
+ * \def MAXNUMNEIGHBORS
+ *
+ * Number of rows of the neighbor table. Neighbors are looked up through a hash index on their 64-bit address, so the
+ * per-frame updates done by the MAC layer do not slow down with larger tables. Acceptable values are [1 - 127].
+ *
+ */
+#ifndef MAXNUMNEIGHBORS
+#define MAXNUMNEIGHBORS                 30
+#endif
+
+/**
+ * \def LINKEST_ALPHA
+ *
+ * Weight of a new sample in the ETX estimate of a link (neighbor or cell), in 1/16th. Lower values give a steadier
+ * estimate which reacts slower to a change of the link. Acceptable values are [1 - 16].
+ *
+ */
+#ifndef LINKEST_ALPHA
+#define LINKEST_ALPHA                   2
+#endif
+
+/**
+ * \def LINKEST_MIN_SAMPLES
+ *
+ * Number of samples an ETX estimate needs before RPL updates its rank through the preferred parent, and before MSF
+ * relocates a cell based on it. Acceptable values are [1 - 255].
+ *
+ */
+#ifndef LINKEST_MIN_SAMPLES
+#define LINKEST_MIN_SAMPLES             8
+#endif
+
+/**
+ * \def OPENQUEUE_NUM_CELLLISTS
+ *
+ * Number of 6P packets which can record the cells they add or delete at the same time. Only 6P responses, and 6P
+ * responses being received, need them.
+ *
+ */
+#ifndef OPENQUEUE_NUM_CELLLISTS
+#define OPENQUEUE_NUM_CELLLISTS         2
+#endif
+
+/**
+ * \def SCHEDULE_MAX_SLOTFRAMES
+ *
+ * Number of slotframes the schedule can hold at the same time. Slotframe 0 is the minimal slotframe, learned from the
+ * EBs. Higher slotframes are added locally (schedule_addSlotframe) and filled through 6P, e.g. a short slotframe for
+ * low latency flows. When cells of several slotframes fall in the same timeslot, a TX cell with a packet queued for
+ * its neighbor wins, otherwise the cell of the lowest slotframe. Each slotframe costs about SLOTFRAME_LENGTH bytes of
+ * RAM. Acceptable values are [1 - 8].
+ *
+ */
+#ifndef SCHEDULE_MAX_SLOTFRAMES
+#define SCHEDULE_MAX_SLOTFRAMES         1
+#endif
+
+/**
+ * \def MSF_SLOTFRAME_LENGTH
+ *
+ * When not 0, MSF installs a second slotframe (ID 1) of this length at boot and negotiates its cells there instead of
+ * in the minimal slotframe. All motes of the network must use the same value. Requires SCHEDULE_MAX_SLOTFRAMES >= 2,
+ * acceptable values are [0 - SLOTFRAME_LENGTH].
+ *
+ */
+#ifndef MSF_SLOTFRAME_LENGTH
+#define MSF_SLOTFRAME_LENGTH            0
+#endif
+
 /**
  * \def DAGROOT
  *
@@ -397,6 +570,19 @@
 #define BOARD_CRYPTOENGINE_ENABLED (0)
 #endif
 
+/**
+ * \def AES128_BACKEND
+ *
+ * Software AES-128 implementation, used by CCM* whenever BOARD_CRYPTOENGINE_ENABLED is not set. 0 selects the byte
+ * oriented implementation (smallest flash and RAM footprint), 1 the 32-bit T-table implementation (fastest, adds a
+ * 1 KB table and is not constant-time on targets with a data cache) and 2 the constant-time bitsliced implementation,
+ * which encrypts two CTR blocks per pass. Acceptable values are [0 - 2].
+ *
+ */
+#ifndef AES128_BACKEND
+#define AES128_BACKEND (0)
+#endif
+
 /**
  * \def BOARD_OPENSERIAL_PRINTF
  *
@@ -442,6 +628,40 @@
 #define BOARD_FASTSIM_ENABLED (0)
 #endif
 
+/**
+ * \def BOARD_MULTI_MOTE_ENABLED
+ *
+ * Allows a single instance of the Python extension to host several independent motes. The state of all modules is kept
+ * in a per-mote context (see mote_ctx.h) which is switched when execution enters a mote, instead of in globals.
+ *
+ */
+#ifndef BOARD_MULTI_MOTE_ENABLED
+#define BOARD_MULTI_MOTE_ENABLED (0)
+#endif
+
+/**
+ * \def BOARD_NATIVE_SIM_ENABLED
+ *
+ * Replaces the Python BSP by a discrete-event simulation engine written in C (bsp/boards/python/native). The firmware
+ * is built as a standalone executable which simulates a whole network, without the Python interpreter in the loop.
+ * Requires BOARD_MULTI_MOTE_ENABLED.
+ *
+ */
+#ifndef BOARD_NATIVE_SIM_ENABLED
+#define BOARD_NATIVE_SIM_ENABLED (0)
+#endif
+
+/**
+ * \def MAX_NUM_TIMERS
+ *
+ * Maximum number of timers that can run concurrently, including the TSCH and inhibit timers. The running timers are
+ * kept in a heap, so the cost of the timer interrupt grows with the logarithm of this number.
+ *
+ */
+#ifndef MAX_NUM_TIMERS
+#define MAX_NUM_TIMERS                  15
+#endif
+
 // ======================== Kernel configuration ========================
 
 /**
@@ -454,6 +674,18 @@
 #define SCHEDULER_DEBUG_ENABLE (0)
 #endif
 
+/**
+ * \def SCHEDULER_STATS_ENABLE
+ *
+ * Timestamps every task when it is pushed, started and finished, and keeps histograms of the wait and run times per
+ * priority and per task callback, as well as a histogram of the number of pending tasks. They are reported in the
+ * STATUS_SCHEDULER status element. Costs two sctimer reads per task and about 1.6 kB of RAM.
+ *
+ */
+#ifndef SCHEDULER_STATS_ENABLE
+#define SCHEDULER_STATS_ENABLE (0)
+#endif
+
 #include "check_config.h"
 
 #endif /* OPENWSN_CONFIG_H */
@@ -0,0 +1,99 @@
+#ifndef OPENWSN_MOTE_CTX_H
+#define OPENWSN_MOTE_CTX_H
+
+/**
+\brief Per-mote state context.
+
+When BOARD_MULTI_MOTE_ENABLED is set, a single process (the Python extension) hosts several motes. The state of each
+module then no longer lives in a file-scope global, but in a slot of the mote context that is currently active. The
+board switches the active context every time execution enters a mote. A module declares its state as follows:
+
+\code
+#if BOARD_MULTI_MOTE_ENABLED
+#define foo_vars MOTE_CTX_VAR(foo_vars_t, foo_vars)
+#else
+foo_vars_t foo_vars;
+#endif
+\endcode
+
+after which all accesses to foo_vars are unchanged. Slots are allocated (and zeroed) on first use, mirroring the
+zero-initialization of regular globals. In all other builds this header declares nothing.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+#if BOARD_MULTI_MOTE_ENABLED
+
+//=========================== define ==========================================
+
+/// evaluates to the instance of the slot 'name' (of type 'type') in the active mote context
+#define MOTE_CTX_VAR(type, name)        (*(type *) mote_ctx_getState(MOTE_CTX_##name, sizeof(type)))
+
+//=========================== typedef =========================================
+
+typedef enum {
+    // bsp
+    MOTE_CTX_notif_vars,
+    MOTE_CTX_radio_icb,
+    MOTE_CTX_sctimer_icb,
+    MOTE_CTX_uart_icb,
+    // kernel
+    MOTE_CTX_scheduler_vars,
+    MOTE_CTX_scheduler_dbg,
+    MOTE_CTX_scheduler_stats,
+    // drivers
+    MOTE_CTX_opensensors_vars,
+    MOTE_CTX_openserial_vars,
+    MOTE_CTX_opentimers_vars,
+    // openstack
+    MOTE_CTX_adaptive_sync_vars,
+    MOTE_CTX_ieee802154_security_vars,
+    MOTE_CTX_ieee154e_vars,
+    MOTE_CTX_ieee154e_status_entry,
+    MOTE_CTX_ieee154e_status_ctx,
+    MOTE_CTX_passed_msgBarrier,
+    MOTE_CTX_passed_ackBarrier,
+    MOTE_CTX_msf_vars,
+    MOTE_CTX_msf_status_ctx,
+    MOTE_CTX_neighbors_vars,
+    MOTE_CTX_neighbors_status_ctx,
+    MOTE_CTX_schedule_vars,
+    MOTE_CTX_schedule_status_ctx,
+    MOTE_CTX_sixtop_vars,
+    MOTE_CTX_sixtop_status_ctx,
+    MOTE_CTX_frag_vars,
+    MOTE_CTX_monitor_expiration_vars,
+    MOTE_CTX_icmpv6echo_vars,
+    MOTE_CTX_icmpv6rpl_vars,
+    MOTE_CTX_udp_socket_list,
+    MOTE_CTX_id_manager_vars,
+    MOTE_CTX_id_manager_status_ctx,
+    MOTE_CTX_openqueue_vars,
+    MOTE_CTX_openqueue_status_ctx,
+    MOTE_CTX_random_vars,
+    // openweb
+    MOTE_CTX_coap_vars,
+    // openapps
+    MOTE_CTX_c6t_vars,
+    MOTE_CTX_cexample_vars,
+    MOTE_CTX_cinfo_vars,
+    MOTE_CTX_cinfrared_vars,
+    MOTE_CTX_cjoin_vars,
+    MOTE_CTX_cled_vars,
+    MOTE_CTX_cstorm_vars,
+    MOTE_CTX_cwellknown_vars,
+    MOTE_CTX_rrt_vars,
+    MOTE_CTX_uecho_sock,
+    // last
+    MOTE_CTX_LAST
+} mote_ctx_slot_t;
+
+//=========================== prototypes ======================================
+
+void *mote_ctx_getState(uint8_t slot, size_t size);
+
+#endif /* BOARD_MULTI_MOTE_ENABLED */
+
+#endif /* OPENWSN_MOTE_CTX_H */
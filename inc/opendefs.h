@@ -16,6 +16,7 @@
 // general
 #include <stdint.h>               // needed for uin8_t, uint16_t
 #include "config.h"
+#include "mote_ctx.h"
 #include "toolchain_defs.h"
 #include "board_info.h"
 #include "af.h"
@@ -40,14 +41,17 @@ static const uint8_t infoStackName[] = "OpenWSN ";
 #define LENGTH_ADDR64b   8
 #define LENGTH_ADDR128b  16
 
-#define MAXNUMNEIGHBORS  30
-
 // maximum celllist length
 #define CELLLIST_MAX_LEN 5
 
 // frame sizes
 #define IEEE802154_FRAME_SIZE   127
 
+// full size packet buffer: 1B spi address, 1B length, 125B data, 2B CRC, 1B LQI
+#define PACKET_BUFFER_SIZE      (1 + 1 + 125 + 2 + 1)
+// bytes after the end of the frame in any packet buffer
+#define PACKET_BUFFER_TAIL      (PACKET_BUFFER_SIZE - IEEE802154_FRAME_SIZE)
+
 #if OPENWSN_6LO_FRAGMENTATION_C
 #define IPV6_PACKET_SIZE        MAX_PKTSIZE_SUPPORTED
 #else
@@ -122,6 +126,7 @@ enum {
     STATUS_KAPERIOD,
     STATUS_JOINED,
     STATUS_MSF,
+    STATUS_SCHEDULER,
     STATUS_MAX,
 };
 
@@ -332,14 +337,30 @@ typedef struct {  // always written big endian, i.e. MSB in addr[0]
 END_PACK
 
 typedef struct {
+    // fields wider than a byte come first, so that the entry needs no padding
+    uint8_t *packet;                                           // buffer holding the packet, taken from the openqueue pool
+    uint8_t *payload;                                          // pointer to the start of the payload within 'packet'
+    uint8_t *l4_payload;                                       // pointer to the start of the payload of l4 (used for retransmits)
+    uint8_t *l2_payload;                                       // pointer to the start of the payload of l2 (used for MAC to fill in ASN in ADV)
+    uint8_t *l2_ASNpayload;                                    // pointer to the ASN in EB
+    uint8_t *l2_nextHop_payload;                               // pointer to the nexthop address in frame
+    uint8_t *l2_FrameCounter;                                  // pointer to the FrameCounter in the MAC header
+    cellInfo_ht *l2_sixtop_celllist_add;                       // record celllist to be added and will be added when 6P response sendDone (see openqueue_getCelllists())
+    cellInfo_ht *l2_sixtop_celllist_delete;                    // record celllist to be removed and will be removed when 6P response sendDone (see openqueue_getCelllists())
+    uint16_t packet_size;                                      // size of the buffer, the frame ends PACKET_BUFFER_TAIL bytes before its end
+    int16_t length;                                            // length in bytes of the payload
+    uint16_t l4_sourcePortORicmpv6Type;                        // l4 source port
+    uint16_t l4_destination_port;                              // l4 destination port
+    uint16_t l2_sixtop_frameID;                                // frameID in 6P message
+    int16_t l2_timeCorrection;                                 // record the timeCorrection and print out at endOfslot
+#if DEADLINE_OPTION
+    uint16_t      max_delay;                                   // Max delay in milliseconds before which the packet should be delivered to the receiver
+#endif
     // admin
     uint8_t creator;                                           // the component which called getFreePacketBuffer()
     uint8_t owner;                                             // the component which currently owns the entry
-    uint8_t *payload;                                          // pointer to the start of the payload within 'packet'
-    int16_t length;                                            // length in bytes of the payload
     // l7
 #if DEADLINE_OPTION
-    uint16_t      max_delay;                                   // Max delay in milliseconds before which the packet should be delivered to the receiver
     bool          orgination_time_flag;
     bool          drop_flag;
 #endif
@@ -351,15 +372,13 @@ typedef struct {
     // l4
     uint8_t l4_protocol;                                       // l4 protocol to be used
     bool l4_protocol_compressed;                               // is the l4 protocol header compressed?
-    uint16_t l4_sourcePortORicmpv6Type;                        // l4 source port
-    uint16_t l4_destination_port;                              // l4 destination port
-    uint8_t *l4_payload;                                       // pointer to the start of the payload of l4 (used for retransmits)
     uint8_t l4_length;                                         // length of the payload of l4 (used for retransmits)
 
     // l3
     open_addr_t l3_destinationAdd;                             // 128b IPv6 destination (down stack)
     open_addr_t l3_sourceAdd;                                  // 128b IPv6 source address
     bool l3_useSourceRouting;                                  // TRUE when the packet goes downstream
+    bool l3_routedDownward;                                    // TRUE when the next hop comes from the routing table (O flag set)
 
 #if OPENWSN_6LO_FRAGMENTATION_C
     bool         l3_isFragment;
@@ -372,46 +391,34 @@ typedef struct {
     uint8_t l2_retriesLeft;                                    // number Tx retries left before packet dropped (dropped when hits 0)
     uint8_t l2_numTxAttempts;                                  // number Tx attempts
     asn_t l2_asn;                                              // at what ASN the packet was Tx'ed or Rx'ed
-    uint8_t *l2_payload;                                       // pointer to the start of the payload of l2 (used for MAC to fill in ASN in ADV)
-    cellInfo_ht l2_sixtop_celllist_add[CELLLIST_MAX_LEN];      // record celllist to be added and will be added when 6P response sendDone
-    cellInfo_ht l2_sixtop_celllist_delete[CELLLIST_MAX_LEN];   // record celllist to be removed and will be removed when 6P response sendDone
-    uint16_t l2_sixtop_frameID;                                // frameID in 6P message
     uint8_t l2_sixtop_messageType;                             // indicating the sixtop message type
     uint8_t l2_sixtop_command;                                 // command of the received 6p request, recorded in 6p response
     uint8_t l2_sixtop_cellOptions;                             // celloptions, used when 6p response senddone. (it's the same with cellOptions in 6p request but with TX and RX bits have been flipped)
     uint8_t l2_sixtop_returnCode;                              // return code in 6P response
-    uint8_t *l2_ASNpayload;                                    // pointer to the ASN in EB
-    uint8_t *l2_nextHop_payload;                               // pointer to the nexthop address in frame
     uint8_t l2_joinPriority;                                   // the join priority received in EB
     bool l2_IEListPresent;                                     // did have IE field?
     bool l2_payloadIEpresent;                                  // did I have payload IE field
     bool l2_joinPriorityPresent;
     bool l2_isNegativeACK;                                     // is the negative ACK?
-    int16_t l2_timeCorrection;                                 // record the timeCorrection and print out at endOfslot
     bool l2_sendOnTxCell;                                      // mark the frame is sent on txCell
     // layer-2 security
     uint8_t l2_securityLevel;                                  // the security level specified for the current frame
     uint8_t l2_keyIdMode;                                      // the key Identifier mode specified for the current frame
     uint8_t l2_keyIndex;                                       // the key Index specified for the current frame
-    open_addr_t l2_keySource;                                  // the key Source specified for the current frame
     uint8_t l2_authenticationLength;                           // the length of the authentication field
     uint8_t commandFrameIdentifier;                            // used in case of Command Frames
-    uint8_t *l2_FrameCounter;                                  // pointer to the FrameCounter in the MAC header
     // l1 (drivers)
     uint8_t l1_txPower;                                        // power for packet to Tx at
     int8_t l1_rssi;                                            // RSSI of received packet
     uint8_t l1_lqi;                                            // LQI of received packet
     bool l1_crc;                                               // did received packet pass CRC check?
-    // the packet
-    uint8_t packet[1 + 1 + 125 + 2 + 1];                       // 1B spi address, 1B length, 125B data, 2B CRC, 1B LQI
 } OpenQueueEntry_t;
 
 
 #if OPENWSN_6LO_FRAGMENTATION_C
 typedef struct {
     OpenQueueEntry_t standard_entry;
-    // 130 bytes alread allocated in the normal OpenQueueEntry
-    uint8_t packet_remainder[IPV6_PACKET_SIZE - 130];
+    uint8_t buffer[IPV6_PACKET_SIZE + PACKET_BUFFER_TAIL];
 } OpenQueueBigEntry_t;
 #endif
 
@@ -9,30 +9,67 @@
 #include "board.h"
 #include "debugpins.h"
 #include "leds.h"
+#if SCHEDULER_STATS_ENABLE
+#include "sctimer.h"
+#endif
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define scheduler_vars MOTE_CTX_VAR(scheduler_vars_t, scheduler_vars)
+#else
 scheduler_vars_t scheduler_vars;
+#endif
 
 #if SCHEDULER_DEBUG_ENABLE
+#if BOARD_MULTI_MOTE_ENABLED
+#define scheduler_dbg MOTE_CTX_VAR(scheduler_dbg_t, scheduler_dbg)
+#else
 scheduler_dbg_t scheduler_dbg;
 #endif
+#endif
 
-#if PYTHON_BOARD
-bool quit = FALSE;
+#if SCHEDULER_STATS_ENABLE
+#if BOARD_MULTI_MOTE_ENABLED
+#define scheduler_stats MOTE_CTX_VAR(scheduler_stats_t, scheduler_stats)
+#else
+scheduler_stats_t scheduler_stats;
+#endif
 #endif
 
 //=========================== prototypes ======================================
 
+static uint8_t scheduler_highestPending(void);
+
+#if SCHEDULER_STATS_ENABLE
+static void scheduler_stats_record(task_cbt cb, uint8_t prio, uint32_t pushedAt, uint32_t startedAt, uint32_t finishedAt);
+
+static void scheduler_stats_add(scheduler_histograms_t *histograms, uint32_t wait, uint32_t run);
+
+static uint8_t scheduler_stats_bin(uint32_t duration);
+
+static void scheduler_stats_copy(debugSchedulerTask_t *output, const scheduler_histograms_t *histograms);
+#endif
+
 //=========================== public ==========================================
 
 void scheduler_init(void) {
+    uint8_t i;
 
     // initialization module variables
     memset(&scheduler_vars, 0, sizeof(scheduler_vars_t));
 #if SCHEDULER_DEBUG_ENABLE
     memset(&scheduler_dbg,0,sizeof(scheduler_dbg_t));
 #endif
+#if SCHEDULER_STATS_ENABLE
+    memset(&scheduler_stats, 0, sizeof(scheduler_stats_t));
+#endif
+
+    // all task containers are free
+    for (i = 0; i < TASK_LIST_DEPTH - 1; i++) {
+        scheduler_vars.taskBuf[i].next = &scheduler_vars.taskBuf[i + 1];
+    }
+    scheduler_vars.freeList = &scheduler_vars.taskBuf[0];
 
     // enable the scheduler's interrupt so SW can wake up the scheduler
     SCHEDULER_ENABLE_INTERRUPT();
@@ -44,59 +81,86 @@ void scheduler_start(void) {
 #else
     _Noreturn void scheduler_start(void) {
 #endif
-    taskList_item_t *pThisTask;
 #if PYTHON_BOARD
-    while (quit == FALSE) {
+    while (scheduler_vars.quit == FALSE) {
 #else
         while (1) {
 #endif
-        while (scheduler_vars.task_list != NULL) {
-            // there is still at least one task in the linked-list of tasks
+        scheduler_run_pending();
+        debugpins_task_clr();
+        board_sleep();
+        debugpins_task_set();                      // IAR should halt here if nothing to do
+    }
+}
 
-            INTERRUPT_DECLARATION();
+/**
+\brief Execute all queued tasks, in order of priority, until the queue is empty.
+*/
+void scheduler_run_pending(void) {
+    taskList_item_t *pThisTask;
+    task_cbt cb;
+    uint8_t prio;
+#if SCHEDULER_STATS_ENABLE
+    uint32_t pushedAt;
+    uint32_t startedAt;
+#endif
 
-            DISABLE_INTERRUPTS();
+    while (scheduler_vars.pending != 0) {
+        // there is still at least one task pending
 
-            // the task to execute is the one at the head of the queue
-            pThisTask = scheduler_vars.task_list;
+        INTERRUPT_DECLARATION();
 
-            // shift the queue by one task
-            scheduler_vars.task_list = pThisTask->next;
+        DISABLE_INTERRUPTS();
 
-            ENABLE_INTERRUPTS();
+        // the task to execute is the oldest one of the highest priority
+        prio = scheduler_highestPending();
+        pThisTask = scheduler_vars.head[prio];
 
-            // execute the current task
-            pThisTask->cb();
+        // shift that queue by one task
+        scheduler_vars.head[prio] = pThisTask->next;
+        if (scheduler_vars.head[prio] == NULL) {
+            scheduler_vars.tail[prio] = NULL;
+            scheduler_vars.pending &= ~(1u << prio);
+        }
 
-            // free up this task container
-            pThisTask->cb = NULL;
-            pThisTask->prio = TASKPRIO_NONE;
-            pThisTask->next = NULL;
+        // free up this task container
+        cb = pThisTask->cb;
+#if SCHEDULER_STATS_ENABLE
+        pushedAt = pThisTask->pushedAt;
+        scheduler_stats.numTasks--;
+#endif
+        pThisTask->cb = NULL;
+        pThisTask->prio = TASKPRIO_NONE;
+        pThisTask->next = scheduler_vars.freeList;
+        scheduler_vars.freeList = pThisTask;
 #if SCHEDULER_DEBUG_ENABLE
-            scheduler_dbg.numTasksCur--;
+        scheduler_dbg.numTasksCur--;
+#endif
+
+        ENABLE_INTERRUPTS();
+
+        // execute the current task
+#if SCHEDULER_STATS_ENABLE
+        startedAt = sctimer_readCounter();
+        cb();
+        scheduler_stats_record(cb, prio, pushedAt, startedAt, sctimer_readCounter());
+#else
+        cb();
 #endif
-        }
-        debugpins_task_clr();
-        board_sleep();
-        debugpins_task_set();                      // IAR should halt here if nothing to do
     }
 }
 
 void scheduler_push_task(task_cbt cb, task_prio_t prio) {
     taskList_item_t *taskContainer;
-    taskList_item_t **taskListWalker;
 
     INTERRUPT_DECLARATION();
 
     DISABLE_INTERRUPTS();
 
-    // find an empty task container
-    taskContainer = &scheduler_vars.taskBuf[0];
-    while (taskContainer->cb != NULL && taskContainer <= &scheduler_vars.taskBuf[TASK_LIST_DEPTH - 1]) {
-        taskContainer++;
-    }
+    // take an empty task container
+    taskContainer = scheduler_vars.freeList;
 
-    if (taskContainer > &scheduler_vars.taskBuf[TASK_LIST_DEPTH - 1]) {
+    if (taskContainer == NULL) {
         // task list has overflown. This should never happpen!
 
         // we can not print from within the kernel. Instead:
@@ -106,18 +170,29 @@ void scheduler_push_task(task_cbt cb, task_prio_t prio) {
         board_reset();
     }
 
+    scheduler_vars.freeList = taskContainer->next;
+
     // fill that task container with this task
     taskContainer->cb = cb;
     taskContainer->prio = prio;
+    taskContainer->next = NULL;
+#if SCHEDULER_STATS_ENABLE
+    taskContainer->pushedAt = sctimer_readCounter();
+    if (scheduler_stats.depth[scheduler_stats.numTasks] < 0xffff) {
+        scheduler_stats.depth[scheduler_stats.numTasks]++;
+    }
+    scheduler_stats.numTasks++;
+#endif
 
-    // find position in queue
-    taskListWalker = &scheduler_vars.task_list;
-    while (*taskListWalker != NULL && (*taskListWalker)->prio <= taskContainer->prio) {
-        taskListWalker = (taskList_item_t **) &((*taskListWalker)->next);
+    // append it to the queue of its priority, after the tasks of the same priority
+    if (scheduler_vars.tail[prio] == NULL) {
+        scheduler_vars.head[prio] = taskContainer;
+    } else {
+        scheduler_vars.tail[prio]->next = taskContainer;
     }
-    // insert at that position
-    taskContainer->next = *taskListWalker;
-    *taskListWalker = taskContainer;
+    scheduler_vars.tail[prio] = taskContainer;
+    scheduler_vars.pending |= (1u << prio);
+
     // maintain debug stats
 
 #if SCHEDULER_DEBUG_ENABLE
@@ -132,8 +207,11 @@ void scheduler_push_task(task_cbt cb, task_prio_t prio) {
 
 #if PYTHON_BOARD
 
+/**
+\brief Make scheduler_start() of the current mote return once the task being executed completes.
+*/
 void scheduler_stop(void) {
-    quit = TRUE;
+    scheduler_vars.quit = TRUE;
 }
 
 #endif
@@ -148,4 +226,157 @@ uint8_t scheduler_debug_get_TasksMax(void) {
    return scheduler_dbg.numTasksMax;
 }
 #endif
+
+#if SCHEDULER_STATS_ENABLE
+/**
+\brief Copy the histogram of the number of tasks pending when a task is pushed.
+*/
+void scheduler_stats_getQueue(debugSchedulerQueue_t *output) {
+    uint8_t i;
+
+    INTERRUPT_DECLARATION();
+
+    DISABLE_INTERRUPTS();
+
+    output->numTasksMax = 0;
+    for (i = 0; i <= TASK_LIST_DEPTH; i++) {
+        output->depth[i] = scheduler_stats.depth[i];
+        if (output->depth[i] != 0) {
+            output->numTasksMax = i + 1;
+        }
+    }
+
+    ENABLE_INTERRUPTS();
+}
+
+/**
+\brief Copy the wait and run time histograms of a priority or of a task callback.
+
+\param[in] index Indices below TASKPRIO_MAX select a priority, the next ones the callbacks in the order they first ran.
+\param[out] output The histograms.
+
+\returns FALSE if no priority or callback has that index.
+*/
+bool scheduler_stats_getTask(uint8_t index, debugSchedulerTask_t *output) {
+    if (index < TASKPRIO_MAX) {
+        output->prio = index;
+        output->cb = 0;
+        scheduler_stats_copy(output, &scheduler_stats.prio[index]);
+        return TRUE;
+    }
+
+    index -= TASKPRIO_MAX;
+    if (index >= scheduler_stats.numCallbacks) {
+        return FALSE;
+    }
+
+    output->prio = TASKPRIO_NONE;
+    output->cb = (uint32_t) (uintptr_t) scheduler_stats.cb[index];
+    scheduler_stats_copy(output, &scheduler_stats.callback[index]);
+    return TRUE;
+}
+#endif
 //=========================== private =========================================
+
+/**
+\brief Find the highest priority (lowest value) with at least one pending task.
+
+Interrupts must be disabled and at least one task must be pending.
+*/
+static uint8_t scheduler_highestPending(void) {
+#if defined(__GNUC__)
+    return (uint8_t) __builtin_ctz(scheduler_vars.pending);
+#else
+    // lowest bit set in each nibble value
+    static const uint8_t lowestBit[16] = {0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0};
+    uint16_t pending;
+    uint8_t prio;
+
+    pending = scheduler_vars.pending;
+    prio = 0;
+    while ((pending & 0x0f) == 0) {
+        pending >>= 4;
+        prio += 4;
+    }
+
+    return prio + lowestBit[pending & 0x0f];
+#endif
+}
+
+#if SCHEDULER_STATS_ENABLE
+/**
+\brief Account a task which just ran in the histograms of its priority and of its callback.
+
+Callbacks beyond the first SCHEDULER_STATS_NUM_CALLBACKS distinct ones are only accounted per priority.
+*/
+static void scheduler_stats_record(task_cbt cb, uint8_t prio, uint32_t pushedAt, uint32_t startedAt, uint32_t finishedAt) {
+    uint8_t i;
+
+    scheduler_stats_add(&scheduler_stats.prio[prio], startedAt - pushedAt, finishedAt - startedAt);
+
+    for (i = 0; i < scheduler_stats.numCallbacks; i++) {
+        if (scheduler_stats.cb[i] == cb) {
+            break;
+        }
+    }
+
+    if (i == scheduler_stats.numCallbacks) {
+        if (i == SCHEDULER_STATS_NUM_CALLBACKS) {
+            return;
+        }
+        scheduler_stats.cb[i] = cb;
+        scheduler_stats.numCallbacks++;
+    }
+
+    scheduler_stats_add(&scheduler_stats.callback[i], startedAt - pushedAt, finishedAt - startedAt);
+}
+
+static void scheduler_stats_add(scheduler_histograms_t *histograms, uint32_t wait, uint32_t run) {
+    uint8_t bin;
+
+    // counters saturate, so that a long running mote does not report wrapped counts
+    if (histograms->numRuns < 0xffff) {
+        histograms->numRuns++;
+    }
+
+    bin = scheduler_stats_bin(wait);
+    if (histograms->wait[bin] < 0xffff) {
+        histograms->wait[bin]++;
+    }
+    if (wait > histograms->maxWait) {
+        histograms->maxWait = (wait > 0xffff) ? 0xffff : (uint16_t) wait;
+    }
+
+    bin = scheduler_stats_bin(run);
+    if (histograms->run[bin] < 0xffff) {
+        histograms->run[bin]++;
+    }
+    if (run > histograms->maxRun) {
+        histograms->maxRun = (run > 0xffff) ? 0xffff : (uint16_t) run;
+    }
+}
+
+static uint8_t scheduler_stats_bin(uint32_t duration) {
+    uint8_t bin;
+
+    bin = 0;
+    while (duration != 0 && bin < SCHEDULER_STATS_NUM_BINS - 1) {
+        duration >>= 1;
+        bin++;
+    }
+
+    return bin;
+}
+
+static void scheduler_stats_copy(debugSchedulerTask_t *output, const scheduler_histograms_t *histograms) {
+    uint8_t i;
+
+    output->numRuns = histograms->numRuns;
+    output->maxWait = histograms->maxWait;
+    output->maxRun = histograms->maxRun;
+    for (i = 0; i < SCHEDULER_STATS_NUM_BINS; i++) {
+        output->wait[i] = histograms->wait[i];
+        output->run[i] = histograms->run[i];
+    }
+}
+#endif
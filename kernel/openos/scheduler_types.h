@@ -14,11 +14,20 @@ typedef struct task_llist_t {
    task_cbt                       cb;
    task_prio_t                    prio;
    void*                          next;
+#if SCHEDULER_STATS_ENABLE
+   uint32_t                       pushedAt;                 // sctimer counter when the task was pushed
+#endif
 } taskList_item_t;
 
 typedef struct {
    taskList_item_t                taskBuf[TASK_LIST_DEPTH];
-   taskList_item_t*               task_list;
+   taskList_item_t*               freeList;                 // unused task containers
+   taskList_item_t*               head[TASKPRIO_MAX];       // FIFO of pending tasks, per priority
+   taskList_item_t*               tail[TASKPRIO_MAX];
+   uint16_t                       pending;                  // bit i set when the FIFO of priority i is not empty
+#if PYTHON_BOARD
+   bool                           quit;                     // set by scheduler_stop(), ends scheduler_start()
+#endif
 } scheduler_vars_t;
 
 #if SCHEDULER_DEBUG_ENABLE
@@ -28,6 +37,25 @@ typedef struct {
 } scheduler_dbg_t;
 #endif
 
+#if SCHEDULER_STATS_ENABLE
+typedef struct {
+   uint16_t                       numRuns;
+   uint16_t                       maxWait;
+   uint16_t                       maxRun;
+   uint16_t                       wait[SCHEDULER_STATS_NUM_BINS];
+   uint16_t                       run[SCHEDULER_STATS_NUM_BINS];
+} scheduler_histograms_t;
+
+typedef struct {
+   uint8_t                        numTasks;                 // number of pending tasks
+   uint16_t                       depth[TASK_LIST_DEPTH + 1];
+   scheduler_histograms_t         prio[TASKPRIO_MAX];
+   task_cbt                       cb[SCHEDULER_STATS_NUM_CALLBACKS];
+   scheduler_histograms_t         callback[SCHEDULER_STATS_NUM_CALLBACKS];
+   uint8_t                        numCallbacks;
+} scheduler_stats_t;
+#endif
+
 /**
 \}
 \}
@@ -32,15 +32,43 @@ typedef enum {
     TASKPRIO_SIXTOP_TIMEOUT = 0x0d,
     TASKPRIO_SNIFFER = 0x0e,
     TASKPRIO_OPENSERIAL = 0X0f,
-    TASKPRIO_MAX = 0x10,
+    TASKPRIO_MAX = 0x10,        // at most 16 levels, one bit each in the scheduler's bitmap of pending queues
 } task_prio_t;
 
 #define TASK_LIST_DEPTH           10
 
+#if SCHEDULER_STATS_ENABLE
+// bin 0 counts durations of 0 sctimer ticks, bin i durations of [2^(i-1), 2^i) ticks, the last bin all longer ones
+#define SCHEDULER_STATS_NUM_BINS        10
+// number of distinct task callbacks which get their own histograms
+#define SCHEDULER_STATS_NUM_CALLBACKS   16
+#endif
+
 // =========================== typedef =========================================
 
 typedef void (*task_cbt)(void);
 
+#if SCHEDULER_STATS_ENABLE
+BEGIN_PACK
+typedef struct {
+    uint8_t numTasksMax;
+    uint16_t depth[TASK_LIST_DEPTH + 1];        // number of pending tasks seen by each push
+} debugSchedulerQueue_t;
+END_PACK
+
+BEGIN_PACK
+typedef struct {
+    uint8_t prio;
+    uint32_t cb;                                // address of the callback, 0 for the histograms of a priority
+    uint16_t numRuns;
+    uint16_t maxWait;                           // in sctimer ticks
+    uint16_t maxRun;                            // in sctimer ticks
+    uint16_t wait[SCHEDULER_STATS_NUM_BINS];    // time between scheduler_push_task() and the start of the task
+    uint16_t run[SCHEDULER_STATS_NUM_BINS];     // execution time of the task
+} debugSchedulerTask_t;
+END_PACK
+#endif
+
 // =========================== prototypes ======================================
 void scheduler_init(void);
 
@@ -54,6 +82,8 @@ void scheduler_stop(void);
 _Noreturn void  scheduler_start(void);
 #endif
 
+void scheduler_run_pending(void);
+
 void scheduler_push_task(task_cbt task_cb, task_prio_t prio);
 
 #if SCHEDULER_DEBUG_ENABLE
@@ -62,6 +92,13 @@ uint8_t scheduler_debug_get_TasksMax(void);
 
 #endif
 
+#if SCHEDULER_STATS_ENABLE
+void scheduler_stats_getQueue(debugSchedulerQueue_t *output);
+
+bool scheduler_stats_getTask(uint8_t index, debugSchedulerTask_t *output);
+
+#endif
+
 #include "openos/scheduler_types.h"
 
 /**
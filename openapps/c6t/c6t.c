@@ -16,6 +16,7 @@
 #include "sixtop.h"
 #include "idmanager.h"
 #include "openqueue.h"
+#include "packetfunctions.h"
 #include "neighbors.h"
 #include "msf.h"
 
@@ -25,7 +26,11 @@ const uint8_t c6t_path0[] = "6t";
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define c6t_vars MOTE_CTX_VAR(c6t_vars_t, c6t_vars)
+#else
 c6t_vars_t c6t_vars;
+#endif
 
 //=========================== prototypes ======================================
 
@@ -90,8 +95,7 @@ owerror_t c6t_receive(OpenQueueEntry_t *msg,
             // add a slot
 
             // reset packet payload
-            msg->payload = &(msg->packet[127]);
-            msg->length = 0;
+            packetfunctions_resetPayload(msg);
 
             // get preferred parent
             foundNeighbor = icmpv6rpl_getPreferredParentEui64(&neighbor);
@@ -129,8 +133,7 @@ owerror_t c6t_receive(OpenQueueEntry_t *msg,
             // delete a slot
 
             // reset packet payload
-            msg->payload = &(msg->packet[127]);
-            msg->length = 0;
+            packetfunctions_resetPayload(msg);
 
             // get preferred parent
             foundNeighbor = icmpv6rpl_getPreferredParentEui64(&neighbor);
@@ -32,7 +32,11 @@ static const uint8_t ipAddr_motesEecs[] = {0x20, 0x01, 0x04, 0x70, 0x00, 0x66, 0
 
 static const uint8_t cexample_path0[] = "ex";
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define cexample_vars MOTE_CTX_VAR(cexample_vars_t, cexample_vars)
+#else
 cexample_vars_t cexample_vars;
+#endif
 
 //=========================== prototypes ======================================
 
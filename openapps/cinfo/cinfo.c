@@ -20,7 +20,11 @@ const uint8_t cinfo_path0[] = "i";
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define cinfo_vars MOTE_CTX_VAR(cinfo_vars_t, cinfo_vars)
+#else
 cinfo_vars_t cinfo_vars;
+#endif
 
 //=========================== prototypes ======================================
 
@@ -85,8 +89,7 @@ owerror_t cinfo_receive(
     switch (coap_header->Code) {
         case COAP_CODE_REQ_GET:
             //=== reset packet payload (we will reuse this packetBuffer)
-            msg->payload = &(msg->packet[127]);
-            msg->length = 0;
+            packetfunctions_resetPayload(msg);
 
             //=== prepare  CoAP response
 
@@ -12,6 +12,7 @@
 #include "cinfrared.h"
 #include "idmanager.h"
 #include "openqueue.h"
+#include "packetfunctions.h"
 #include "neighbors.h"
 #include "pwm.h"
 #include "opentimers.h"
@@ -23,7 +24,11 @@ const uint8_t cinfrared_path0[] = "ir";
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define cinfrared_vars MOTE_CTX_VAR(cinfrared_vars_t, cinfrared_vars)
+#else
 cinfrared_vars_t cinfrared_vars;
+#endif
 
 //=========================== prototypes ======================================
 
@@ -90,8 +95,7 @@ owerror_t cinfrared_receive(OpenQueueEntry_t *msg,
             cinrared_turnOnOrOff(msg->payload[0]);
 
             // reset packet payload
-            msg->payload = &(msg->packet[127]);
-            msg->length = 0;
+            packetfunctions_resetPayload(msg);
 
             // set the CoAP header
             coap_header->Code = COAP_CODE_RESP_CHANGED;
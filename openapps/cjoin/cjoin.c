@@ -34,7 +34,11 @@ static const uint8_t proxyScheme[] = "coap";
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define cjoin_vars MOTE_CTX_VAR(cjoin_vars_t, cjoin_vars)
+#else
 cjoin_vars_t cjoin_vars;
+#endif
 
 //=========================== prototypes ======================================
 void cjoin_init_security_context(void);
@@ -16,7 +16,11 @@
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define cled_vars MOTE_CTX_VAR(cled_vars_t, cled_vars)
+#else
 cled_vars_t cled_vars;
+#endif
 
 const uint8_t cled_path0[] = "l";
 
@@ -71,8 +75,7 @@ owerror_t cled_receive(OpenQueueEntry_t *msg,
     switch (coap_header->Code) {
         case COAP_CODE_REQ_GET:
             // reset packet payload
-            msg->payload = &(msg->packet[127]);
-            msg->length = 0;
+            packetfunctions_resetPayload(msg);
 
             // add CoAP payload
             if (packetfunctions_reserveHeader(&msg, 1) == E_FAIL) {
@@ -104,8 +107,7 @@ owerror_t cled_receive(OpenQueueEntry_t *msg,
             }
 
             // reset packet payload
-            msg->payload = &(msg->packet[127]);
-            msg->length = 0;
+            packetfunctions_resetPayload(msg);
 
             // set the CoAP header
             coap_header->Code = COAP_CODE_RESP_CHANGED;
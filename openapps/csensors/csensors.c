@@ -192,8 +192,7 @@ owerror_t csensors_receive(
     switch (coap_header->Code) {
         case COAP_CODE_REQ_GET:
             // reset packet payload
-            msg->payload = &(msg->packet[127]);
-            msg->length = 0;
+            packetfunctions_resetPayload(msg);
 
             if (coap_incomingOptions[1].type != COAP_OPTION_NUM_URIPATH) {
 
@@ -263,8 +262,7 @@ owerror_t csensors_receive(
             }
 
             // reset packet payload
-            msg->payload = &(msg->packet[127]);
-            msg->length = 0;
+            packetfunctions_resetPayload(msg);
             // set the CoAP header
             coap_header->Code = COAP_CODE_RESP_CHANGED;
 
@@ -24,7 +24,11 @@ static const uint8_t dst_addr[] = {
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define cstorm_vars MOTE_CTX_VAR(cstorm_vars_t, cstorm_vars)
+#else
 cstorm_vars_t cstorm_vars;
+#endif
 
 //=========================== prototypes ======================================
 
@@ -89,8 +93,7 @@ owerror_t cstorm_receive(
         case COAP_CODE_REQ_GET:
 
             // reset packet payload
-            msg->payload = &(msg->packet[127]);
-            msg->length = 0;
+            packetfunctions_resetPayload(msg);
 
             // add CoAP payload
             if (packetfunctions_reserveHeader(&msg, 2) == E_FAIL) {
@@ -135,8 +138,7 @@ owerror_t cstorm_receive(
             */
 
             // reset packet payload
-            msg->payload = &(msg->packet[127]);
-            msg->length = 0;
+            packetfunctions_resetPayload(msg);
 
             // set the CoAP header
             coap_header->Code = COAP_CODE_RESP_CHANGED;
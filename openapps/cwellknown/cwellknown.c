@@ -6,11 +6,16 @@
 #include "cwellknown.h"
 #include "coap.h"
 #include "openqueue.h"
+#include "packetfunctions.h"
 #include "idmanager.h"
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define cwellknown_vars MOTE_CTX_VAR(cwellknown_vars_t, cwellknown_vars)
+#else
 cwellknown_vars_t cwellknown_vars;
+#endif
 
 const uint8_t cwellknown_path0[] = ".well-known";
 const uint8_t cwellknown_path1[] = "core";
@@ -61,8 +66,7 @@ owerror_t cwellknown_receive(OpenQueueEntry_t *msg,
     switch (coap_header->Code) {
         case COAP_CODE_REQ_GET:
             // reset packet payload
-            msg->payload = &(msg->packet[127]);
-            msg->length = 0;
+            packetfunctions_resetPayload(msg);
 
             // have CoAP module write links to all resources
             coap_writeLinks(msg, COMPONENT_CWELLKNOWN);
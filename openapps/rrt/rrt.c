@@ -26,7 +26,11 @@ static const uint8_t ipAddr_ringmaster[] = {0xbb, 0xbb, 0x00, 0x00, 0x00, 0x00,
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define rrt_vars MOTE_CTX_VAR(rrt_vars_t, rrt_vars)
+#else
 rrt_vars_t rrt_vars;
+#endif
 
 //=========================== prototypes ======================================
 
@@ -99,8 +103,7 @@ owerror_t rrt_receive(
         case COAP_CODE_REQ_GET:
 
             //=== reset packet payload (we will reuse this packetBuffer)
-            msg->payload = &(msg->packet[127]);
-            msg->length = 0;
+            packetfunctions_resetPayload(msg);
 
             //=== prepare  CoAP response
             rrt_setGETRespMsg(msg, rrt_vars.discovered);
@@ -129,8 +132,7 @@ owerror_t rrt_receive(
             }
 
             // reset packet payload
-            msg->payload = &(msg->packet[127]);
-            msg->length = 0;
+            packetfunctions_resetPayload(msg);
 
             //set the CoAP header
             coap_header->Code = COAP_CODE_RESP_CONTENT;
@@ -139,8 +141,7 @@ owerror_t rrt_receive(
 
             break;
         case COAP_CODE_REQ_DELETE:
-            msg->payload = &(msg->packet[127]);
-            msg->length = 0;
+            packetfunctions_resetPayload(msg);
 
             //unregister the current mote as 'discovered' by ringmaster
             rrt_vars.discovered = 0;
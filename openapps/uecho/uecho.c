@@ -6,7 +6,11 @@
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define uecho_sock MOTE_CTX_VAR(sock_udp_t, uecho_sock)
+#else
 sock_udp_t uecho_sock;
+#endif
 
 //=========================== prototypes ======================================
 
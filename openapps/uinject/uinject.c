@@ -63,9 +63,10 @@ void uinject_init(void) {
     // start periodic timer
     uinject_vars.period = UINJECT_PERIOD_MS;
     uinject_vars.timerId = opentimers_create(TIMER_GENERAL_PURPOSE, TASKPRIO_UDP);
-    opentimers_scheduleIn(
+    opentimers_scheduleInWithSlack(
             uinject_vars.timerId,
             UINJECT_PERIOD_MS,
+            OPENTIMERS_SLACK(UINJECT_PERIOD_MS),
             TIME_MS,
             TIMER_PERIODIC,
             _uinject_timer_cb
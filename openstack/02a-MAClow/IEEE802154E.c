@@ -49,14 +49,25 @@ END_PACK
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define ieee154e_vars         MOTE_CTX_VAR(ieee154eVars_t, ieee154e_vars)
+#define ieee154e_status_entry MOTE_CTX_VAR(ieee154eStatusEntry_t, ieee154e_status_entry)
+#define ieee154e_status_ctx   MOTE_CTX_VAR(ieee154eStatusCtx_t, ieee154e_status_ctx)
+#else
 ieee154eVars_t ieee154e_vars;
 ieee154eStatusEntry_t ieee154e_status_entry;
 ieee154eStatusCtx_t ieee154e_status_ctx;
+#endif
 
 #if PYTHON_BOARD
+#if BOARD_MULTI_MOTE_ENABLED
+#define passed_msgBarrier MOTE_CTX_VAR(bool, passed_msgBarrier)
+#define passed_ackBarrier MOTE_CTX_VAR(bool, passed_ackBarrier)
+#else
 bool passed_msgBarrier;
 bool passed_ackBarrier;
 #endif
+#endif
 
 //=========================== prototypes ======================================
 
@@ -174,6 +185,16 @@ void updateStats(PORT_SIGNED_INT_WIDTH timeCorrection);
 // misc
 uint8_t calculateFrequency(uint8_t channelOffset);
 
+uint8_t calculateFrequencyAt(uint8_t asnOffset, uint8_t channelOffset);
+
+void prepareSlotPlan(void);
+
+owerror_t prepareLocalCopy(void);
+
+#if OPENWSN_IEEE802154E_SECURITY_C
+void task_ieee154eSecureAhead(void);
+#endif
+
 void changeState(ieee154eState_t newstate);
 
 void endSlot(void);
@@ -206,6 +227,13 @@ void ieee154e_init(void) {
     memset(&ieee154e_vars, 0, sizeof(ieee154eVars_t));
     memset(&ieee154e_status_ctx, 0, sizeof(ieee154eStatusCtx_t));
 
+    ieee154e_vars.localCopyForTransmission.packet = ieee154e_vars.localCopyBuffer;
+    ieee154e_vars.localCopyForTransmission.packet_size = sizeof(ieee154e_vars.localCopyBuffer);
+#if OPENWSN_IEEE802154E_SECURITY_C
+    ieee154e_vars.securedFrame.copy.packet = ieee154e_vars.securedFrame.buffer;
+    ieee154e_vars.securedFrame.copy.packet_size = sizeof(ieee154e_vars.securedFrame.buffer);
+#endif
+
     // set singleChannel to 0 to enable channel hopping.
 #if IEEE802154E_SINGLE_CHANNEL
     ieee154e_vars.singleChannel     = IEEE802154E_SINGLE_CHANNEL;
@@ -835,7 +863,7 @@ port_INLINE void activity_synchronize_endOfFrame(PORT_TIMER_WIDTH capturedTime)
         ieee154e_vars.dataReceived->payload = &(ieee154e_vars.dataReceived->packet[FIRST_FRAME_BYTE]);
         radio_getReceivedFrame(ieee154e_vars.dataReceived->payload,
                                (uint8_t *) &ieee154e_vars.dataReceived->length,
-                               sizeof(ieee154e_vars.dataReceived->packet),
+                               ieee154e_vars.dataReceived->packet_size,
                                &ieee154e_vars.dataReceived->l1_rssi,
                                &ieee154e_vars.dataReceived->l1_lqi,
                                &ieee154e_vars.dataReceived->l1_crc);
@@ -979,7 +1007,8 @@ port_INLINE bool ieee154e_processIEs(OpenQueueEntry_t *pkt, uint16_t *lenIE) {
 
 port_INLINE void activity_ti1ORri1(void) {
     cellType_t cellType;
-    open_addr_t neighbor;
+    open_addr_t *neighbor;
+    slotinfo_element_t info;
     uint32_t i;
     uint8_t asn[5];
     uint8_t join_priority;
@@ -1041,8 +1070,23 @@ port_INLINE void activity_ti1ORri1(void) {
         // advance the schedule
         schedule_advanceSlot();
 
+        // the plan prepared at the end of the previous active slot holds as long as the schedule did not change
+        if (
+                ieee154e_vars.slotPlan.isValid == FALSE ||
+                ieee154e_vars.slotPlan.slotOffset != ieee154e_vars.slotOffset ||
+                ieee154e_vars.slotPlan.asnOffset != ieee154e_vars.asnOffset ||
+                ieee154e_vars.slotPlan.scheduleVersion != schedule_getVersion()
+                ) {
+            schedule_getCurrentSlotInfo(ieee154e_vars.slotOffset, &info);
+            ieee154e_vars.slotPlan.type = info.link_type;
+            ieee154e_vars.slotPlan.isShared = info.shared;
+            memcpy(&ieee154e_vars.slotPlan.neighbor, &info.address, sizeof(open_addr_t));
+            ieee154e_vars.slotPlan.freq = calculateFrequency(info.channelOffset);
+        }
+        ieee154e_vars.slotPlan.isValid = FALSE;
+
         // calculate the frequency to transmit on
-        ieee154e_vars.freq = calculateFrequency(schedule_getChannelOffset());
+        ieee154e_vars.freq = ieee154e_vars.slotPlan.freq;
 
         // find the next one
         ieee154e_vars.nextActiveSlotOffset = schedule_getNextActiveSlotOffset();
@@ -1078,34 +1122,34 @@ port_INLINE void activity_ti1ORri1(void) {
         return;
     }
 
-    // check the schedule to see what type of slot this is
-    cellType = schedule_getType();
+    // check the plan to see what type of slot this is
+    cellType = ieee154e_vars.slotPlan.type;
     switch (cellType) {
         case CELLTYPE_TXRX:
         case CELLTYPE_TX:
             // assuming that there is nothing to send
             ieee154e_vars.dataToSend = NULL;
             // get the neighbor
-            schedule_getNeighbor(&neighbor);
+            neighbor = &ieee154e_vars.slotPlan.neighbor;
 
             // check whether we can send
             if (schedule_getOkToSend()) {
-                if (packetfunctions_isBroadcastMulticast(&neighbor) == FALSE) {
+                if (packetfunctions_isBroadcastMulticast(neighbor) == FALSE) {
 
                     // look for a unicast packet to send
-                    ieee154e_vars.dataToSend = openqueue_macGetUnicastPacket(&neighbor);
+                    ieee154e_vars.dataToSend = openqueue_macGetUnicastPacket(neighbor);
 
                     if (ieee154e_vars.dataToSend == NULL) {
-                        ieee154e_vars.dataToSend = openqueue_macGetKaPacket(&neighbor);
+                        ieee154e_vars.dataToSend = openqueue_macGetKaPacket(neighbor);
                     }
 
-                    if (schedule_getShared() == FALSE) {
+                    if (ieee154e_vars.slotPlan.isShared == FALSE) {
                         // update numCellElapsed and numCellUsed on managed Tx cell
                         if (ieee154e_vars.dataToSend != NULL) {
                             ieee154e_vars.dataToSend->l2_sendOnTxCell = TRUE;
-                            msf_updateCellsUsed(&neighbor, CELLTYPE_TX);
+                            msf_updateCellsUsed(neighbor, CELLTYPE_TX);
                         }
-                        msf_updateCellsElapsed(&neighbor, CELLTYPE_TX);
+                        msf_updateCellsElapsed(neighbor, CELLTYPE_TX);
                     }
                 } else {
                     // this is minimal cell
@@ -1142,17 +1186,11 @@ port_INLINE void activity_ti1ORri1(void) {
                 // 1. schedule timer for loading packet
                 sctimer_scheduleActionIn(ACTION_LOAD_PACKET, ieee154e_vars.startOfSlotReference+DURATION_tt1);
                 // prepare the packet for load packet action at DURATION_tt1
-                // make a local copy of the frame
-                packetfunctions_duplicatePacket(&ieee154e_vars.localCopyForTransmission, ieee154e_vars.dataToSend);
-
-                // check if packet needs to be encrypted/authenticated before transmission
-                if (ieee154e_vars.localCopyForTransmission.l2_securityLevel != IEEE154_ASH_SLF_TYPE_NOSEC) { // security enabled
-                    // encrypt in a local copy
-                    if (IEEE802154_security_outgoingFrameSecurity(&ieee154e_vars.localCopyForTransmission) != E_SUCCESS) {
-                        // keep the frame in the OpenQueue in order to retry later
-                        endSlot(); // abort
-                        return;
-                    }
+                // make a local copy of the frame, encrypted/authenticated if needed
+                if (prepareLocalCopy() != E_SUCCESS) {
+                    // keep the frame in the OpenQueue in order to retry later
+                    endSlot(); // abort
+                    return;
                 }
 
                 // add 2 CRC bytes only to the local copy as we end up here for each retransmission
@@ -1242,17 +1280,11 @@ port_INLINE void activity_ti2(void) {
             TIME_TICS,                                        // timetype
             isr_ieee154e_timer                                // callback
     );
-    // make a local copy of the frame
-    packetfunctions_duplicatePacket(&ieee154e_vars.localCopyForTransmission, ieee154e_vars.dataToSend);
-
-    // check if packet needs to be encrypted/authenticated before transmission
-    if (ieee154e_vars.localCopyForTransmission.l2_securityLevel != IEEE154_ASH_SLF_TYPE_NOSEC) { // security enabled
-        // encrypt in a local copy
-        if (IEEE802154_security_outgoingFrameSecurity(&ieee154e_vars.localCopyForTransmission) != E_SUCCESS) {
-            // keep the frame in the OpenQueue in order to retry later
-            endSlot(); // abort
-            return;
-        }
+    // make a local copy of the frame, encrypted/authenticated if needed
+    if (prepareLocalCopy() != E_SUCCESS) {
+        // keep the frame in the OpenQueue in order to retry later
+        endSlot(); // abort
+        return;
     }
 
     // add 2 CRC bytes only to the local copy as we end up here for each retransmission
@@ -1623,7 +1655,7 @@ port_INLINE void activity_ti9(PORT_TIMER_WIDTH capturedTime) {
         radio_getReceivedFrame(
                 ieee154e_vars.ackReceived->payload,
                 (uint8_t *) &ieee154e_vars.ackReceived->length,
-                sizeof(ieee154e_vars.ackReceived->packet),
+                ieee154e_vars.ackReceived->packet_size,
                 &ieee154e_vars.ackReceived->l1_rssi,
                 &ieee154e_vars.ackReceived->l1_lqi,
                 &ieee154e_vars.ackReceived->l1_crc
@@ -1870,7 +1902,7 @@ port_INLINE void activity_ri5(PORT_TIMER_WIDTH capturedTime) {
         radio_getReceivedFrame(
                 ieee154e_vars.dataReceived->payload,
                 (uint8_t *) &ieee154e_vars.dataReceived->length,
-                sizeof(ieee154e_vars.dataReceived->packet),
+                ieee154e_vars.dataReceived->packet_size,
                 &ieee154e_vars.dataReceived->l1_rssi,
                 &ieee154e_vars.dataReceived->l1_lqi,
                 &ieee154e_vars.dataReceived->l1_crc
@@ -2551,6 +2583,12 @@ bool isValidEbFormat(OpenQueueEntry_t *pkt, uint16_t *lenIE) {
                     break;
                 case IEEE802154E_MLME_TIMESLOT_IE_SUBID:
                     timeslotTemplateIDStoreFromEB(*((uint8_t *) (pkt->payload) + ptr));
+#if IEEE802154E_STRICT_TSTEMPLATE
+                    if (ieee154e_vars.tsTemplateId != TIMESLOT_TEMPLATE_ID) {
+                        // the timing is fixed at build time, do not join a network using another template
+                        return FALSE;
+                    }
+#endif
                     tsTemplate_checkpass = TRUE;
                     break;
                 case IEEE802154E_MLME_SLOTFRAME_LINK_IE_SUBID:
@@ -2577,6 +2615,7 @@ bool isValidEbFormat(OpenQueueEntry_t *pkt, uint16_t *lenIE) {
                             channeloffset |= *((uint8_t *) (pkt->payload + ptr + 5 + 5 * i + 3)) << 8;
 
                             schedule_addActiveSlot(
+                                    SCHEDULE_MINIMAL_6TISCH_DEFAULT_SLOTFRAME_HANDLE, // slotframe
                                     slotoffset,    // slot offset
                                     CELLTYPE_TXRX, // type of slot
                                     TRUE,          // shared?
@@ -2854,14 +2893,174 @@ different channel offsets in the same slot.
 \returns The calculated frequency channel, an integer between 11 and 26.
 */
 port_INLINE uint8_t calculateFrequency(uint8_t channelOffset) {
+    return calculateFrequencyAt(ieee154e_vars.asnOffset, channelOffset);
+}
+
+port_INLINE uint8_t calculateFrequencyAt(uint8_t asnOffset, uint8_t channelOffset) {
     if (ieee154e_vars.singleChannel >= 11 && ieee154e_vars.singleChannel <= 26) {
         return ieee154e_vars.singleChannel; // single channel
     } else {
         // channel hopping enabled, use the channel depending on hopping template
-        return 11 + ieee154e_vars.chTemplate[(ieee154e_vars.asnOffset + channelOffset) % NUM_CHANNELS];
+        return 11 + ieee154e_vars.chTemplate[(asnOffset + channelOffset) % NUM_CHANNELS];
+    }
+}
+
+/**
+\brief Prepare what to do in the next active slot, so that the start of that slot only reads the plan.
+
+Called at the end of each slot, outside of the time-critical part of the slot. The packet to send is still picked at
+the start of the slot, as the queue keeps changing until then.
+*/
+void prepareSlotPlan(void) {
+    slotinfo_element_t info;
+    frameLength_t frameLength;
+    slotOffset_t nextActiveSlotOffset;
+    uint16_t numSlots;
+    uint16_t carry;
+    uint8_t i;
+
+    if (
+            ieee154e_vars.slotPlan.isValid &&
+            ieee154e_vars.slotPlan.scheduleVersion == schedule_getVersion()
+            ) {
+        // the plan is up to date
+        return;
+    }
+    ieee154e_vars.slotPlan.isValid = FALSE;
+
+    frameLength = schedule_getFrameLength();
+    if (ieee154e_vars.isSync == FALSE || frameLength == 0) {
+        return;
+    }
+
+    ieee154e_vars.slotPlan.scheduleVersion = schedule_getVersion();
+    if (schedule_getNextSlotInfo(&info) == FALSE) {
+        // the start of the slot will look at the schedule
+        return;
+    }
+
+    // number of slots until the next active slot, a full slotframe if it is the current slot offset
+    nextActiveSlotOffset = schedule_getNextActiveSlotOffset();
+    numSlots = (nextActiveSlotOffset + frameLength - ieee154e_vars.slotOffset) % frameLength;
+    if (numSlots == 0) {
+        numSlots = frameLength;
     }
+
+    ieee154e_vars.slotPlan.slotOffset = nextActiveSlotOffset;
+    ieee154e_vars.slotPlan.asnOffset = (ieee154e_vars.asnOffset + numSlots) % NUM_CHANNELS;
+    ieee154e_getAsn(ieee154e_vars.slotPlan.asn);
+    carry = numSlots;
+    for (i = 0; i < sizeof(ieee154e_vars.slotPlan.asn) && carry != 0; i++) {
+        carry += ieee154e_vars.slotPlan.asn[i];
+        ieee154e_vars.slotPlan.asn[i] = carry & 0xff;
+        carry >>= 8;
+    }
+    ieee154e_vars.slotPlan.type = info.link_type;
+    ieee154e_vars.slotPlan.isShared = info.shared;
+    memcpy(&ieee154e_vars.slotPlan.neighbor, &info.address, sizeof(open_addr_t));
+    ieee154e_vars.slotPlan.freq = calculateFrequencyAt(ieee154e_vars.slotPlan.asnOffset, info.channelOffset);
+    ieee154e_vars.slotPlan.isValid = TRUE;
 }
 
+/**
+\brief Make localCopyForTransmission a copy of the frame to send, secured for the current slot if needed.
+
+The copy secured at the end of the previous slot is used when it was made from the same packet, for this ASN and with
+the current keys. Anything else is secured here, inside the slot.
+*/
+owerror_t prepareLocalCopy(void) {
+#if OPENWSN_IEEE802154E_SECURITY_C
+    ieee154eSecuredFrame_t *secured;
+    uint8_t asn[5];
+
+    secured = &ieee154e_vars.securedFrame;
+    ieee154e_getAsn(asn);
+
+    if (
+            secured->isValid &&
+            secured->packet == ieee154e_vars.dataToSend &&
+            secured->dsn == ieee154e_vars.dataToSend->l2_dsn &&
+            secured->keyVersion == IEEE802154_security_getKeyVersion() &&
+            memcmp(secured->asn, asn, sizeof(asn)) == 0
+            ) {
+        secured->isValid = FALSE;
+        packetfunctions_duplicatePacket(&ieee154e_vars.localCopyForTransmission, &secured->copy);
+        return E_SUCCESS;
+    }
+    secured->isValid = FALSE;
+#endif
+
+    packetfunctions_duplicatePacket(&ieee154e_vars.localCopyForTransmission, ieee154e_vars.dataToSend);
+
+    // check if packet needs to be encrypted/authenticated before transmission
+    if (ieee154e_vars.localCopyForTransmission.l2_securityLevel != IEEE154_ASH_SLF_TYPE_NOSEC) { // security enabled
+        // encrypt in a local copy
+        return IEEE802154_security_outgoingFrameSecurity(&ieee154e_vars.localCopyForTransmission);
+    }
+
+    return E_SUCCESS;
+}
+
+#if OPENWSN_IEEE802154E_SECURITY_C
+/**
+\brief Secure the frame the next active slot will most likely send, for the ASN of that slot.
+
+Posted at the end of each slot, after the next active slot is planned. The packet is looked up as the start of the
+slot does, without consuming a share of the queue. EBs are left out, the start of the slot writes their ASN. If the
+slot ends up sending something else, prepareLocalCopy() secures it inline.
+*/
+void task_ieee154eSecureAhead(void) {
+    ieee154eSecuredFrame_t *secured;
+    OpenQueueEntry_t *pkt;
+    uint8_t asn[5];
+    uint8_t keyVersion;
+
+    INTERRUPT_DECLARATION();
+
+    secured = &ieee154e_vars.securedFrame;
+
+    DISABLE_INTERRUPTS();
+    secured->isTaskPending = FALSE;
+    secured->isValid = FALSE;
+
+    pkt = NULL;
+    if (
+            ieee154e_vars.state == S_SLEEP &&
+            ieee154e_vars.slotPlan.isValid &&
+            (ieee154e_vars.slotPlan.type == CELLTYPE_TX || ieee154e_vars.slotPlan.type == CELLTYPE_TXRX)
+            ) {
+        if (packetfunctions_isBroadcastMulticast(&ieee154e_vars.slotPlan.neighbor) == FALSE) {
+            pkt = openqueue_macPeekUnicastPacket(&ieee154e_vars.slotPlan.neighbor);
+            if (pkt == NULL) {
+                pkt = openqueue_macGetKaPacket(&ieee154e_vars.slotPlan.neighbor);
+            }
+        } else {
+            pkt = openqueue_macGetDIOPacket();
+        }
+    }
+    memcpy(asn, ieee154e_vars.slotPlan.asn, sizeof(asn));
+    ENABLE_INTERRUPTS();
+
+    if (pkt == NULL || pkt->l2_securityLevel == IEEE154_ASH_SLF_TYPE_NOSEC) {
+        return;
+    }
+
+    keyVersion = IEEE802154_security_getKeyVersion();
+    packetfunctions_duplicatePacket(&secured->copy, pkt);
+    if (IEEE802154_security_outgoingFrameSecurityAt(&secured->copy, asn) != E_SUCCESS) {
+        return;
+    }
+
+    DISABLE_INTERRUPTS();
+    secured->packet = pkt;
+    secured->dsn = pkt->l2_dsn;
+    memcpy(secured->asn, asn, sizeof(asn));
+    secured->keyVersion = keyVersion;
+    secured->isValid = TRUE;
+    ENABLE_INTERRUPTS();
+}
+#endif
+
 /**
 \brief Changes the state of the IEEE802.15.4e FSM.
 
@@ -2921,7 +3120,6 @@ will do that for you, but assume that something went wrong.
 */
 void endSlot(void) {
 
-    open_addr_t slotNeighbor;
     open_addr_t parentAddress;
     slotinfo_element_t info;
 
@@ -2996,7 +3194,7 @@ void endSlot(void) {
         ieee154e_vars.dataToSend = NULL;
     }
 
-    schedule_getSlotInfo(ieee154e_vars.slotOffset, &info);
+    schedule_getCurrentSlotInfo(ieee154e_vars.slotOffset, &info);
     if (info.link_type == CELLTYPE_RX) {
         // update numcellelapsed and numcellused on Rx cell
 
@@ -3054,18 +3252,15 @@ void endSlot(void) {
     }
 
     // check if this is auto tx cell
-    if (
-            schedule_getSlottOffset() == ieee154e_vars.slotOffset &&
-            schedule_getIsAutoCell() && schedule_getType() == CELLTYPE_TX
-            ) {
+    if (info.isAutoCell && info.link_type == CELLTYPE_TX) {
         // check if there are unicast packets to the neighbor of this slot if not, remove the cell
-        schedule_getNeighbor(&slotNeighbor);
-        if (openqueue_macGetUnicastPacket(&slotNeighbor) == NULL) {
+        if (openqueue_macHasUnicastPacket(&info.address) == FALSE) {
             schedule_removeActiveSlot(
-                    ieee154e_vars.slotOffset,
+                    info.slotframeID,
+                    info.slotOffset,
                     CELLTYPE_TX,
                     TRUE,
-                    &slotNeighbor
+                    &info.address
             );
         }
     }
@@ -3073,6 +3268,21 @@ void endSlot(void) {
     // change state
     changeState(S_SLEEP);
 
+    // get ready for the next active slot
+    prepareSlotPlan();
+
+#if OPENWSN_IEEE802154E_SECURITY_C
+    // secure the frame of the next active slot outside of that slot
+    if (
+            ieee154e_vars.slotPlan.isValid &&
+            ieee154e_vars.securedFrame.isTaskPending == FALSE &&
+            (ieee154e_vars.slotPlan.type == CELLTYPE_TX || ieee154e_vars.slotPlan.type == CELLTYPE_TXRX)
+            ) {
+        ieee154e_vars.securedFrame.isTaskPending = TRUE;
+        scheduler_push_task(task_ieee154eSecureAhead, TASKPRIO_SIXTOP_NOTIF_TXDONE);
+    }
+#endif
+
     // arm serialInhibit timer (if we are still BEFORE DURATION_si)
     if (ieee154e_vars.isSync == TRUE) {
         opentimers_scheduleAbsolute(
@@ -156,49 +156,96 @@ typedef enum {
     S_RXPROC = 0x19,            // processing received data
 } ieee154eState_t;
 
-#define  TIMESLOT_TEMPLATE_ID         0x00
 #define  CHANNELHOPPING_TEMPLATE_ID   0x00
 
-// Atomic durations
-// expressed in 32kHz ticks:
-//    - ticks = duration_in_seconds * 32768
-//    - duration_in_seconds = ticks / 32768
+// timeslot templates, advertised in the timeslot IE of the EBs
+#define IEEE802154E_TIMESLOT_TEMPLATE_10MS      0x00    // IEEE802.15.4 default timeslot template
+#define IEEE802154E_TIMESLOT_TEMPLATE_20MS      0x01
+#define IEEE802154E_TIMESLOT_TEMPLATE_160MS     0x02
 
-enum ieee154e_atomicdurations_enum {
-// time-slot related
+// IEEE802.15.4 TsMaxTx and TsMaxAck at 250kbps: air time of the longest frame and of the longest ACK
+#define IEEE802154E_MAXTX_US                    4256
+#define IEEE802154E_MAXACK_US                   2400
+
+// Timeslot template of the SLOTDURATION of the board, in us
+// The TS_* timings are shared by both ends of a link, which only agree on them through the template ID of the EBs, so
+// they are a fixed table rather than derived from the delays of the board. The checks below verify that the board
+// fits in them. The WD_* watchdogs are local to the mote.
 #if SLOTDURATION == 10
-    TsTxOffset = (2120 / PORT_US_PER_TICK),                  //  2120us
-    TsLongGT = (1100 / PORT_US_PER_TICK),                  //  1100us
-    TsTxAckDelay = (1000 / PORT_US_PER_TICK),                  //  1000us
-    TsShortGT = (500 /
-                 PORT_US_PER_TICK),                  //  500us, The standardlized value for this is 400/2=200us(7ticks). Currectly 7 doesn't work for short packet, change it back to 7 when found the problem.
-    wdRadioTx = (1342 /
-                 PORT_US_PER_TICK),                  //  1000us (needs to be >delayTx) (SCuM need a larger value, 45 is tested and works)
-    wdDataDuration = (5000 / PORT_US_PER_TICK),                  //  5000us (measured 4280us with max payload)
-    wdAckDuration = (3000 / PORT_US_PER_TICK),                  //  3000us (measured 1000us)
+#define SLOTDURATION_TEMPLATE_ID    IEEE802154E_TIMESLOT_TEMPLATE_10MS
+#define TS_TX_OFFSET_US             2120
+#define TS_LONG_GT_US               1100
+#define TS_TX_ACK_DELAY_US          1000
+#define TS_SHORT_GT_US              500     // The standardlized value for this is 400/2=200us(7ticks). Currectly 7 doesn't work for short packet, change it back to 7 when found the problem.
+#define WD_RADIO_TX_US              1342    // needs to be >delayTx (SCuM need a larger value, 45 is tested and works)
+#define WD_DATA_DURATION_US         5000    // measured 4280us with max payload
+#define WD_ACK_DURATION_US          3000    // measured 1000us
+#elif SLOTDURATION == 20
+#define SLOTDURATION_TEMPLATE_ID    IEEE802154E_TIMESLOT_TEMPLATE_20MS
+#define TS_TX_OFFSET_US             5215
+#define TS_LONG_GT_US               1311
+#define TS_TX_ACK_DELAY_US          5521
+#define TS_SHORT_GT_US              700
+#define WD_RADIO_TX_US              1342    // needs to be >delayTx (SCuM need a larger value, 45 is tested and works)
+#define WD_DATA_DURATION_US         5000    // measured 4280us with max payload
+#define WD_ACK_DURATION_US          3000    // measured 1000us
+#elif SLOTDURATION == 160
+#define SLOTDURATION_TEMPLATE_ID    IEEE802154E_TIMESLOT_TEMPLATE_160MS
+#define TS_TX_OFFSET_US             10986   // 360 ticks
+#define TS_LONG_GT_US               7324    // 240 ticks
+#define TS_TX_ACK_DELAY_US          11047   // 362 ticks
+#define TS_SHORT_GT_US              1831    // 60 ticks
+#define WD_RADIO_TX_US              7019    // 230 ticks, delayTx+Tx time for 10 bytes (needs to be >delayTx)
+#define WD_DATA_DURATION_US         81238   // 2662 ticks (measured with max payload)
+#define WD_ACK_DURATION_US          18310   // 600 ticks (measured)
+#else
+#error "no timeslot template for this SLOTDURATION, supported values are 10, 20 and 160 ms"
 #endif
 
-#if SLOTDURATION == 20
-    TsTxOffset                =  (5215/PORT_US_PER_TICK),                  //  5215us
-    TsLongGT                  =  (1311/PORT_US_PER_TICK),                  //  1311us
-    TsTxAckDelay              =  (5521/PORT_US_PER_TICK),                  //  5521us
-    TsShortGT                 =   (700/PORT_US_PER_TICK),                  //   700us
-    wdRadioTx                 =  (1342/PORT_US_PER_TICK),                  //  1000us (needs to be >delayTx) (SCuM need a larger value, 45 is tested and works)
-    wdDataDuration            =  (5000/PORT_US_PER_TICK),                  //  5000us (measured 4280us with max payload)
-    wdAckDuration             =  (3000/PORT_US_PER_TICK),                  //  3000us (measured 1000us)
+// template ID advertised in the EBs, without IEEE802154E_STRICT_TSTEMPLATE every slot duration advertises the default
+#if IEEE802154E_STRICT_TSTEMPLATE
+#define TIMESLOT_TEMPLATE_ID        SLOTDURATION_TEMPLATE_ID
+#else
+#define TIMESLOT_TEMPLATE_ID        IEEE802154E_TIMESLOT_TEMPLATE_10MS
 #endif
 
-#if SLOTDURATION == 160
-    TsTxOffset                =  (10986/PORT_US_PER_TICK),                 //    360 ticks, 10986us
-    TsLongGT                  =  (7324/PORT_US_PER_TICK),                  //    240 ticks, 7324us
-    TsTxAckDelay              =  (11047/PORT_US_PER_TICK),                 //    362 ticks, 11047us
-    TsShortGT                 =  (1831/PORT_US_PER_TICK),                  //    60 ticksz 1831us
-    // radio watchdog
-    wdRadioTx                 =  (7019/PORT_US_PER_TICK),                  //    230 ticks  7019us delayTx+Tx time for 10 bytes( (needs to be >delayTx) (SCuM need a larger value, 45 is tested and works)
-    wdDataDuration            =  (81238/PORT_US_PER_TICK),                 //    2662 ticks  81238us (measured with max payload)
-    wdAckDuration             =  (18310/PORT_US_PER_TICK),                 //    600 ticks 18310us (measured)
+// the longest frame and its ACK fit in the timeslot
+#if TS_TX_OFFSET_US + IEEE802154E_MAXTX_US + TS_TX_ACK_DELAY_US + IEEE802154E_MAXACK_US > SLOTDURATION * 1000
+#error "the timeslot template does not fit the longest frame and its ACK"
+#endif
+
+// the board prepares the radio between the events of the timeslot (see the DURATION_* macros)
+#if TS_TX_OFFSET_US / PORT_US_PER_TICK <= PORT_delayTx + PORT_maxTxDataPrepare
+#error "TS_TX_OFFSET_US is too short for the Tx preparation of the board"
+#endif
+#if (TS_TX_OFFSET_US - TS_LONG_GT_US) / PORT_US_PER_TICK <= PORT_delayRx + PORT_maxRxDataPrepare
+#error "TS_TX_OFFSET_US is too short for the Rx preparation of the board"
+#endif
+#if TS_TX_ACK_DELAY_US / PORT_US_PER_TICK <= PORT_delayTx + PORT_maxTxAckPrepare
+#error "TS_TX_ACK_DELAY_US is too short for the ACK Tx preparation of the board"
+#endif
+#if (TS_TX_ACK_DELAY_US - TS_SHORT_GT_US) / PORT_US_PER_TICK <= PORT_delayRx + PORT_maxRxAckPrepare
+#error "TS_TX_ACK_DELAY_US is too short for the ACK Rx preparation of the board"
+#endif
+#if WD_RADIO_TX_US / PORT_US_PER_TICK <= PORT_delayTx
+#error "WD_RADIO_TX_US must be larger than the Tx delay of the board"
 #endif
 
+// Atomic durations
+// expressed in 32kHz ticks:
+//    - ticks = duration_in_seconds * 32768
+//    - duration_in_seconds = ticks / 32768
+
+enum ieee154e_atomicdurations_enum {
+// time-slot related
+    TsTxOffset = (TS_TX_OFFSET_US / PORT_US_PER_TICK),
+    TsLongGT = (TS_LONG_GT_US / PORT_US_PER_TICK),
+    TsTxAckDelay = (TS_TX_ACK_DELAY_US / PORT_US_PER_TICK),
+    TsShortGT = (TS_SHORT_GT_US / PORT_US_PER_TICK),
+    wdRadioTx = (WD_RADIO_TX_US / PORT_US_PER_TICK),
+    wdDataDuration = (WD_DATA_DURATION_US / PORT_US_PER_TICK),
+    wdAckDuration = (WD_ACK_DURATION_US / PORT_US_PER_TICK),
+
     TsSlotDuration = PORT_TsSlotDuration,
     // execution speed related
     maxTxDataPrepare = PORT_maxTxDataPrepare,
@@ -249,6 +296,33 @@ typedef struct {
     PORT_SIGNED_INT_WIDTH timeCorrection;
 } ieee154eHt_t;
 
+// what to do in the next active slot, prepared at the end of the previous one
+typedef struct {
+    bool isValid;                                   // TRUE until the planned slot starts
+    uint16_t scheduleVersion;                       // schedule version the plan was prepared from
+    slotOffset_t slotOffset;                        // slot offset of the planned slot
+    uint8_t asnOffset;                              // asnOffset of the planned slot
+    uint8_t asn[5];                                 // ASN of the planned slot, as returned by ieee154e_getAsn()
+    cellType_t type;                                // type of the cell
+    bool isShared;                                  // whether the cell is shared
+    open_addr_t neighbor;                           // neighbor of the cell
+    uint8_t freq;                                   // frequency of the planned slot
+} ieee154eSlotPlan_t;
+
+#if OPENWSN_IEEE802154E_SECURITY_C
+// frame secured ahead of the slot it is planned to be sent in
+typedef struct {
+    bool isValid;                                   // TRUE while the copy can be sent as is
+    bool isTaskPending;                             // whether securing the next frame is already scheduled
+    OpenQueueEntry_t *packet;                       // queue entry the copy was made from
+    uint8_t dsn;                                    // sequence number of that entry, in case it got recycled
+    uint8_t asn[5];                                 // ASN the nonce of the copy was built with
+    uint8_t keyVersion;                             // version of the keys the copy was secured with
+    OpenQueueEntry_t copy;                          // the secured copy
+    uint8_t buffer[PACKET_BUFFER_SIZE];             // buffer of the secured copy
+} ieee154eSecuredFrame_t;
+#endif
+
 //=========================== module variables ================================
 
 typedef struct {
@@ -256,9 +330,14 @@ typedef struct {
     asn_t asn;                                      // current absolute slot number
     slotOffset_t slotOffset;                        // current slot offset
     slotOffset_t nextActiveSlotOffset;              // next active slot offset
+    ieee154eSlotPlan_t slotPlan;                    // plan of the next active slot
     PORT_TIMER_WIDTH deSyncTimeout;                 // how many slots left before looses sync
     bool isSync;                                    // TRUE iff mote is synchronized to network
     OpenQueueEntry_t localCopyForTransmission;      // copy of the frame used for current TX
+    uint8_t localCopyBuffer[PACKET_BUFFER_SIZE];    // buffer of localCopyForTransmission
+#if OPENWSN_IEEE802154E_SECURITY_C
+    ieee154eSecuredFrame_t securedFrame;            // frame of the next active slot, secured at the end of this one
+#endif
     PORT_TIMER_WIDTH numOfSleepSlots;               // number of slots to sleep between active slots
     // as shown on the chronogram
     ieee154eState_t state;                         // state of the FSM
@@ -22,7 +22,11 @@
 //=============================define==========================================
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define ieee802154_security_vars MOTE_CTX_VAR(ieee802154_security_vars_t, ieee802154_security_vars)
+#else
 ieee802154_security_vars_t ieee802154_security_vars;
+#endif
 
 //========= common functions regardless of whether L2SEC is used or not =======
 // following 7 functions are also called when L2SEC is not used. This is to facilitate
@@ -43,11 +47,11 @@ void IEEE802154_security_init(void) {
 
     // invalidate beacon key (key 1)
     ieee802154_security_vars.k1.index = IEEE802154_SECURITY_KEYINDEX_INVALID;
-    memset(&ieee802154_security_vars.k1.value[0], 0x00, 16);
+    memset(&ieee802154_security_vars.k1.ctx, 0x00, sizeof(aes128_ctx_t));
 
     // invalidate data key (key 2)
     ieee802154_security_vars.k2.index = IEEE802154_SECURITY_KEYINDEX_INVALID;
-    memset(&ieee802154_security_vars.k2.value[0], 0x00, 16);
+    memset(&ieee802154_security_vars.k2.ctx, 0x00, sizeof(aes128_ctx_t));
 }
 
 uint8_t IEEE802154_security_getBeaconKeyIndex(void) {
@@ -60,12 +64,23 @@ uint8_t IEEE802154_security_getDataKeyIndex(void) {
 
 void IEEE802154_security_setBeaconKey(uint8_t index, uint8_t *value) {
     ieee802154_security_vars.k1.index = index;
-    memcpy(ieee802154_security_vars.k1.value, value, 16);
+    aes128_set_key(&ieee802154_security_vars.k1.ctx, value);
+    ieee802154_security_vars.keyVersion++;
 }
 
 void IEEE802154_security_setDataKey(uint8_t index, uint8_t *value) {
     ieee802154_security_vars.k2.index = index;
-    memcpy(ieee802154_security_vars.k2.value, value, 16);
+    aes128_set_key(&ieee802154_security_vars.k2.ctx, value);
+    ieee802154_security_vars.keyVersion++;
+}
+
+/**
+\brief Version of the keys, changes every time a key is set.
+
+Frames secured ahead of time are only valid as long as the version they were secured with is current.
+*/
+uint8_t IEEE802154_security_getKeyVersion(void) {
+    return ieee802154_security_vars.keyVersion;
 }
 
 bool IEEE802154_security_isConfigured(void) {
@@ -128,7 +143,8 @@ owerror_t IEEE802154_security_prependAuxiliarySecurityHeader(OpenQueueEntry_t *m
         case IEEE154_ASH_KEYIDMODE_DEFAULTKEYSOURCE: // macDefaultKeySource
             break;
         case IEEE154_ASH_KEYIDMODE_EXPLICIT_16: // keySource with 16b address
-            temp_keySource = &msg->l2_keySource;
+            // the keys are my own, so is the key source
+            temp_keySource = idmanager_getMyID(ADDR_64B);
             if (packetfunctions_reserveHeader(&msg, sizeof(uint8_t)) == E_FAIL) {
                 return E_FAIL;
             }
@@ -139,7 +155,7 @@ owerror_t IEEE802154_security_prependAuxiliarySecurityHeader(OpenQueueEntry_t *m
             *((uint8_t * )(msg->payload)) = temp_keySource->addr_type.addr_64b[7];
             break;
         case IEEE154_ASH_KEYIDMODE_EXPLICIT_64: // keySource with 64b address
-            temp_keySource = &msg->l2_keySource;
+            temp_keySource = idmanager_getMyID(ADDR_64B);
             if (packetfunctions_writeAddress(&msg, temp_keySource, OW_LITTLE_ENDIAN) == E_FAIL) {
                 return E_FAIL;
             }
@@ -168,25 +184,38 @@ owerror_t IEEE802154_security_prependAuxiliarySecurityHeader(OpenQueueEntry_t *m
 }
 
 /**
-\brief Key searching and encryption/authentication operations.
+\brief Key searching and encryption/authentication operations, for a frame sent in the current slot.
 */
 owerror_t IEEE802154_security_outgoingFrameSecurity(OpenQueueEntry_t *msg) {
+    uint8_t asn[5];
+
+    ieee154e_getAsn(asn);
+    return IEEE802154_security_outgoingFrameSecurityAt(msg, asn);
+}
+
+/**
+\brief Key searching and encryption/authentication operations, for a frame sent in the slot with the given ASN.
+
+\param[in,out] msg The frame to secure, in place.
+\param[in]     asn The ASN of the slot the frame will be sent in, least significant byte first (see ieee154e_getAsn()).
+*/
+owerror_t IEEE802154_security_outgoingFrameSecurityAt(OpenQueueEntry_t *msg, const uint8_t *asn) {
     uint8_t nonce[13];
-    uint8_t *key;
+    aes128_ctx_t *key;
     owerror_t outStatus;
     uint8_t *a;
     uint8_t len_a;
     uint8_t *m;
     uint8_t len_m;
 
-    key = msg->l2_frameType == IEEE154_TYPE_BEACON ? ieee802154_security_vars.k1.value
-                                                   : ieee802154_security_vars.k2.value;
+    key = msg->l2_frameType == IEEE154_TYPE_BEACON ? &ieee802154_security_vars.k1.ctx
+                                                   : &ieee802154_security_vars.k2.ctx;
 
     // First 8 bytes of the nonce are always the source address of the frame
     memcpy(&nonce[0], idmanager_getMyID(ADDR_64B)->addr_type.addr_64b, 8);
 
     // Fill last 5 bytes with the ASN part of the nonce
-    ieee154e_getAsn(&nonce[8]);
+    memcpy(&nonce[8], asn, 5);
     packetfunctions_reverseArrayByteOrder(&nonce[8], 5);  // reverse ASN bytes to big endian
 
     // identify data to be authenticated and data to be encrypted
@@ -230,14 +259,14 @@ owerror_t IEEE802154_security_outgoingFrameSecurity(OpenQueueEntry_t *msg) {
 
     // Encryption and/or authentication
     // cryptoengine overwrites m[] with ciphertext and appends the MIC
-    outStatus = aes128_ccms_enc(a,
-                                len_a,
-                                m,
-                                &len_m,
-                                nonce,
-                                2, // L=2 in 15.4 std
-                                key,
-                                msg->l2_authenticationLength);
+    outStatus = aes128_ccms_enc_ctx(a,
+                                    len_a,
+                                    m,
+                                    &len_m,
+                                    nonce,
+                                    2, // L=2 in 15.4 std
+                                    key,
+                                    msg->l2_authenticationLength);
 
     // verify that no errors occurred
     if (outStatus != E_SUCCESS) {
@@ -304,25 +333,16 @@ void IEEE802154_security_retrieveAuxiliarySecurityHeader(OpenQueueEntry_t *msg,
 
     }
 
-    //retrieve the Key Identifier field
+    //skip the Key Source field, keys are looked up by their index only
     switch (msg->l2_keyIdMode) {
         case IEEE154_ASH_KEYIDMODE_IMPLICIT:
         case IEEE154_ASH_KEYIDMODE_DEFAULTKEYSOURCE:
             //key is derived implicitly
-            memcpy(&(msg->l2_keySource), &tempheader->src, sizeof(open_addr_t));
             break;
         case IEEE154_ASH_KEYIDMODE_EXPLICIT_16:
-            packetfunctions_readAddress(((uint8_t * )(msg->payload) + tempheader->headerLength),
-                                        ADDR_16B,
-                                        &msg->l2_keySource,
-                                        OW_LITTLE_ENDIAN);
             tempheader->headerLength += 2;
             break;
         case IEEE154_ASH_KEYIDMODE_EXPLICIT_64:
-            packetfunctions_readAddress(((uint8_t * )(msg->payload) + tempheader->headerLength),
-                                        ADDR_64B,
-                                        &msg->l2_keySource,
-                                        OW_LITTLE_ENDIAN);
             tempheader->headerLength += 8;
             break;
         default: //error
@@ -351,10 +371,10 @@ owerror_t IEEE802154_security_incomingFrame(OpenQueueEntry_t *msg) {
     uint8_t len_a;
     uint8_t *c;
     uint8_t len_c;
-    uint8_t *key;
+    aes128_ctx_t *key;
 
-    key = msg->l2_frameType == IEEE154_TYPE_BEACON ? ieee802154_security_vars.k1.value
-                                                   : ieee802154_security_vars.k2.value;
+    key = msg->l2_frameType == IEEE154_TYPE_BEACON ? &ieee802154_security_vars.k1.ctx
+                                                   : &ieee802154_security_vars.k2.ctx;
 
     // First 8 bytes of the nonce are always the source address of the frame
     memcpy(&nonce[0], msg->l2_nextORpreviousHop.addr_type.addr_64b, 8);
@@ -395,14 +415,14 @@ owerror_t IEEE802154_security_incomingFrame(OpenQueueEntry_t *msg) {
     }
 
     // decrypt and/or verify authenticity of the frame
-    outStatus = aes128_ccms_dec(a,
-                                len_a,
-                                c,
-                                &len_c,
-                                nonce,
-                                2,
-                                key,
-                                msg->l2_authenticationLength);
+    outStatus = aes128_ccms_dec_ctx(a,
+                                    len_a,
+                                    c,
+                                    &len_c,
+                                    nonce,
+                                    2,
+                                    key,
+                                    msg->l2_authenticationLength);
 
     // verify if any error occurs
     if (outStatus != E_SUCCESS) {
@@ -562,6 +582,13 @@ owerror_t IEEE802154_security_outgoingFrameSecurity(OpenQueueEntry_t *msg) {
     return E_SUCCESS;
 }
 
+owerror_t IEEE802154_security_outgoingFrameSecurityAt(OpenQueueEntry_t *msg, const uint8_t *asn) {
+    (void) msg;
+    (void) asn;
+
+    return E_SUCCESS;
+}
+
 owerror_t IEEE802154_security_incomingFrame(OpenQueueEntry_t *msg) {
     (void) msg;
 
@@ -21,6 +21,7 @@
 #include "config.h"
 #include "opendefs.h"
 #include "IEEE802154.h"
+#include "aes128.h"
 
 //=========================== define ==========================================
 
@@ -51,7 +52,7 @@
 
 typedef struct {
     uint8_t index;
-    uint8_t value[16];
+    aes128_ctx_t ctx;   // key value and its expanded schedule, refreshed whenever the key is set
 } symmetric_key_802154_t;
 
 //=========================== variables =======================================
@@ -61,6 +62,7 @@ typedef struct {
     bool joinPermitted;
     symmetric_key_802154_t k1;
     symmetric_key_802154_t k2;
+    uint8_t keyVersion;     // incremented every time k1 or k2 is set
 } ieee802154_security_vars_t;
 
 //=========================== prototypes ======================================
@@ -73,6 +75,8 @@ void IEEE802154_security_retrieveAuxiliarySecurityHeader(OpenQueueEntry_t *msg,
 
 owerror_t IEEE802154_security_outgoingFrameSecurity(OpenQueueEntry_t *msg);
 
+owerror_t IEEE802154_security_outgoingFrameSecurityAt(OpenQueueEntry_t *msg, const uint8_t *asn);
+
 owerror_t IEEE802154_security_incomingFrame(OpenQueueEntry_t *msg);
 
 uint8_t IEEE802154_security_authLengthChecking(uint8_t securityLevel);
@@ -90,6 +94,8 @@ void IEEE802154_security_setBeaconKey(uint8_t index, uint8_t *value);
 
 void IEEE802154_security_setDataKey(uint8_t index, uint8_t *value);
 
+uint8_t IEEE802154_security_getKeyVersion(void);
+
 uint8_t IEEE802154_security_getSecurityLevel(OpenQueueEntry_t *msg);
 
 bool IEEE802154_security_acceptableLevel(OpenQueueEntry_t *msg, ieee802154_header_iht *parsedHeader);
@@ -28,7 +28,11 @@
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define adaptive_sync_vars MOTE_CTX_VAR(adaptive_sync_vars_t, adaptive_sync_vars)
+#else
 adaptive_sync_vars_t adaptive_sync_vars;
+#endif
 
 //=========================== public ==========================================
 
@@ -0,0 +1,118 @@
+/**
+\brief Estimation of the ETX of a link, from the acknowledgements of the frames sent over it.
+
+\author agent <agent@local>, October 2026.
+*/
+
+#include "opendefs.h"
+#include "linkest.h"
+
+//=========================== variables =======================================
+
+//=========================== prototypes ======================================
+
+//=========================== public ==========================================
+
+/**
+\brief Start estimating a link.
+
+\param[in] estimate The estimate to initialize.
+\param[in] etx The ETX the link is assumed to have until it is sampled, see linkest_bootstrapEtx().
+*/
+void linkest_init(linkest_t *estimate, uint16_t etx) {
+    estimate->etx = etx;
+    estimate->numSamples = 0;
+    estimate->pendingTx = 0;
+}
+
+/**
+\brief Guess the ETX of a link which was not sampled yet.
+
+The guess is pessimistic: the ETX is interpolated between LINKEST_ETX_DEFAULT and LINKEST_ETX_POOR over the range
+[LINKEST_RSSI_POOR - LINKEST_RSSI_GOOD], so a strong RSSI only ranks a link ahead of the weaker unsampled ones. It only
+seeds the estimate, the first samples quickly take over (see linkest_indicateTx()).
+
+\param[in] rssi The RSSI the neighbor was heard with, in dBm.
+
+\returns The ETX to initialize the estimate with.
+*/
+uint16_t linkest_bootstrapEtx(int8_t rssi) {
+    if (rssi >= LINKEST_RSSI_GOOD) {
+        return LINKEST_ETX_DEFAULT;
+    }
+    if (rssi <= LINKEST_RSSI_POOR) {
+        return LINKEST_ETX_POOR;
+    }
+    return (uint16_t) (LINKEST_ETX_DEFAULT +
+                       ((uint32_t) (LINKEST_RSSI_GOOD - rssi) * (LINKEST_ETX_POOR - LINKEST_ETX_DEFAULT)) /
+                       (LINKEST_RSSI_GOOD - LINKEST_RSSI_POOR));
+}
+
+/**
+\brief Indicate some transmission attempts over the link.
+
+Each acknowledged frame gives one sample: the number of attempts since the previous sample. Every
+LINKEST_MAX_TX_PER_SAMPLE attempts without an ACK give a sample of LINKEST_ETX_MAX, so the ETX of a link which went
+dead keeps growing until the link reaches the maximum cost.
+
+Samples are weighted by LINKEST_ALPHA. While there are few samples, each one weighs as much as all previous ones
+together (the bootstrap value counting as one), so the estimate does not lag behind the bootstrap value.
+
+\param[in] estimate The estimate of the link.
+\param[in] numTxAttempts Number of attempts made.
+\param[in] wasAcked TRUE if the last attempt was acknowledged.
+
+\returns TRUE if the ETX was updated.
+*/
+bool linkest_indicateTx(linkest_t *estimate, uint8_t numTxAttempts, bool wasAcked) {
+    uint8_t weight;
+    uint32_t sample;
+
+    if (numTxAttempts > LINKEST_MAX_TX_PER_SAMPLE - estimate->pendingTx) {
+        estimate->pendingTx = LINKEST_MAX_TX_PER_SAMPLE;
+    } else {
+        estimate->pendingTx += numTxAttempts;
+    }
+
+    if (estimate->pendingTx == 0 || (wasAcked == FALSE && estimate->pendingTx < LINKEST_MAX_TX_PER_SAMPLE)) {
+        return FALSE;
+    }
+
+    // weight of the sample, in 1/16th
+    if ((uint16_t) (estimate->numSamples + 2) * LINKEST_ALPHA < 16) {
+        weight = 16 / (estimate->numSamples + 2);
+    } else {
+        weight = LINKEST_ALPHA;
+    }
+
+    if (wasAcked) {
+        sample = (uint32_t) estimate->pendingTx * LINKEST_ETX_ONE;
+    } else {
+        sample = LINKEST_ETX_MAX;
+    }
+    estimate->etx = (uint16_t) (((uint32_t) estimate->etx * (16 - weight) + sample * weight) >> 4);
+
+    estimate->pendingTx = 0;
+    if (estimate->numSamples < 0xff) {
+        estimate->numSamples++;
+    }
+
+    return TRUE;
+}
+
+uint16_t linkest_getEtx(const linkest_t *estimate) {
+    return estimate->etx;
+}
+
+uint8_t linkest_getNumSamples(const linkest_t *estimate) {
+    return estimate->numSamples;
+}
+
+/**
+\brief Indicate whether the estimate is based on enough samples to act upon, see LINKEST_MIN_SAMPLES.
+*/
+bool linkest_isConfident(const linkest_t *estimate) {
+    return estimate->numSamples >= LINKEST_MIN_SAMPLES;
+}
+
+//=========================== private =========================================
@@ -0,0 +1,62 @@
+#ifndef OPENWSN_LINKEST_H
+#define OPENWSN_LINKEST_H
+
+/**
+\addtogroup MAChigh
+\{
+\addtogroup LinkEst
+\{
+*/
+
+#include "opendefs.h"
+
+//=========================== define ==========================================
+
+#ifndef DEFAULTLINKCOST
+#define DEFAULTLINKCOST             4       // ETX assumed for a link until it was sampled often enough
+#endif
+
+#define LINKEST_ETX_ONE             256     // ETX of a link which never loses a frame, ETX is kept in 1/256th
+#define LINKEST_ETX_DEFAULT         (DEFAULTLINKCOST * LINKEST_ETX_ONE)
+#define LINKEST_ETX_MAX             0xffff  // sample of attempts which all went unacknowledged
+#define LINKEST_MAX_TX_PER_SAMPLE   16      // attempts without ACK after which the link is sampled anyway
+
+// bootstrap of a link which was not sampled yet, from the RSSI it was heard with
+#define LINKEST_RSSI_GOOD           (-60)   // dBm, links at least this strong start at LINKEST_ETX_DEFAULT
+#define LINKEST_RSSI_POOR           (-80)   // dBm, links at most this strong start at LINKEST_ETX_POOR
+#define LINKEST_ETX_POOR            (2 * LINKEST_ETX_DEFAULT)
+
+//=========================== typedef =========================================
+
+/**
+\brief Estimate of the expected number of transmissions (ETX) over a link.
+
+The ETX is an exponentially weighted moving average of the number of attempts it took to get each frame
+acknowledged. Its confidence is the number of samples it is based on.
+*/
+typedef struct {
+    uint16_t etx;                   // in 1/LINKEST_ETX_ONE
+    uint8_t numSamples;             // saturates at 0xff
+    uint8_t pendingTx;              // attempts since the last sample
+} linkest_t;
+
+//=========================== prototypes ======================================
+
+void linkest_init(linkest_t *estimate, uint16_t etx);
+
+uint16_t linkest_bootstrapEtx(int8_t rssi);
+
+bool linkest_indicateTx(linkest_t *estimate, uint8_t numTxAttempts, bool wasAcked);
+
+uint16_t linkest_getEtx(const linkest_t *estimate);
+
+uint8_t linkest_getNumSamples(const linkest_t *estimate);
+
+bool linkest_isConfident(const linkest_t *estimate);
+
+/**
+\}
+\}
+*/
+
+#endif /* OPENWSN_LINKEST_H */
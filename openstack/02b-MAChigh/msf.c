@@ -20,8 +20,13 @@ typedef struct {
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define msf_vars       MOTE_CTX_VAR(msfVars_t, msf_vars)
+#define msf_status_ctx MOTE_CTX_VAR(msfStatus_t, msf_status_ctx)
+#else
 msfVars_t msf_vars;
 msfStatus_t msf_status_ctx;
+#endif
 
 //=========================== prototypes ======================================
 
@@ -68,6 +73,7 @@ void msf_init(void) {
     memset(&temp_neighbor, 0, sizeof(temp_neighbor));
     temp_neighbor.type = ADDR_ANYCAST;
     schedule_addActiveSlot(
+            SCHEDULE_MINIMAL_6TISCH_DEFAULT_SLOTFRAME_HANDLE,                // slotframe
             msf_hashFunction_getSlotoffset(idmanager_getMyID(ADDR_64B)),     // slot offset
             CELLTYPE_RX,                                                     // type of slot
             FALSE,                                                           // shared?
@@ -76,11 +82,19 @@ void msf_init(void) {
             &temp_neighbor                                                   // neighbor
     );
 
+#if MSF_SLOTFRAME_LENGTH
+    // negotiate the cells in a slotframe of their own, aligned with the ASN once synchronized
+    if (schedule_addSlotframe(MSF_SLOTFRAME_ID, MSF_SLOTFRAME_LENGTH) == E_SUCCESS) {
+        msf_setSlotframe(MSF_SLOTFRAME_ID);
+    }
+#endif
+
     msf_vars.housekeepingTimerId = opentimers_create(TIMER_GENERAL_PURPOSE, TASKPRIO_MSF);
     msf_vars.housekeepingPeriod = HOUSEKEEPING_PERIOD;
-    opentimers_scheduleIn(
+    opentimers_scheduleInWithSlack(
             msf_vars.housekeepingTimerId,
             openrandom_getRandomizePeriod(msf_vars.housekeepingPeriod, msf_vars.housekeepingPeriod),
+            OPENTIMERS_SLACK(msf_vars.housekeepingPeriod),
             TIME_MS,
             TIMER_PERIODIC,
             msf_timer_housekeeping_cb
@@ -197,7 +211,7 @@ uint8_t msf_getsfid(void) {
 }
 
 uint16_t msf_getMetadata(void) {
-    return SCHEDULE_MINIMAL_6TISCH_DEFAULT_SLOTFRAME_HANDLE;
+    return msf_vars.slotframeID;
 }
 
 metadata_t msf_translateMetadata(void) {
@@ -410,8 +424,8 @@ bool msf_candidateAddCellList(
     memset(cellList, 0, CELLLIST_MAX_LEN * sizeof(cellInfo_ht));
     numCandCells = 0;
     for (i = 0; i < CELLLIST_MAX_LEN; i++) {
-        slotoffset = openrandom_get16b() % schedule_getFrameLength();
-        if (schedule_isSlotOffsetAvailable(slotoffset) == TRUE) {
+        slotoffset = openrandom_get16b() % schedule_getSlotframeLength(msf_vars.slotframeID);
+        if (schedule_isSlotOffsetAvailable(msf_vars.slotframeID, slotoffset) == TRUE) {
             cellList[numCandCells].slotoffset = slotoffset;
             cellList[numCandCells].channeloffset = openrandom_get16b() & 0x0F;
             cellList[numCandCells].isUsed = TRUE;
@@ -432,14 +446,14 @@ bool msf_candidateRemoveCellList(
         uint8_t requiredCells,
         uint8_t cellOptions
 ) {
-    uint8_t i;
+    frameLength_t i;
     uint8_t numCandCells;
     slotinfo_element_t info;
 
     memset(cellList, 0, CELLLIST_MAX_LEN * sizeof(cellInfo_ht));
     numCandCells = 0;
-    for (i = 0; i < schedule_getFrameLength(); i++) {
-        schedule_getSlotInfo(i, &info);
+    for (i = 0; i < schedule_getSlotframeLength(msf_vars.slotframeID); i++) {
+        schedule_getSlotInfo(msf_vars.slotframeID, i, &info);
         if (
                 packetfunctions_sameAddress(neighbor, &(info.address)) &&
                 info.link_type == cellOptions &&
@@ -507,12 +521,8 @@ void msf_housekeeping(void) {
         return;
     }
 
-    if (schedule_isNumTxWrapped(&parentNeighbor) == FALSE) {
-        return;
-    }
-
     memset(celllist_delete, 0, CELLLIST_MAX_LEN * sizeof(cellInfo_ht));
-    if (schedule_getCellsToBeRelocated(&parentNeighbor, celllist_delete)) {
+    if (schedule_getCellsToBeRelocated(msf_vars.slotframeID, &parentNeighbor, celllist_delete)) {
         if (msf_candidateAddCellList(celllist_add, NUMCELLS_MSF) == FALSE) {
             // failed to get cell list to add
             return;
@@ -558,6 +568,20 @@ bool msf_getHashCollisionFlag(void) {
     return msf_vars.f_hashCollision;
 }
 
+/**
+\brief Negotiate cells in another slotframe than the minimal one.
+
+The slotframe must have been added with schedule_addSlotframe(). Cells already negotiated in the previous slotframe
+are left in place.
+*/
+void msf_setSlotframe(uint8_t slotframeID) {
+    if (schedule_getSlotframeLength(slotframeID) == 0) {
+        LOG_ERROR(COMPONENT_MSF, ERR_INVALID_PARAM, (errorparameter_t) slotframeID, 0);
+        return;
+    }
+    msf_vars.slotframeID = slotframeID;
+}
+
 uint8_t msf_getPreviousNumCellsUsed(cellType_t cellType) {
     switch (cellType) {
         case CELLTYPE_TX:
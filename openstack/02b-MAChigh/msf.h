@@ -40,6 +40,12 @@
 #define WAITDURATION_MIN             30000 // miliseconds
 #define WAITDURATION_RANDOM_RANGE    30000 // miliseconds
 
+#define MSF_SLOTFRAME_ID                 1 // slotframe installed when MSF_SLOTFRAME_LENGTH is set
+
+#if MSF_SLOTFRAME_LENGTH < 0 || MSF_SLOTFRAME_LENGTH > SLOTFRAME_LENGTH
+#error "MSF_SLOTFRAME_LENGTH must be in the range [0 - SLOTFRAME_LENGTH]."
+#endif
+
 //=========================== typedef =========================================
 
 typedef struct {
@@ -57,6 +63,7 @@ typedef struct {
     bool needAddRx;
     bool needDeleteTx;
     bool needDeleteRx;
+    uint8_t slotframeID;                // slotframe holding the negotiated cells
     // for msf status report
     uint8_t previousNumCellsUsed_tx;
     uint8_t previousNumCellsUsed_rx;
@@ -103,6 +110,8 @@ bool msf_getHashCollisionFlag(void);
 
 uint8_t msf_getPreviousNumCellsUsed(cellType_t cellType);
 
+void msf_setSlotframe(uint8_t slotframeID);
+
 /**
 \}
 \}
@@ -6,6 +6,7 @@
 #include "IEEE802154E.h"
 #include "openrandom.h"
 #include "msf.h"
+#include "schedule.h"
 
 //=========================== typedefs ========================================
 
@@ -22,8 +23,13 @@ typedef struct {
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define neighbors_vars       MOTE_CTX_VAR(neighborsVars_t, neighbors_vars)
+#define neighbors_status_ctx MOTE_CTX_VAR(neighborStatus_t, neighbors_status_ctx)
+#else
 neighborsVars_t neighbors_vars;
 neighborStatus_t neighbors_status_ctx;
+#endif
 
 //=========================== prototypes ======================================
 
@@ -38,7 +44,17 @@ bool isNeighbor(const open_addr_t *neighbor);
 
 void removeNeighbor(uint8_t neighborIndex);
 
-bool isThisRowMatching(const open_addr_t *address, uint8_t rowNumber);
+static uint8_t neighbors_findRow(const open_addr_t *address);
+
+static uint64_t neighbors_keyOf(const open_addr_t *address);
+
+static uint8_t neighbors_lookupHome(uint64_t key);
+
+static void neighbors_lookupInsert(uint8_t row);
+
+static void neighbors_lookupRemove(uint8_t row);
+
+static void neighbors_updatePathCost(uint8_t index);
 
 // debug
 static bool statusPrint_neighbors(void);
@@ -52,6 +68,9 @@ void neighbors_init(void) {
     // clear module variables
     // The .used fields get reset to FALSE by this memset.
     memset(&neighbors_vars, 0, sizeof(neighborsVars_t));
+    memset(neighbors_vars.lookup, NEIGHBORS_LOOKUP_EMPTY, sizeof(neighbors_vars.lookup));
+    // no row is a candidate parent, MAXDAGRANK everywhere
+    memset(neighbors_vars.pathCost, 0xff, sizeof(neighbors_vars.pathCost));
 
     neighbors_status_ctx.statusNeighborEntries.id = STATUS_NEIGHBORS;
     neighbors_status_ctx.statusNeighborEntries.statusPrint_cb = statusPrint_neighbors;
@@ -90,6 +109,21 @@ uint8_t neighbors_getNumTx(uint8_t index) {
     return neighbors_vars.neighbors[index].numTx;
 }
 
+/**
+\brief Retrieve the rank this mote would have with some neighbor as parent.
+
+The cost is the neighbor's rank plus the link metric to it, kept up to date as either changes, so reading it does not
+recompute the link metric.
+
+\param[in] index The index of the neighbor in the neighbor table.
+
+\returns The path cost through that neighbor, MAXDAGRANK if it is not in use, not stable, out of 6P resources or
+   has not advertised a rank yet.
+*/
+uint16_t neighbors_getPathCost(uint8_t index) {
+    return neighbors_vars.pathCost[index];
+}
+
 /**
 \brief Find neighbor to which to send KA.
 
@@ -157,13 +191,28 @@ bool neighbors_getNeighborNoResource(uint8_t index) {
 
 uint8_t neighbors_getSequenceNumber(open_addr_t *address) {
     uint8_t i;
-    for (i = 0; i < MAXNUMNEIGHBORS; i++) {
-        if (packetfunctions_sameAddress(address, &neighbors_vars.neighbors[i].addr)) {
-            break;
-        }
+
+    i = neighbors_findRow(address);
+    if (i == MAXNUMNEIGHBORS) {
+        return 0;
     }
     return neighbors_vars.neighbors[i].sequenceNumber;
+}
+
+/**
+\brief Retrieve the index of a neighbor in the neighbor table.
 
+The index of a neighbor does not change for as long as it stays in the table, it can be cached and passed to the
+functions taking an index instead of looking the address up again.
+
+\param[in]  address The 64-bit address of the neighbor.
+\param[out] index   The index of that neighbor.
+
+\returns TRUE if the neighbor is in the table, FALSE otherwise.
+*/
+bool neighbors_getIndex(open_addr_t *address, uint8_t *index) {
+    *index = neighbors_findRow(address);
+    return *index != MAXNUMNEIGHBORS;
 }
 
 //===== interrogators
@@ -196,12 +245,9 @@ bool neighbors_isStableNeighbor(open_addr_t *address) {
             return returnVal;
     }
 
-    // iterate through neighbor table
-    for (i = 0; i < MAXNUMNEIGHBORS; i++) {
-        if (isThisRowMatching(&temp_addr_64b, i) && neighbors_vars.neighbors[i].stableNeighbor == TRUE) {
-            returnVal = TRUE;
-            break;
-        }
+    i = neighbors_findRow(&temp_addr_64b);
+    if (i != MAXNUMNEIGHBORS && neighbors_vars.neighbors[i].stableNeighbor == TRUE) {
+        returnVal = TRUE;
     }
 
     return returnVal;
@@ -243,12 +289,9 @@ bool neighbors_isInsecureNeighbor(open_addr_t *address) {
             return returnVal;
     }
 
-    // iterate through neighbor table
-    for (i = 0; i < MAXNUMNEIGHBORS; i++) {
-        if (isThisRowMatching(address, i)) {
-            returnVal = neighbors_vars.neighbors[i].insecure;
-            break;
-        }
+    i = neighbors_findRow(address);
+    if (i != MAXNUMNEIGHBORS) {
+        returnVal = neighbors_vars.neighbors[i].insecure;
     }
 
     return returnVal;
@@ -274,10 +317,16 @@ bool neighbors_isNeighborWithHigherDAGrank(uint8_t index) {
     return returnVal;
 }
 
+/**
+\brief Indicate whether the link to some neighbor was sampled often enough to be trusted, see LINKEST_MIN_SAMPLES.
+*/
 bool neighbors_reachedMinimalTransmission(uint8_t index) {
     bool returnVal;
 
-    if (neighbors_vars.neighbors[index].used == TRUE && neighbors_vars.neighbors[index].numTx > MINIMAL_NUM_TX) {
+    if (
+            neighbors_vars.neighbors[index].used == TRUE &&
+            linkest_isConfident(&neighbors_vars.linkEstimate[index])
+            ) {
         returnVal = TRUE;
     } else {
         returnVal = FALSE;
@@ -317,53 +366,52 @@ void neighbors_indicateRx(open_addr_t *l2_src,
                           bool insecure) {
     uint8_t i;
     bool newNeighbor;
+    bool wasStable;
 
     // update existing neighbor
-    newNeighbor = TRUE;
-    for (i = 0; i < MAXNUMNEIGHBORS; i++) {
-        if (isThisRowMatching(l2_src, i)) {
-
-            // this is not a new neighbor
-            newNeighbor = FALSE;
-
-            // whether the neighbor is considered as secure or not
-            neighbors_vars.neighbors[i].insecure = insecure;
-
-            // update numRx, rssi, asn
-            neighbors_vars.neighbors[i].numRx++;
-            neighbors_vars.neighbors[i].rssi = rssi;
-            memcpy(&neighbors_vars.neighbors[i].asn, asnTs, sizeof(asn_t));
-
-            //update jp
-            if (joinPrioPresent == TRUE) {
-                neighbors_vars.neighbors[i].joinPrio = joinPrio;
-            }
+    i = neighbors_findRow(l2_src);
+    newNeighbor = (i == MAXNUMNEIGHBORS);
+    if (newNeighbor == FALSE) {
+        // whether the neighbor is considered as secure or not
+        neighbors_vars.neighbors[i].insecure = insecure;
+
+        // update numRx, rssi, asn
+        neighbors_vars.neighbors[i].numRx++;
+        neighbors_vars.neighbors[i].rssi = rssi;
+        memcpy(&neighbors_vars.neighbors[i].asn, asnTs, sizeof(asn_t));
+
+        //update jp
+        if (joinPrioPresent == TRUE) {
+            neighbors_vars.neighbors[i].joinPrio = joinPrio;
+        }
 
-            // update stableNeighbor, switchStabilityCounter
-            if (neighbors_vars.neighbors[i].stableNeighbor == FALSE) {
-                if (neighbors_vars.neighbors[i].rssi > BADNEIGHBORMAXRSSI) {
-                    neighbors_vars.neighbors[i].switchStabilityCounter++;
-                    if (neighbors_vars.neighbors[i].switchStabilityCounter >= SWITCHSTABILITYTHRESHOLD) {
-                        neighbors_vars.neighbors[i].switchStabilityCounter = 0;
-                        neighbors_vars.neighbors[i].stableNeighbor = TRUE;
-                    }
-                } else {
+        // update stableNeighbor, switchStabilityCounter
+        wasStable = neighbors_vars.neighbors[i].stableNeighbor;
+        if (neighbors_vars.neighbors[i].stableNeighbor == FALSE) {
+            if (neighbors_vars.neighbors[i].rssi > BADNEIGHBORMAXRSSI) {
+                neighbors_vars.neighbors[i].switchStabilityCounter++;
+                if (neighbors_vars.neighbors[i].switchStabilityCounter >= SWITCHSTABILITYTHRESHOLD) {
                     neighbors_vars.neighbors[i].switchStabilityCounter = 0;
+                    neighbors_vars.neighbors[i].stableNeighbor = TRUE;
                 }
-            } else if (neighbors_vars.neighbors[i].stableNeighbor == TRUE) {
-                if (neighbors_vars.neighbors[i].rssi < GOODNEIGHBORMINRSSI) {
-                    neighbors_vars.neighbors[i].switchStabilityCounter++;
-                    if (neighbors_vars.neighbors[i].switchStabilityCounter >= SWITCHSTABILITYTHRESHOLD) {
-                        neighbors_vars.neighbors[i].switchStabilityCounter = 0;
-                        neighbors_vars.neighbors[i].stableNeighbor = FALSE;
-                    }
-                } else {
+            } else {
+                neighbors_vars.neighbors[i].switchStabilityCounter = 0;
+            }
+        } else if (neighbors_vars.neighbors[i].stableNeighbor == TRUE) {
+            if (neighbors_vars.neighbors[i].rssi < GOODNEIGHBORMINRSSI) {
+                neighbors_vars.neighbors[i].switchStabilityCounter++;
+                if (neighbors_vars.neighbors[i].switchStabilityCounter >= SWITCHSTABILITYTHRESHOLD) {
                     neighbors_vars.neighbors[i].switchStabilityCounter = 0;
+                    neighbors_vars.neighbors[i].stableNeighbor = FALSE;
                 }
+            } else {
+                neighbors_vars.neighbors[i].switchStabilityCounter = 0;
             }
+        }
 
-            // stop looping
-            break;
+        // only stable neighbors are candidate parents
+        if (neighbors_vars.neighbors[i].stableNeighbor != wasStable) {
+            neighbors_updatePathCost(i);
         }
     }
 
@@ -383,6 +431,9 @@ The fields which are updated are:
 - numTx
 - numTxACK
 - asn
+- the ETX estimate of the link
+
+numTx and numTxACK are only kept for the status reported over serial, the link metric is based on the ETX estimate.
 
 \param[in] l2_dest MAC destination address of the packet, i.e. the neighbor
    who I just sent the packet to.
@@ -398,63 +449,62 @@ void neighbors_indicateTx(open_addr_t *l2_dest, uint8_t numTxAttempts, bool sent
         return;
     }
 
-    // loop through neighbor table
-    for (i = 0; i < MAXNUMNEIGHBORS; i++) {
-        if (isThisRowMatching(l2_dest, i)) {
-            // found the target neighbor
-
-            // reset backoff variable
-            neighbors_vars.neighbors[i].backoffExponenton = MINBE - 1;
-            neighbors_vars.neighbors[i].backoff = 0;
+    // look up the target neighbor
+    i = neighbors_findRow(l2_dest);
+    if (i == MAXNUMNEIGHBORS) {
+        return;
+    }
 
-            // update asn if ack'ed
-            if (wasAcked == TRUE) {
-                memcpy(&neighbors_vars.neighbors[i].asn, asnTs, sizeof(asn_t));
-            }
+    // reset backoff variable
+    neighbors_vars.neighbors[i].backoffExponenton = MINBE - 1;
+    neighbors_vars.neighbors[i].backoff = 0;
 
-            // only update numTx/numTxAck on Tx cell
-            if (sentOnTxCell) {
-                if (neighbors_vars.neighbors[i].numTx > (0xff - numTxAttempts)) {
-                    neighbors_vars.neighbors[i].numWraps++; //counting the number of times that tx wraps.
-                    neighbors_vars.neighbors[i].numTx /= 2;
-                    neighbors_vars.neighbors[i].numTxACK /= 2;
-                }
-                // update statistics
-                neighbors_vars.neighbors[i].numTx += numTxAttempts;
+    // update asn if ack'ed
+    if (wasAcked == TRUE) {
+        memcpy(&neighbors_vars.neighbors[i].asn, asnTs, sizeof(asn_t));
+    }
 
-                if (wasAcked == TRUE) {
-                    neighbors_vars.neighbors[i].numTxACK++;
-                }
+    // only update the link statistics on Tx cell
+    if (sentOnTxCell) {
+        if (neighbors_vars.neighbors[i].numTx > (0xff - numTxAttempts)) {
+            neighbors_vars.neighbors[i].numWraps++; //counting the number of times that tx wraps.
+            neighbors_vars.neighbors[i].numTx /= 2;
+            neighbors_vars.neighbors[i].numTxACK /= 2;
+        }
+        // update statistics
+        neighbors_vars.neighbors[i].numTx += numTxAttempts;
 
-                // numTx and numTxAck changed,, update my rank
-                icmpv6rpl_updateMyDAGrankAndParentSelection();
-            }
-            break;
+        if (wasAcked == TRUE) {
+            neighbors_vars.neighbors[i].numTxACK++;
         }
+        if (linkest_indicateTx(&neighbors_vars.linkEstimate[i], numTxAttempts, wasAcked)) {
+            neighbors_updatePathCost(i);
+        }
+
+        // statistics changed, update my rank
+        icmpv6rpl_updateMyDAGrankAndParentSelection();
     }
 }
 
 void neighbors_updateSequenceNumber(open_addr_t *address) {
     uint8_t i;
-    for (i = 0; i < MAXNUMNEIGHBORS; i++) {
-        if (packetfunctions_sameAddress(address, &neighbors_vars.neighbors[i].addr)) {
-            neighbors_vars.neighbors[i].sequenceNumber = (neighbors_vars.neighbors[i].sequenceNumber + 1) & 0xFF;
-            // rollover from 0xff to 0x01
-            if (neighbors_vars.neighbors[i].sequenceNumber == 0) {
-                neighbors_vars.neighbors[i].sequenceNumber = 1;
-            }
-            break;
+
+    i = neighbors_findRow(address);
+    if (i != MAXNUMNEIGHBORS) {
+        neighbors_vars.neighbors[i].sequenceNumber = (neighbors_vars.neighbors[i].sequenceNumber + 1) & 0xFF;
+        // rollover from 0xff to 0x01
+        if (neighbors_vars.neighbors[i].sequenceNumber == 0) {
+            neighbors_vars.neighbors[i].sequenceNumber = 1;
         }
     }
 }
 
 void neighbors_resetSequenceNumber(open_addr_t *address) {
     uint8_t i;
-    for (i = 0; i < MAXNUMNEIGHBORS; i++) {
-        if (packetfunctions_sameAddress(address, &neighbors_vars.neighbors[i].addr)) {
-            neighbors_vars.neighbors[i].sequenceNumber = 0;
-            break;
-        }
+
+    i = neighbors_findRow(address);
+    if (i != MAXNUMNEIGHBORS) {
+        neighbors_vars.neighbors[i].sequenceNumber = 0;
     }
 }
 
@@ -490,29 +540,25 @@ bool neighbors_getNeighborEui64(open_addr_t *address, uint8_t addr_type, uint8_t
 // ==== update backoff
 void neighbors_updateBackoff(open_addr_t *address) {
     uint8_t i;
-    for (i = 0; i < MAXNUMNEIGHBORS; i++) {
-        if (packetfunctions_sameAddress(address, &neighbors_vars.neighbors[i].addr)) {
-            // increase the backoffExponent
-            if (neighbors_vars.neighbors[i].backoffExponenton < MAXBE) {
-                neighbors_vars.neighbors[i].backoffExponenton++;
-            }
-            // set the backoff to a random value in [0..2^BE]
-            neighbors_vars.neighbors[i].backoff =
-                    openrandom_get16b() % (1 << neighbors_vars.neighbors[i].backoffExponenton);
-            break;
+
+    i = neighbors_findRow(address);
+    if (i != MAXNUMNEIGHBORS) {
+        // increase the backoffExponent
+        if (neighbors_vars.neighbors[i].backoffExponenton < MAXBE) {
+            neighbors_vars.neighbors[i].backoffExponenton++;
         }
+        // set the backoff to a random value in [0..2^BE]
+        neighbors_vars.neighbors[i].backoff =
+                openrandom_get16b() % (1 << neighbors_vars.neighbors[i].backoffExponenton);
     }
 }
 
 void neighbors_decreaseBackoff(open_addr_t *address) {
     uint8_t i;
-    for (i = 0; i < MAXNUMNEIGHBORS; i++) {
-        if (packetfunctions_sameAddress(address, &neighbors_vars.neighbors[i].addr)) {
-            if (neighbors_vars.neighbors[i].backoff > 0) {
-                neighbors_vars.neighbors[i].backoff--;
-            }
-            break;
-        }
+
+    i = neighbors_findRow(address);
+    if (i != MAXNUMNEIGHBORS && neighbors_vars.neighbors[i].backoff > 0) {
+        neighbors_vars.neighbors[i].backoff--;
     }
 }
 
@@ -520,14 +566,10 @@ bool neighbors_backoffHitZero(open_addr_t *address) {
     uint8_t i;
     bool returnVal;
 
-    returnVal = FALSE;
-    for (i = 0; i < MAXNUMNEIGHBORS; i++) {
-        if (packetfunctions_sameAddress(address, &neighbors_vars.neighbors[i].addr)) {
-            returnVal = (neighbors_vars.neighbors[i].backoff == 0);
-            break;
-        }
-    }
-    if (i == MAXNUMNEIGHBORS) {
+    i = neighbors_findRow(address);
+    if (i != MAXNUMNEIGHBORS) {
+        returnVal = (neighbors_vars.neighbors[i].backoff == 0);
+    } else {
         // The neighbor looking for is not in the table.
         // This is usually the case a packet is from downward traffic, which
         // doesn't need to be in the neighbor table.
@@ -542,12 +584,10 @@ bool neighbors_backoffHitZero(open_addr_t *address) {
 void neighbors_resetBackoff(open_addr_t *address) {
     uint8_t i;
 
-    for (i = 0; i < MAXNUMNEIGHBORS; i++) {
-        if (packetfunctions_sameAddress(address, &neighbors_vars.neighbors[i].addr)) {
-            neighbors_vars.neighbors[i].backoffExponenton = MINBE - 1;
-            neighbors_vars.neighbors[i].backoff = 0;
-            break;
-        }
+    i = neighbors_findRow(address);
+    if (i != MAXNUMNEIGHBORS) {
+        neighbors_vars.neighbors[i].backoffExponenton = MINBE - 1;
+        neighbors_vars.neighbors[i].backoff = 0;
     }
 }
 
@@ -555,19 +595,17 @@ void neighbors_resetBackoff(open_addr_t *address) {
 
 void neighbors_setNeighborRank(uint8_t index, dagrank_t rank) {
     neighbors_vars.neighbors[index].DAGrank = rank;
-
+    neighbors_updatePathCost(index);
 }
 
 void neighbors_setNeighborNoResource(open_addr_t *address) {
     uint8_t i;
 
-    // loop through neighbor table
-    for (i = 0; i < MAXNUMNEIGHBORS; i++) {
-        if (isThisRowMatching(address, i)) {
-            neighbors_vars.neighbors[i].f6PNORES = TRUE;
-            icmpv6rpl_updateMyDAGrankAndParentSelection();
-            break;
-        }
+    i = neighbors_findRow(address);
+    if (i != MAXNUMNEIGHBORS) {
+        neighbors_vars.neighbors[i].f6PNORES = TRUE;
+        neighbors_updatePathCost(i);
+        icmpv6rpl_updateMyDAGrankAndParentSelection();
     }
 }
 
@@ -585,37 +623,21 @@ This really belongs to icmpv6rpl but it would require a much more complex interf
 */
 
 uint16_t neighbors_getLinkMetric(uint8_t index) {
-    uint16_t rankIncrease;
-    uint32_t rankIncreaseIntermediary; // stores intermediary results of rankIncrease calculation
+    uint32_t rankIncrease;
+    uint16_t etx;
 
     // we assume that this neighbor has already been checked for being in use
-    // calculate link cost to this neighbor
-    if (neighbors_vars.neighbors[index].numTxACK == 0) {
-        if (neighbors_vars.neighbors[index].numTx > DEFAULTLINKCOST) {
-            if (neighbors_vars.neighbors[index].numTx < MINIMAL_NUM_TX) {
-                rankIncrease = (3 * neighbors_vars.neighbors[index].numTx - 2) * MINHOPRANKINCREASE;
-            } else {
-                rankIncrease = 65535;
-            }
-        } else {
-            rankIncrease = (3 * DEFAULTLINKCOST - 2) * MINHOPRANKINCREASE;
-        }
-    } else {
-        //6TiSCH minimal draft using OF0 for rank computation: ((3*numTx/numTxAck)-2)*minHopRankIncrease
-        // numTx is on 8 bits, so scaling up 10 bits won't lead to saturation
-        // but this <<10 followed by >>10 does not provide any benefit either. Result is the same.
-        rankIncreaseIntermediary = (((uint32_t) neighbors_vars.neighbors[index].numTx) << 10);
-        rankIncreaseIntermediary = (3 * rankIncreaseIntermediary * MINHOPRANKINCREASE) /
-                                   ((uint32_t) neighbors_vars.neighbors[index].numTxACK);
-        rankIncreaseIntermediary = rankIncreaseIntermediary - ((uint32_t) (2 * MINHOPRANKINCREASE) << 10);
-        // this could still overflow for numTx large and numTxAck small, Casting to 16 bits will yiel the least significant bits
-        if (rankIncreaseIntermediary >= (65536 << 10)) {
-            rankIncrease = 65535;
-        } else {
-            rankIncrease = (uint16_t) (rankIncreaseIntermediary >> 10);
-        }
+    // 6TiSCH minimal draft using OF0 for rank computation: ((3*ETX)-2)*minHopRankIncrease
+    etx = linkest_getEtx(&neighbors_vars.linkEstimate[index]);
+    if (linkest_isConfident(&neighbors_vars.linkEstimate[index]) == FALSE && etx < LINKEST_ETX_DEFAULT) {
+        // too few samples to tell the link is better than an unknown one
+        etx = LINKEST_ETX_DEFAULT;
+    }
+    rankIncrease = ((3 * (uint32_t) etx - 2 * LINKEST_ETX_ONE) * MINHOPRANKINCREASE) / LINKEST_ETX_ONE;
+    if (rankIncrease > 65535) {
+        rankIncrease = 65535;
     }
-    return rankIncrease;
+    return (uint16_t) rankIncrease;
 }
 
 //===== maintenance
@@ -648,7 +670,7 @@ void neighbors_removeOld(void) {
                 if (neighbors_vars.neighbors[i].f6PNORES == FALSE &&
                     neighbors_vars.neighbors[i].parentPreference == 0) {
                     // remove neighbor only when there is no packet in queue
-                    if (openqueue_macGetUnicastPacket(&(neighbors_vars.neighbors[i].addr)) == NULL) {
+                    if (openqueue_macHasUnicastPacket(&(neighbors_vars.neighbors[i].addr)) == FALSE) {
                         removeNeighbor(i);
                     }
                 }
@@ -710,12 +732,16 @@ void registerNewNeighbor(const open_addr_t *neighborID,
                 neighbors_vars.neighbors[i].stableNeighbor = TRUE;
                 neighbors_vars.neighbors[i].switchStabilityCounter = 0;
                 memcpy(&neighbors_vars.neighbors[i].addr, neighborID, sizeof(open_addr_t));
+                neighbors_lookupInsert(i);
+                schedule_indicateNeighborAdded(i, &neighbors_vars.neighbors[i].addr);
+                openqueue_indicateNeighborAdded(i);
                 neighbors_vars.neighbors[i].DAGrank = DEFAULTDAGRANK;
                 // since we don't have a DAG rank at this point, no need to call for routing table update
                 neighbors_vars.neighbors[i].rssi = rssi;
                 neighbors_vars.neighbors[i].numRx = 1;
                 neighbors_vars.neighbors[i].numTx = 0;
                 neighbors_vars.neighbors[i].numTxACK = 0;
+                linkest_init(&neighbors_vars.linkEstimate[i], linkest_bootstrapEtx(rssi));
                 memcpy(&neighbors_vars.neighbors[i].asn, asnTimestamp, sizeof(asn_t));
                 neighbors_vars.neighbors[i].backoffExponenton = MINBE - 1;;
                 neighbors_vars.neighbors[i].backoff = 0;
@@ -725,6 +751,7 @@ void registerNewNeighbor(const open_addr_t *neighborID,
                 } else {
                     neighbors_vars.neighbors[i].joinPrio = DEFAULTJOINPRIORITY;
                 }
+                neighbors_updatePathCost(i);
                 break;
             }
             i++;
@@ -739,17 +766,15 @@ void registerNewNeighbor(const open_addr_t *neighborID,
 }
 
 bool isNeighbor(const open_addr_t *neighbor) {
-    uint8_t i = 0;
-    for (i = 0; i < MAXNUMNEIGHBORS; i++) {
-        if (isThisRowMatching(neighbor, i)) {
-            return TRUE;
-        }
-    }
-    return FALSE;
+    return neighbors_findRow(neighbor) != MAXNUMNEIGHBORS;
 }
 
 void removeNeighbor(uint8_t neighborIndex) {
 
+    neighbors_lookupRemove(neighborIndex);
+    schedule_indicateNeighborRemoved(neighborIndex);
+    openqueue_indicateNeighborRemoved(neighborIndex);
+
     neighbors_vars.neighbors[neighborIndex].used = FALSE;
     neighbors_vars.neighbors[neighborIndex].parentPreference = 0;
     neighbors_vars.neighbors[neighborIndex].stableNeighbor = FALSE;
@@ -767,19 +792,138 @@ void removeNeighbor(uint8_t neighborIndex) {
     neighbors_vars.neighbors[neighborIndex].backoffExponenton = MINBE - 1;
     neighbors_vars.neighbors[neighborIndex].backoff = 0;
     neighbors_vars.neighbors[neighborIndex].addr.type = ADDR_NONE;
+    neighbors_updatePathCost(neighborIndex);
+#if RPL_STORING_MODE
+    icmpv6rpl_indicateNeighborRemoved(neighborIndex);
+#endif
 }
 
 //=========================== helpers =========================================
 
-bool isThisRowMatching(const open_addr_t *address, uint8_t rowNumber) {
-    switch (address->type) {
-        case ADDR_64B:
-            return neighbors_vars.neighbors[rowNumber].used &&
-                   packetfunctions_sameAddress(address, &neighbors_vars.neighbors[rowNumber].addr);
-        default:
-            LOG_CRITICAL(COMPONENT_NEIGHBORS, ERR_WRONG_ADDR_TYPE,
-                         (errorparameter_t) address->type,
-                         (errorparameter_t) 4);
-            return FALSE;
+/**
+\brief Row of the neighbor table holding a neighbor.
+
+Follows the probe sequence of the lookup index from the slot the address hashes to, which is free or holds the
+neighbor after a few steps since the index is kept at most half full.
+
+\param[in] address The address of the neighbor, only 64-bit addresses are in the table.
+
+\returns The row of the neighbor, MAXNUMNEIGHBORS if it is not in the table.
+*/
+static uint8_t neighbors_findRow(const open_addr_t *address) {
+    uint64_t key;
+    uint8_t slot;
+    uint8_t row;
+
+    if (address->type != ADDR_64B) {
+        return MAXNUMNEIGHBORS;
+    }
+
+    key = neighbors_keyOf(address);
+    for (slot = neighbors_lookupHome(key);; slot = (slot + 1) & (NEIGHBORS_LOOKUP_SIZE - 1)) {
+        row = neighbors_vars.lookup[slot];
+        if (row == NEIGHBORS_LOOKUP_EMPTY) {
+            return MAXNUMNEIGHBORS;
+        }
+        if (neighbors_vars.eui64[row] == key) {
+            return row;
+        }
+    }
+}
+
+static uint64_t neighbors_keyOf(const open_addr_t *address) {
+    uint64_t key;
+    uint8_t i;
+
+    key = 0;
+    for (i = 0; i < LENGTH_ADDR64b; i++) {
+        key = (key << 8) | address->addr_type.addr_64b[i];
+    }
+    return key;
+}
+
+/**
+\brief Slot of the lookup index where the probe sequence of a key starts.
+
+Fibonacci hashing of both halves of the key folded together, the top bits of the product spread EUI-64s which only
+differ in their last bytes over the whole index.
+*/
+static uint8_t neighbors_lookupHome(uint64_t key) {
+    uint32_t folded;
+
+    folded = (uint32_t) key ^ (uint32_t) (key >> 32);
+    return (uint8_t) ((folded * 2654435769u) >> (32 - NEIGHBORS_LOOKUP_BITS));
+}
+
+static void neighbors_lookupInsert(uint8_t row) {
+    uint8_t slot;
+
+    neighbors_vars.eui64[row] = neighbors_keyOf(&neighbors_vars.neighbors[row].addr);
+
+    slot = neighbors_lookupHome(neighbors_vars.eui64[row]);
+    while (neighbors_vars.lookup[slot] != NEIGHBORS_LOOKUP_EMPTY) {
+        slot = (slot + 1) & (NEIGHBORS_LOOKUP_SIZE - 1);
+    }
+    neighbors_vars.lookup[slot] = row;
+}
+
+/**
+\brief Recompute the path cost through a neighbor, after a field it depends on changed.
+
+RPL is told about every change, it keeps its candidate parents ordered on these costs.
+*/
+static void neighbors_updatePathCost(uint8_t index) {
+    uint32_t pathCost;
+
+    pathCost = MAXDAGRANK;
+    if (
+            neighbors_vars.neighbors[index].used &&
+            neighbors_vars.neighbors[index].stableNeighbor &&
+            neighbors_vars.neighbors[index].f6PNORES == FALSE &&
+            neighbors_vars.neighbors[index].DAGrank != DEFAULTDAGRANK
+            ) {
+        pathCost = (uint32_t) neighbors_vars.neighbors[index].DAGrank + neighbors_getLinkMetric(index);
+        if (pathCost > MAXDAGRANK) {
+            pathCost = MAXDAGRANK;
+        }
+    }
+
+    if (neighbors_vars.pathCost[index] != pathCost) {
+        neighbors_vars.pathCost[index] = (uint16_t) pathCost;
+        icmpv6rpl_indicatePathCost(index);
+    }
+}
+
+/**
+\brief Remove a row from the lookup index.
+
+Rather than leaving a marker in the freed slot, the entries further down the same probe sequence move back into it,
+so lookups never walk over deleted entries.
+*/
+static void neighbors_lookupRemove(uint8_t row) {
+    uint8_t hole;
+    uint8_t slot;
+    uint8_t home;
+
+    if (neighbors_vars.neighbors[row].used == FALSE) {
+        return;
+    }
+
+    hole = neighbors_lookupHome(neighbors_vars.eui64[row]);
+    while (neighbors_vars.lookup[hole] != row) {
+        hole = (hole + 1) & (NEIGHBORS_LOOKUP_SIZE - 1);
+    }
+    neighbors_vars.lookup[hole] = NEIGHBORS_LOOKUP_EMPTY;
+
+    for (slot = (hole + 1) & (NEIGHBORS_LOOKUP_SIZE - 1);
+         neighbors_vars.lookup[slot] != NEIGHBORS_LOOKUP_EMPTY;
+         slot = (slot + 1) & (NEIGHBORS_LOOKUP_SIZE - 1)) {
+        home = neighbors_lookupHome(neighbors_vars.eui64[neighbors_vars.lookup[slot]]);
+        // the entry can fill the hole if the hole lies between its home slot and where it is now
+        if (((slot - home) & (NEIGHBORS_LOOKUP_SIZE - 1)) >= ((slot - hole) & (NEIGHBORS_LOOKUP_SIZE - 1))) {
+            neighbors_vars.lookup[hole] = neighbors_vars.lookup[slot];
+            neighbors_vars.lookup[slot] = NEIGHBORS_LOOKUP_EMPTY;
+            hole = slot;
+        }
     }
 }
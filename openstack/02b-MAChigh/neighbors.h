@@ -9,6 +9,7 @@
 */
 #include "opendefs.h"
 #include "icmpv6rpl.h"
+#include "linkest.h"
 
 //=========================== define ==========================================
 
@@ -22,10 +23,6 @@
 #ifndef SWITCHSTABILITYTHRESHOLD
 #define SWITCHSTABILITYTHRESHOLD  3
 #endif
-#ifndef DEFAULTLINKCOST
-#define DEFAULTLINKCOST           4
-#endif
-#define MINIMAL_NUM_TX            16
 
 #define MAXDAGRANK                0xffff
 #define DEFAULTDAGRANK            MAXDAGRANK
@@ -34,10 +31,29 @@
 
 #define DEFAULTJOINPRIORITY       0xff
 
+// size of the hash index over the neighbor table, a power of two at least twice MAXNUMNEIGHBORS
+#if MAXNUMNEIGHBORS <= 8
+#define NEIGHBORS_LOOKUP_BITS     4
+#elif MAXNUMNEIGHBORS <= 16
+#define NEIGHBORS_LOOKUP_BITS     5
+#elif MAXNUMNEIGHBORS <= 32
+#define NEIGHBORS_LOOKUP_BITS     6
+#elif MAXNUMNEIGHBORS <= 64
+#define NEIGHBORS_LOOKUP_BITS     7
+#else
+#define NEIGHBORS_LOOKUP_BITS     8
+#endif
+#define NEIGHBORS_LOOKUP_SIZE     (1 << NEIGHBORS_LOOKUP_BITS)
+#define NEIGHBORS_LOOKUP_EMPTY    0xff
+
 //=========================== typedef =========================================
 
 typedef struct {
     neighborRow_t neighbors[MAXNUMNEIGHBORS];
+    uint64_t eui64[MAXNUMNEIGHBORS];                // address of each row in use, as key of the lookup index
+    uint8_t lookup[NEIGHBORS_LOOKUP_SIZE];          // open addressing index from address to row
+    uint16_t pathCost[MAXNUMNEIGHBORS];             // rank through each row, see neighbors_getPathCost()
+    linkest_t linkEstimate[MAXNUMNEIGHBORS];        // ETX of the link to each row
     dagrank_t myDAGrank;
     uint8_t debugRow;
 } neighborsVars_t;
@@ -63,8 +79,12 @@ int8_t neighbors_getRssi(uint8_t index);
 
 uint8_t neighbors_getNumTx(uint8_t index);
 
+uint16_t neighbors_getPathCost(uint8_t index);
+
 uint8_t neighbors_getSequenceNumber(open_addr_t *address);
 
+bool neighbors_getIndex(open_addr_t *address, uint8_t *index);
+
 // setters
 void neighbors_setNeighborRank(uint8_t index, dagrank_t rank);
 
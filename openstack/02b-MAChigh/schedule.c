@@ -6,6 +6,7 @@
 #include "idmanager.h"
 #include "IEEE802154E.h"
 #include "neighbors.h"
+#include "openqueue.h"
 
 //=========================== definition ======================================
 
@@ -33,8 +34,13 @@ END_PACK
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define schedule_vars       MOTE_CTX_VAR(scheduleVars_t, schedule_vars)
+#define schedule_status_ctx MOTE_CTX_VAR(scheduleStatus_t, schedule_status_ctx)
+#else
 scheduleVars_t schedule_vars;
 scheduleStatus_t schedule_status_ctx;
+#endif
 
 //=========================== prototypes ======================================
 
@@ -42,6 +48,28 @@ void schedule_resetEntry(scheduleEntry_t *pScheduleEntry);
 
 void schedule_resetBackupEntry(backupEntry_t *pBackupEntry);
 
+static scheduleEntry_t *schedule_getEntry(uint8_t slotframeID, slotOffset_t slotOffset);
+
+static void schedule_indexSlot(uint8_t slotframeID, slotOffset_t slotOffset, scheduleEntry_t *pScheduleEntry);
+
+static frameLength_t schedule_getDistance(slotOffset_t from, slotOffset_t to, frameLength_t frameLength);
+
+static frameLength_t schedule_getSlotsToNextEntry(scheduleSlotframe_t *slotframe);
+
+static frameLength_t schedule_getSlotsToNextActiveSlot(void);
+
+static slotOffset_t schedule_asnToSlotOffset(asn_t *asn, frameLength_t frameLength);
+
+static void schedule_selectEntry(void);
+
+static scheduleNeighborCells_t *schedule_getNeighborCells(open_addr_t *neighbor, bool allocate);
+
+static scheduleNeighborCells_t *schedule_findUnindexedNeighborCells(open_addr_t *neighbor);
+
+static void schedule_countCell(scheduleNeighborCells_t *neighborCells, bool shared, cellType_t type);
+
+static void schedule_uncountCell(open_addr_t *neighbor, bool shared, cellType_t type);
+
 static bool statusPrint_schedule(void);
 
 static bool statusPrint_backoff(void);
@@ -61,6 +89,14 @@ void schedule_init(void) {
 
     // reset local variables
     memset(&schedule_vars, 0, sizeof(scheduleVars_t));
+    memset(&schedule_vars.neighborCellsRow[0], SCHEDULE_NO_ENTRY, sizeof(schedule_vars.neighborCellsRow));
+    for (i = 0; i < SCHEDULE_MAX_SLOTFRAMES; i++) {
+        memset(
+                &schedule_vars.slotframes[i].slotIndex[0],
+                SCHEDULE_NO_ENTRY,
+                sizeof(schedule_vars.slotframes[i].slotIndex)
+        );
+    }
     for (running_slotOffset = 0; running_slotOffset < MAXACTIVESLOTS; running_slotOffset++) {
         schedule_resetEntry(&schedule_vars.scheduleBuf[running_slotOffset]);
         for (i = 0; i < MAXBACKUPSLOTS; i++) {
@@ -93,7 +129,7 @@ void schedule_startDAGroot(void) {
 
     start_slotOffset = SCHEDULE_MINIMAL_6TISCH_SLOTOFFSET;
     // set frame length, handle and number (default 1 by now)
-    if (schedule_vars.frameLength == 0) {
+    if (schedule_vars.slotframes[0].frameLength == 0) {
         // slotframe length is not set, set it to default length
         schedule_setFrameLength(SLOTFRAME_LENGTH);
     } else {
@@ -108,6 +144,7 @@ void schedule_startDAGroot(void) {
     for (running_slotOffset = start_slotOffset;
          running_slotOffset < start_slotOffset + SCHEDULE_MINIMAL_6TISCH_ACTIVE_CELLS; running_slotOffset++) {
         schedule_addActiveSlot(
+                SCHEDULE_MINIMAL_6TISCH_DEFAULT_SLOTFRAME_HANDLE,  // slotframe
                 running_slotOffset,                     // slot offset
                 CELLTYPE_TXRX,                          // type of slot
                 TRUE,                                   // shared?
@@ -185,7 +222,8 @@ void schedule_setFrameLength(frameLength_t newFrameLength) {
     INTERRUPT_DECLARATION();
     DISABLE_INTERRUPTS();
 
-    schedule_vars.frameLength = newFrameLength;
+    schedule_vars.slotframes[0].frameLength = newFrameLength;
+    schedule_vars.version++;
     if (newFrameLength <= MAXACTIVESLOTS) {
         schedule_vars.maxActiveSlots = newFrameLength;
     }
@@ -222,43 +260,117 @@ void schedule_setFrameNumber(uint8_t frameNumber) {
     ENABLE_INTERRUPTS();
 }
 
+/**
+\brief Add a slotframe to the schedule.
+
+Slotframe 0 is the minimal slotframe, its length is set by schedule_setFrameLength(). The other slotframes start
+aligned with the ASN, like the minimal one, and are filled with schedule_addActiveSlot() or through 6P.
+
+\param slotframeID The slotframe to add, in the range [1 - SCHEDULE_MAX_SLOTFRAMES-1].
+\param frameLength The length of the slotframe, at most SLOTFRAME_LENGTH.
+
+\returns E_SUCCESS if the slotframe was added, E_FAIL if it already exists or the parameters are out of range.
+*/
+owerror_t schedule_addSlotframe(uint8_t slotframeID, frameLength_t frameLength) {
+    scheduleSlotframe_t *slotframe;
+
+    INTERRUPT_DECLARATION();
+
+    if (slotframeID == 0 || slotframeID >= SCHEDULE_MAX_SLOTFRAMES ||
+        frameLength == 0 || frameLength > SLOTFRAME_LENGTH) {
+        LOG_ERROR(COMPONENT_SCHEDULE, ERR_INVALID_PARAM, (errorparameter_t) slotframeID,
+                  (errorparameter_t) frameLength);
+        return E_FAIL;
+    }
+
+    DISABLE_INTERRUPTS();
+
+    slotframe = &schedule_vars.slotframes[slotframeID];
+    if (slotframe->frameLength != 0) {
+        ENABLE_INTERRUPTS();
+        return E_FAIL;
+    }
+
+    slotframe->frameLength = frameLength;
+    slotframe->slotOffset = schedule_asnToSlotOffset(&schedule_vars.asn, frameLength);
+    slotframe->currentScheduleEntry = NULL;
+    schedule_vars.version++;
+
+    ENABLE_INTERRUPTS();
+    return E_SUCCESS;
+}
+
 /**
 \brief Get the information of a specific slot.
 
+\param slotframeID
 \param slotOffset
 \param info
 */
-void schedule_getSlotInfo(slotOffset_t slotOffset, slotinfo_element_t *info) {
+void schedule_getSlotInfo(uint8_t slotframeID, slotOffset_t slotOffset, slotinfo_element_t *info) {
 
     scheduleEntry_t *slotContainer;
 
-    // find an empty schedule entry container
-    slotContainer = &schedule_vars.scheduleBuf[0];
-    while (slotContainer <= &schedule_vars.scheduleBuf[schedule_vars.maxActiveSlots - 1]) {
-        //check that this entry for that neighbour and timeslot is not already scheduled.
-        if (slotContainer->slotOffset == slotOffset) {
-            //it exists so this is an update.
-            info->link_type = slotContainer->type;
-            info->shared = slotContainer->shared;
-            info->slotOffset = slotOffset;
-            info->channelOffset = slotContainer->channelOffset;
-            info->isAutoCell = slotContainer->isAutoCell;
-            memcpy(&(info->address), &(slotContainer->neighbor), sizeof(open_addr_t));
-            return; //as this is an update. No need to re-insert as it is in the same position on the list.
-        }
-        slotContainer++;
+    slotContainer = schedule_getEntry(slotframeID, slotOffset);
+    if (slotContainer != NULL) {
+        info->link_type = slotContainer->type;
+        info->shared = slotContainer->shared;
+        info->slotframeID = slotframeID;
+        info->slotOffset = slotOffset;
+        info->channelOffset = slotContainer->channelOffset;
+        info->isAutoCell = slotContainer->isAutoCell;
+        memcpy(&(info->address), &(slotContainer->neighbor), sizeof(open_addr_t));
+        return;
     }
     // return cell type off
     info->link_type = CELLTYPE_OFF;
     info->shared = FALSE;
+    info->slotframeID = slotframeID;
+    info->slotOffset = slotOffset;
     info->channelOffset = 0;        //set to zero if not set.
     info->isAutoCell = FALSE;
     memset(&(info->address), 0, sizeof(open_addr_t));
 }
 
+/**
+\brief Get the information of the cell used in the current slot.
+
+\param slotOffset  The slot offset of the current slot, in the minimal slotframe.
+\param info        The information of the cell, of type CELLTYPE_OFF if the current slot is not an active slot.
+*/
+void schedule_getCurrentSlotInfo(slotOffset_t slotOffset, slotinfo_element_t *info) {
+    scheduleEntry_t *slotContainer;
+
+    INTERRUPT_DECLARATION();
+    DISABLE_INTERRUPTS();
+
+    // the slotframes only move on active slots, and the minimal slotframe has an active slot every cycle
+    slotContainer = schedule_vars.currentScheduleEntry;
+    if (slotContainer != NULL && schedule_vars.slotframes[0].slotOffset == slotOffset) {
+        info->link_type = slotContainer->type;
+        info->shared = slotContainer->shared;
+        info->slotframeID = slotContainer->slotframeID;
+        info->slotOffset = slotContainer->slotOffset;
+        info->channelOffset = slotContainer->channelOffset;
+        info->isAutoCell = slotContainer->isAutoCell;
+        memcpy(&(info->address), &(slotContainer->neighbor), sizeof(open_addr_t));
+    } else {
+        info->link_type = CELLTYPE_OFF;
+        info->shared = FALSE;
+        info->slotframeID = 0;
+        info->slotOffset = slotOffset;
+        info->channelOffset = 0;
+        info->isAutoCell = FALSE;
+        memset(&(info->address), 0, sizeof(open_addr_t));
+    }
+
+    ENABLE_INTERRUPTS();
+}
+
 /**
 \brief Add a new active slot into the schedule.
 
+\param slotframeID      The slotframe of the new slot
 \param slotOffset       The slotoffset of the new slot
 \param type             The type of the cell
 \param shared           Whether this cell is shared (TRUE) or not (FALSE).
@@ -267,6 +379,7 @@ void schedule_getSlotInfo(slotOffset_t slotOffset, slotinfo_element_t *info) {
    none)
 */
 owerror_t schedule_addActiveSlot(
+        uint8_t slotframeID,
         slotOffset_t slotOffset,
         cellType_t type,
         bool shared,
@@ -280,6 +393,8 @@ owerror_t schedule_addActiveSlot(
     scheduleEntry_t *nextSlotWalker;
 
     backupEntry_t *backupEntry;
+    scheduleNeighborCells_t *neighborCells;
+    scheduleSlotframe_t *slotframe;
 
     uint8_t i;
     bool entry_found;
@@ -288,35 +403,56 @@ owerror_t schedule_addActiveSlot(
     bool needSwapEntries;
 
     INTERRUPT_DECLARATION();
+
+    // the minimal slotframe takes cells before its length is known, the others are checked against their length
+    if (
+            slotframeID >= SCHEDULE_MAX_SLOTFRAMES ||
+            (slotframeID > 0 && slotOffset >= schedule_vars.slotframes[slotframeID].frameLength)
+            ) {
+        LOG_ERROR(COMPONENT_SCHEDULE, ERR_INVALID_PARAM, (errorparameter_t) slotframeID,
+                  (errorparameter_t) slotOffset);
+        return E_FAIL;
+    }
+    slotframe = &schedule_vars.slotframes[slotframeID];
+
     DISABLE_INTERRUPTS();
 
-    // find an empty schedule entry container
     entry_found = FALSE;
     inBackupEntries = FALSE;
-    slotContainer = &schedule_vars.scheduleBuf[0];
-    do {
-        if (slotContainer->type != CELLTYPE_OFF) {
-            if (slotContainer->slotOffset == slotOffset) {
-                // found one entry with same slotoffset in schedule, check if there is space in second entries
-
-                for (i = 0; i < MAXBACKUPSLOTS; i++) {
-                    if (slotContainer->backupEntries[i].type == CELLTYPE_OFF) {
-                        inBackupEntries = TRUE;
-                        backupEntry = &(slotContainer->backupEntries[i]);
-                        break;
-                    }
-                }
-                if (inBackupEntries) {
-                    entry_found = TRUE;
-                    break;
-                }
+    slotContainer = schedule_getEntry(slotframeID, slotOffset);
+    if (slotContainer != NULL) {
+        // found one entry with same slotoffset in schedule, check if there is space in second entries
+        for (i = 0; i < MAXBACKUPSLOTS; i++) {
+            if (slotContainer->backupEntries[i].type == CELLTYPE_OFF) {
+                inBackupEntries = TRUE;
+                backupEntry = &(slotContainer->backupEntries[i]);
+                break;
+            }
+        }
+        if (inBackupEntries == FALSE) {
+            // slot is already in schedule
+            ENABLE_INTERRUPTS();
+            LOG_ERROR(COMPONENT_SCHEDULE, ERR_SCHEDULE_ADD_DUPLICATE_SLOT, (errorparameter_t) slotOffset,
+                      (errorparameter_t) 0);
+            return E_FAIL;
+        }
+        entry_found = TRUE;
+    } else {
+        // find an empty schedule entry container
+        for (i = 0; i < schedule_vars.maxActiveSlots; i++) {
+            if (schedule_vars.scheduleBuf[i].type == CELLTYPE_OFF) {
+                slotContainer = &schedule_vars.scheduleBuf[i];
+                entry_found = TRUE;
+                break;
             }
-            slotContainer++;
-        } else {
-            entry_found = TRUE;
-            break;
         }
-    } while (slotContainer <= &schedule_vars.scheduleBuf[schedule_vars.maxActiveSlots - 1]);
+    }
+
+    // unicast cells also need a row in the per-neighbor index
+    neighborCells = schedule_getNeighborCells(neighbor, TRUE);
+    if (neighbor->type == ADDR_64B && neighborCells == NULL) {
+        entry_found = FALSE;
+    }
 
     // abort it schedule overflow
     if (entry_found == FALSE) {
@@ -359,6 +495,7 @@ owerror_t schedule_addActiveSlot(
             backupEntry->numRx = slotContainer->numRx;
             backupEntry->numTx = slotContainer->numTx;
             backupEntry->numTxACK = slotContainer->numTxACK;
+            backupEntry->linkEstimate = slotContainer->linkEstimate;
             backupEntry->lastUsedAsn.byte4 = slotContainer->lastUsedAsn.byte4;
             backupEntry->lastUsedAsn.bytes0and1 = slotContainer->lastUsedAsn.bytes0and1;
             backupEntry->lastUsedAsn.bytes0and1 = slotContainer->lastUsedAsn.bytes0and1;
@@ -370,6 +507,7 @@ owerror_t schedule_addActiveSlot(
             slotContainer->channelOffset = channelOffset;
             slotContainer->isAutoCell = isAutoCell;
             memcpy(&(slotContainer->neighbor), neighbor, sizeof(open_addr_t));
+            linkest_init(&slotContainer->linkEstimate, LINKEST_ETX_ONE);
 
             // fill that schedule entry with current asn
             ieee154e_getAsn(&(asn[0]));
@@ -394,12 +532,14 @@ owerror_t schedule_addActiveSlot(
             // use the same next point in schedule
             backupEntry->next = slotContainer->next;
         }
+        schedule_countCell(neighborCells, shared, type);
         ENABLE_INTERRUPTS();
         return E_SUCCESS;
     }
 
     // fill that schedule entry with parameters passed
     slotContainer->slotOffset = slotOffset;
+    slotContainer->slotframeID = slotframeID;
     slotContainer->type = type;
     slotContainer->shared = shared;
     slotContainer->channelOffset = channelOffset;
@@ -412,20 +552,23 @@ owerror_t schedule_addActiveSlot(
     slotContainer->lastUsedAsn.bytes2and3 = 256 * asn[3] + asn[2];
     slotContainer->lastUsedAsn.byte4 = asn[4];
 
-    // insert in circular list
-    if (schedule_vars.currentScheduleEntry == NULL) {
+    // insert in the circular list of the slotframe
+    if (slotframe->currentScheduleEntry == NULL) {
         // this is the first active slot added
 
         // the next slot of this slot is this slot
         slotContainer->next = slotContainer;
 
         // current slot points to this slot
-        schedule_vars.currentScheduleEntry = slotContainer;
+        slotframe->currentScheduleEntry = slotContainer;
+        if (schedule_vars.currentScheduleEntry == NULL) {
+            schedule_vars.currentScheduleEntry = slotContainer;
+        }
     } else {
         // this is NOT the first active slot added
 
         // find position in schedule
-        previousSlotWalker = schedule_vars.currentScheduleEntry;
+        previousSlotWalker = slotframe->currentScheduleEntry;
         while (1) {
             nextSlotWalker = previousSlotWalker->next;
             if (
@@ -446,27 +589,29 @@ owerror_t schedule_addActiveSlot(
                     ) {
                 break;
             }
-            if (previousSlotWalker->slotOffset == slotContainer->slotOffset) {
-                // slot is already in schedule
-                LOG_ERROR(COMPONENT_SCHEDULE, ERR_SCHEDULE_ADD_DUPLICATE_SLOT,
-                          (errorparameter_t) slotContainer->slotOffset,
-                          (errorparameter_t) 0);
-                // reset the entry
-                slotContainer->slotOffset = 0;
-                slotContainer->type = CELLTYPE_OFF;
-                slotContainer->shared = FALSE;
-                slotContainer->channelOffset = 0;
-                memset(&slotContainer->neighbor, 0, sizeof(open_addr_t));
-                ENABLE_INTERRUPTS();
-                return E_FAIL;
-            }
             previousSlotWalker = nextSlotWalker;
         }
         // insert between previousSlotWalker and nextSlotWalker
         previousSlotWalker->next = slotContainer;
         slotContainer->next = nextSlotWalker;
+
+        // a slot inserted between the current entry and the position of the slotframe becomes the current entry
+        if (
+                schedule_getDistance(slotframe->currentScheduleEntry->slotOffset, slotOffset,
+                                     slotframe->frameLength) > 0 &&
+                schedule_getDistance(slotframe->currentScheduleEntry->slotOffset, slotOffset,
+                                     slotframe->frameLength) <=
+                schedule_getDistance(slotframe->currentScheduleEntry->slotOffset, slotframe->slotOffset,
+                                     slotframe->frameLength)
+                ) {
+            slotframe->currentScheduleEntry = slotContainer;
+        }
     }
 
+    schedule_indexSlot(slotframeID, slotOffset, slotContainer);
+    schedule_vars.version++;
+    schedule_countCell(neighborCells, shared, type);
+
     ENABLE_INTERRUPTS();
     return E_SUCCESS;
 }
@@ -474,13 +619,20 @@ owerror_t schedule_addActiveSlot(
 /**
 \brief Remove an active slot from the schedule.
 
+\param slotframeID      The slotframe of the slot to remove.
 \param slotOffset       The slotoffset of the slot to remove.
 \param type             The type of the slot to remove.
 \param isShared         The slot is shared or not.
 \param neighbor         The neighbor associated with this cell (all 0's if
    none)
 */
-owerror_t schedule_removeActiveSlot(slotOffset_t slotOffset, cellType_t type, bool isShared, open_addr_t *neighbor) {
+owerror_t schedule_removeActiveSlot(
+        uint8_t slotframeID,
+        slotOffset_t slotOffset,
+        cellType_t type,
+        bool isShared,
+        open_addr_t *neighbor
+) {
     uint8_t i;
     bool entry_found;
     bool isbackupEntry;
@@ -489,6 +641,7 @@ owerror_t schedule_removeActiveSlot(slotOffset_t slotOffset, cellType_t type, bo
 
     scheduleEntry_t *slotContainer;
     scheduleEntry_t *previousSlotWalker;
+    scheduleSlotframe_t *slotframe;
 
     INTERRUPT_DECLARATION();
     DISABLE_INTERRUPTS();
@@ -496,31 +649,26 @@ owerror_t schedule_removeActiveSlot(slotOffset_t slotOffset, cellType_t type, bo
     // find the schedule entry
     entry_found = FALSE;
     isbackupEntry = FALSE;
-    slotContainer = &schedule_vars.scheduleBuf[0];
-    while (slotContainer <= &schedule_vars.scheduleBuf[schedule_vars.maxActiveSlots - 1]) {
-        if (slotContainer->slotOffset == slotOffset) {
-            if (packetfunctions_sameAddress(neighbor, &(slotContainer->neighbor))) {
-                entry_found = TRUE;
-                break;
-            } else {
-                for (i = 0; i < MAXBACKUPSLOTS; i++) {
-                    if (
-                            packetfunctions_sameAddress(neighbor, &(slotContainer->backupEntries[i].neighbor)) &&
-                            type == slotContainer->backupEntries[i].type &&
-                            isShared == slotContainer->backupEntries[i].shared
-                            ) {
-                        isbackupEntry = TRUE;
-                        backupEntry = &(slotContainer->backupEntries[i]);
-                        break;
-                    }
-                }
-                if (isbackupEntry) {
-                    entry_found = TRUE;
+    slotContainer = schedule_getEntry(slotframeID, slotOffset);
+    if (slotContainer != NULL) {
+        if (packetfunctions_sameAddress(neighbor, &(slotContainer->neighbor))) {
+            entry_found = TRUE;
+        } else {
+            for (i = 0; i < MAXBACKUPSLOTS; i++) {
+                if (
+                        packetfunctions_sameAddress(neighbor, &(slotContainer->backupEntries[i].neighbor)) &&
+                        type == slotContainer->backupEntries[i].type &&
+                        isShared == slotContainer->backupEntries[i].shared
+                        ) {
+                    isbackupEntry = TRUE;
+                    backupEntry = &(slotContainer->backupEntries[i]);
                     break;
                 }
             }
+            if (isbackupEntry) {
+                entry_found = TRUE;
+            }
         }
-        slotContainer++;
     }
 
     // abort it could not find
@@ -532,6 +680,8 @@ owerror_t schedule_removeActiveSlot(slotOffset_t slotOffset, cellType_t type, bo
 
     if (isbackupEntry) {
 
+        schedule_uncountCell(&backupEntry->neighbor, backupEntry->shared, backupEntry->type);
+
         // reset the backup entry
         backupEntry->type = CELLTYPE_OFF;
         backupEntry->shared = FALSE;
@@ -548,6 +698,8 @@ owerror_t schedule_removeActiveSlot(slotOffset_t slotOffset, cellType_t type, bo
         ENABLE_INTERRUPTS();
         return E_SUCCESS;
     } else {
+        schedule_uncountCell(&slotContainer->neighbor, slotContainer->shared, slotContainer->type);
+
         // looking for a cell in backup entries
         candidate_index = MAXBACKUPSLOTS;
         for (i = 0; i < MAXBACKUPSLOTS; i++) {
@@ -574,6 +726,7 @@ owerror_t schedule_removeActiveSlot(slotOffset_t slotOffset, cellType_t type, bo
             slotContainer->numTx = slotContainer->backupEntries[candidate_index].numTx;
             slotContainer->numRx = slotContainer->backupEntries[candidate_index].numRx;
             slotContainer->numTxACK = slotContainer->backupEntries[candidate_index].numTxACK;
+            slotContainer->linkEstimate = slotContainer->backupEntries[candidate_index].linkEstimate;
             slotContainer->lastUsedAsn.bytes0and1 = slotContainer->backupEntries[candidate_index].lastUsedAsn.bytes0and1;
             slotContainer->lastUsedAsn.bytes2and3 = slotContainer->backupEntries[candidate_index].lastUsedAsn.bytes2and3;
             slotContainer->lastUsedAsn.byte4 = slotContainer->backupEntries[candidate_index].lastUsedAsn.byte4;
@@ -589,15 +742,19 @@ owerror_t schedule_removeActiveSlot(slotOffset_t slotOffset, cellType_t type, bo
     }
 
     // remove from linked list
+    slotframe = &schedule_vars.slotframes[slotframeID];
     if (slotContainer->next == slotContainer) {
-        // this is the last active slot, the next slot of this slot is NULL
+        // this is the last active slot of the slotframe, the next slot of this slot is NULL
         slotContainer->next = NULL;
 
         // current slot points to this slot
-        schedule_vars.currentScheduleEntry = NULL;
+        slotframe->currentScheduleEntry = NULL;
+        if (schedule_vars.currentScheduleEntry == slotContainer) {
+            schedule_vars.currentScheduleEntry = schedule_vars.slotframes[0].currentScheduleEntry;
+        }
     } else {
         // this is NOT the last active slot, find the previous in the schedule
-        previousSlotWalker = schedule_vars.currentScheduleEntry;
+        previousSlotWalker = slotframe->currentScheduleEntry;
 
         while (1) {
             if (previousSlotWalker->next == slotContainer) {
@@ -610,6 +767,9 @@ owerror_t schedule_removeActiveSlot(slotOffset_t slotOffset, cellType_t type, bo
         previousSlotWalker->next = slotContainer->next;
 
         // update current slot if points to slot I just removed
+        if (slotframe->currentScheduleEntry == slotContainer) {
+            slotframe->currentScheduleEntry = previousSlotWalker;
+        }
         if (schedule_vars.currentScheduleEntry == slotContainer) {
             /**
                 attention: this should only happen at the end of slot. It's dangerous to remove current schedule entry
@@ -624,6 +784,8 @@ owerror_t schedule_removeActiveSlot(slotOffset_t slotOffset, cellType_t type, bo
     }
 
     // reset removed schedule entry
+    schedule_indexSlot(slotframeID, slotContainer->slotOffset, NULL);
+    schedule_vars.version++;
     schedule_resetEntry(slotContainer);
 
     ENABLE_INTERRUPTS();
@@ -631,40 +793,31 @@ owerror_t schedule_removeActiveSlot(slotOffset_t slotOffset, cellType_t type, bo
     return E_SUCCESS;
 }
 
-bool schedule_isSlotOffsetAvailable(uint16_t slotOffset) {
-
-    scheduleEntry_t *scheduleWalker;
+bool schedule_isSlotOffsetAvailable(uint8_t slotframeID, uint16_t slotOffset) {
+    bool returnVal;
 
     INTERRUPT_DECLARATION();
     DISABLE_INTERRUPTS();
 
-    if (slotOffset >= schedule_vars.frameLength) {
+    if (slotOffset >= schedule_getSlotframeLength(slotframeID)) {
         ENABLE_INTERRUPTS();
         return FALSE;
     }
 
-    scheduleWalker = schedule_vars.currentScheduleEntry;
-    do {
-        if (slotOffset == scheduleWalker->slotOffset) {
-            ENABLE_INTERRUPTS();
-            return FALSE;
-        }
-        scheduleWalker = scheduleWalker->next;
-    } while (scheduleWalker != schedule_vars.currentScheduleEntry);
+    returnVal = (schedule_getEntry(slotframeID, slotOffset) == NULL);
 
     ENABLE_INTERRUPTS();
 
-    return TRUE;
+    return returnVal;
 }
 
 void schedule_removeAllNegotiatedCellsToNeighbor(uint8_t slotframeID, open_addr_t *neighbor) {
-    (void) slotframeID;
-
     uint8_t i;
 
-    // remove all entries in schedule with previousHop address
+    // remove all entries of the slotframe with previousHop address
     for (i = 0; i < MAXACTIVESLOTS; i++) {
         if (
+                schedule_vars.scheduleBuf[i].slotframeID == slotframeID &&
                 packetfunctions_sameAddress(&(schedule_vars.scheduleBuf[i].neighbor), neighbor) &&
                 (
                         schedule_vars.scheduleBuf[i].type == CELLTYPE_TX ||
@@ -672,6 +825,7 @@ void schedule_removeAllNegotiatedCellsToNeighbor(uint8_t slotframeID, open_addr_
                 )
                 ) {
             schedule_removeActiveSlot(
+                    slotframeID,
                     schedule_vars.scheduleBuf[i].slotOffset,
                     schedule_vars.scheduleBuf[i].type,
                     schedule_vars.scheduleBuf[i].shared,
@@ -700,37 +854,17 @@ uint8_t schedule_getNumberOfFreeEntries() {
 }
 
 uint8_t schedule_getNumberOfNegotiatedCells(open_addr_t *neighbor, cellType_t cell_type) {
-    uint8_t i;
-    uint8_t j;
     uint8_t counter;
+    scheduleNeighborCells_t *neighborCells;
 
     INTERRUPT_DECLARATION();
     DISABLE_INTERRUPTS();
 
+    // counts the cells in the backup entries as well
     counter = 0;
-    for (i = 0; i < MAXACTIVESLOTS; i++) {
-        if (
-                schedule_vars.scheduleBuf[i].shared == FALSE &&
-                schedule_vars.scheduleBuf[i].type == cell_type &&
-                packetfunctions_sameAddress(&schedule_vars.scheduleBuf[i].neighbor, neighbor) == TRUE
-                ) {
-            counter++;
-        } else {
-            if (schedule_vars.scheduleBuf[i].isAutoCell) {
-                for (j = 0; j < MAXBACKUPSLOTS; j++) {
-                    if (
-                            schedule_vars.scheduleBuf[i].backupEntries[j].type == CELLTYPE_TX &&
-                            packetfunctions_sameAddress(&(schedule_vars.scheduleBuf[i].backupEntries[j].neighbor),
-                                                        neighbor) == TRUE &&
-                            schedule_vars.scheduleBuf[i].backupEntries[j].shared == FALSE
-                            ) {
-                        counter++;
-                        // at most one negotiated Tx cell to a neighbor in backup entries
-                        break;
-                    }
-                }
-            }
-        }
+    neighborCells = schedule_getNeighborCells(neighbor, FALSE);
+    if (neighborCells != NULL) {
+        counter = neighborCells->numCellsByType[0][cell_type];
     }
 
     ENABLE_INTERRUPTS();
@@ -738,45 +872,31 @@ uint8_t schedule_getNumberOfNegotiatedCells(open_addr_t *neighbor, cellType_t ce
     return counter;
 }
 
-bool schedule_isNumTxWrapped(open_addr_t *neighbor) {
-    uint8_t i;
-    bool returnVal;
-
-    INTERRUPT_DECLARATION();
-
-    DISABLE_INTERRUPTS();
-
-    returnVal = FALSE;
-    for (i = 0; i < MAXACTIVESLOTS; i++) {
-        if (packetfunctions_sameAddress(&schedule_vars.scheduleBuf[i].neighbor, neighbor) == TRUE) {
-            if (schedule_vars.scheduleBuf[i].numTx > 0xFF / 2) {
-                returnVal = TRUE;
-            }
-            ENABLE_INTERRUPTS();
-            return returnVal;
-        }
-    }
-
-    ENABLE_INTERRUPTS();
+/**
+\brief Find a cell to some neighbor which should be relocated.
 
-    return returnVal;
+A cell is relocated once its ETX estimate is confident (see LINKEST_MIN_SAMPLES) and its PDR, the inverse of its
+ETX, is below RELOCATE_PDRTHRES.
 
-}
-
-bool schedule_getCellsToBeRelocated(open_addr_t *neighbor, cellInfo_ht *celllist) {
+\returns TRUE if such a cell was found and written to celllist.
+*/
+bool schedule_getCellsToBeRelocated(uint8_t slotframeID, open_addr_t *neighbor, cellInfo_ht *celllist) {
     uint8_t i;
 
-    uint16_t cellPDR;
-
     INTERRUPT_DECLARATION();
     DISABLE_INTERRUPTS();
 
-    // found the cell with higest PDR
     for (i = 0; i < MAXACTIVESLOTS; i++) {
-        if (packetfunctions_sameAddress(&schedule_vars.scheduleBuf[i].neighbor, neighbor) == TRUE) {
-            if (schedule_vars.scheduleBuf[i].numTx > MINIMAL_NUM_TX) {
-                cellPDR = 100 * schedule_vars.scheduleBuf[i].numTxACK / schedule_vars.scheduleBuf[i].numTx;
-                if (cellPDR < RELOCATE_PDRTHRES) {
+        if (
+                schedule_vars.scheduleBuf[i].slotframeID == slotframeID &&
+                packetfunctions_sameAddress(&schedule_vars.scheduleBuf[i].neighbor, neighbor) == TRUE
+                ) {
+            if (linkest_isConfident(&schedule_vars.scheduleBuf[i].linkEstimate)) {
+                // 100 / ETX < RELOCATE_PDRTHRES
+                if (
+                        (uint32_t) linkest_getEtx(&schedule_vars.scheduleBuf[i].linkEstimate) * RELOCATE_PDRTHRES >
+                        (uint32_t) 100 * LINKEST_ETX_ONE
+                        ) {
                     celllist->isUsed = TRUE;
                     celllist->slotoffset = schedule_vars.scheduleBuf[i].slotOffset;
                     celllist->channeloffset = schedule_vars.scheduleBuf[i].channelOffset;
@@ -793,28 +913,18 @@ bool schedule_getCellsToBeRelocated(open_addr_t *neighbor, cellInfo_ht *celllist
 }
 
 bool schedule_hasAutonomousTxRxCellUnicast(open_addr_t *neighbor) {
-    uint8_t i;
+    bool returnVal;
+    scheduleNeighborCells_t *neighborCells;
 
     INTERRUPT_DECLARATION();
     DISABLE_INTERRUPTS();
 
-    for (i = 0; i < MAXACTIVESLOTS; i++) {
-        if (
-                schedule_vars.scheduleBuf[i].type == CELLTYPE_TXRX &&
-                schedule_vars.scheduleBuf[i].shared &&
-                schedule_vars.scheduleBuf[i].neighbor.type == ADDR_64B &&
-                packetfunctions_sameAddress(neighbor, &schedule_vars.scheduleBuf[i].neighbor)
-                ) {
-
-            ENABLE_INTERRUPTS();
-
-            return TRUE;
-        }
-    }
+    neighborCells = schedule_getNeighborCells(neighbor, FALSE);
+    returnVal = (neighborCells != NULL && neighborCells->numCellsByType[1][CELLTYPE_TXRX] > 0);
 
     ENABLE_INTERRUPTS();
 
-    return FALSE;
+    return returnVal;
 }
 
 // bool schedule_getAutonomousTxRxCellUnicastNeighbor(open_addr_t *neighbor) {
@@ -842,51 +952,33 @@ bool schedule_hasAutonomousTxRxCellUnicast(open_addr_t *neighbor) {
 // }
 
 bool schedule_hasAutoTxCellToNeighbor(open_addr_t *neighbor) {
-    uint8_t i;
+    bool returnVal;
+    scheduleNeighborCells_t *neighborCells;
 
     INTERRUPT_DECLARATION();
     DISABLE_INTERRUPTS();
 
-    for (i = 0; i < MAXACTIVESLOTS; i++) {
-        if (
-                schedule_vars.scheduleBuf[i].shared == TRUE &&
-                schedule_vars.scheduleBuf[i].type == CELLTYPE_TX &&
-                schedule_vars.scheduleBuf[i].neighbor.type == ADDR_64B &&
-                packetfunctions_sameAddress(neighbor, &schedule_vars.scheduleBuf[i].neighbor)
-                ) {
-
-            ENABLE_INTERRUPTS();
-
-            return TRUE;
-        }
-    }
+    neighborCells = schedule_getNeighborCells(neighbor, FALSE);
+    returnVal = (neighborCells != NULL && neighborCells->numCellsByType[1][CELLTYPE_TX] > 0);
 
     ENABLE_INTERRUPTS();
 
-    return FALSE;
+    return returnVal;
 }
 
 bool schedule_hasNegotiatedCellToNeighbor(open_addr_t *neighbor, cellType_t cell_type) {
-    uint8_t i;
+    bool returnVal;
+    scheduleNeighborCells_t *neighborCells;
 
     INTERRUPT_DECLARATION();
     DISABLE_INTERRUPTS();
 
-    for (i = 0; i < MAXACTIVESLOTS; i++) {
-        if (
-                schedule_vars.scheduleBuf[i].shared == FALSE &&
-                schedule_vars.scheduleBuf[i].type == cell_type &&
-                schedule_vars.scheduleBuf[i].neighbor.type == ADDR_64B &&
-                packetfunctions_sameAddress(neighbor, &schedule_vars.scheduleBuf[i].neighbor)
-                ) {
-            ENABLE_INTERRUPTS();
-            return TRUE;
-        }
-    }
+    neighborCells = schedule_getNeighborCells(neighbor, FALSE);
+    returnVal = (neighborCells != NULL && neighborCells->numCellsByType[0][cell_type] > 0);
 
     ENABLE_INTERRUPTS();
 
-    return FALSE;
+    return returnVal;
 }
 
 /**
@@ -902,14 +994,13 @@ bool schedule_hasNegotiatedTxCellToNonParent(open_addr_t *parentNeighbor, open_a
     INTERRUPT_DECLARATION();
     DISABLE_INTERRUPTS();
 
-    for (i = 0; i < MAXACTIVESLOTS; i++) {
+    for (i = 0; i < SCHEDULE_MAXNEIGHBORS; i++) {
         if (
-                schedule_vars.scheduleBuf[i].type == CELLTYPE_TX &&
-                schedule_vars.scheduleBuf[i].shared == FALSE &&
-                schedule_vars.scheduleBuf[i].neighbor.type == ADDR_64B &&
-                packetfunctions_sameAddress(parentNeighbor, &schedule_vars.scheduleBuf[i].neighbor) == FALSE
+                schedule_vars.neighborCells[i].numCells > 0 &&
+                schedule_vars.neighborCells[i].numCellsByType[0][CELLTYPE_TX] > 0 &&
+                packetfunctions_sameAddress(parentNeighbor, &schedule_vars.neighborCells[i].neighbor) == FALSE
                 ) {
-            memcpy(nonParentNeighbor, &schedule_vars.scheduleBuf[i].neighbor, sizeof(open_addr_t));
+            memcpy(nonParentNeighbor, &schedule_vars.neighborCells[i].neighbor, sizeof(open_addr_t));
 
             ENABLE_INTERRUPTS();
 
@@ -947,35 +1038,151 @@ bool schedule_hasNegotiatedTxCellToNonParent(open_addr_t *parentNeighbor, open_a
 //     return FALSE;
 // }
 
+//=== from neighbors
+
+/**
+\brief Indicate a neighbor was added to the neighbor table, index the cells it may already have.
+
+\param[in] index    The index of that neighbor in the neighbor table.
+\param[in] neighbor The address of that neighbor.
+*/
+void schedule_indicateNeighborAdded(uint8_t index, open_addr_t *neighbor) {
+    scheduleNeighborCells_t *neighborCells;
+
+    INTERRUPT_DECLARATION();
+    DISABLE_INTERRUPTS();
+
+    neighborCells = schedule_findUnindexedNeighborCells(neighbor);
+    if (neighborCells != NULL) {
+        schedule_vars.neighborCellsRow[index] = (uint8_t) (neighborCells - schedule_vars.neighborCells);
+        schedule_vars.numUnindexedNeighbors--;
+    }
+
+    ENABLE_INTERRUPTS();
+}
+
+/**
+\brief Indicate a neighbor was removed from the neighbor table, its cells are then looked up by address.
+
+\param[in] index The index of that neighbor in the neighbor table.
+*/
+void schedule_indicateNeighborRemoved(uint8_t index) {
+    INTERRUPT_DECLARATION();
+    DISABLE_INTERRUPTS();
+
+    if (schedule_vars.neighborCellsRow[index] != SCHEDULE_NO_ENTRY) {
+        schedule_vars.neighborCellsRow[index] = SCHEDULE_NO_ENTRY;
+        schedule_vars.numUnindexedNeighbors++;
+    }
+
+    ENABLE_INTERRUPTS();
+}
+
 //=== from IEEE802154E: reading the schedule and updating statistics
 
+/**
+\brief Align the slotframes with the current ASN.
+
+\param targetSlotOffset The current slot offset, in the minimal slotframe.
+*/
 void schedule_syncSlotOffset(slotOffset_t targetSlotOffset) {
+    uint8_t asn[5];
+    uint8_t i;
+    scheduleSlotframe_t *slotframe;
+    scheduleEntry_t *scheduleWalker;
 
     INTERRUPT_DECLARATION();
     DISABLE_INTERRUPTS();
 
-    while (schedule_vars.currentScheduleEntry->slotOffset != targetSlotOffset) {
-        schedule_advanceSlot();
+    ieee154e_getAsn(&(asn[0]));
+    schedule_vars.asn.bytes0and1 = 256 * asn[1] + asn[0];
+    schedule_vars.asn.bytes2and3 = 256 * asn[3] + asn[2];
+    schedule_vars.asn.byte4 = asn[4];
+
+    for (i = 0; i < SCHEDULE_MAX_SLOTFRAMES; i++) {
+        slotframe = &schedule_vars.slotframes[i];
+        if (i == 0) {
+            slotframe->slotOffset = targetSlotOffset;
+        } else if (slotframe->frameLength != 0) {
+            slotframe->slotOffset = schedule_asnToSlotOffset(&schedule_vars.asn, slotframe->frameLength);
+        }
+
+        if (slotframe->currentScheduleEntry == NULL) {
+            continue;
+        }
+
+        // the current entry is the last one at or before the new position
+        scheduleWalker = slotframe->currentScheduleEntry;
+        do {
+            if (
+                    schedule_getDistance(scheduleWalker->slotOffset, slotframe->slotOffset, slotframe->frameLength) <
+                    schedule_getDistance(slotframe->currentScheduleEntry->slotOffset, slotframe->slotOffset,
+                                         slotframe->frameLength)
+                    ) {
+                slotframe->currentScheduleEntry = scheduleWalker;
+            }
+            scheduleWalker = scheduleWalker->next;
+        } while (scheduleWalker != slotframe->currentScheduleEntry);
     }
 
+    schedule_selectEntry();
+    schedule_vars.version++;
+
     ENABLE_INTERRUPTS();
 }
 
 /**
 \brief advance to next active slot
+
+All slotframes move to the first active slot of any of them. The entry used in that slot is picked as explained at
+schedule_selectEntry().
 */
 void schedule_advanceSlot(void) {
+    frameLength_t numSlots;
+    uint16_t bytes0and1;
+    uint8_t i;
+    scheduleSlotframe_t *slotframe;
 
     INTERRUPT_DECLARATION();
     DISABLE_INTERRUPTS();
 
-    schedule_vars.currentScheduleEntry = schedule_vars.currentScheduleEntry->next;
+    numSlots = schedule_getSlotsToNextActiveSlot();
+    if (numSlots == 0) {
+        // empty schedule
+        ENABLE_INTERRUPTS();
+        return;
+    }
+
+    for (i = 0; i < SCHEDULE_MAX_SLOTFRAMES; i++) {
+        slotframe = &schedule_vars.slotframes[i];
+        if (schedule_getSlotsToNextEntry(slotframe) == numSlots) {
+            slotframe->currentScheduleEntry = slotframe->currentScheduleEntry->next;
+        }
+        if (slotframe->frameLength == 0) {
+            slotframe->slotOffset += numSlots;
+        } else {
+            slotframe->slotOffset = (slotframe->slotOffset + numSlots) % slotframe->frameLength;
+        }
+    }
+
+    bytes0and1 = schedule_vars.asn.bytes0and1;
+    schedule_vars.asn.bytes0and1 += numSlots;
+    if (schedule_vars.asn.bytes0and1 < bytes0and1) {
+        schedule_vars.asn.bytes2and3++;
+        if (schedule_vars.asn.bytes2and3 == 0) {
+            schedule_vars.asn.byte4++;
+        }
+    }
+
+    schedule_selectEntry();
 
     ENABLE_INTERRUPTS();
 }
 
 /**
 \brief return slotOffset of next active slot
+
+The slot offset is expressed in the minimal slotframe, which has an active slot every cycle.
 */
 slotOffset_t schedule_getNextActiveSlotOffset(void) {
     slotOffset_t res;
@@ -983,13 +1190,84 @@ slotOffset_t schedule_getNextActiveSlotOffset(void) {
     INTERRUPT_DECLARATION();
     DISABLE_INTERRUPTS();
 
-    res = ((scheduleEntry_t *) (schedule_vars.currentScheduleEntry->next))->slotOffset;
+    res = schedule_vars.slotframes[0].slotOffset + schedule_getSlotsToNextActiveSlot();
+    if (schedule_vars.slotframes[0].frameLength != 0) {
+        res %= schedule_vars.slotframes[0].frameLength;
+    }
 
     ENABLE_INTERRUPTS();
 
     return res;
 }
 
+/**
+\brief Get the information of the cell schedule_advanceSlot() will move to, without moving.
+
+The information stays accurate as long as schedule_getVersion() does not change.
+
+\param info        The information of the cell, info->slotOffset is the slot offset in its own slotframe.
+
+\returns FALSE if the schedule is empty, or if the cell depends on the packets queued at the time of the slot.
+*/
+bool schedule_getNextSlotInfo(slotinfo_element_t *info) {
+    frameLength_t numSlots;
+    uint8_t i;
+    scheduleEntry_t *nextEntry;
+
+    INTERRUPT_DECLARATION();
+    DISABLE_INTERRUPTS();
+
+    nextEntry = NULL;
+    numSlots = schedule_getSlotsToNextActiveSlot();
+    if (numSlots != 0) {
+        for (i = 0; i < SCHEDULE_MAX_SLOTFRAMES; i++) {
+            if (schedule_getSlotsToNextEntry(&schedule_vars.slotframes[i]) != numSlots) {
+                continue;
+            }
+            if (nextEntry != NULL) {
+                // cells of several slotframes overlap, schedule_selectEntry() looks at the queue
+                nextEntry = NULL;
+                break;
+            }
+            nextEntry = schedule_vars.slotframes[i].currentScheduleEntry->next;
+        }
+    }
+
+    if (nextEntry == NULL) {
+        ENABLE_INTERRUPTS();
+        return FALSE;
+    }
+
+    info->link_type = nextEntry->type;
+    info->shared = nextEntry->shared;
+    info->slotframeID = nextEntry->slotframeID;
+    info->slotOffset = nextEntry->slotOffset;
+    info->channelOffset = nextEntry->channelOffset;
+    info->isAutoCell = nextEntry->isAutoCell;
+    memcpy(&(info->address), &(nextEntry->neighbor), sizeof(open_addr_t));
+
+    ENABLE_INTERRUPTS();
+    return TRUE;
+}
+
+/**
+\brief Version of the sequence of active slots.
+
+It changes whenever a cell or a slotframe is added or removed, or the slotframes are resynchronized.
+*/
+uint16_t schedule_getVersion(void) {
+    uint16_t returnVal;
+
+    INTERRUPT_DECLARATION();
+    DISABLE_INTERRUPTS();
+
+    returnVal = schedule_vars.version;
+
+    ENABLE_INTERRUPTS();
+
+    return returnVal;
+}
+
 /**
 \brief Get the frame length.
 
@@ -1001,7 +1279,30 @@ frameLength_t schedule_getFrameLength(void) {
     INTERRUPT_DECLARATION();
     DISABLE_INTERRUPTS();
 
-    returnVal = schedule_vars.frameLength;
+    returnVal = schedule_vars.slotframes[0].frameLength;
+
+    ENABLE_INTERRUPTS();
+
+    return returnVal;
+}
+
+/**
+\brief Get the length of a slotframe.
+
+\returns The length of the slotframe, 0 if it is not in use.
+*/
+frameLength_t schedule_getSlotframeLength(uint8_t slotframeID) {
+    frameLength_t returnVal;
+
+    INTERRUPT_DECLARATION();
+
+    if (slotframeID >= SCHEDULE_MAX_SLOTFRAMES) {
+        return 0;
+    }
+
+    DISABLE_INTERRUPTS();
+
+    returnVal = schedule_vars.slotframes[slotframeID].frameLength;
 
     ENABLE_INTERRUPTS();
 
@@ -1216,6 +1517,7 @@ void schedule_indicateTx(asn_t *asnTimestamp, bool successfullTx) {
     if (successfullTx == TRUE) {
         schedule_vars.currentScheduleEntry->numTxACK++;
     }
+    linkest_indicateTx(&schedule_vars.currentScheduleEntry->linkEstimate, 1, successfullTx);
 
     // update last used timestamp
     memcpy(&schedule_vars.currentScheduleEntry->lastUsedAsn, asnTimestamp, sizeof(asn_t));
@@ -1254,12 +1556,13 @@ bool schedule_getOneCellAfterOffset(uint8_t metadata,
                                     uint8_t cellOptions,
                                     uint16_t *slotoffset,
                                     uint16_t *channeloffset) {
-    (void) metadata;
     (void) neighbor;
 
     bool returnVal;
     scheduleEntry_t *scheduleWalker;
     cellType_t type;
+    frameLength_t frameLength;
+    slotOffset_t slotOffset;
 
     INTERRUPT_DECLARATION();
     DISABLE_INTERRUPTS();
@@ -1275,17 +1578,18 @@ bool schedule_getOneCellAfterOffset(uint8_t metadata,
         type = CELLTYPE_TXRX;
     }
 
+    // the metadata is the slotframe
     returnVal = FALSE;
-    scheduleWalker = &schedule_vars.scheduleBuf[0]; // fisrt entry record slotoffset 0
-    do {
-        if (type == scheduleWalker->type && scheduleWalker->slotOffset >= offset) {
+    frameLength = schedule_getSlotframeLength(metadata);
+    for (slotOffset = offset; slotOffset < frameLength; slotOffset++) {
+        scheduleWalker = schedule_getEntry(metadata, slotOffset);
+        if (scheduleWalker != NULL && type == scheduleWalker->type) {
             *slotoffset = scheduleWalker->slotOffset;
             *channeloffset = scheduleWalker->channelOffset;
             returnVal = TRUE;
             break;
         }
-        scheduleWalker = scheduleWalker->next;
-    } while (scheduleWalker != &schedule_vars.scheduleBuf[0]);
+    }
 
     ENABLE_INTERRUPTS();
 
@@ -1299,6 +1603,7 @@ bool schedule_getOneCellAfterOffset(uint8_t metadata,
 */
 void schedule_resetEntry(scheduleEntry_t *pScheduleEntry) {
     pScheduleEntry->slotOffset = 0;
+    pScheduleEntry->slotframeID = 0;
     pScheduleEntry->type = CELLTYPE_OFF;
     pScheduleEntry->shared = FALSE;
     pScheduleEntry->isAutoCell = FALSE;
@@ -1311,6 +1616,7 @@ void schedule_resetEntry(scheduleEntry_t *pScheduleEntry) {
     pScheduleEntry->numRx = 0;
     pScheduleEntry->numTx = 0;
     pScheduleEntry->numTxACK = 0;
+    linkest_init(&pScheduleEntry->linkEstimate, LINKEST_ETX_ONE);
     pScheduleEntry->lastUsedAsn.bytes0and1 = 0;
     pScheduleEntry->lastUsedAsn.bytes2and3 = 0;
     pScheduleEntry->lastUsedAsn.byte4 = 0;
@@ -1329,9 +1635,320 @@ void schedule_resetBackupEntry(backupEntry_t *pBackupEntry) {
     pBackupEntry->numRx = 0;
     pBackupEntry->numTx = 0;
     pBackupEntry->numTxACK = 0;
+    linkest_init(&pBackupEntry->linkEstimate, LINKEST_ETX_ONE);
     pBackupEntry->lastUsedAsn.bytes0and1 = 0;
     pBackupEntry->lastUsedAsn.bytes2and3 = 0;
     pBackupEntry->lastUsedAsn.byte4 = 0;
     pBackupEntry->next = NULL;
 }
 
+/**
+\brief Find the schedule entry of a slot offset.
+
+\pre This function assumes interrupts are already disabled.
+
+\returns The schedule entry, NULL if there is none at that slot offset.
+*/
+static scheduleEntry_t *schedule_getEntry(uint8_t slotframeID, slotOffset_t slotOffset) {
+    uint8_t i;
+    scheduleSlotframe_t *slotframe;
+
+    if (slotframeID >= SCHEDULE_MAX_SLOTFRAMES) {
+        return NULL;
+    }
+    slotframe = &schedule_vars.slotframes[slotframeID];
+
+    if (slotOffset < SLOTFRAME_LENGTH) {
+        if ((slotframe->occupiedSlots[slotOffset / 8] & (1 << (slotOffset % 8))) == 0) {
+            return NULL;
+        }
+        return &schedule_vars.scheduleBuf[slotframe->slotIndex[slotOffset]];
+    }
+
+    // not covered by the index
+    for (i = 0; i < schedule_vars.maxActiveSlots; i++) {
+        if (
+                schedule_vars.scheduleBuf[i].type != CELLTYPE_OFF &&
+                schedule_vars.scheduleBuf[i].slotframeID == slotframeID &&
+                schedule_vars.scheduleBuf[i].slotOffset == slotOffset
+                ) {
+            return &schedule_vars.scheduleBuf[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+\brief Record the schedule entry of a slot offset in the index.
+
+\param slotframeID     The slotframe.
+\param slotOffset      The slot offset.
+\param pScheduleEntry  The schedule entry now at that slot offset, NULL if the slot offset was freed.
+
+\pre This function assumes interrupts are already disabled.
+*/
+static void schedule_indexSlot(uint8_t slotframeID, slotOffset_t slotOffset, scheduleEntry_t *pScheduleEntry) {
+    scheduleSlotframe_t *slotframe;
+
+    if (slotOffset >= SLOTFRAME_LENGTH) {
+        return;
+    }
+    slotframe = &schedule_vars.slotframes[slotframeID];
+
+    if (pScheduleEntry == NULL) {
+        slotframe->slotIndex[slotOffset] = SCHEDULE_NO_ENTRY;
+        slotframe->occupiedSlots[slotOffset / 8] &= ~(1 << (slotOffset % 8));
+    } else {
+        slotframe->slotIndex[slotOffset] = (uint8_t) (pScheduleEntry - &schedule_vars.scheduleBuf[0]);
+        slotframe->occupiedSlots[slotOffset / 8] |= 1 << (slotOffset % 8);
+    }
+}
+
+/**
+\brief Number of slots from one slot offset to another, going forward in a slotframe.
+
+A slotframe of length 0 (the minimal slotframe before its length is known) wraps around at 2^16.
+*/
+static frameLength_t schedule_getDistance(slotOffset_t from, slotOffset_t to, frameLength_t frameLength) {
+    if (frameLength == 0) {
+        return (frameLength_t) (to - from);
+    }
+    return (frameLength_t) ((to + frameLength - from) % frameLength);
+}
+
+/**
+\brief Number of slots from the position of a slotframe to its next entry.
+
+\pre This function assumes interrupts are already disabled.
+
+\returns The number of slots, a full slotframe if it has a single entry at its position, 0 if it has no entries.
+*/
+static frameLength_t schedule_getSlotsToNextEntry(scheduleSlotframe_t *slotframe) {
+    frameLength_t numSlots;
+
+    if (slotframe->currentScheduleEntry == NULL) {
+        return 0;
+    }
+
+    numSlots = schedule_getDistance(
+            slotframe->slotOffset,
+            ((scheduleEntry_t *) (slotframe->currentScheduleEntry->next))->slotOffset,
+            slotframe->frameLength
+    );
+    if (numSlots == 0) {
+        numSlots = slotframe->frameLength;
+    }
+    return numSlots;
+}
+
+/**
+\brief Number of slots from the current position to the next active slot of any slotframe.
+
+\pre This function assumes interrupts are already disabled.
+
+\returns The number of slots, 0 if the schedule is empty.
+*/
+static frameLength_t schedule_getSlotsToNextActiveSlot(void) {
+    frameLength_t slotsToNextEntry;
+    frameLength_t numSlots;
+    uint8_t i;
+
+    numSlots = 0;
+    for (i = 0; i < SCHEDULE_MAX_SLOTFRAMES; i++) {
+        slotsToNextEntry = schedule_getSlotsToNextEntry(&schedule_vars.slotframes[i]);
+        if (slotsToNextEntry != 0 && (numSlots == 0 || slotsToNextEntry < numSlots)) {
+            numSlots = slotsToNextEntry;
+        }
+    }
+    return numSlots;
+}
+
+static slotOffset_t schedule_asnToSlotOffset(asn_t *asn, frameLength_t frameLength) {
+    uint32_t slotOffset;
+
+    slotOffset = asn->byte4;
+    slotOffset = slotOffset % frameLength;
+    slotOffset = slotOffset << 16;
+    slotOffset = slotOffset + asn->bytes2and3;
+    slotOffset = slotOffset % frameLength;
+    slotOffset = slotOffset << 16;
+    slotOffset = slotOffset + asn->bytes0and1;
+    slotOffset = slotOffset % frameLength;
+
+    return (slotOffset_t) slotOffset;
+}
+
+/**
+\brief Pick the entry used in the current slot among the slotframes with an entry at their position.
+
+A TX cell with a packet queued for its neighbor takes precedence, otherwise the cell of the lowest slotframe is used
+(IEEE802.15.4-2015, 6.2.6.3). The queue is only looked at when slotframes overlap.
+
+\pre This function assumes interrupts are already disabled.
+*/
+static void schedule_selectEntry(void) {
+    uint8_t i;
+    uint8_t numCandidates;
+    scheduleEntry_t *candidate;
+    scheduleEntry_t *selected;
+
+    numCandidates = 0;
+    selected = NULL;
+    for (i = 0; i < SCHEDULE_MAX_SLOTFRAMES; i++) {
+        candidate = schedule_vars.slotframes[i].currentScheduleEntry;
+        if (candidate != NULL && candidate->slotOffset == schedule_vars.slotframes[i].slotOffset) {
+            if (selected == NULL) {
+                selected = candidate;
+            }
+            numCandidates++;
+        }
+    }
+
+    if (selected == NULL) {
+        return;
+    }
+
+    if (numCandidates > 1) {
+        for (i = 0; i < SCHEDULE_MAX_SLOTFRAMES; i++) {
+            candidate = schedule_vars.slotframes[i].currentScheduleEntry;
+            if (
+                    candidate != NULL &&
+                    candidate->slotOffset == schedule_vars.slotframes[i].slotOffset &&
+                    (candidate->type == CELLTYPE_TX || candidate->type == CELLTYPE_TXRX) &&
+                    candidate->neighbor.type == ADDR_64B &&
+                    openqueue_macHasUnicastPacket(&candidate->neighbor)
+                    ) {
+                selected = candidate;
+                break;
+            }
+        }
+    }
+
+    schedule_vars.currentScheduleEntry = selected;
+}
+
+/**
+\brief Find the row of a neighbor in the per-neighbor cell index.
+
+Only unicast (64-bit) neighbors are indexed. The row of a neighbor in the neighbor table is found from its index in
+that table, only neighbors outside the table are looked up by address, and only when some row holds one.
+
+\param neighbor    The neighbor.
+\param allocate    Whether to hand out a free row if the neighbor has none. The row is only taken once a cell is
+                    counted in it.
+
+\pre This function assumes interrupts are already disabled.
+
+\returns The row, NULL if the neighbor has none (and none could be allocated).
+*/
+static scheduleNeighborCells_t *schedule_getNeighborCells(open_addr_t *neighbor, bool allocate) {
+    uint8_t i;
+    uint8_t index;
+    scheduleNeighborCells_t *neighborCells;
+
+    if (neighbor->type != ADDR_64B) {
+        return NULL;
+    }
+
+    if (neighbors_getIndex(neighbor, &index)) {
+        if (schedule_vars.neighborCellsRow[index] != SCHEDULE_NO_ENTRY) {
+            return &schedule_vars.neighborCells[schedule_vars.neighborCellsRow[index]];
+        }
+    } else {
+        neighborCells = schedule_findUnindexedNeighborCells(neighbor);
+        if (neighborCells != NULL) {
+            return neighborCells;
+        }
+    }
+
+    if (allocate == FALSE) {
+        return NULL;
+    }
+
+    // the neighbor gets its first cell, hand out a free row
+    for (i = 0; i < SCHEDULE_MAXNEIGHBORS; i++) {
+        if (schedule_vars.neighborCells[i].numCells == 0) {
+            memcpy(&schedule_vars.neighborCells[i].neighbor, neighbor, sizeof(open_addr_t));
+            return &schedule_vars.neighborCells[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+\brief Row of a neighbor which is not indexed by its index in the neighbor table, because it was not in the table when
+    it got its first cell or it left the table since.
+
+\pre This function assumes interrupts are already disabled.
+
+\returns The row, NULL if the neighbor has none.
+*/
+static scheduleNeighborCells_t *schedule_findUnindexedNeighborCells(open_addr_t *neighbor) {
+    uint8_t i;
+
+    if (schedule_vars.numUnindexedNeighbors == 0) {
+        return NULL;
+    }
+
+    for (i = 0; i < SCHEDULE_MAXNEIGHBORS; i++) {
+        if (
+                schedule_vars.neighborCells[i].numCells > 0 &&
+                packetfunctions_sameAddress(neighbor, &schedule_vars.neighborCells[i].neighbor)
+                ) {
+            return &schedule_vars.neighborCells[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+\pre This function assumes interrupts are already disabled.
+*/
+static void schedule_countCell(scheduleNeighborCells_t *neighborCells, bool shared, cellType_t type) {
+    uint8_t index;
+
+    if (neighborCells == NULL) {
+        return;
+    }
+
+    if (neighborCells->numCells == 0) {
+        // the row is taken, index it
+        if (neighbors_getIndex(&neighborCells->neighbor, &index)) {
+            schedule_vars.neighborCellsRow[index] = (uint8_t) (neighborCells - schedule_vars.neighborCells);
+        } else {
+            schedule_vars.numUnindexedNeighbors++;
+        }
+    }
+
+    neighborCells->numCells++;
+    neighborCells->numCellsByType[shared ? 1 : 0][type]++;
+}
+
+/**
+\pre This function assumes interrupts are already disabled.
+*/
+static void schedule_uncountCell(open_addr_t *neighbor, bool shared, cellType_t type) {
+    uint8_t index;
+    scheduleNeighborCells_t *neighborCells;
+
+    neighborCells = schedule_getNeighborCells(neighbor, FALSE);
+    if (neighborCells == NULL) {
+        return;
+    }
+
+    neighborCells->numCells--;
+    neighborCells->numCellsByType[shared ? 1 : 0][type]--;
+
+    if (neighborCells->numCells == 0) {
+        // the row is free again
+        if (
+                neighbors_getIndex(neighbor, &index) &&
+                schedule_vars.neighborCellsRow[index] == (uint8_t) (neighborCells - schedule_vars.neighborCells)
+                ) {
+            schedule_vars.neighborCellsRow[index] = SCHEDULE_NO_ENTRY;
+        } else {
+            schedule_vars.numUnindexedNeighbors--;
+        }
+    }
+}
+
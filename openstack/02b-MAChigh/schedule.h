@@ -9,6 +9,7 @@
 */
 
 #include "opendefs.h"
+#include "linkest.h"
 
 //=========================== define ==========================================
 
@@ -60,6 +61,36 @@ in your schedule, so not to waste RAM.
 #define MAXACTIVESLOTS       (SCHEDULE_MINIMAL_6TISCH_ACTIVE_CELLS + NUMSLOTSOFF)
 #endif
 
+/**
+\brief Marks a slot offset without entry in the slot offset index.
+
+Rows of the schedule are indexed on a single byte, so MAXACTIVESLOTS must stay below this value.
+*/
+#define SCHEDULE_NO_ENTRY    0xff
+
+#if MAXACTIVESLOTS >= SCHEDULE_NO_ENTRY
+#error "MAXACTIVESLOTS must be smaller than 255"
+#endif
+
+/**
+\brief Number of bytes of the bitmap of occupied slot offsets.
+
+The slot offset index of a slotframe covers the offsets 0..SLOTFRAME_LENGTH-1. Cells at higher offsets, which only
+exist when the mote joins a network advertising a longer slotframe, are looked up by scanning the schedule.
+*/
+#define SCHEDULE_OCCUPIED_LEN    ((SLOTFRAME_LENGTH + 7) / 8)
+
+/**
+\brief Maximum number of neighbors with unicast cells in the schedule.
+
+Each row of the per-neighbor cell index counts the cells, including those in backup entries, installed to one
+neighbor. A cell is only added when its neighbor has a row, or a row is free for it. The row of a neighbor in the
+neighbor table is found from its index in that table, rows of other neighbors are looked up by address.
+*/
+#ifndef SCHEDULE_MAXNEIGHBORS
+#define SCHEDULE_MAXNEIGHBORS    MAXACTIVESLOTS
+#endif
+
 /**
 \brief Maximum number of alternative slots (more than one cells with same slotOffset)
 
@@ -123,12 +154,14 @@ typedef struct {
     uint8_t numRx;
     uint8_t numTx;
     uint8_t numTxACK;
+    linkest_t linkEstimate;
     asn_t lastUsedAsn;
     void *next;
 } backupEntry_t;
 
 typedef struct {
     slotOffset_t slotOffset;
+    uint8_t slotframeID;
     cellType_t type;
     bool shared;
     bool isAutoCell;
@@ -137,15 +170,37 @@ typedef struct {
     uint8_t numRx;
     uint8_t numTx;
     uint8_t numTxACK;
+    linkest_t linkEstimate;                     // ETX of the cell, numTx and numTxACK are only reported
     asn_t lastUsedAsn;
     backupEntry_t backupEntries[MAXBACKUPSLOTS];
     void *next;
 } scheduleEntry_t;
 
+/**
+\brief A slotframe of the schedule.
+
+The entries of a slotframe form a circular list sorted on slot offset. slotOffset is the position of the slotframe at
+the ASN of the current active slot; currentScheduleEntry is the last entry at or before that position.
+*/
+typedef struct {
+    frameLength_t frameLength;                  // 0 if the slotframe is not in use
+    slotOffset_t slotOffset;
+    scheduleEntry_t *currentScheduleEntry;
+    uint8_t slotIndex[SLOTFRAME_LENGTH];        // row in scheduleBuf of each slot offset, SCHEDULE_NO_ENTRY if none
+    uint8_t occupiedSlots[SCHEDULE_OCCUPIED_LEN];  // one bit per slot offset with an entry
+} scheduleSlotframe_t;
+
+typedef struct {
+    open_addr_t neighbor;
+    uint8_t numCells;                           // total number of cells to this neighbor, 0 if the row is free
+    uint8_t numCellsByType[2][CELLTYPE_TXRX + 1];  // number of cells, indexed on [shared][type]
+} scheduleNeighborCells_t;
+
 typedef struct {
     open_addr_t address;
     cellType_t link_type;
     bool shared;
+    uint8_t slotframeID;
     slotOffset_t slotOffset;
     channelOffset_t channelOffset;
     bool isAutoCell;
@@ -155,8 +210,13 @@ typedef struct {
 
 typedef struct {
     scheduleEntry_t scheduleBuf[MAXACTIVESLOTS];
-    scheduleEntry_t *currentScheduleEntry;
-    frameLength_t frameLength;
+    scheduleEntry_t *currentScheduleEntry;      // entry used in the current active slot, picked among the slotframes
+    scheduleSlotframe_t slotframes[SCHEDULE_MAX_SLOTFRAMES];
+    asn_t asn;                                  // ASN of the current active slot
+    scheduleNeighborCells_t neighborCells[SCHEDULE_MAXNEIGHBORS];
+    uint8_t neighborCellsRow[MAXNUMNEIGHBORS];  // row in neighborCells of each neighbor table row, SCHEDULE_NO_ENTRY if none
+    uint8_t numUnindexedNeighbors;              // rows in use for neighbors not in the neighbor table
+    uint16_t version;                           // bumped whenever the sequence of active slots may have changed
     frameLength_t maxActiveSlots;
     uint8_t frameHandle;
     uint8_t frameNumber;
@@ -179,7 +239,10 @@ void schedule_setFrameHandle(uint8_t frameHandle);
 
 void schedule_setFrameNumber(uint8_t frameNumber);
 
+owerror_t schedule_addSlotframe(uint8_t slotframeID, frameLength_t frameLength);
+
 owerror_t schedule_addActiveSlot(
+        uint8_t slotframeID,
         slotOffset_t slotOffset,
         cellType_t type,
         bool shared,
@@ -189,11 +252,15 @@ owerror_t schedule_addActiveSlot(
 );
 
 void schedule_getSlotInfo(
+        uint8_t slotframeID,
         slotOffset_t slotOffset,
         slotinfo_element_t *info
 );
 
+void schedule_getCurrentSlotInfo(slotOffset_t slotOffset, slotinfo_element_t *info);
+
 owerror_t schedule_removeActiveSlot(
+        uint8_t slotframeID,
         slotOffset_t slotOffset,
         cellType_t type,
         bool isShared,
@@ -202,7 +269,7 @@ owerror_t schedule_removeActiveSlot(
 
 // void schedule_removeAllAutonomousTxRxCellUnicast(void);
 
-bool schedule_isSlotOffsetAvailable(uint16_t slotOffset);
+bool schedule_isSlotOffsetAvailable(uint8_t slotframeID, uint16_t slotOffset);
 
 void schedule_removeAllNegotiatedCellsToNeighbor(uint8_t slotframeID, open_addr_t *neighbor);
 
@@ -210,9 +277,7 @@ uint8_t schedule_getNumberOfFreeEntries(void);
 
 uint8_t schedule_getNumberOfNegotiatedCells(open_addr_t *neighbor, cellType_t cell_type);
 
-bool schedule_isNumTxWrapped(open_addr_t *neighbor);
-
-bool schedule_getCellsToBeRelocated(open_addr_t *neighbor, cellInfo_ht *celllist);
+bool schedule_getCellsToBeRelocated(uint8_t slotframeID, open_addr_t *neighbor, cellInfo_ht *celllist);
 
 bool schedule_hasAutonomousTxRxCellUnicast(open_addr_t *neighbor);
 
@@ -230,6 +295,11 @@ bool schedule_hasNegotiatedCellToNeighbor(open_addr_t *neighbor, cellType_t cell
 
 bool schedule_hasNegotiatedTxCellToNonParent(open_addr_t *parentNeighbor, open_addr_t *nonParentNeighbor);
 
+// from neighbors
+void schedule_indicateNeighborAdded(uint8_t index, open_addr_t *neighbor);
+
+void schedule_indicateNeighborRemoved(uint8_t index);
+
 // from IEEE802154E
 void schedule_syncSlotOffset(slotOffset_t targetSlotOffset);
 
@@ -237,8 +307,14 @@ void schedule_advanceSlot(void);
 
 slotOffset_t schedule_getNextActiveSlotOffset(void);
 
+bool schedule_getNextSlotInfo(slotinfo_element_t *info);
+
+uint16_t schedule_getVersion(void);
+
 frameLength_t schedule_getFrameLength(void);
 
+frameLength_t schedule_getSlotframeLength(uint8_t slotframeID);
+
 cellType_t schedule_getType(void);
 
 bool schedule_getShared(void);
@@ -38,8 +38,13 @@ END_PACK
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define sixtop_vars       MOTE_CTX_VAR(sixtopVars_t, sixtop_vars)
+#define sixtop_status_ctx MOTE_CTX_VAR(sixtopStatus_t, sixtop_status_ctx)
+#else
 sixtopVars_t sixtop_vars;
 sixtopStatus_t sixtop_status_ctx;
+#endif
 
 //=========================== prototypes ======================================
 
@@ -116,18 +121,20 @@ void sixtop_init(void) {
     sixtop_vars.six2six_state = SIX_STATE_IDLE;
 
     sixtop_vars.ebSendingTimerId = opentimers_create(TIMER_GENERAL_PURPOSE, TASKPRIO_SIXTOP);
-    opentimers_scheduleIn(
+    opentimers_scheduleInWithSlack(
             sixtop_vars.ebSendingTimerId,
             SLOTFRAME_LENGTH * SLOTDURATION,
+            OPENTIMERS_SLACK(SLOTFRAME_LENGTH * SLOTDURATION),
             TIME_MS,
             TIMER_PERIODIC,
             sixtop_sendingEb_timer_cb
     );
 
     sixtop_vars.maintenanceTimerId = opentimers_create(TIMER_GENERAL_PURPOSE, TASKPRIO_SIXTOP);
-    opentimers_scheduleIn(
+    opentimers_scheduleInWithSlack(
             sixtop_vars.maintenanceTimerId,
             sixtop_vars.periodMaintenance,
+            OPENTIMERS_SLACK(sixtop_vars.periodMaintenance),
             TIME_MS,
             TIMER_PERIODIC,
             sixtop_maintenance_timer_cb
@@ -210,6 +217,7 @@ owerror_t sixtop_request(
             for (i = 0; i < CELLLIST_MAX_LEN; i++) {
                 if (celllist_toBeAdded[i].isUsed) {
                     if (packetfunctions_reserveHeader(&pkt, 4) == E_FAIL) {
+                        openqueue_freePacketBuffer(pkt);
                         return E_FAIL;
                     }
                     pkt->payload[0] = (uint8_t) (celllist_toBeAdded[i].slotoffset & 0x00FF);
@@ -224,6 +232,7 @@ owerror_t sixtop_request(
             for (i = 0; i < CELLLIST_MAX_LEN; i++) {
                 if (celllist_toBeDeleted[i].isUsed) {
                     if (packetfunctions_reserveHeader(&pkt, 4) == E_FAIL) {
+                        openqueue_freePacketBuffer(pkt);
                         return E_FAIL;
                     }
                     pkt->payload[0] = (uint8_t) (celllist_toBeDeleted[i].slotoffset & 0x00FF);
@@ -235,7 +244,8 @@ owerror_t sixtop_request(
             }
         }
         // append 6p numberCells
-        if (packetfunctions_reserveHeader(&pkt, sizeof(uint8_t))) {
+        if (packetfunctions_reserveHeader(&pkt, sizeof(uint8_t)) == E_FAIL) {
+            openqueue_freePacketBuffer(pkt);
             return E_FAIL;
         }
         *((uint8_t *) (pkt->payload)) = numCells;
@@ -245,6 +255,7 @@ owerror_t sixtop_request(
     if (code == IANA_6TOP_CMD_LIST) {
         // append 6p max number of cells
         if (packetfunctions_reserveHeader(&pkt, sizeof(uint16_t)) == E_FAIL) {
+            openqueue_freePacketBuffer(pkt);
             return E_FAIL;
         }
         *((uint8_t *) (pkt->payload)) = (uint8_t) (listingMaxNumCells & 0x00FF);
@@ -252,6 +263,7 @@ owerror_t sixtop_request(
         len += 2;
         // append 6p listing offset
         if (packetfunctions_reserveHeader(&pkt, sizeof(uint16_t)) == E_FAIL) {
+            openqueue_freePacketBuffer(pkt);
             return E_FAIL;
         }
         *((uint8_t *) (pkt->payload)) = (uint8_t) (listingOffset & 0x00FF);
@@ -259,6 +271,7 @@ owerror_t sixtop_request(
         len += 2;
         // append 6p Reserved field
         if (packetfunctions_reserveHeader(&pkt, sizeof(uint8_t)) == E_FAIL) {
+            openqueue_freePacketBuffer(pkt);
             return E_FAIL;
         }
         *((uint8_t *) (pkt->payload)) = 0;
@@ -268,6 +281,7 @@ owerror_t sixtop_request(
     if (code != IANA_6TOP_CMD_CLEAR) {
         // append 6p celloptions
         if (packetfunctions_reserveHeader(&pkt, sizeof(uint8_t)) == E_FAIL) {
+            openqueue_freePacketBuffer(pkt);
             return E_FAIL;
         }
         *((uint8_t *) (pkt->payload)) = cellOptions;
@@ -279,6 +293,7 @@ owerror_t sixtop_request(
 
     // append 6p metadata
     if (packetfunctions_reserveHeader(&pkt, sizeof(uint16_t)) == E_FAIL) {
+        openqueue_freePacketBuffer(pkt);
         return E_FAIL;
     }
     pkt->payload[0] = (uint8_t) (sixtop_vars.cb_sf_getMetadata() & 0x00FF);
@@ -287,6 +302,7 @@ owerror_t sixtop_request(
 
     // append 6p Seqnum and schedule Generation
     if (packetfunctions_reserveHeader(&pkt, sizeof(uint8_t)) == E_FAIL) {
+        openqueue_freePacketBuffer(pkt);
         return E_FAIL;
     }
     sequenceNumber = neighbors_getSequenceNumber(neighbor);
@@ -295,6 +311,7 @@ owerror_t sixtop_request(
 
     // append 6p sfid
     if (packetfunctions_reserveHeader(&pkt, sizeof(uint8_t)) == E_FAIL) {
+        openqueue_freePacketBuffer(pkt);
         return E_FAIL;
     }
     *((uint8_t *) (pkt->payload)) = sfid;
@@ -302,6 +319,7 @@ owerror_t sixtop_request(
 
     // append 6p code
     if (packetfunctions_reserveHeader(&pkt, sizeof(uint8_t)) == E_FAIL) {
+        openqueue_freePacketBuffer(pkt);
         return E_FAIL;
     }
     *((uint8_t *) (pkt->payload)) = code;
@@ -311,6 +329,7 @@ owerror_t sixtop_request(
 
     // append 6p version, T(type) and  R(reserved)
     if (packetfunctions_reserveHeader(&pkt, sizeof(uint8_t)) == E_FAIL) {
+        openqueue_freePacketBuffer(pkt);
         return E_FAIL;
     }
     *((uint8_t *) (pkt->payload)) = IANA_6TOP_6P_VERSION | IANA_6TOP_TYPE_REQUEST;
@@ -318,6 +337,7 @@ owerror_t sixtop_request(
 
     // append 6p subtype id
     if (packetfunctions_reserveHeader(&pkt, sizeof(uint8_t)) == E_FAIL) {
+        openqueue_freePacketBuffer(pkt);
         return E_FAIL;
     }
     *((uint8_t *) (pkt->payload)) = IANA_6TOP_SUBIE_ID;
@@ -325,6 +345,7 @@ owerror_t sixtop_request(
 
     // append IETF IE header (length_groupid_type)
     if (packetfunctions_reserveHeader(&pkt, sizeof(uint16_t)) == E_FAIL) {
+        openqueue_freePacketBuffer(pkt);
         return E_FAIL;
     }
     length_groupid_type = len;
@@ -608,7 +629,7 @@ owerror_t sixtop_send_internal(OpenQueueEntry_t *msg, bool payloadIEPresent) {
         return E_FAIL;
     }
     // change owner to IEEE802154E fetches it from queue
-    msg->owner = COMPONENT_SIXTOP_TO_IEEE802154E;
+    openqueue_macEnqueue(msg);
 
     if (
             packetfunctions_isBroadcastMulticast(&(msg->l2_nextORpreviousHop)) == FALSE &&
@@ -620,6 +641,7 @@ owerror_t sixtop_send_internal(OpenQueueEntry_t *msg, bool payloadIEPresent) {
         // no auto tx cell to that neighbor
 
         schedule_addActiveSlot(
+                SCHEDULE_MINIMAL_6TISCH_DEFAULT_SLOTFRAME_HANDLE,                // slotframe
                 msf_hashFunction_getSlotoffset(&(msg->l2_nextORpreviousHop)),    // slot offset
                 CELLTYPE_TX,                                                     // type of slot
                 TRUE,                                                            // shared?
@@ -754,7 +776,10 @@ port_INLINE void sixtop_sendEB(void) {
     // in case we none default number of shared cells defined in minimal configuration
     if (ebIEsBytestream[EB_SLOTFRAME_NUMLINK_OFFSET] > 1) {
         for (i = ebIEsBytestream[EB_SLOTFRAME_NUMLINK_OFFSET] - 1; i > 0; i--) {
-            packetfunctions_reserveHeader(&eb, 5);
+            if (packetfunctions_reserveHeader(&eb, 5) == E_FAIL) {
+                openqueue_freePacketBuffer(eb);
+                return;
+            }
             eb->payload[0] = i;    // slot offset
             eb->payload[1] = 0x00;
             eb->payload[2] = 0x00; // channel offset
@@ -764,7 +789,10 @@ port_INLINE void sixtop_sendEB(void) {
     }
 
     // reserve space for EB IEs
-    packetfunctions_reserveHeader(&eb, EB_IE_LEN);
+    if (packetfunctions_reserveHeader(&eb, EB_IE_LEN) == E_FAIL) {
+        openqueue_freePacketBuffer(eb);
+        return;
+    }
     for (i = 0; i < EB_IE_LEN; i++) {
         eb->payload[i] = ebIEsBytestream[i];
     }
@@ -777,6 +805,7 @@ port_INLINE void sixtop_sendEB(void) {
         eb->payload[1] = (uint8_t) ((temp16b & 0xff00) >> 8);
     }
 
+    eb->payload[EB_SLOTFRAME_TS_ID_OFFSET] = TIMESLOT_TEMPLATE_ID;
     eb->payload[EB_SLOTFRAME_LEN_OFFSET] = (uint8_t) (0x00FF & (schedule_getFrameLength()));
     eb->payload[EB_SLOTFRAME_LEN_OFFSET + 1] = (uint8_t) (0x00FF & (schedule_getFrameLength() >> 8));
 
@@ -1129,6 +1158,13 @@ void sixtop_six2six_notifyReceive(
             return;
         }
 
+        // the response records the cells to add or delete when it is sent
+        if (openqueue_getCelllists(response_pkt) == E_FAIL) {
+            LOG_ERROR(COMPONENT_SIXTOP_RES, ERR_NO_FREE_PACKET_BUFFER, (errorparameter_t) 1, (errorparameter_t) 0);
+            openqueue_freePacketBuffer(response_pkt);
+            return;
+        }
+
         // take ownership
         response_pkt->creator = COMPONENT_SIXTOP_RES;
         response_pkt->owner = COMPONENT_SIXTOP_RES;
@@ -1172,6 +1208,13 @@ void sixtop_six2six_notifyReceive(
             ptr += 2;
             pktLen -= 2;
 
+            // the frame must be in our schedule
+            if (metadata >= SCHEDULE_MAX_SLOTFRAMES || schedule_getSlotframeLength((uint8_t) metadata) == 0) {
+                LOG_ERROR(COMPONENT_SIXTOP, ERR_INVALID_PARAM, (errorparameter_t) metadata, 0);
+                returnCode = IANA_6TOP_RC_ERROR;
+                break;
+            }
+
             // clear command
             if (code == IANA_6TOP_CMD_CLEAR) {
                 // the cells will be removed when the repsonse sendone successfully
@@ -1212,7 +1255,10 @@ void sixtop_six2six_notifyReceive(
                                     &channeloffset)
                             ) {
                         // found one cell after slot offset+i
-                        packetfunctions_reserveHeader(&response_pkt, 4);
+                        if (packetfunctions_reserveHeader(&response_pkt, 4) == E_FAIL) {
+                            openqueue_freePacketBuffer(response_pkt);
+                            return;
+                        }
                         response_pkt->payload[0] = slotoffset & 0x00FF;
                         response_pkt->payload[1] = (slotoffset & 0xFF00) >> 8;
                         response_pkt->payload[2] = channeloffset & 0x00FF;
@@ -1249,7 +1295,7 @@ void sixtop_six2six_notifyReceive(
                 } else {
                     cellOptions_transformed = cellOptions;
                 }
-                for (i = 0; i < schedule_getFrameLength(); i++) {
+                for (i = 0; i < schedule_getSlotframeLength(metadata); i++) {
                     if (
                             schedule_getOneCellAfterOffset(
                                     metadata,
@@ -1265,7 +1311,10 @@ void sixtop_six2six_notifyReceive(
                     }
                 }
                 returnCode = IANA_6TOP_RC_SUCCESS;
-                packetfunctions_reserveHeader(&response_pkt, sizeof(uint16_t));
+                if (packetfunctions_reserveHeader(&response_pkt, sizeof(uint16_t)) == E_FAIL) {
+                    openqueue_freePacketBuffer(response_pkt);
+                    return;
+                }
                 response_pkt->payload[0] = numCells & 0x00FF;
                 response_pkt->payload[1] = (numCells & 0xFF00) >> 8;
                 response_pktLen += 2;
@@ -1284,7 +1333,7 @@ void sixtop_six2six_notifyReceive(
                 }
                 // retrieve cell list
                 i = 0;
-                memset(response_pkt->l2_sixtop_celllist_add, 0, sizeof(response_pkt->l2_sixtop_celllist_add));
+                memset(response_pkt->l2_sixtop_celllist_add, 0, CELLLIST_MAX_LEN * sizeof(cellInfo_ht));
                 while (pktLen > 0) {
                     response_pkt->l2_sixtop_celllist_add[i].slotoffset = *((uint8_t *) (pkt->payload) + ptr);
                     response_pkt->l2_sixtop_celllist_add[i].slotoffset |=
@@ -1300,7 +1349,10 @@ void sixtop_six2six_notifyReceive(
                 if (sixtop_areAvailableCellsToBeScheduled(metadata, numCells, response_pkt->l2_sixtop_celllist_add)) {
                     for (i = 0; i < CELLLIST_MAX_LEN; i++) {
                         if (response_pkt->l2_sixtop_celllist_add[i].isUsed) {
-                            packetfunctions_reserveHeader(&response_pkt, 4);
+                            if (packetfunctions_reserveHeader(&response_pkt, 4) == E_FAIL) {
+                                openqueue_freePacketBuffer(response_pkt);
+                                return;
+                            }
                             response_pkt->payload[0] = (uint8_t) (
                                     response_pkt->l2_sixtop_celllist_add[i].slotoffset & 0x00FF);
                             response_pkt->payload[1] = (uint8_t) (
@@ -1320,7 +1372,7 @@ void sixtop_six2six_notifyReceive(
             // delete command
             if (code == IANA_6TOP_CMD_DELETE) {
                 i = 0;
-                memset(response_pkt->l2_sixtop_celllist_delete, 0, sizeof(response_pkt->l2_sixtop_celllist_delete));
+                memset(response_pkt->l2_sixtop_celllist_delete, 0, CELLLIST_MAX_LEN * sizeof(cellInfo_ht));
                 while (pktLen > 0) {
                     response_pkt->l2_sixtop_celllist_delete[i].slotoffset = *((uint8_t *) (pkt->payload) + ptr);
                     response_pkt->l2_sixtop_celllist_delete[i].slotoffset |=
@@ -1343,7 +1395,10 @@ void sixtop_six2six_notifyReceive(
                     returnCode = IANA_6TOP_RC_SUCCESS;
                     for (i = 0; i < CELLLIST_MAX_LEN; i++) {
                         if (response_pkt->l2_sixtop_celllist_delete[i].isUsed) {
-                            packetfunctions_reserveHeader(&response_pkt, 4);
+                            if (packetfunctions_reserveHeader(&response_pkt, 4) == E_FAIL) {
+                                openqueue_freePacketBuffer(response_pkt);
+                                return;
+                            }
                             response_pkt->payload[0] = (uint8_t) (
                                     response_pkt->l2_sixtop_celllist_delete[i].slotoffset & 0x00FF);
                             response_pkt->payload[1] = (uint8_t) (
@@ -1365,7 +1420,7 @@ void sixtop_six2six_notifyReceive(
             if (code == IANA_6TOP_CMD_RELOCATE) {
                 // retrieve cell list to be relocated
                 i = 0;
-                memset(response_pkt->l2_sixtop_celllist_delete, 0, sizeof(response_pkt->l2_sixtop_celllist_delete));
+                memset(response_pkt->l2_sixtop_celllist_delete, 0, CELLLIST_MAX_LEN * sizeof(cellInfo_ht));
                 temp16 = numCells;
                 while (temp16 > 0) {
                     response_pkt->l2_sixtop_celllist_delete[i].slotoffset = *((uint8_t *) (pkt->payload) + ptr);
@@ -1393,7 +1448,7 @@ void sixtop_six2six_notifyReceive(
                 }
                 // retrieve cell list to be relocated
                 i = 0;
-                memset(response_pkt->l2_sixtop_celllist_add, 0, sizeof(response_pkt->l2_sixtop_celllist_add));
+                memset(response_pkt->l2_sixtop_celllist_add, 0, CELLLIST_MAX_LEN * sizeof(cellInfo_ht));
                 while (pktLen > 0) {
                     response_pkt->l2_sixtop_celllist_add[i].slotoffset = *((uint8_t *) (pkt->payload) + ptr);
                     response_pkt->l2_sixtop_celllist_add[i].slotoffset |=
@@ -1409,7 +1464,10 @@ void sixtop_six2six_notifyReceive(
                 if (sixtop_areAvailableCellsToBeScheduled(metadata, numCells, response_pkt->l2_sixtop_celllist_add)) {
                     for (i = 0; i < CELLLIST_MAX_LEN; i++) {
                         if (response_pkt->l2_sixtop_celllist_add[i].isUsed) {
-                            packetfunctions_reserveHeader(&response_pkt, 4);
+                            if (packetfunctions_reserveHeader(&response_pkt, 4) == E_FAIL) {
+                                openqueue_freePacketBuffer(response_pkt);
+                                return;
+                            }
                             response_pkt->payload[0] = (uint8_t) (
                                     response_pkt->l2_sixtop_celllist_add[i].slotoffset & 0x00FF);
                             response_pkt->payload[1] = (uint8_t) (
@@ -1439,32 +1497,50 @@ void sixtop_six2six_notifyReceive(
         }
 
         // append 6p Seqnum
-        packetfunctions_reserveHeader(&response_pkt, sizeof(uint8_t));
+        if (packetfunctions_reserveHeader(&response_pkt, sizeof(uint8_t)) == E_FAIL) {
+            openqueue_freePacketBuffer(response_pkt);
+            return;
+        }
         *((uint8_t *) (response_pkt->payload)) = seqNum;
         response_pktLen += 1;
 
         // append 6p sfid
-        packetfunctions_reserveHeader(&response_pkt, sizeof(uint8_t));
+        if (packetfunctions_reserveHeader(&response_pkt, sizeof(uint8_t)) == E_FAIL) {
+            openqueue_freePacketBuffer(response_pkt);
+            return;
+        }
         *((uint8_t *) (response_pkt->payload)) = sixtop_vars.cb_sf_getsfid();
         response_pktLen += 1;
 
         // append 6p code
-        packetfunctions_reserveHeader(&response_pkt, sizeof(uint8_t));
+        if (packetfunctions_reserveHeader(&response_pkt, sizeof(uint8_t)) == E_FAIL) {
+            openqueue_freePacketBuffer(response_pkt);
+            return;
+        }
         *((uint8_t *) (response_pkt->payload)) = returnCode;
         response_pktLen += 1;
 
         // append 6p version, T(type) and  R(reserved)
-        packetfunctions_reserveHeader(&response_pkt, sizeof(uint8_t));
+        if (packetfunctions_reserveHeader(&response_pkt, sizeof(uint8_t)) == E_FAIL) {
+            openqueue_freePacketBuffer(response_pkt);
+            return;
+        }
         *((uint8_t *) (response_pkt->payload)) = IANA_6TOP_6P_VERSION | IANA_6TOP_TYPE_RESPONSE;
         response_pktLen += 1;
 
         // append 6p subtype id
-        packetfunctions_reserveHeader(&response_pkt, sizeof(uint8_t));
+        if (packetfunctions_reserveHeader(&response_pkt, sizeof(uint8_t)) == E_FAIL) {
+            openqueue_freePacketBuffer(response_pkt);
+            return;
+        }
         *((uint8_t *) (response_pkt->payload)) = IANA_6TOP_SUBIE_ID;
         response_pktLen += 1;
 
         // append IETF IE header (length_groupid_type)
-        packetfunctions_reserveHeader(&response_pkt, sizeof(uint16_t));
+        if (packetfunctions_reserveHeader(&response_pkt, sizeof(uint16_t)) == E_FAIL) {
+            openqueue_freePacketBuffer(response_pkt);
+            return;
+        }
         length_groupid_type = response_pktLen;
         length_groupid_type |= (IANA_IETF_IE_GROUP_ID | IANA_IETF_IE_TYPE);
         response_pkt->payload[0] = length_groupid_type & 0xFF;
@@ -1480,26 +1556,27 @@ void sixtop_six2six_notifyReceive(
 
     if (type == SIXTOP_CELL_RESPONSE) {
         // this is a 6p response message
+        // the cells it carries are parsed into celllist_list, the response itself needs no cell lists
 
         // if the code is SUCCESS
         if (code == IANA_6TOP_RC_SUCCESS || code == IANA_6TOP_RC_EOL) {
             switch (sixtop_vars.six2six_state) {
                 case SIX_STATE_WAIT_ADDRESPONSE:
                     i = 0;
-                    memset(pkt->l2_sixtop_celllist_add, 0, sizeof(pkt->l2_sixtop_celllist_add));
+                    memset(celllist_list, 0, CELLLIST_MAX_LEN * sizeof(cellInfo_ht));
                     while (pktLen > 0) {
-                        pkt->l2_sixtop_celllist_add[i].slotoffset = *((uint8_t *) (pkt->payload) + ptr);
-                        pkt->l2_sixtop_celllist_add[i].slotoffset |= (*((uint8_t *) (pkt->payload) + ptr + 1)) << 8;
-                        pkt->l2_sixtop_celllist_add[i].channeloffset = *((uint8_t *) (pkt->payload) + ptr + 2);
-                        pkt->l2_sixtop_celllist_add[i].channeloffset |= (*((uint8_t *) (pkt->payload) + ptr + 3)) << 8;
-                        pkt->l2_sixtop_celllist_add[i].isUsed = TRUE;
+                        celllist_list[i].slotoffset = *((uint8_t *) (pkt->payload) + ptr);
+                        celllist_list[i].slotoffset |= (*((uint8_t *) (pkt->payload) + ptr + 1)) << 8;
+                        celllist_list[i].channeloffset = *((uint8_t *) (pkt->payload) + ptr + 2);
+                        celllist_list[i].channeloffset |= (*((uint8_t *) (pkt->payload) + ptr + 3)) << 8;
+                        celllist_list[i].isUsed = TRUE;
                         ptr += 4;
                         pktLen -= 4;
                         i++;
                     }
                     sixtop_addCells(
                             sixtop_vars.cb_sf_getMetadata(),     // frame id
-                            pkt->l2_sixtop_celllist_add,  // celllist to be added
+                            celllist_list,                // celllist to be added
                             &(pkt->l2_nextORpreviousHop), // neighbor that cells to be added to
                             sixtop_vars.cellOptions       // cell options
                     );
@@ -1507,21 +1584,20 @@ void sixtop_six2six_notifyReceive(
                     break;
                 case SIX_STATE_WAIT_DELETERESPONSE:
                     i = 0;
-                    memset(pkt->l2_sixtop_celllist_delete, 0, sizeof(pkt->l2_sixtop_celllist_delete));
+                    memset(celllist_list, 0, CELLLIST_MAX_LEN * sizeof(cellInfo_ht));
                     while (pktLen > 0) {
-                        pkt->l2_sixtop_celllist_delete[i].slotoffset = *((uint8_t *) (pkt->payload) + ptr);
-                        pkt->l2_sixtop_celllist_delete[i].slotoffset |= (*((uint8_t *) (pkt->payload) + ptr + 1)) << 8;
-                        pkt->l2_sixtop_celllist_delete[i].channeloffset = *((uint8_t *) (pkt->payload) + ptr + 2);
-                        pkt->l2_sixtop_celllist_delete[i].channeloffset |=
-                                (*((uint8_t *) (pkt->payload) + ptr + 3)) << 8;
-                        pkt->l2_sixtop_celllist_delete[i].isUsed = TRUE;
+                        celllist_list[i].slotoffset = *((uint8_t *) (pkt->payload) + ptr);
+                        celllist_list[i].slotoffset |= (*((uint8_t *) (pkt->payload) + ptr + 1)) << 8;
+                        celllist_list[i].channeloffset = *((uint8_t *) (pkt->payload) + ptr + 2);
+                        celllist_list[i].channeloffset |= (*((uint8_t *) (pkt->payload) + ptr + 3)) << 8;
+                        celllist_list[i].isUsed = TRUE;
                         ptr += 4;
                         pktLen -= 4;
                         i++;
                     }
                     sixtop_removeCells(
                             sixtop_vars.cb_sf_getMetadata(),
-                            pkt->l2_sixtop_celllist_delete,
+                            celllist_list,
                             &(pkt->l2_nextORpreviousHop),
                             sixtop_vars.cellOptions
                     );
@@ -1529,13 +1605,13 @@ void sixtop_six2six_notifyReceive(
                     break;
                 case SIX_STATE_WAIT_RELOCATERESPONSE:
                     i = 0;
-                    memset(pkt->l2_sixtop_celllist_add, 0, sizeof(pkt->l2_sixtop_celllist_add));
+                    memset(celllist_list, 0, CELLLIST_MAX_LEN * sizeof(cellInfo_ht));
                     while (pktLen > 0) {
-                        pkt->l2_sixtop_celllist_add[i].slotoffset = *((uint8_t *) (pkt->payload) + ptr);
-                        pkt->l2_sixtop_celllist_add[i].slotoffset |= (*((uint8_t *) (pkt->payload) + ptr + 1)) << 8;
-                        pkt->l2_sixtop_celllist_add[i].channeloffset = *((uint8_t *) (pkt->payload) + ptr + 2);
-                        pkt->l2_sixtop_celllist_add[i].channeloffset |= (*((uint8_t *) (pkt->payload) + ptr + 3)) << 8;
-                        pkt->l2_sixtop_celllist_add[i].isUsed = TRUE;
+                        celllist_list[i].slotoffset = *((uint8_t *) (pkt->payload) + ptr);
+                        celllist_list[i].slotoffset |= (*((uint8_t *) (pkt->payload) + ptr + 1)) << 8;
+                        celllist_list[i].channeloffset = *((uint8_t *) (pkt->payload) + ptr + 2);
+                        celllist_list[i].channeloffset |= (*((uint8_t *) (pkt->payload) + ptr + 3)) << 8;
+                        celllist_list[i].isUsed = TRUE;
                         ptr += 4;
                         pktLen -= 4;
                         i++;
@@ -1548,7 +1624,7 @@ void sixtop_six2six_notifyReceive(
                     );
                     sixtop_addCells(
                             sixtop_vars.cb_sf_getMetadata(),     // frame id
-                            pkt->l2_sixtop_celllist_add,  // celllist to be added
+                            celllist_list,                // celllist to be added
                             &(pkt->l2_nextORpreviousHop), // neighbor that cells to be added to
                             sixtop_vars.cellOptions       // cell options
                     );
@@ -1621,8 +1697,6 @@ void sixtop_six2six_notifyReceive(
 //======= helper functions
 
 bool sixtop_addCells(uint8_t slotframeID, cellInfo_ht *cellList, open_addr_t *previousHop, uint8_t cellOptions) {
-    (void) slotframeID;
-
     uint8_t i;
     bool isShared;
     open_addr_t temp_neighbor;
@@ -1650,16 +1724,14 @@ bool sixtop_addCells(uint8_t slotframeID, cellInfo_ht *cellList, open_addr_t *pr
     for (i = 0; i < CELLLIST_MAX_LEN; i++) {
         if (cellList[i].isUsed) {
             hasCellsAdded = TRUE;
-            schedule_addActiveSlot(cellList[i].slotoffset, type, isShared, FALSE, cellList[i].channeloffset,
-                                   &temp_neighbor);
+            schedule_addActiveSlot(slotframeID, cellList[i].slotoffset, type, isShared, FALSE,
+                                   cellList[i].channeloffset, &temp_neighbor);
         }
     }
     return hasCellsAdded;
 }
 
 bool sixtop_removeCells(uint8_t slotframeID, cellInfo_ht *cellList, open_addr_t *previousHop, uint8_t cellOptions) {
-    (void) slotframeID;
-
     uint8_t i;
     bool isShared;
     open_addr_t temp_neighbor;
@@ -1688,6 +1760,7 @@ bool sixtop_removeCells(uint8_t slotframeID, cellInfo_ht *cellList, open_addr_t
         if (cellList[i].isUsed) {
             hasCellsRemoved = TRUE;
             schedule_removeActiveSlot(
+                    slotframeID,
                     cellList[i].slotoffset,
                     type,
                     isShared,
@@ -1700,8 +1773,6 @@ bool sixtop_removeCells(uint8_t slotframeID, cellInfo_ht *cellList, open_addr_t
 }
 
 bool sixtop_areAvailableCellsToBeScheduled(uint8_t frameID, uint8_t numOfCells, cellInfo_ht *cellList) {
-    (void) frameID;
-
     uint8_t i;
     uint8_t numbOfavailableCells;
     bool available;
@@ -1716,7 +1787,7 @@ bool sixtop_areAvailableCellsToBeScheduled(uint8_t frameID, uint8_t numOfCells,
         available = FALSE;
     } else {
         do {
-            if (schedule_isSlotOffsetAvailable(cellList[i].slotoffset) == TRUE) {
+            if (schedule_isSlotOffsetAvailable(frameID, cellList[i].slotoffset) == TRUE) {
                 numbOfavailableCells++;
             } else {
                 // mark the cell
@@ -1748,7 +1819,6 @@ bool sixtop_areAvailableCellsToBeRemoved(
         open_addr_t *neighbor,
         uint8_t cellOptions) {
 
-    (void) frameID;
     (void) neighbor;
 
     uint8_t i;
@@ -1783,9 +1853,9 @@ bool sixtop_areAvailableCellsToBeRemoved(
             if (cellList[i].isUsed) {
                 memset(&info, 0, sizeof(slotinfo_element_t));
                 if (type == CELLTYPE_TXRX) {
-                    schedule_getSlotInfo(cellList[i].slotoffset, &info);
+                    schedule_getSlotInfo(frameID, cellList[i].slotoffset, &info);
                 } else {
-                    schedule_getSlotInfo(cellList[i].slotoffset, &info);
+                    schedule_getSlotInfo(frameID, cellList[i].slotoffset, &info);
                 }
                 if (info.link_type != type) {
                     available = FALSE;
@@ -104,7 +104,11 @@ typedef struct {
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define frag_vars MOTE_CTX_VAR(frag_vars_t, frag_vars)
+#else
 frag_vars_t frag_vars;
+#endif
 
 //=========================== prototypes ======================================
 
@@ -116,9 +120,9 @@ static void reassemble_fragments(uint16_t tag, uint16_t size, OpenQueueEntry_t *
 
 static owerror_t allocate_vrb(OpenQueueEntry_t *frag1, uint16_t size, uint16_t tag);
 
-static void prepend_frag1_header(OpenQueueEntry_t *frag1, uint16_t size, uint16_t tag);
+static owerror_t prepend_frag1_header(OpenQueueEntry_t *frag1, uint16_t size, uint16_t tag);
 
-static void prepend_fragn_header(OpenQueueEntry_t *fragn, uint16_t size, uint16_t tag, uint8_t offset);
+static owerror_t prepend_fragn_header(OpenQueueEntry_t *fragn, uint16_t size, uint16_t tag, uint8_t offset);
 
 static void fast_forward_frags(uint16_t tag, uint16_t size, uint8_t vrb_pos);
 
@@ -147,6 +151,7 @@ owerror_t frag_fragment6LoPacket(OpenQueueEntry_t *msg) {
     uint8_t fragment_length;
     uint8_t fragment_offset;
     int8_t bpos;
+    owerror_t outcome;
 
     // check if fragmentation is necessary
     if (!msg->l3_isFragment && msg->length > (MAX_FRAGMENT_SIZE + FRAGN_HEADER_SIZE)) {
@@ -176,7 +181,7 @@ owerror_t frag_fragment6LoPacket(OpenQueueEntry_t *msg) {
 
             lowpan_fragment->l3_isFragment = TRUE;
             lowpan_fragment->owner = COMPONENT_FRAG;
-            lowpan_fragment->creator = msg->creator;
+            openqueue_setCreator(lowpan_fragment, msg->creator);
 
             if (remaining_bytes > MAX_FRAGMENT_SIZE)
                 fragment_length = MAX_FRAGMENT_SIZE;
@@ -209,6 +214,7 @@ owerror_t frag_fragment6LoPacket(OpenQueueEntry_t *msg) {
 
             // copy 'fragment_length' bytes from the original packet to the fragment
             if (packetfunctions_reserveHeader(&lowpan_fragment, fragment_length) == E_FAIL) {
+                cleanup_fragments(frag_vars.global_tag);
                 return E_FAIL;
             }
             memcpy(lowpan_fragment->payload, msg->payload + (fragment_offset * OFFSET_MULTIPLE), fragment_length);
@@ -216,14 +222,19 @@ owerror_t frag_fragment6LoPacket(OpenQueueEntry_t *msg) {
             // copy address information
             lowpan_fragment->l3_destinationAdd = msg->l3_destinationAdd;
             lowpan_fragment->l3_sourceAdd = msg->l3_sourceAdd;
+            lowpan_fragment->l3_routedDownward = msg->l3_routedDownward;
             lowpan_fragment->l2_nextORpreviousHop = msg->l2_nextORpreviousHop;
 
             remaining_bytes -= fragment_length;
 
             if (fragment_offset == 0) {
-                prepend_frag1_header(lowpan_fragment, msg->length, frag_vars.global_tag);
+                outcome = prepend_frag1_header(lowpan_fragment, msg->length, frag_vars.global_tag);
             } else {
-                prepend_fragn_header(lowpan_fragment, msg->length, frag_vars.global_tag, fragment_offset);
+                outcome = prepend_fragn_header(lowpan_fragment, msg->length, frag_vars.global_tag, fragment_offset);
+            }
+            if (outcome == E_FAIL) {
+                cleanup_fragments(frag_vars.global_tag);
+                return E_FAIL;
             }
 
             // update the fragment offset
@@ -257,7 +268,11 @@ owerror_t frag_fragment6LoPacket(OpenQueueEntry_t *msg) {
         for (i = 0; i < NUM_OF_VRBS; i++) {
             if (frag_vars.vrbs[i].frag1 == msg) {
                 memcpy(&frag_vars.vrbs[i].nexthop, &msg->l2_nextORpreviousHop, sizeof(open_addr_t));
-                prepend_frag1_header(msg, frag_vars.vrbs[i].size, frag_vars.vrbs[i].tag);
+                if (prepend_frag1_header(msg, frag_vars.vrbs[i].size, frag_vars.vrbs[i].tag) == E_FAIL) {
+                    // the caller frees the fragment, the VRB times out
+                    frag_vars.vrbs[i].frag1 = NULL;
+                    return E_FAIL;
+                }
                 fast_forward_frags(frag_vars.vrbs[i].tag, frag_vars.vrbs[i].size, i);
                 break;
             }
@@ -391,7 +406,7 @@ void frag_receive(OpenQueueEntry_t *msg) {
                 store_fragment(msg, size, tag, offset);
             } else {
                 // fast forwarding / source routing
-                msg->creator = COMPONENT_FRAG;
+                openqueue_setCreator(msg, COMPONENT_FRAG);
                 allocate_vrb(msg, size, tag);
                 iphc_receive(msg);
             }
@@ -426,7 +441,7 @@ void frag_receive(OpenQueueEntry_t *msg) {
             if (i < NUM_OF_VRBS) {
                 // we have found a corresponding VRB for this subsequent fragment, update the fragment's next hop
                 msg->l3_useSourceRouting = TRUE;
-                msg->creator = COMPONENT_FRAG;
+                openqueue_setCreator(msg, COMPONENT_FRAG);
 
                 memcpy(&msg->l2_nextORpreviousHop, &frag_vars.vrbs[i].nexthop, sizeof(open_addr_t));
 
@@ -449,7 +464,10 @@ void frag_receive(OpenQueueEntry_t *msg) {
                 }
 
                 // restore fragn header
-                prepend_fragn_header(msg, size, tag, offset);
+                if (prepend_fragn_header(msg, size, tag, offset) == E_FAIL) {
+                    openqueue_freePacketBuffer(msg);
+                    return;
+                }
                 sixtop_send(msg);
             } else {
                 /*
@@ -680,7 +698,7 @@ static void fast_forward_frags(uint16_t tag, uint16_t size, uint8_t vrb_pos) {
             frag_vars.fragmentBuf[i].datagram_tag == tag &&
             frag_vars.fragmentBuf[i].datagram_offset != 0) {
 
-            frag_vars.fragmentBuf[i].pFragment->creator = COMPONENT_FRAG;
+            openqueue_setCreator(frag_vars.fragmentBuf[i].pFragment, COMPONENT_FRAG);
             frag_vars.fragmentBuf[i].pFragment->l3_useSourceRouting = TRUE;
 
             // provide the stored fragment with the right next hop address
@@ -715,11 +733,16 @@ static void fast_forward_frags(uint16_t tag, uint16_t size, uint8_t vrb_pos) {
                 }
             }
 
-            prepend_fragn_header(
-                    frag_vars.fragmentBuf[i].pFragment,
-                    size,
-                    frag_vars.fragmentBuf[i].datagram_tag,
-                    frag_vars.fragmentBuf[i].datagram_offset);
+            if (
+                    prepend_fragn_header(
+                            frag_vars.fragmentBuf[i].pFragment,
+                            size,
+                            frag_vars.fragmentBuf[i].datagram_tag,
+                            frag_vars.fragmentBuf[i].datagram_offset) == E_FAIL
+                    ) {
+                RESET_FRAG_BUFFER_ENTRY(i);
+                continue;
+            }
 
             LOCK(frag_vars.fragmentBuf[i]);
             if (sixtop_send(frag_vars.fragmentBuf[i].pFragment) == E_FAIL) {
@@ -731,23 +754,29 @@ static void fast_forward_frags(uint16_t tag, uint16_t size, uint8_t vrb_pos) {
     }
 }
 
-static void prepend_frag1_header(OpenQueueEntry_t *frag1, uint16_t size, uint16_t tag) {
+static owerror_t prepend_frag1_header(OpenQueueEntry_t *frag1, uint16_t size, uint16_t tag) {
     uint16_t ds_field; // temporary dispatch | size field for fragmentation header
-    packetfunctions_reserveHeader(&frag1, FRAG1_HEADER_SIZE);
+    if (packetfunctions_reserveHeader(&frag1, FRAG1_HEADER_SIZE) == E_FAIL) {
+        return E_FAIL;
+    }
     ds_field = ((DISPATCH_FRAG_FIRST & DISPATCH_MASK) << DISPATCH_SHIFT);
     ds_field |= (size & SIZE_MASK);
     packetfunctions_htons(ds_field, (uint8_t * ) & (((frag1_t *) frag1->payload)->dispatch_size_field));
     packetfunctions_htons(tag, (uint8_t * ) & (((frag1_t *) frag1->payload)->datagram_tag));
+    return E_SUCCESS;
 }
 
-static void prepend_fragn_header(OpenQueueEntry_t *fragn, uint16_t size, uint16_t tag, uint8_t offset) {
+static owerror_t prepend_fragn_header(OpenQueueEntry_t *fragn, uint16_t size, uint16_t tag, uint8_t offset) {
     uint16_t ds_field; // temporary dispatch | size field for fragmentation header
-    packetfunctions_reserveHeader(&fragn, FRAGN_HEADER_SIZE);
+    if (packetfunctions_reserveHeader(&fragn, FRAGN_HEADER_SIZE) == E_FAIL) {
+        return E_FAIL;
+    }
     ds_field = ((DISPATCH_FRAG_SUBSEQ & DISPATCH_MASK) << DISPATCH_SHIFT);
     ds_field |= (size & SIZE_MASK);
     packetfunctions_htons(ds_field, (uint8_t * ) & (((fragn_t *) fragn->payload)->dispatch_size_field));
     packetfunctions_htons(tag, (uint8_t * ) & (((fragn_t *) fragn->payload)->datagram_tag));
     ((fragn_t *) fragn->payload)->datagram_offset = offset;
+    return E_SUCCESS;
 }
 
 owerror_t frag_timerq_enqueue(opentimers_id_t id) {
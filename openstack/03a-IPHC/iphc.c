@@ -14,8 +14,12 @@
 static const uint8_t dagroot_mac64b[] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01};
 
 #if DEADLINE_OPTION
+#if BOARD_MULTI_MOTE_ENABLED
+#define monitor_expiration_vars MOTE_CTX_VAR(monitor_expiration_vars_t, monitor_expiration_vars)
+#else
 static monitor_expiration_vars_t  monitor_expiration_vars;
 #endif
+#endif
 
 //=========================== prototypes ======================================
 
@@ -306,6 +310,18 @@ void iphc_receive(OpenQueueEntry_t *msg) {
                 &rpl_option
         );
     } else {
+#if RPL_STORING_MODE
+        // the DAOs end at the root, learn the downward route each carries before handing it to the OpenVisualizer
+        if (
+                ipv6_inner_header.next_header_compressed == FALSE &&
+                ipv6_inner_header.next_header == IANA_ICMPv6 &&
+                ipv6_inner_header.upper_layer_header + 2 <= (uint8_t *) (msg->payload) + msg->length &&
+                ipv6_inner_header.upper_layer_header[0] == IANA_ICMPv6_RPL &&
+                ipv6_inner_header.upper_layer_header[1] == IANA_ICMPv6_RPL_DAO
+                ) {
+            icmpv6rpl_indicateRelayedDAO(&(ipv6_inner_header.src), &(msg->l2_nextORpreviousHop));
+        }
+#endif
         openbridge_receive(msg);                   //out to the OpenVisualizer
     }
 }
@@ -571,6 +587,7 @@ owerror_t iphc_retrieveIPv6Header(OpenQueueEntry_t *msg, ipv6_header_iht *ipv6_o
     ipv6_outer_header->header_length = 0;
     ipv6_inner_header->header_length = 0;
     ipv6_outer_header->rhe_length = 0;
+    ipv6_inner_header->upper_layer_header = NULL;
 
 
     // four steps to retrieve:
@@ -753,6 +770,9 @@ owerror_t iphc_retrieveIPv6Header(OpenQueueEntry_t *msg, ipv6_header_iht *ipv6_o
         return E_FAIL;
     }
 
+    ipv6_inner_header->upper_layer_header = (uint8_t *) (msg->payload) + *page_length + extention_header_length + \
+            ipv6_outer_header->header_length + ipv6_inner_header->header_length;
+
     return E_SUCCESS;
 }
 
@@ -168,6 +168,7 @@ typedef struct {
     uint8_t next_header;
     uint8_t *routing_header[MAXNUM_RH3];
     uint8_t *hopByhop_option;
+    uint8_t *upper_layer_header;    ///< Start of the (uncompressed) next header, inner header only
 #if OPENWSN_DEADLINE_OPTION
     uint8_t* deadline_option;
 #endif
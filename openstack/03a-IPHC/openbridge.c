@@ -49,7 +49,10 @@ void openbridge_triggerData(void) {
         pkt->l2_nextORpreviousHop.type = ADDR_64B;
         memcpy(&(pkt->l2_nextORpreviousHop.addr_type.addr_64b[0]), &(input_buffer[0]), 8);
         //payload
-        packetfunctions_reserveHeader(&pkt, numDataBytes - 8);
+        if (packetfunctions_reserveHeader(&pkt, numDataBytes - 8) == E_FAIL) {
+            openqueue_freePacketBuffer(pkt);
+            return;
+        }
         memcpy(pkt->payload, &(input_buffer[8]), numDataBytes - 8);
 
         //send
@@ -75,11 +78,17 @@ void openbridge_sendDone(OpenQueueEntry_t *msg, owerror_t error) {
 void openbridge_receive(OpenQueueEntry_t *msg) {
 
     // prepend previous hop
-    packetfunctions_reserveHeader(&msg, LENGTH_ADDR64b);
+    if (packetfunctions_reserveHeader(&msg, LENGTH_ADDR64b) == E_FAIL) {
+        openqueue_freePacketBuffer(msg);
+        return;
+    }
     memcpy(msg->payload, msg->l2_nextORpreviousHop.addr_type.addr_64b, LENGTH_ADDR64b);
 
     // prepend next hop (me)
-    packetfunctions_reserveHeader(&msg, LENGTH_ADDR64b);
+    if (packetfunctions_reserveHeader(&msg, LENGTH_ADDR64b) == E_FAIL) {
+        openqueue_freePacketBuffer(msg);
+        return;
+    }
     memcpy(msg->payload, idmanager_getMyID(ADDR_64B)->addr_type.addr_64b, LENGTH_ADDR64b);
 
     // send packet over serial (will be memcopied into serial buffer)
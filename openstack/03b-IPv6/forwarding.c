@@ -17,7 +17,15 @@
 
 //=========================== prototypes ======================================
 
-void forwarding_getNextHop(open_addr_t *destination, open_addr_t *addressToWrite);
+bool forwarding_getNextHop(open_addr_t *destination, open_addr_t *addressToWrite);
+
+#if RPL_STORING_MODE
+void forwarding_learnDownwardRoute(
+        OpenQueueEntry_t *msg,
+        ipv6_header_iht *ipv6_outer_header,
+        ipv6_header_iht *ipv6_inner_header
+);
+#endif
 
 owerror_t forwarding_send_internal_RoutingTable(
         OpenQueueEntry_t *msg,
@@ -285,6 +293,10 @@ void forwarding_receive(
 ) {
     uint8_t flags;
     uint16_t senderRank;
+    bool downward;
+#if RPL_STORING_MODE
+    open_addr_t nextHop;
+#endif
 
     // take ownership
     msg->owner = COMPONENT_FORWARDING;
@@ -336,7 +348,13 @@ void forwarding_receive(
         // this packet is not for me: relay
 
         // change the creator of the packet
-        msg->creator = COMPONENT_FORWARDING;
+        openqueue_setCreator(msg, COMPONENT_FORWARDING);
+
+#if RPL_STORING_MODE
+        if (ipv6_outer_header->next_header != IANA_IPv6ROUTE) {
+            forwarding_learnDownwardRoute(msg, ipv6_outer_header, ipv6_inner_header);
+        }
+#endif
 
 #if DEADLINE_OPTION
         if (deadline_option != NULL) {
@@ -356,27 +374,45 @@ void forwarding_receive(
             // drop this message by free the buffer.
             LOG_WARNING(COMPONENT_FORWARDING, ERR_FORWARDING_PACKET_DROPPED, (errorparameter_t) 0,
                         (errorparameter_t) 0);
-            openqueue_freePacketBuffer(msg);
+            openqueue_dropPacketBuffer(msg);
             return;
         }
 
         if (ipv6_outer_header->next_header != IANA_IPv6ROUTE) {
             flags = rpl_option->flags;
             senderRank = rpl_option->senderRank;
-            if ((flags & O_FLAG) != 0) {
-                // wrong direction
-                LOG_ERROR(COMPONENT_FORWARDING, ERR_WRONG_DIRECTION,
-                          (errorparameter_t) flags,
-                          (errorparameter_t) senderRank);
-            }
-            if (senderRank < icmpv6rpl_getMyDAGrank()) {
-                // loop detected
-                // set flag
-                rpl_option->flags |= R_FLAG;
-                // log error
-                LOG_ERROR(COMPONENT_FORWARDING, ERR_LOOP_DETECTED,
-                          (errorparameter_t) senderRank,
-                          (errorparameter_t) icmpv6rpl_getMyDAGrank());
+#if RPL_STORING_MODE
+            downward = icmpv6rpl_getDownwardNextHop(&(msg->l3_destinationAdd), &nextHop);
+#else
+            downward = FALSE;
+#endif
+            if (downward) {
+                // going down, possibly turning at the common ancestor of source and destination (storing mode)
+                if ((flags & O_FLAG) != 0 && senderRank > icmpv6rpl_getMyDAGrank()) {
+                    // loop detected
+                    // set flag
+                    rpl_option->flags |= R_FLAG;
+                    // log error
+                    LOG_ERROR(COMPONENT_FORWARDING, ERR_LOOP_DETECTED,
+                              (errorparameter_t) senderRank,
+                              (errorparameter_t) icmpv6rpl_getMyDAGrank());
+                }
+            } else {
+                if ((flags & O_FLAG) != 0) {
+                    // wrong direction
+                    LOG_ERROR(COMPONENT_FORWARDING, ERR_WRONG_DIRECTION,
+                              (errorparameter_t) flags,
+                              (errorparameter_t) senderRank);
+                }
+                if (senderRank < icmpv6rpl_getMyDAGrank()) {
+                    // loop detected
+                    // set flag
+                    rpl_option->flags |= R_FLAG;
+                    // log error
+                    LOG_ERROR(COMPONENT_FORWARDING, ERR_LOOP_DETECTED,
+                              (errorparameter_t) senderRank,
+                              (errorparameter_t) icmpv6rpl_getMyDAGrank());
+                }
             }
             forwarding_createRplOption(rpl_option, rpl_option->flags);
 
@@ -422,8 +458,10 @@ void forwarding_receive(
 
 \param[in]  destination128b  Final IPv6 destination address.
 \param[out] addressToWrite64b Location to write the EUI64 of next hop to.
+
+\returns TRUE if the next hop is down the DODAG, FALSE otherwise.
 */
-void forwarding_getNextHop(open_addr_t *destination128b, open_addr_t *addressToWrite64b) {
+bool forwarding_getNextHop(open_addr_t *destination128b, open_addr_t *addressToWrite64b) {
     uint8_t i;
 
     if (packetfunctions_isBroadcastMulticast(destination128b)) {
@@ -432,11 +470,51 @@ void forwarding_getNextHop(open_addr_t *destination128b, open_addr_t *addressToW
         for (i = 0; i < 8; i++) {
             addressToWrite64b->addr_type.addr_64b[i] = 0xff;
         }
+#if RPL_STORING_MODE
+    } else if (icmpv6rpl_getDownwardNextHop(destination128b, addressToWrite64b)) {
+        // destination is below me, send to the child towards it
+        return TRUE;
+#endif
     } else {
         // destination is remote, send to preferred parent
         icmpv6rpl_getPreferredParentEui64(addressToWrite64b);
     }
+    return FALSE;
+}
+
+#if RPL_STORING_MODE
+/**
+\brief Learn a downward route from a packet being relayed, if it is a DAO.
+
+\param[in] msg               The packet being relayed, with msg->payload pointing to its IPv6 header(s).
+\param[in] ipv6_outer_header The packet's IPv6 outer header.
+\param[in] ipv6_inner_header The packet's IPv6 inner header.
+*/
+void forwarding_learnDownwardRoute(
+        OpenQueueEntry_t *msg,
+        ipv6_header_iht *ipv6_outer_header,
+        ipv6_header_iht *ipv6_inner_header
+) {
+    uint8_t offset;
+
+    if (msg->l4_protocol != IANA_ICMPv6 || msg->l4_protocol_compressed) {
+        return;
+    }
+
+    // locate the ICMPv6 header, as done when the packet is for me
+    offset = ipv6_inner_header->header_length;
+    if (ipv6_outer_header->src.type != ADDR_NONE || ipv6_outer_header->rhe_length) {
+        offset += ipv6_outer_header->header_length + ipv6_outer_header->rhe_length;
+    }
+    if (msg->length < offset + 2) {
+        return;
+    }
+
+    if (msg->payload[offset] == IANA_ICMPv6_RPL && msg->payload[offset + 1] == IANA_ICMPv6_RPL_DAO) {
+        icmpv6rpl_indicateRelayedDAO(&(msg->l3_sourceAdd), &(msg->l2_nextORpreviousHop));
+    }
 }
+#endif
 
 /**
 \brief Send a packet using the routing table to find the next hop.
@@ -471,7 +549,11 @@ owerror_t forwarding_send_internal_RoutingTable(
                                            &(msg->l2_nextORpreviousHop));
         }
     } else {
-        forwarding_getNextHop(&(msg->l3_destinationAdd), &(msg->l2_nextORpreviousHop));
+        if (forwarding_getNextHop(&(msg->l3_destinationAdd), &(msg->l2_nextORpreviousHop))) {
+            // the packet now travels down the DODAG
+            rpl_option->flags |= O_FLAG;
+            msg->l3_routedDownward = TRUE;
+        }
     }
 
     if (msg->l2_nextORpreviousHop.type == ADDR_NONE) {
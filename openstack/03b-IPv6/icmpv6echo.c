@@ -11,7 +11,11 @@
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define icmpv6echo_vars MOTE_CTX_VAR(icmpv6echo_vars_t, icmpv6echo_vars)
+#else
 icmpv6echo_vars_t icmpv6echo_vars;
+#endif
 
 //=========================== prototypes ======================================
 
@@ -15,12 +15,17 @@
 
 //=========================== definition ======================================
 
-#define DIO_PORTION 10
 #define DAO_PORTION 60
+#define DIO_INTERVAL_MAX_EXPONENT 24        // cap of DIOIntMin + DIOIntDoubl, keeps the interval (in ms) within opentimers range
+#define ROUTE_LIFETIME (16 * DAO_PORTION)   // DAO timer periods after which a route which was not refreshed expires
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define icmpv6rpl_vars MOTE_CTX_VAR(icmpv6rpl_vars_t, icmpv6rpl_vars)
+#else
 icmpv6rpl_vars_t icmpv6rpl_vars;
+#endif
 
 //=========================== prototypes ======================================
 
@@ -29,7 +34,19 @@ void icmpv6rpl_timer_DIO_cb(opentimers_id_t id);
 
 void icmpv6rpl_timer_DIO_task(void);
 
-void sendDIO(void);
+void icmpv6rpl_timer_DIOInterval_cb(opentimers_id_t id);
+
+void icmpv6rpl_startDIOInterval(void);
+
+void icmpv6rpl_resetDIOTrickle(void);
+
+uint32_t icmpv6rpl_getDIOIntervalMin(void);
+
+uint32_t icmpv6rpl_getDIOIntervalMax(void);
+
+bool sendDIO(void);
+
+bool sendDIS(void);
 
 // DAO-related
 void icmpv6rpl_timer_DAO_cb(opentimers_id_t id);
@@ -38,6 +55,16 @@ void icmpv6rpl_timer_DAO_task(void);
 
 void sendDAO(void);
 
+void icmpv6rpl_rankCandidates(void);
+
+bool icmpv6rpl_isBetterCandidate(uint16_t cost, uint8_t index, uint16_t otherCost, uint8_t otherIndex);
+
+#if RPL_STORING_MODE
+uint8_t icmpv6rpl_findRoute(const uint8_t *target);
+
+void icmpv6rpl_ageRoutes(void);
+#endif
+
 //=========================== public ==========================================
 
 /**
@@ -46,6 +73,9 @@ void sendDAO(void);
 void icmpv6rpl_init(void) {
 
     uint8_t dodagid[16];
+#if RPL_STORING_MODE
+    uint8_t i;
+#endif
 
     // retrieve my prefix and EUI64
     memcpy(&dodagid[0], idmanager_getMyID(ADDR_PREFIX)->addr_type.prefix, 8); // prefix
@@ -56,7 +86,16 @@ void icmpv6rpl_init(void) {
 
     //=== routing
     icmpv6rpl_vars.haveParent = FALSE;
+    icmpv6rpl_vars.bestCandidate = MAXNUMNEIGHBORS;
+    icmpv6rpl_vars.secondCandidate = MAXNUMNEIGHBORS;
+    icmpv6rpl_vars.bestCost = MAXDAGRANK;
+    icmpv6rpl_vars.secondCost = MAXDAGRANK;
     icmpv6rpl_vars.daoSent = FALSE;
+#if RPL_STORING_MODE
+    for (i = 0; i < RPL_MAX_ROUTES; i++) {
+        icmpv6rpl_vars.routes[i].nextHop = MAXNUMNEIGHBORS;
+    }
+#endif
 
     if (idmanager_getIsDAGroot() == TRUE) {
         icmpv6rpl_vars.myDAGrank = MINHOPRANKINCREASE;
@@ -92,7 +131,6 @@ void icmpv6rpl_init(void) {
     icmpv6rpl_vars.dioDestination.type = ADDR_128B;
     memcpy(&icmpv6rpl_vars.dioDestination.addr_type.addr_128b[0], all_routers_multicast, sizeof(all_routers_multicast));
 
-    icmpv6rpl_vars.dioPeriod = DIO_PERIOD;
     icmpv6rpl_vars.timerIdDIO = opentimers_create(TIMER_GENERAL_PURPOSE, TASKPRIO_RPL);
 
     //initialize PIO -> move this to dagroot code
@@ -120,9 +158,9 @@ void icmpv6rpl_init(void) {
     icmpv6rpl_vars.conf.type = RPL_OPTION_CONFIG;
     icmpv6rpl_vars.conf.optLen = 14;
     icmpv6rpl_vars.conf.flagsAPCS = DEFAULT_PATH_CONTROL_SIZE; //DEFAULT_PATH_CONTROL_SIZE = 0
-    icmpv6rpl_vars.conf.DIOIntDoubl = 8; //8 -> trickle period - max times it will double ~20min
-    icmpv6rpl_vars.conf.DIOIntMin = 12; // 12 ->  min trickle period -> 16s
-    icmpv6rpl_vars.conf.DIORedun = 0; // 0
+    icmpv6rpl_vars.conf.DIOIntDoubl = RPL_DIO_INTERVAL_DOUBLINGS; // Imax = Imin * 2^DIOIntDoubl
+    icmpv6rpl_vars.conf.DIOIntMin = RPL_DIO_INTERVAL_MIN; // Imin = 2^DIOIntMin ms
+    icmpv6rpl_vars.conf.DIORedun = RPL_DIO_REDUNDANCY; // k, 0 -> never suppress
     icmpv6rpl_vars.conf.maxRankIncrease = 2048; //  2048
     icmpv6rpl_vars.conf.minHopRankIncrease = 256; //256
     icmpv6rpl_vars.conf.OCP = 0; // 0 OF0
@@ -130,13 +168,8 @@ void icmpv6rpl_init(void) {
     icmpv6rpl_vars.conf.defLifetime = 0xff; //infinite - limit for DAO period  -> 0xff
     icmpv6rpl_vars.conf.lifetimeUnit = 0xffff; // 0xffff
 
-    opentimers_scheduleIn(
-            icmpv6rpl_vars.timerIdDIO,
-            SLOTFRAME_LENGTH * SLOTDURATION,
-            TIME_MS,
-            TIMER_PERIODIC,
-            icmpv6rpl_timer_DIO_cb
-    );
+    icmpv6rpl_vars.dioInterval = icmpv6rpl_getDIOIntervalMin();
+    icmpv6rpl_startDIOInterval();
 
     //=== DAO
 
@@ -174,9 +207,10 @@ void icmpv6rpl_init(void) {
 
     icmpv6rpl_vars.daoPeriod = DAO_PERIOD;
     icmpv6rpl_vars.timerIdDAO = opentimers_create(TIMER_GENERAL_PURPOSE, TASKPRIO_RPL);
-    opentimers_scheduleIn(
+    opentimers_scheduleInWithSlack(
             icmpv6rpl_vars.timerIdDAO,
             SLOTFRAME_LENGTH * SLOTDURATION,
+            OPENTIMERS_SLACK(SLOTFRAME_LENGTH * SLOTDURATION),
             TIME_MS,
             TIMER_PERIODIC,
             icmpv6rpl_timer_DAO_cb
@@ -256,7 +290,10 @@ void icmpv6rpl_receive(OpenQueueEntry_t *msg) {
     // handle message
     switch (icmpv6code) {
         case IANA_ICMPv6_RPL_DIS:
-            icmpv6rpl_timer_DIO_task();
+            // a neighbor solicits a DIO (RFC 6550 section 8.3), a mote without a DAGrank has none to give
+            if (idmanager_getIsDAGroot() == TRUE || icmpv6rpl_getMyDAGrank() != DEFAULTDAGRANK) {
+                icmpv6rpl_resetDIOTrickle();
+            }
             break;
         case IANA_ICMPv6_RPL_DIO:
             if (idmanager_getIsDAGroot() == TRUE) {
@@ -298,6 +335,20 @@ bool icmpv6rpl_getPreferredParentIndex(uint8_t *indexptr) {
     return icmpv6rpl_vars.haveParent;
 }
 
+/**
+\brief Retrieve the best candidate parent other than the preferred parent, to fail over to.
+
+\returns TRUE and index of that neighbor if there is one, FALSE otherwise.
+*/
+bool icmpv6rpl_getBackupParentIndex(uint8_t *indexptr) {
+    if (icmpv6rpl_vars.haveParent && icmpv6rpl_vars.bestCandidate == icmpv6rpl_vars.ParentIndex) {
+        *indexptr = icmpv6rpl_vars.secondCandidate;
+    } else {
+        *indexptr = icmpv6rpl_vars.bestCandidate;
+    }
+    return *indexptr != MAXNUMNEIGHBORS;
+}
+
 /**
 \brief Retrieve my preferred parent's EUI64 address.
 \param[out] addressToWrite Where to copy the preferred parent's address to.
@@ -351,9 +402,12 @@ dagrank_t icmpv6rpl_getMyDAGrank(void) {
 
 /**
 \brief Routing algorithm
+
+The candidate parent with the lowest path cost is kept up to date by icmpv6rpl_indicatePathCost(), only that one
+needs to be checked against the rank bounds.
 */
 void icmpv6rpl_updateMyDAGrankAndParentSelection(void) {
-    uint8_t i;
+    uint16_t entryDAGrank;
     uint16_t previousDAGrank;
     uint16_t prevRankIncrease;
     uint8_t prevParentIndex;
@@ -376,6 +430,7 @@ void icmpv6rpl_updateMyDAGrankAndParentSelection(void) {
         }
     }
     // prep for loop, remember state before neighbor table scanning
+    entryDAGrank = icmpv6rpl_vars.myDAGrank;
     prevParentIndex = icmpv6rpl_vars.ParentIndex;
     prevHadParent = icmpv6rpl_vars.haveParent;
     prevRankIncrease = icmpv6rpl_vars.rankIncrease;
@@ -402,52 +457,30 @@ void icmpv6rpl_updateMyDAGrankAndParentSelection(void) {
     foundBetterParent = FALSE;
     icmpv6rpl_vars.haveParent = FALSE;
 
-    // loop through neighbor table, update myDAGrank
-    for (i = 0; i < MAXNUMNEIGHBORS; i++) {
-        if (neighbors_isStableNeighborByIndex(i)) { // in use and link is stable
-            // neighbor marked as NORES can't be parent
-            if (
-                    neighbors_getNeighborNoResource(i) == TRUE
-                    ) {
-                continue;
-            }
-            // get link cost to this neighbor
-            rankIncrease = neighbors_getLinkMetric(i);
-            // get this neighbor's advertized rank
-            neighborRank = neighbors_getNeighborRank(i);
-            // if this neighbor has unknown/infinite rank, pass on it
-            if (neighborRank == DEFAULTDAGRANK) continue;
-            // compute tentative cost of full path to root through this neighbor
-            tentativeDAGrank = (uint32_t) neighborRank + rankIncrease;
-            if (tentativeDAGrank > 65535) {
-                tentativeDAGrank = 65535;
-            }
-            // if larger than lowestRank+maxRankIncrease, pass (per rfc6550#section-8.2.2.4)
-            if (
-                    icmpv6rpl_vars.lowestRankInHistory<(MAXDAGRANK - DAGMAXRANKINCREASE) &&
-                                                       tentativeDAGrank>(
-                            icmpv6rpl_vars.lowestRankInHistory + DAGMAXRANKINCREASE)
-                    ) {
-                continue;
-            }
-            // if not low enough to justify switch, pass (i.e. hysterisis)
-            if (
-                    (previousDAGrank < tentativeDAGrank) ||
-                    (previousDAGrank - tentativeDAGrank < 2 * MINHOPRANKINCREASE)
-                    ) {
-                continue;
-            }
-            // remember that we have at least one valid candidate parent
+    // the best candidate (in use, stable, not NORES, with a known rank) is the only one which can pass the bounds
+    if (icmpv6rpl_vars.bestCandidate != MAXNUMNEIGHBORS) {
+        // cost of full path to root through this neighbor
+        tentativeDAGrank = icmpv6rpl_vars.bestCost;
+        if (
+                // if larger than lowestRank+maxRankIncrease, pass (per rfc6550#section-8.2.2.4)
+                (
+                        icmpv6rpl_vars.lowestRankInHistory < (MAXDAGRANK - DAGMAXRANKINCREASE) &&
+                        tentativeDAGrank > (icmpv6rpl_vars.lowestRankInHistory + DAGMAXRANKINCREASE)
+                ) ||
+                // if not low enough to justify switch, pass (i.e. hysterisis)
+                (previousDAGrank < tentativeDAGrank) ||
+                (previousDAGrank - tentativeDAGrank < 2 * MINHOPRANKINCREASE)
+                ) {
+            foundBetterParent = FALSE;
+        } else {
+            // remember that we have a valid candidate parent
             foundBetterParent = TRUE;
-            // select best candidate so far
-            if (icmpv6rpl_vars.myDAGrank > tentativeDAGrank) {
-                if (tentativeDAGrank < icmpv6rpl_vars.lowestRankInHistory) {
-                    icmpv6rpl_vars.lowestRankInHistory = (uint16_t) tentativeDAGrank;
-                }
-                icmpv6rpl_vars.myDAGrank = (uint16_t) tentativeDAGrank;
-                icmpv6rpl_vars.ParentIndex = i;
-                icmpv6rpl_vars.rankIncrease = rankIncrease;
+            if (tentativeDAGrank < icmpv6rpl_vars.lowestRankInHistory) {
+                icmpv6rpl_vars.lowestRankInHistory = (uint16_t) tentativeDAGrank;
             }
+            icmpv6rpl_vars.myDAGrank = (uint16_t) tentativeDAGrank;
+            icmpv6rpl_vars.ParentIndex = icmpv6rpl_vars.bestCandidate;
+            icmpv6rpl_vars.rankIncrease = neighbors_getLinkMetric(icmpv6rpl_vars.bestCandidate);
         }
     }
 
@@ -495,8 +528,172 @@ void icmpv6rpl_updateMyDAGrankAndParentSelection(void) {
     if (icmpv6rpl_vars.myDAGrank == MAXDAGRANK) {
         icmpv6rpl_vars.lowestRankInHistory = MAXDAGRANK;
     }
+
+    // a new parent or a new DAGRank (integer part of the rank, rfc6550#section-3.5.1) is an inconsistency
+    if (
+            icmpv6rpl_vars.haveParent != prevHadParent ||
+            icmpv6rpl_vars.ParentIndex != prevParentIndex ||
+            icmpv6rpl_vars.myDAGrank / MINHOPRANKINCREASE != entryDAGrank / MINHOPRANKINCREASE
+            ) {
+        icmpv6rpl_resetDIOTrickle();
+    }
+}
+
+/**
+\brief Indicate the path cost through a neighbor changed, see neighbors_getPathCost().
+
+Keeps the two best candidate parents in order. A neighbor getting better only needs to be compared with them. The
+neighbors are only scanned again when one of the two gets worse than the other one, as the next best neighbor is not
+known then, which includes a candidate being removed from the neighbor table.
+
+\param[in] index The index of that neighbor in the neighbor table.
+*/
+void icmpv6rpl_indicatePathCost(uint8_t index) {
+    uint16_t cost;
+
+    cost = neighbors_getPathCost(index);
+
+    if (index == icmpv6rpl_vars.bestCandidate) {
+        if (
+                cost != MAXDAGRANK &&
+                icmpv6rpl_isBetterCandidate(cost, index, icmpv6rpl_vars.secondCost, icmpv6rpl_vars.secondCandidate)
+                ) {
+            // still ahead of the second one, which is ahead of all others
+            icmpv6rpl_vars.bestCost = cost;
+            return;
+        }
+    } else if (index == icmpv6rpl_vars.secondCandidate) {
+        if (cost <= icmpv6rpl_vars.secondCost) {
+            // got better, at most swaps with the best one
+            icmpv6rpl_vars.secondCost = cost;
+            if (icmpv6rpl_isBetterCandidate(cost, index, icmpv6rpl_vars.bestCost, icmpv6rpl_vars.bestCandidate)) {
+                icmpv6rpl_vars.secondCandidate = icmpv6rpl_vars.bestCandidate;
+                icmpv6rpl_vars.secondCost = icmpv6rpl_vars.bestCost;
+                icmpv6rpl_vars.bestCandidate = index;
+                icmpv6rpl_vars.bestCost = cost;
+            }
+            return;
+        }
+    } else {
+        if (cost == MAXDAGRANK) {
+            // not a candidate
+        } else if (
+                icmpv6rpl_isBetterCandidate(cost, index, icmpv6rpl_vars.bestCost, icmpv6rpl_vars.bestCandidate)
+                ) {
+            icmpv6rpl_vars.secondCandidate = icmpv6rpl_vars.bestCandidate;
+            icmpv6rpl_vars.secondCost = icmpv6rpl_vars.bestCost;
+            icmpv6rpl_vars.bestCandidate = index;
+            icmpv6rpl_vars.bestCost = cost;
+        } else if (
+                icmpv6rpl_isBetterCandidate(cost, index, icmpv6rpl_vars.secondCost, icmpv6rpl_vars.secondCandidate)
+                ) {
+            icmpv6rpl_vars.secondCandidate = index;
+            icmpv6rpl_vars.secondCost = cost;
+        }
+        return;
+    }
+
+    // one of the candidates got worse, the next best neighbor may now be ahead of it
+    icmpv6rpl_rankCandidates();
 }
 
+#if RPL_STORING_MODE
+/**
+\brief Indicate this mote relays a DAO towards the root, or received one as the root.
+
+The DAO was sent by target and received from previousHop, so target can be reached through previousHop. Only targets
+in the DODAG prefix are stored. When the routing table is full, the least recently used route is replaced.
+
+\param[in] target128b The IPv6 source address of the DAO.
+\param[in] previousHop64b The neighbor the DAO was received from.
+*/
+void icmpv6rpl_indicateRelayedDAO(open_addr_t *target128b, open_addr_t *previousHop64b) {
+    uint8_t nextHop;
+    uint8_t route;
+    uint8_t i;
+
+    if (
+            target128b->type != ADDR_128B ||
+            memcmp(&target128b->addr_type.addr_128b[0], idmanager_getMyID(ADDR_PREFIX)->addr_type.prefix, 8) != 0
+            ) {
+        return;
+    }
+
+    // a DAO only travels up, never learn a route through the parent
+    if (
+            neighbors_getIndex(previousHop64b, &nextHop) == FALSE ||
+            (icmpv6rpl_vars.haveParent && nextHop == icmpv6rpl_vars.ParentIndex)
+            ) {
+        return;
+    }
+
+    route = icmpv6rpl_findRoute(&target128b->addr_type.addr_128b[8]);
+    if (route == RPL_MAX_ROUTES) {
+        // take a free entry, or else the least recently used one
+        route = 0;
+        for (i = 0; i < RPL_MAX_ROUTES; i++) {
+            if (icmpv6rpl_vars.routes[i].nextHop == MAXNUMNEIGHBORS) {
+                route = i;
+                break;
+            }
+            if (
+                    (uint16_t) (icmpv6rpl_vars.routeClock - icmpv6rpl_vars.routes[i].lastUsed) >
+                    (uint16_t) (icmpv6rpl_vars.routeClock - icmpv6rpl_vars.routes[route].lastUsed)
+                    ) {
+                route = i;
+            }
+        }
+        memcpy(icmpv6rpl_vars.routes[route].target, &target128b->addr_type.addr_128b[8], 8);
+    }
+
+    icmpv6rpl_vars.routes[route].nextHop = nextHop;
+    icmpv6rpl_vars.routes[route].age = 0;
+    icmpv6rpl_vars.routes[route].lastUsed = ++icmpv6rpl_vars.routeClock;
+}
+
+/**
+\brief Retrieve the next hop towards a mote below this one.
+
+\param[in] destination128b The IPv6 destination address.
+\param[out] addressToWrite64b Where to write the EUI64 of the child towards the destination.
+
+\returns TRUE if there is a route to the destination, FALSE otherwise.
+*/
+bool icmpv6rpl_getDownwardNextHop(open_addr_t *destination128b, open_addr_t *addressToWrite64b) {
+    uint8_t route;
+
+    if (
+            destination128b->type != ADDR_128B ||
+            memcmp(&destination128b->addr_type.addr_128b[0], idmanager_getMyID(ADDR_PREFIX)->addr_type.prefix, 8) != 0
+            ) {
+        return FALSE;
+    }
+
+    route = icmpv6rpl_findRoute(&destination128b->addr_type.addr_128b[8]);
+    if (route == RPL_MAX_ROUTES) {
+        return FALSE;
+    }
+
+    icmpv6rpl_vars.routes[route].lastUsed = ++icmpv6rpl_vars.routeClock;
+    return neighbors_getNeighborEui64(addressToWrite64b, ADDR_64B, icmpv6rpl_vars.routes[route].nextHop);
+}
+
+/**
+\brief Indicate a neighbor was removed from the neighbor table, drop the routes through it.
+
+\param[in] index The index of that neighbor in the neighbor table.
+*/
+void icmpv6rpl_indicateNeighborRemoved(uint8_t index) {
+    uint8_t i;
+
+    for (i = 0; i < RPL_MAX_ROUTES; i++) {
+        if (icmpv6rpl_vars.routes[i].nextHop == index) {
+            icmpv6rpl_vars.routes[i].nextHop = MAXNUMNEIGHBORS;
+        }
+    }
+}
+#endif
+
 /**
 \brief In case of parent changed, update the nexthop of the IPv6 packet in the queue
 
@@ -523,13 +720,27 @@ void icmpv6rpl_indicateRxDIO(OpenQueueEntry_t *msg) {
     uint8_t i;
     uint8_t temp_8b;
     dagrank_t neighborRank;
-    open_addr_t NeighborAddress;
     open_addr_t myPrefix;
     uint8_t *current;
     uint8_t optionsLen;
+    bool sameDodagVersion;
     // take ownership over the packet
     msg->owner = COMPONENT_ICMPv6RPL;
 
+    // a new DODAG version is an inconsistency
+    sameDodagVersion = FALSE;
+    if (((icmpv6rpl_dio_ht *) (msg->payload))->verNumb != icmpv6rpl_vars.dio.verNumb) {
+        icmpv6rpl_resetDIOTrickle();
+    } else if (
+            memcmp(
+                    ((icmpv6rpl_dio_ht *) (msg->payload))->DODAGID,
+                    icmpv6rpl_vars.dio.DODAGID,
+                    sizeof(icmpv6rpl_vars.dio.DODAGID)
+            ) == 0
+            ) {
+        sameDodagVersion = TRUE;
+    }
+
     // update some fields of our DIO
     memcpy(
             &(icmpv6rpl_vars.dio),
@@ -600,33 +811,34 @@ void icmpv6rpl_indicateRxDIO(OpenQueueEntry_t *msg) {
     //update rank in DIO as well (which will be overwritten with my rank when send).
     icmpv6rpl_vars.dio.rank = icmpv6rpl_vars.incomingDio->rank;
 
-    // update rank of that neighbor in table
-    for (i = 0; i < MAXNUMNEIGHBORS; i++) {
+    // only a DIO of the same DODAG version advertising a rank no worse than mine counts towards suppressing mine
+    // (RFC 6550 section 8.3): my children and the motes further from the root may still need to hear it
+    if (
+            sameDodagVersion &&
+            icmpv6rpl_vars.incomingDio->rank <= icmpv6rpl_vars.myDAGrank &&
+            icmpv6rpl_vars.dioNumConsistent < 0xff
+            ) {
+        icmpv6rpl_vars.dioNumConsistent++;
+    }
 
-        // Find a used neighbor table entry
-        if (neighbors_getNeighborEui64(&NeighborAddress, ADDR_64B, i)) {
-
-            // check address
-            if (packetfunctions_sameAddress(&(msg->l2_nextORpreviousHop), &NeighborAddress)) {
-                neighborRank = neighbors_getNeighborRank(i);
-                if (
-                        (icmpv6rpl_vars.incomingDio->rank > neighborRank) &&
-                        (icmpv6rpl_vars.incomingDio->rank - neighborRank) >
-                        ((3 * DEFAULTLINKCOST - 2) * MINHOPRANKINCREASE)
-                        ) {
-                    // the new DAGrank looks suspiciously high, only increment a bit
-                    neighbors_setNeighborRank(i, neighborRank + ((3 * DEFAULTLINKCOST - 2) * 2 * MINHOPRANKINCREASE));
-                    LOG_ERROR(COMPONENT_ICMPv6RPL, ERR_LARGE_DAGRANK,
-                              (errorparameter_t) icmpv6rpl_vars.incomingDio->rank,
-                              (errorparameter_t) neighborRank);
-                } else {
-                    neighbors_setNeighborRank(i, icmpv6rpl_vars.incomingDio->rank);
-                }
-                // since changes were made to neighbors DAG rank, run the routing algorithm again
-                icmpv6rpl_updateMyDAGrankAndParentSelection();
-                break; // there should be only one matching entry, no need to loop further
-            }
+    // update rank of that neighbor in table
+    if (neighbors_getIndex(&(msg->l2_nextORpreviousHop), &i)) {
+        neighborRank = neighbors_getNeighborRank(i);
+        if (
+                (icmpv6rpl_vars.incomingDio->rank > neighborRank) &&
+                (icmpv6rpl_vars.incomingDio->rank - neighborRank) >
+                ((3 * DEFAULTLINKCOST - 2) * MINHOPRANKINCREASE)
+                ) {
+            // the new DAGrank looks suspiciously high, only increment a bit
+            neighbors_setNeighborRank(i, neighborRank + ((3 * DEFAULTLINKCOST - 2) * 2 * MINHOPRANKINCREASE));
+            LOG_ERROR(COMPONENT_ICMPv6RPL, ERR_LARGE_DAGRANK,
+                      (errorparameter_t) icmpv6rpl_vars.incomingDio->rank,
+                      (errorparameter_t) neighborRank);
+        } else {
+            neighbors_setNeighborRank(i, icmpv6rpl_vars.incomingDio->rank);
         }
+        // since changes were made to neighbors DAG rank, run the routing algorithm again
+        icmpv6rpl_updateMyDAGrankAndParentSelection();
     }
 }
 
@@ -644,7 +856,7 @@ void icmpv6rpl_indicateRxDIO(OpenQueueEntry_t *msg) {
 //===== DIO-related
 
 /**
-\brief DIO timer callback function.
+\brief DIO timer callback function, fired at the time (t) of the Trickle interval at which the DIO is due.
 
 \note This timer callback function is executed in task mode by opentimer
     already. No need to push a task again.
@@ -653,24 +865,142 @@ void icmpv6rpl_timer_DIO_cb(opentimers_id_t id) {
     (void) id;
 
     icmpv6rpl_timer_DIO_task();
+
+    opentimers_scheduleInWithSlack(
+            icmpv6rpl_vars.timerIdDIO,
+            icmpv6rpl_vars.dioIntervalRemainder,
+            OPENTIMERS_SLACK(icmpv6rpl_getDIOIntervalMin()),
+            TIME_MS,
+            TIMER_ONESHOT,
+            icmpv6rpl_timer_DIOInterval_cb
+    );
 }
 
 /**
 \brief Handler for DIO timer event.
 
+The DIO is suppressed if enough consistent DIOs were heard during the interval (RFC 6206 section 4.2).
+
 \note This function is executed in task context, called by the scheduler.
 */
 void icmpv6rpl_timer_DIO_task(void) {
 
-    if (openrandom_get16b() < (0xffff / DIO_PORTION)) {
-        sendDIO();
+    // a mote without a DAGrank has nothing to advertise, it solicits DIOs from its neighbors instead. The interval
+    // keeps doubling, so a mote no DIO reaches does not keep the shared cells busy. Getting a parent restarts it.
+    if (idmanager_getIsDAGroot() == FALSE && icmpv6rpl_getMyDAGrank() == DEFAULTDAGRANK) {
+        if (sendDIS() == FALSE) {
+            icmpv6rpl_vars.dioIntervalHeld = TRUE;
+        }
+        return;
+    }
+
+    if (
+            icmpv6rpl_vars.conf.DIORedun != 0 &&
+            icmpv6rpl_vars.dioNumConsistent >= icmpv6rpl_vars.conf.DIORedun
+            ) {
+        return;
+    }
+
+    if (sendDIO() == FALSE) {
+        // nothing advertised yet, keep advertising at the current rate
+        icmpv6rpl_vars.dioIntervalHeld = TRUE;
     }
 }
 
+/**
+\brief DIO timer callback function, fired at the end of the Trickle interval.
+
+Doubles the interval, up to Imax, and starts the next one.
+*/
+void icmpv6rpl_timer_DIOInterval_cb(opentimers_id_t id) {
+    uint32_t intervalMax;
+
+    (void) id;
+
+    intervalMax = icmpv6rpl_getDIOIntervalMax();
+    if (icmpv6rpl_vars.dioIntervalHeld == FALSE && icmpv6rpl_vars.dioInterval < intervalMax) {
+        icmpv6rpl_vars.dioInterval *= 2;
+    }
+    if (icmpv6rpl_vars.dioInterval > intervalMax) {
+        icmpv6rpl_vars.dioInterval = intervalMax;
+    }
+
+    icmpv6rpl_startDIOInterval();
+}
+
+/**
+\brief Start a Trickle interval (RFC 6206) of length dioInterval, the DIO is due at a random time in its second half.
+*/
+void icmpv6rpl_startDIOInterval(void) {
+    uint32_t half;
+    uint32_t t;
+
+    // t is drawn from [I/2, I), in steps of 1/4096th of I/2
+    half = icmpv6rpl_vars.dioInterval / 2;
+    t = half + (((half >> 4) * (openrandom_get16b() >> 4)) >> 8);
+
+    icmpv6rpl_vars.dioIntervalRemainder = icmpv6rpl_vars.dioInterval - t;
+    icmpv6rpl_vars.dioNumConsistent = 0;
+    icmpv6rpl_vars.dioIntervalHeld = FALSE;
+
+    opentimers_scheduleInWithSlack(
+            icmpv6rpl_vars.timerIdDIO,
+            t,
+            OPENTIMERS_SLACK(icmpv6rpl_getDIOIntervalMin()),
+            TIME_MS,
+            TIMER_ONESHOT,
+            icmpv6rpl_timer_DIO_cb
+    );
+}
+
+/**
+\brief Restart the DIO Trickle timer from Imin upon an inconsistency, so the change is advertised quickly.
+
+Nothing happens if the interval is Imin already, so a burst of changes does not postpone the DIO.
+*/
+void icmpv6rpl_resetDIOTrickle(void) {
+
+    if (icmpv6rpl_vars.dioInterval == icmpv6rpl_getDIOIntervalMin()) {
+        return;
+    }
+
+    icmpv6rpl_vars.dioInterval = icmpv6rpl_getDIOIntervalMin();
+    opentimers_cancel(icmpv6rpl_vars.timerIdDIO);
+    icmpv6rpl_startDIOInterval();
+}
+
+/**
+\brief Imin of the DIO Trickle timer, in ms, as found in the configuration option of the DODAG.
+*/
+uint32_t icmpv6rpl_getDIOIntervalMin(void) {
+    uint8_t exponent;
+
+    exponent = icmpv6rpl_vars.conf.DIOIntMin;
+    if (exponent > DIO_INTERVAL_MAX_EXPONENT) {
+        exponent = DIO_INTERVAL_MAX_EXPONENT;
+    }
+    return (uint32_t) 1 << exponent;
+}
+
+/**
+\brief Imax of the DIO Trickle timer, in ms, as found in the configuration option of the DODAG.
+*/
+uint32_t icmpv6rpl_getDIOIntervalMax(void) {
+    uint16_t exponent;
+
+    exponent = (uint16_t) icmpv6rpl_vars.conf.DIOIntMin + icmpv6rpl_vars.conf.DIOIntDoubl;
+    if (exponent > DIO_INTERVAL_MAX_EXPONENT) {
+        exponent = DIO_INTERVAL_MAX_EXPONENT;
+    }
+    return (uint32_t) 1 << exponent;
+}
+
 /**
 \brief Prepare and a send a RPL DIO.
+
+\returns TRUE if the DIO was handed to the lower layers.
 */
-void sendDIO(void) {
+bool sendDIO(void) {
 
     OpenQueueEntry_t *msg;
     open_addr_t addressToWrite;
@@ -688,12 +1018,12 @@ void sendDIO(void) {
         icmpv6rpl_vars.busySendingDAO = FALSE;
 
         // stop here
-        return;
+        return FALSE;
     }
 
     // do not send DIO if I have the default DAG rank
     if (icmpv6rpl_getMyDAGrank() == DEFAULTDAGRANK) {
-        return;
+        return FALSE;
     }
 
     if (
@@ -713,7 +1043,7 @@ void sendDIO(void) {
         icmpv6rpl_vars.busySendingDIO = FALSE;
         icmpv6rpl_vars.busySendingDAO = FALSE;
 
-        return;
+        return FALSE;
     }
 
     // if you get here, all good to send a DIO
@@ -722,7 +1052,7 @@ void sendDIO(void) {
     msg = openqueue_getFreePacketBuffer(COMPONENT_ICMPv6RPL);
     if (msg == NULL) {
         LOG_ERROR(COMPONENT_ICMPv6RPL, ERR_NO_FREE_PACKET_BUFFER, (errorparameter_t) 0, (errorparameter_t) 0);
-        return;
+        return FALSE;
     }
 
     // take ownership
@@ -740,7 +1070,7 @@ void sendDIO(void) {
     //===== Configuration option
     if (packetfunctions_reserveHeader(&msg, sizeof(icmpv6rpl_config_ht)) == E_FAIL) {
         openqueue_freePacketBuffer(msg);
-        return;
+        return FALSE;
     }
 
     //copy the PIO in the packet
@@ -759,7 +1089,7 @@ void sendDIO(void) {
 
     if (packetfunctions_reserveHeader(&msg, sizeof(icmpv6rpl_pio_t)) == E_FAIL) {
         openqueue_freePacketBuffer(msg);
-        return;
+        return FALSE;
     }
 
     // copy my prefix into the PIO
@@ -784,7 +1114,7 @@ void sendDIO(void) {
     icmpv6rpl_vars.dio.rank = icmpv6rpl_getMyDAGrank();
     if (packetfunctions_reserveHeader(&msg, sizeof(icmpv6rpl_dio_ht)) == E_FAIL) {
         openqueue_freePacketBuffer(msg);
-        return;
+        return FALSE;
     }
     memcpy(((icmpv6rpl_dio_ht *) (msg->payload)), &(icmpv6rpl_vars.dio), sizeof(icmpv6rpl_dio_ht));
 
@@ -795,7 +1125,7 @@ void sendDIO(void) {
     //===== ICMPv6 header
     if (packetfunctions_reserveHeader(&msg, sizeof(ICMPv6_ht)) == E_FAIL) {
         openqueue_freePacketBuffer(msg);
-        return;
+        return FALSE;
     }
     ((ICMPv6_ht *) (msg->payload))->type = msg->l4_sourcePortORicmpv6Type;
     ((ICMPv6_ht *) (msg->payload))->code = IANA_ICMPv6_RPL_DIO;
@@ -804,8 +1134,74 @@ void sendDIO(void) {
     //send
     if (icmpv6_send(msg) == E_SUCCESS) {
         icmpv6rpl_vars.busySendingDIO = TRUE;
+        return TRUE;
+    } else {
+        openqueue_freePacketBuffer(msg);
+        return FALSE;
+    }
+}
+
+/**
+\brief Prepare and send a RPL DIS, which resets the DIO Trickle timer of the neighbors receiving it.
+
+\returns TRUE if the DIS was handed to the lower layers.
+*/
+bool sendDIS(void) {
+    OpenQueueEntry_t *msg;
+
+    // stop if I'm not sync'ed or did not join, the DIS could not be secured
+    if (ieee154e_isSynch() == FALSE || IEEE802154_security_isConfigured() == FALSE) {
+        return FALSE;
+    }
+
+    // dont' send a DIS if the previous DIO/DIS is still queued
+    if (icmpv6rpl_vars.busySendingDIO == TRUE) {
+        return FALSE;
+    }
+
+    // reserve a free packet buffer for DIS
+    msg = openqueue_getFreePacketBuffer(COMPONENT_ICMPv6RPL);
+    if (msg == NULL) {
+        LOG_ERROR(COMPONENT_ICMPv6RPL, ERR_NO_FREE_PACKET_BUFFER, (errorparameter_t) 0, (errorparameter_t) 0);
+        return FALSE;
+    }
+
+    // take ownership
+    msg->creator = COMPONENT_ICMPv6RPL;
+    msg->owner = COMPONENT_ICMPv6RPL;
+
+    // set transport information
+    msg->l4_protocol = IANA_ICMPv6;
+    msg->l4_protocol_compressed = FALSE;
+    msg->l4_sourcePortORicmpv6Type = IANA_ICMPv6_RPL;
+
+    // DIS is multicast to the same routers as DIOs
+    memcpy(&(msg->l3_destinationAdd), &icmpv6rpl_vars.dioDestination, sizeof(open_addr_t));
+
+    //===== DIS payload, without options
+    if (packetfunctions_reserveHeader(&msg, sizeof(icmpv6rpl_dis_ht)) == E_FAIL) {
+        openqueue_freePacketBuffer(msg);
+        return FALSE;
+    }
+    ((icmpv6rpl_dis_ht *) (msg->payload))->flags = 0x00;
+    ((icmpv6rpl_dis_ht *) (msg->payload))->reserved = 0x00;
+
+    //===== ICMPv6 header
+    if (packetfunctions_reserveHeader(&msg, sizeof(ICMPv6_ht)) == E_FAIL) {
+        openqueue_freePacketBuffer(msg);
+        return FALSE;
+    }
+    ((ICMPv6_ht *) (msg->payload))->type = msg->l4_sourcePortORicmpv6Type;
+    ((ICMPv6_ht *) (msg->payload))->code = IANA_ICMPv6_RPL_DIS;
+    packetfunctions_calculateChecksum(msg, (uint8_t *) &(((ICMPv6_ht *) (msg->payload))->checksum));//call last
+
+    //send
+    if (icmpv6_send(msg) == E_SUCCESS) {
+        icmpv6rpl_vars.busySendingDIO = TRUE;
+        return TRUE;
     } else {
         openqueue_freePacketBuffer(msg);
+        return FALSE;
     }
 }
 
@@ -830,6 +1226,10 @@ void icmpv6rpl_timer_DAO_cb(opentimers_id_t id) {
 */
 void icmpv6rpl_timer_DAO_task(void) {
 
+#if RPL_STORING_MODE
+    icmpv6rpl_ageRoutes();
+#endif
+
     if (openrandom_get16b() < (0xffff / DAO_PORTION)) {
         sendDAO();
     }
@@ -1045,6 +1445,84 @@ void sendDAO(void) {
     }
 }
 
+/**
+\brief Orders candidate parents by path cost, the lowest index wins a tie.
+
+\returns TRUE if the candidate (cost, index) is ahead of (otherCost, otherIndex).
+*/
+bool icmpv6rpl_isBetterCandidate(uint16_t cost, uint8_t index, uint16_t otherCost, uint8_t otherIndex) {
+    return cost < otherCost || (cost == otherCost && index < otherIndex);
+}
+
+/**
+\brief Find the two best candidate parents from the path costs kept by the neighbor table.
+*/
+void icmpv6rpl_rankCandidates(void) {
+    uint8_t i;
+    uint16_t cost;
+
+    icmpv6rpl_vars.bestCandidate = MAXNUMNEIGHBORS;
+    icmpv6rpl_vars.secondCandidate = MAXNUMNEIGHBORS;
+    icmpv6rpl_vars.bestCost = MAXDAGRANK;
+    icmpv6rpl_vars.secondCost = MAXDAGRANK;
+
+    for (i = 0; i < MAXNUMNEIGHBORS; i++) {
+        cost = neighbors_getPathCost(i);
+        if (cost == MAXDAGRANK) {
+            continue;
+        }
+        if (cost < icmpv6rpl_vars.bestCost) {
+            icmpv6rpl_vars.secondCandidate = icmpv6rpl_vars.bestCandidate;
+            icmpv6rpl_vars.secondCost = icmpv6rpl_vars.bestCost;
+            icmpv6rpl_vars.bestCandidate = i;
+            icmpv6rpl_vars.bestCost = cost;
+        } else if (cost < icmpv6rpl_vars.secondCost) {
+            icmpv6rpl_vars.secondCandidate = i;
+            icmpv6rpl_vars.secondCost = cost;
+        }
+    }
+}
+
+#if RPL_STORING_MODE
+/**
+\brief Row of the routing table holding the route to a target.
+
+\param[in] target Interface identifier of the target.
+
+\returns The row, RPL_MAX_ROUTES if there is no route to that target.
+*/
+uint8_t icmpv6rpl_findRoute(const uint8_t *target) {
+    uint8_t i;
+
+    for (i = 0; i < RPL_MAX_ROUTES; i++) {
+        if (
+                icmpv6rpl_vars.routes[i].nextHop != MAXNUMNEIGHBORS &&
+                memcmp(icmpv6rpl_vars.routes[i].target, target, 8) == 0
+                ) {
+            return i;
+        }
+    }
+    return RPL_MAX_ROUTES;
+}
+
+/**
+\brief Drop the routes to targets which did not send a DAO for ROUTE_LIFETIME DAO timer periods.
+*/
+void icmpv6rpl_ageRoutes(void) {
+    uint8_t i;
+
+    for (i = 0; i < RPL_MAX_ROUTES; i++) {
+        if (icmpv6rpl_vars.routes[i].nextHop == MAXNUMNEIGHBORS) {
+            continue;
+        }
+        icmpv6rpl_vars.routes[i].age++;
+        if (icmpv6rpl_vars.routes[i].age >= ROUTE_LIFETIME) {
+            icmpv6rpl_vars.routes[i].nextHop = MAXNUMNEIGHBORS;
+        }
+    }
+}
+#endif
+
 bool icmpv6rpl_daoSent(void) {
     if (idmanager_getIsDAGroot() == TRUE) {
         return TRUE;
@@ -12,13 +12,19 @@
 
 //=========================== define ==========================================
 
-#define DIO_PERIOD             10000   // in miliseconds
 #define DAO_PERIOD             60000   // in miliseconds
 
+#if RPL_STORING_MODE
+// Storing Mode of Operation with no multicast support (2)
+#define MOP_DIO_A                 0<<5
+#define MOP_DIO_B                 1<<4
+#define MOP_DIO_C                 0<<3
+#else
 // Non-Storing Mode of Operation (1)
 #define MOP_DIO_A                 0<<5
 #define MOP_DIO_B                 0<<4
 #define MOP_DIO_C                 1<<3
+#endif
 // least preferred (0)
 #define PRF_DIO_A                 0<<2
 #define PRF_DIO_B                 0<<1
@@ -97,6 +103,16 @@ typedef struct {
 } icmpv6rpl_dio_ht;
 END_PACK
 
+/**
+\brief Header format of a RPL DIS packet.
+*/
+BEGIN_PACK
+typedef struct {
+    uint8_t flags;
+    uint8_t reserved;
+} icmpv6rpl_dis_ht;
+END_PACK
+
 
         BEGIN_PACK
 typedef struct {
@@ -116,9 +132,9 @@ typedef struct {
     uint8_t type;                   // 0x04
     uint8_t optLen;                 // 14d
     uint8_t flagsAPCS;
-    uint8_t DIOIntDoubl;            // 8 -> trickle period - max times it will double ~20min
-    uint8_t DIOIntMin;              // 12 ->  min trickle period -> 16s
-    uint8_t DIORedun;               // 0
+    uint8_t DIOIntDoubl;            // 8 -> trickle period - max times it will double ~17min
+    uint8_t DIOIntMin;              // 12 ->  min trickle period -> 4s
+    uint8_t DIORedun;               // 10
     uint16_t maxRankIncrease;       // 2048
     uint16_t minHopRankIncrease;    // 256
     uint16_t OCP;                   // 0 OF0
@@ -169,6 +185,22 @@ typedef struct {
 } icmpv6rpl_dao_target_ht;
 END_PACK
 
+//===== routing table
+
+#if RPL_STORING_MODE
+/**
+\brief Downward route to a mote below this one, learned from its DAO (storing mode).
+
+Only the interface identifier of the target is stored, its prefix is the one of the DODAG.
+*/
+typedef struct {
+    uint8_t target[8];                        ///< interface identifier of the target.
+    uint8_t nextHop;                          ///< row of the child towards the target in the neighbor table.
+    uint16_t age;                             ///< DAO timer periods since the target was last heard of.
+    uint16_t lastUsed;                        ///< routeClock when the route was last used, for LRU eviction.
+} icmpv6rpl_route_t;
+#endif
+
 //=========================== module variables ================================
 
 
@@ -183,9 +215,11 @@ typedef struct {
     icmpv6rpl_pio_t pio;                      ///< pre-populated PIO com
     icmpv6rpl_config_ht conf;
     open_addr_t dioDestination;               ///< IPv6 destination address for DIOs.
-    uint16_t dioTimerCounter;                 ///< counter to determine when to send DIO.
     opentimers_id_t timerIdDIO;               ///< ID of the timer used to send DIOs.
-    uint16_t dioPeriod;                       ///< dio period in seconds.
+    uint32_t dioInterval;                     ///< current Trickle interval (I), in ms.
+    uint32_t dioIntervalRemainder;            ///< time left in the interval once the DIO is sent, in ms.
+    uint8_t dioNumConsistent;                 ///< consistent DIOs heard during the interval (c).
+    bool dioIntervalHeld;                     ///< no DIO could be sent during the interval, do not double it.
     // DAO-related
     icmpv6rpl_dao_ht dao;                     ///< pre-populated DAO packet.
     icmpv6rpl_dao_transit_ht dao_transit;     ///< pre-populated DAO "Transit Info" option header.
@@ -199,6 +233,14 @@ typedef struct {
     uint16_t rankIncrease;                    ///< the cost of the link to the parent, in units of rank
     bool haveParent;                          ///< this router has a route to DAG root
     uint8_t ParentIndex;                      ///< index of Parent in neighbor table (iff haveParent==TRUE)
+    uint8_t bestCandidate;                    ///< neighbor with the lowest path cost, MAXNUMNEIGHBORS if none
+    uint8_t secondCandidate;                  ///< neighbor with the second lowest path cost, MAXNUMNEIGHBORS if none
+    uint16_t bestCost;                        ///< path cost through bestCandidate
+    uint16_t secondCost;                      ///< path cost through secondCandidate
+#if RPL_STORING_MODE
+    icmpv6rpl_route_t routes[RPL_MAX_ROUTES]; ///< downward routes, nextHop is MAXNUMNEIGHBORS if unused.
+    uint16_t routeClock;                      ///< incremented each time a route is used.
+#endif
     // actually only here for debug
     icmpv6rpl_dio_ht *incomingDio;            ///< keep it global to be able to debug correctly.
     icmpv6rpl_pio_t *incomingPio;             ///< pio structure incoming
@@ -224,6 +266,8 @@ owerror_t icmpv6rpl_getRPLDODAGid(uint8_t *address_128b);
 
 bool icmpv6rpl_getPreferredParentIndex(uint8_t *indexptr);
 
+bool icmpv6rpl_getBackupParentIndex(uint8_t *indexptr);
+
 bool icmpv6rpl_getPreferredParentEui64(open_addr_t *addressToWrite);
 
 void icmpv6rpl_updateNexthopAddress(open_addr_t *addressToWrite);
@@ -236,6 +280,16 @@ dagrank_t icmpv6rpl_getMyDAGrank(void);
 
 void icmpv6rpl_updateMyDAGrankAndParentSelection(void);
 
+void icmpv6rpl_indicatePathCost(uint8_t index);
+
+#if RPL_STORING_MODE
+void icmpv6rpl_indicateRelayedDAO(open_addr_t *target128b, open_addr_t *previousHop64b);
+
+bool icmpv6rpl_getDownwardNextHop(open_addr_t *destination128b, open_addr_t *addressToWrite64b);
+
+void icmpv6rpl_indicateNeighborRemoved(uint8_t index);
+#endif
+
 void icmpv6rpl_indicateRxDIO(OpenQueueEntry_t *msg);
 
 bool icmpv6rpl_daoSent(void);
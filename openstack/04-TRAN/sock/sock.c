@@ -16,7 +16,11 @@
 
 // ============================ defines ========================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define udp_socket_list MOTE_CTX_VAR(sock_udp_t *, udp_socket_list)
+#else
 sock_udp_t *udp_socket_list;
+#endif
 
 // =========================== variables =======================================
 // =========================== prototypes ======================================
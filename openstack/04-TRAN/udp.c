@@ -36,7 +36,10 @@ void udp_transmit(OpenQueueEntry_t *msg) {
     msg->l4_protocol_compressed = FALSE;
     msg->l4_protocol = IANA_UDP;
 
-    packetfunctions_reserveHeader(&msg, sizeof(udp_ht));
+    if (packetfunctions_reserveHeader(&msg, sizeof(udp_ht)) == E_FAIL) {
+        openqueue_freePacketBuffer(msg);
+        return;
+    }
     packetfunctions_htons(msg->l4_sourcePortORicmpv6Type, &(msg->payload[0]));
     packetfunctions_htons(msg->l4_destination_port, &(msg->payload[2]));
     packetfunctions_htons(msg->length, &(msg->payload[4]));
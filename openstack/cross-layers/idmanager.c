@@ -28,8 +28,13 @@ END_PACK
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define id_manager_vars       MOTE_CTX_VAR(idManagerVars_t, id_manager_vars)
+#define id_manager_status_ctx MOTE_CTX_VAR(idManagerStatus_t, id_manager_status_ctx)
+#else
 idManagerVars_t id_manager_vars;
 idManagerStatus_t id_manager_status_ctx;
+#endif
 
 //=========================== prototypes ======================================
 
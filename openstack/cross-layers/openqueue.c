@@ -7,10 +7,12 @@
 #include "radio.h"
 #include "IEEE802154_security.h"
 #include "sixtop.h"
+#include "neighbors.h"
 
 //=========================== defination =====================================
 
 #define HIGH_PRIORITY_QUEUE_ENTRY       (5)
+#define HIGH_PRIORITY_FULL_BUFFERS      (2)     // to receive a data frame and an ACK
 
 BEGIN_PACK
 typedef struct {
@@ -20,13 +22,62 @@ END_PACK
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define openqueue_vars       MOTE_CTX_VAR(openqueueVars_t, openqueue_vars)
+#define openqueue_status_ctx MOTE_CTX_VAR(openqueueStatus_t, openqueue_status_ctx)
+#else
 openqueueVars_t openqueue_vars;
 openqueueStatus_t openqueue_status_ctx;
+#endif
 
 //=========================== prototypes ======================================
 
 void openqueue_reset_entry(OpenQueueEntry_t *entry);
 
+static void openqueue_release(uint8_t index);
+
+static owerror_t openqueue_attachBuffer(OpenQueueEntry_t *entry, uint8_t creator);
+
+static void openqueue_detach(OpenQueueEntry_t *entry);
+
+static uint8_t *openqueue_takeFullBuffer(uint8_t creator);
+
+static bool openqueue_isFullBuffer(const uint8_t *buffer);
+
+static void openqueue_compactBuffer(OpenQueueEntry_t *pkt);
+
+static void openqueue_returnBuffer(uint8_t *buffer);
+
+static bool openqueue_isLowPriority(uint8_t creator);
+
+static uint8_t openqueue_classOf(uint8_t creator);
+
+static void openqueue_countDrop(uint8_t creator);
+
+static OpenQueueEntry_t *openqueue_drrSelect(uint8_t drr, OpenQueueEntry_t *candidates[], bool consume);
+
+static void openqueue_drrReset(uint8_t drr);
+
+static uint8_t openqueue_txListOf(OpenQueueEntry_t *entry);
+
+static uint8_t openqueue_txListOfNeighbor(open_addr_t *neighbor);
+
+static void openqueue_txRelink(uint8_t list);
+
+static void openqueue_txAppend(uint8_t index);
+
+static void openqueue_txRemove(uint8_t index);
+
+static OpenQueueEntry_t *openqueue_txFind(uint8_t list, open_addr_t *neighbor, uint8_t creator);
+
+static OpenQueueEntry_t *openqueue_txSelect(uint8_t list, open_addr_t *neighbor, bool consume);
+
+static OpenQueueEntry_t *openqueue_unicastSelect(open_addr_t *toNeighbor, bool consume);
+
+#if OPENWSN_6LO_FRAGMENTATION_C
+static OpenQueueEntry_t *openqueue_bigFind(open_addr_t *neighbor);
+#endif
+
 #if OPENWSN_6LO_FRAGMENTATION_C
 void openqueue_reset_big_entry(OpenQueueBigEntry_t *entry);
 #endif
@@ -43,11 +94,44 @@ static bool statusPrint_queue(void);
 void openqueue_init() {
     uint8_t i;
     for (i = 0; i < QUEUELENGTH; i++) {
+        openqueue_vars.queue[i].packet = NULL;
+        openqueue_vars.queue[i].l2_sixtop_celllist_add = NULL;
+        openqueue_vars.queue[i].l2_sixtop_celllist_delete = NULL;
         openqueue_reset_entry(&(openqueue_vars.queue[i]));
+        openqueue_vars.next[i] = (i + 1 < QUEUELENGTH) ? i + 1 : OPENQUEUE_NONE;
+        openqueue_vars.prev[i] = OPENQUEUE_NONE;
+        openqueue_vars.txList[i] = OPENQUEUE_NONE;
     }
+    openqueue_vars.freeHead = 0;
+    openqueue_vars.numLowPriority = 0;
+
+    for (i = 0; i < OPENQUEUE_NUM_TXLISTS; i++) {
+        openqueue_vars.txHead[i] = OPENQUEUE_NONE;
+        openqueue_vars.txTail[i] = OPENQUEUE_NONE;
+    }
+
+    for (i = 0; i < OPENQUEUE_NUM_DRR; i++) {
+        openqueue_drrReset(i);
+    }
+
+    for (i = 0; i < OPENQUEUE_NUM_FULL_BUFFERS; i++) {
+        openqueue_vars.freeFull[i] = i;
+    }
+    openqueue_vars.numFreeFull = OPENQUEUE_NUM_FULL_BUFFERS;
+    for (i = 0; i < OPENQUEUE_NUM_SMALL_BUFFERS; i++) {
+        openqueue_vars.freeSmall[i] = i;
+    }
+    openqueue_vars.numFreeSmall = OPENQUEUE_NUM_SMALL_BUFFERS;
+    for (i = 0; i < OPENQUEUE_NUM_CELLLISTS; i++) {
+        openqueue_vars.freeCelllists[i] = i;
+    }
+    openqueue_vars.numFreeCelllists = OPENQUEUE_NUM_CELLLISTS;
 
 #if OPENWSN_6LO_FRAGMENTATION_C
     for (i = 0; i < BIGQUEUELENGTH; i++) {
+        // big entries keep their own buffer
+        openqueue_vars.big_queue[i].standard_entry.packet = openqueue_vars.big_queue[i].buffer;
+        openqueue_vars.big_queue[i].standard_entry.packet_size = sizeof(openqueue_vars.big_queue[i].buffer);
         openqueue_reset_big_entry(&(openqueue_vars.big_queue[i]));
     }
 #endif
@@ -66,13 +150,16 @@ status information about several modules in the OpenWSN stack.
 \returns TRUE if this function printed something, FALSE otherwise.
 */
 static bool statusPrint_queue() {
-    debugOpenQueueEntry_t output[QUEUELENGTH];
+    debugOpenQueue_t output;
     uint8_t i;
     for (i = 0; i < QUEUELENGTH; i++) {
-        output[i].creator = openqueue_vars.queue[i].creator;
-        output[i].owner = openqueue_vars.queue[i].owner;
+        output.entries[i].creator = openqueue_vars.queue[i].creator;
+        output.entries[i].owner = openqueue_vars.queue[i].owner;
+    }
+    for (i = 0; i < OPENQUEUE_NUM_CLASSES; i++) {
+        output.numDropped[i] = openqueue_vars.numDropped[i];
     }
-    openserial_printStatus(STATUS_QUEUE, (uint8_t *) &output, QUEUELENGTH * sizeof(debugOpenQueueEntry_t));
+    openserial_printStatus(STATUS_QUEUE, (uint8_t *) &output, sizeof(debugOpenQueue_t));
     return TRUE;
 }
 
@@ -101,19 +188,33 @@ OpenQueueEntry_t *openqueue_getFreePacketBuffer(uint8_t creator) {
     // if you get here, I will try to allocate a buffer for you
 
     // if there is no space left for high priority queue, don't reserve
-    if (openqueue_isHighPriorityEntryEnough() == FALSE && creator > COMPONENT_SIXTOP_RES) { ENABLE_INTERRUPTS();
+    if (openqueue_isHighPriorityEntryEnough() == FALSE && openqueue_isLowPriority(creator)) {
+        openqueue_countDrop(creator);ENABLE_INTERRUPTS();
         return NULL;
     }
 
-    // walk through queue and find free entry
-    for (i = 0; i < QUEUELENGTH; i++) {
-        if (openqueue_vars.queue[i].owner == COMPONENT_NULL) {
-            openqueue_vars.queue[i].creator = creator;
-            openqueue_vars.queue[i].owner = COMPONENT_OPENQUEUE;ENABLE_INTERRUPTS();
-            return &openqueue_vars.queue[i];
-        }
-    }ENABLE_INTERRUPTS();
-    return NULL;
+    // take the first free entry
+    i = openqueue_vars.freeHead;
+    if (i == OPENQUEUE_NONE) {
+        openqueue_countDrop(creator);ENABLE_INTERRUPTS();
+        return NULL;
+    }
+
+    // and a buffer for its packet
+    if (openqueue_attachBuffer(&openqueue_vars.queue[i], creator) == E_FAIL) {
+        openqueue_countDrop(creator);ENABLE_INTERRUPTS();
+        return NULL;
+    }
+    openqueue_vars.freeHead = openqueue_vars.next[i];
+    openqueue_vars.next[i] = OPENQUEUE_NONE;
+
+    if (openqueue_isLowPriority(creator)) {
+        openqueue_vars.numLowPriority++;
+    }
+
+    openqueue_vars.queue[i].creator = creator;
+    openqueue_vars.queue[i].owner = COMPONENT_OPENQUEUE;ENABLE_INTERRUPTS();
+    return &openqueue_vars.queue[i];
 }
 
 /**
@@ -145,15 +246,16 @@ owerror_t openqueue_freePacketBuffer(OpenQueueEntry_t *pkt) {
         }
     } else {
 #endif
-    for (i = 0; i < QUEUELENGTH; i++) {
-        if (&openqueue_vars.queue[i] == pkt) {
-            if (openqueue_vars.queue[i].owner == COMPONENT_NULL) {
-                // log the error
-                LOG_CRITICAL(COMPONENT_OPENQUEUE, ERR_FREEING_UNUSED, (errorparameter_t) 0, (errorparameter_t) 0);
-            }
+    if (pkt >= &openqueue_vars.queue[0] && pkt < &openqueue_vars.queue[QUEUELENGTH]) {
+        i = (uint8_t) (pkt - &openqueue_vars.queue[0]);
+        if (openqueue_vars.queue[i].owner == COMPONENT_NULL) {
+            // log the error
+            LOG_CRITICAL(COMPONENT_OPENQUEUE, ERR_FREEING_UNUSED, (errorparameter_t) 0, (errorparameter_t) 0);
             openqueue_reset_entry(&(openqueue_vars.queue[i]));ENABLE_INTERRUPTS();
             return E_SUCCESS;
         }
+        openqueue_release(i);ENABLE_INTERRUPTS();
+        return E_SUCCESS;
     }
 #if OPENWSN_6LO_FRAGMENTATION_C
     }
@@ -191,6 +293,7 @@ OpenQueueEntry_t* openqueue_getFreeBigPacketBuffer(uint8_t creator) {
         }
     }
 
+    openqueue_countDrop(creator);
     ENABLE_INTERRUPTS();
     return NULL;
 }
@@ -206,9 +309,10 @@ void openqueue_removeAllCreatedBy(uint8_t creator) {
     for (i = 0; i < QUEUELENGTH; i++) {
         if (
                 openqueue_vars.queue[i].creator == creator &&
+                openqueue_vars.queue[i].owner != COMPONENT_NULL &&
                 openqueue_vars.queue[i].owner != COMPONENT_IEEE802154E
                 ) {
-            openqueue_reset_entry(&(openqueue_vars.queue[i]));
+            openqueue_release(i);
         }
     }
 
@@ -313,94 +417,109 @@ void openqueue_remove6PrequestToNeighbor(open_addr_t *neighbor) {
                 openqueue_vars.queue[i].l2_sixtop_messageType == SIXTOP_CELL_REQUEST &&
                 packetfunctions_sameAddress(neighbor, &openqueue_vars.queue[i].l2_nextORpreviousHop)
                 ) {
-            openqueue_reset_entry(&(openqueue_vars.queue[i]));
+            openqueue_release(i);
         }
     }ENABLE_INTERRUPTS();
 }
 
-//======= called by IEEE80215E
+/**
+\brief Give a 6P packet the cell lists it records, they are released with the packet.
 
-bool openqueue_isHighPriorityEntryEnough() {
-    uint8_t i;
-    uint8_t numberOfEntry;INTERRUPT_DECLARATION();DISABLE_INTERRUPTS();
+\returns E_SUCCESS when the packet has cell lists.
+\returns E_FAIL when all cell lists are in use.
+*/
+owerror_t openqueue_getCelllists(OpenQueueEntry_t *pkt) {
+    uint8_t i;INTERRUPT_DECLARATION();DISABLE_INTERRUPTS();
 
-    numberOfEntry = 0;
-    for (i = 0; i < QUEUELENGTH; i++) {
-        if (openqueue_vars.queue[i].creator > COMPONENT_SIXTOP_RES) {
-            numberOfEntry++;
+    if (pkt->l2_sixtop_celllist_add == NULL) {
+        if (openqueue_vars.numFreeCelllists == 0) { ENABLE_INTERRUPTS();
+            return E_FAIL;
         }
+        i = openqueue_vars.freeCelllists[--openqueue_vars.numFreeCelllists];
+        pkt->l2_sixtop_celllist_add = openqueue_vars.celllists[i].celllist_add;
+        pkt->l2_sixtop_celllist_delete = openqueue_vars.celllists[i].celllist_delete;
     }
 
-    if (numberOfEntry > QUEUELENGTH - HIGH_PRIORITY_QUEUE_ENTRY) { ENABLE_INTERRUPTS();
-        return FALSE;
-    } else { ENABLE_INTERRUPTS();
-        return TRUE;
-    }
+    ENABLE_INTERRUPTS();
+    return E_SUCCESS;
+}
+
+//======= called by IEEE80215E
+
+bool openqueue_isHighPriorityEntryEnough() {
+    bool res;INTERRUPT_DECLARATION();DISABLE_INTERRUPTS();
+
+    res = (openqueue_vars.numLowPriority > QUEUELENGTH - HIGH_PRIORITY_QUEUE_ENTRY) ? FALSE : TRUE;
+
+    ENABLE_INTERRUPTS();
+    return res;
 }
 
 OpenQueueEntry_t *openqueue_macGetEBPacket() {
-    uint8_t i;INTERRUPT_DECLARATION();DISABLE_INTERRUPTS();
-    for (i = 0; i < QUEUELENGTH; i++) {
-        if (openqueue_vars.queue[i].owner == COMPONENT_SIXTOP_TO_IEEE802154E &&
-            openqueue_vars.queue[i].creator == COMPONENT_SIXTOP &&
-            packetfunctions_isBroadcastMulticast(
-                    &(openqueue_vars.queue[i].l2_nextORpreviousHop))) { ENABLE_INTERRUPTS();
-            return &openqueue_vars.queue[i];
-        }
-    }ENABLE_INTERRUPTS();
-    return NULL;
+    OpenQueueEntry_t *pkt;INTERRUPT_DECLARATION();DISABLE_INTERRUPTS();
+
+    pkt = openqueue_txFind(OPENQUEUE_TXLIST_EB, NULL, COMPONENT_NULL);
+
+    ENABLE_INTERRUPTS();
+    return pkt;
 }
 
 OpenQueueEntry_t *openqueue_macGetKaPacket(open_addr_t *toNeighbor) {
-    uint8_t i;INTERRUPT_DECLARATION();DISABLE_INTERRUPTS();
-    for (i = 0; i < QUEUELENGTH; i++) {
-        if (openqueue_vars.queue[i].owner == COMPONENT_SIXTOP_TO_IEEE802154E &&
-            openqueue_vars.queue[i].creator == COMPONENT_SIXTOP &&
-            toNeighbor->type == ADDR_64B &&
-            packetfunctions_sameAddress(toNeighbor, &openqueue_vars.queue[i].l2_nextORpreviousHop)
-                ) { ENABLE_INTERRUPTS();
-            return &openqueue_vars.queue[i];
-        }
-    }ENABLE_INTERRUPTS();
-    return NULL;
+    OpenQueueEntry_t *pkt;INTERRUPT_DECLARATION();DISABLE_INTERRUPTS();
+
+    pkt = NULL;
+    if (toNeighbor->type == ADDR_64B) {
+        pkt = openqueue_txFind(openqueue_txListOfNeighbor(toNeighbor), toNeighbor, COMPONENT_SIXTOP);
+    }
+
+    ENABLE_INTERRUPTS();
+    return pkt;
 }
 
 OpenQueueEntry_t *openqueue_macGetDIOPacket() {
-    uint8_t i;INTERRUPT_DECLARATION();DISABLE_INTERRUPTS();
-    for (i = 0; i < QUEUELENGTH; i++) {
-        if (openqueue_vars.queue[i].owner == COMPONENT_SIXTOP_TO_IEEE802154E &&
-            openqueue_vars.queue[i].creator == COMPONENT_ICMPv6RPL &&
-            packetfunctions_isBroadcastMulticast(
-                    &(openqueue_vars.queue[i].l2_nextORpreviousHop))) { ENABLE_INTERRUPTS();
-            return &openqueue_vars.queue[i];
-        }
-    }ENABLE_INTERRUPTS();
-    return NULL;
+    OpenQueueEntry_t *pkt;INTERRUPT_DECLARATION();DISABLE_INTERRUPTS();
+
+    pkt = openqueue_txFind(OPENQUEUE_TXLIST_DIO, NULL, COMPONENT_NULL);
+
+    ENABLE_INTERRUPTS();
+    return pkt;
 }
 
 /**
 \Brief replace the upstream packet nexthop payload by given newNextHop address
+
+Packets going down the DODAG, by source routing or by routing table lookup, keep their next hop.
+
 \param newNextHop.
 */
 void openqueue_updateNextHopPayload(open_addr_t *newNextHop) {
 
-    uint8_t i, j;INTERRUPT_DECLARATION();DISABLE_INTERRUPTS();
+    uint8_t i, j, list, next;INTERRUPT_DECLARATION();DISABLE_INTERRUPTS();
 
-    for (i = 0; i < QUEUELENGTH; i++) {
-        if (
-                openqueue_vars.queue[i].owner == COMPONENT_SIXTOP_TO_IEEE802154E &&
-                (
-                        newNextHop->type == ADDR_64B &&
-                        packetfunctions_sameAddress(newNextHop, &openqueue_vars.queue[i].l2_nextORpreviousHop) == FALSE
-                )
-                ) {
+    // walk the lists of the neighbors in order, so packets moved to the new next hop stay first-in first-out
+    for (list = 0; list < MAXNUMNEIGHBORS; list++) {
+        for (i = openqueue_vars.txHead[list]; i != OPENQUEUE_NONE; i = next) {
+            next = openqueue_vars.next[i];
             if (
-                    openqueue_vars.queue[i].creator >= COMPONENT_FORWARDING &&
-                    openqueue_vars.queue[i].l3_useSourceRouting == FALSE
+                    openqueue_vars.queue[i].owner == COMPONENT_SIXTOP_TO_IEEE802154E &&
+                    (
+                            newNextHop->type == ADDR_64B &&
+                            packetfunctions_sameAddress(newNextHop, &openqueue_vars.queue[i].l2_nextORpreviousHop) == FALSE
+                    )
                     ) {
-                memcpy(&openqueue_vars.queue[i].l2_nextORpreviousHop, newNextHop, sizeof(open_addr_t));
-                for (j = 0; j < 8; j++) {
-                    *((uint8_t *) openqueue_vars.queue[i].l2_nextHop_payload + j) = newNextHop->addr_type.addr_64b[j];
+                if (
+                        openqueue_vars.queue[i].creator >= COMPONENT_FORWARDING &&
+                        openqueue_vars.queue[i].l3_useSourceRouting == FALSE &&
+                        openqueue_vars.queue[i].l3_routedDownward == FALSE
+                        ) {
+                    memcpy(&openqueue_vars.queue[i].l2_nextORpreviousHop, newNextHop, sizeof(open_addr_t));
+                    for (j = 0; j < 8; j++) {
+                        *((uint8_t *) openqueue_vars.queue[i].l2_nextHop_payload + j) = newNextHop->addr_type.addr_64b[j];
+                    }
+
+                    // move the packet to the list of its new next hop
+                    openqueue_txRemove(i);
+                    openqueue_txAppend(i);
                 }
             }
         }
@@ -422,65 +541,609 @@ OpenQueueEntry_t *openqueue_getPacketByComponent(uint8_t component) {
     return NULL;
 }
 
+/**
+\brief Pick the packet to send to a neighbor in the current cell.
+
+6P responses go first, then other 6P and RPL control packets. Locally originated and forwarded data share the remaining
+cells by deficit round robin, with OPENQUEUE_WEIGHT_LOCAL and OPENQUEUE_WEIGHT_FORWARDED as quanta. Packets of a class
+are sent in the order they were handed to the MAC layer. Each neighbor has its own shares.
+
+\note Every call returning a data packet for its first attempt consumes a share of its class, only call this when the
+    packet is sent.
+*/
 OpenQueueEntry_t *openqueue_macGetUnicastPacket(open_addr_t *toNeighbor) {
+    OpenQueueEntry_t *pkt;INTERRUPT_DECLARATION();DISABLE_INTERRUPTS();
+
+    pkt = openqueue_unicastSelect(toNeighbor, TRUE);
+
+    ENABLE_INTERRUPTS();
+    return pkt;
+}
+
+/**
+\brief The packet openqueue_macGetUnicastPacket() would return, without consuming a share of its class.
+*/
+OpenQueueEntry_t *openqueue_macPeekUnicastPacket(open_addr_t *toNeighbor) {
+    OpenQueueEntry_t *pkt;INTERRUPT_DECLARATION();DISABLE_INTERRUPTS();
+
+    pkt = openqueue_unicastSelect(toNeighbor, FALSE);
+
+    ENABLE_INTERRUPTS();
+    return pkt;
+}
+
+/**
+\brief Whether a unicast packet to a neighbor is waiting for the MAC layer.
+
+Unlike openqueue_macGetUnicastPacket(), this does not count as a transmission opportunity of the queueing discipline.
+*/
+bool openqueue_macHasUnicastPacket(open_addr_t *toNeighbor) {
+    OpenQueueEntry_t *pkt;INTERRUPT_DECLARATION();DISABLE_INTERRUPTS();
+
+    pkt = NULL;
+    if (toNeighbor->type == ADDR_64B) {
+        pkt = openqueue_txFind(OPENQUEUE_TXLIST_6PRESPONSE, toNeighbor, COMPONENT_NULL);
+        if (pkt == NULL) {
+            pkt = openqueue_txFind(openqueue_txListOfNeighbor(toNeighbor), toNeighbor, COMPONENT_NULL);
+        }
+#if OPENWSN_6LO_FRAGMENTATION_C
+        if (pkt == NULL) {
+            pkt = openqueue_bigFind(toNeighbor);
+        }
+#endif
+    }
+
+    ENABLE_INTERRUPTS();
+    return pkt != NULL;
+}
+
+
+/**
+\brief Change the component a packet is accounted to, e.g. when relaying a received packet.
+
+Creators above COMPONENT_SIXTOP_RES count towards the low-priority share of the queue, use this function rather than
+writing pkt->creator whenever the new creator may be in another priority class than the previous one.
+*/
+void openqueue_setCreator(OpenQueueEntry_t *pkt, uint8_t creator) {
+    INTERRUPT_DECLARATION();DISABLE_INTERRUPTS();
+
+    if (pkt >= &openqueue_vars.queue[0] && pkt < &openqueue_vars.queue[QUEUELENGTH]) {
+        if (openqueue_isLowPriority(pkt->creator) && !openqueue_isLowPriority(creator)) {
+            openqueue_vars.numLowPriority--;
+        } else if (!openqueue_isLowPriority(pkt->creator) && openqueue_isLowPriority(creator)) {
+            openqueue_vars.numLowPriority++;
+        }
+    }
+    pkt->creator = creator;
+
+    ENABLE_INTERRUPTS();
+}
+
+/**
+\brief Free a packet buffer the queue has no room for, and account it as a drop of its traffic class.
+
+\param pkt A pointer to the previsouly-allocated packet buffer.
+*/
+void openqueue_dropPacketBuffer(OpenQueueEntry_t *pkt) {
+    INTERRUPT_DECLARATION();DISABLE_INTERRUPTS();
+
+    openqueue_countDrop(pkt->creator);
+    openqueue_freePacketBuffer(pkt);
+
+    ENABLE_INTERRUPTS();
+}
+
+/**
+\brief Move a packet from a small to a full size buffer, called when it outgrows the former.
+
+The packet keeps the same room for footers after its end.
+
+\returns E_SUCCESS when the packet was moved.
+\returns E_FAIL when the packet is not in a small buffer, or no full size buffer is available.
+*/
+owerror_t openqueue_growPacketBuffer(OpenQueueEntry_t *pkt) {
+    uint8_t *buffer;
+    uint8_t *small;INTERRUPT_DECLARATION();DISABLE_INTERRUPTS();
+
+    if (pkt->packet_size >= PACKET_BUFFER_SIZE || (buffer = openqueue_takeFullBuffer(pkt->creator)) == NULL) {
+        ENABLE_INTERRUPTS();
+        return E_FAIL;
+    }
+
+    small = pkt->packet;
+    packetfunctions_movePacket(pkt, buffer, PACKET_BUFFER_SIZE,
+                               buffer + PACKET_BUFFER_SIZE - (pkt->packet + pkt->packet_size - pkt->payload));
+    openqueue_returnBuffer(small);
+
+    ENABLE_INTERRUPTS();
+    return E_SUCCESS;
+}
+
+//======= called by sixtop
+
+/**
+\brief Hand a packet over to the MAC layer.
+
+The packet is assigned to the virtual component COMPONENT_SIXTOP_TO_IEEE802154E and appended to the transmit list of
+its class (EB, DIO, 6P response) or next hop, so IEEE802154E finds it in constant time at the start of a slot. The
+frame is moved to a small buffer when it fits in one.
+*/
+void openqueue_macEnqueue(OpenQueueEntry_t *pkt) {
     uint8_t i;INTERRUPT_DECLARATION();DISABLE_INTERRUPTS();
 
-    // first to look the sixtop RES packet
-    for (i = 0; i < QUEUELENGTH; i++) {
+    pkt->owner = COMPONENT_SIXTOP_TO_IEEE802154E;
+
+    // big packets are few, they are looked up by openqueue_macGetUnicastPacket() directly
+    if (pkt >= &openqueue_vars.queue[0] && pkt < &openqueue_vars.queue[QUEUELENGTH]) {
+        i = (uint8_t) (pkt - &openqueue_vars.queue[0]);
+        openqueue_txRemove(i);
+        openqueue_txAppend(i);
+
+        // the frame is complete, it may wait for a cell in a smaller buffer
+        openqueue_compactBuffer(pkt);
+    }
+
+    ENABLE_INTERRUPTS();
+}
+
+//======= called by neighbors
+
+/**
+\brief A neighbor was added to the neighbor table, move the packets to it into the transmit list of its row.
+
+\param[in] index The row of the neighbor in the neighbor table.
+*/
+void openqueue_indicateNeighborAdded(uint8_t index) {
+    INTERRUPT_DECLARATION();DISABLE_INTERRUPTS();
+
+    openqueue_drrReset(index);
+    openqueue_txRelink(OPENQUEUE_TXLIST_OTHER);
+
+    ENABLE_INTERRUPTS();
+}
+
+/**
+\brief A neighbor was removed from the neighbor table, move the packets to it out of the transmit list of its row.
+
+Call once the neighbor can no longer be found in the neighbor table, the packets then go to OPENQUEUE_TXLIST_OTHER.
+
+\param[in] index The row the neighbor had in the neighbor table.
+*/
+void openqueue_indicateNeighborRemoved(uint8_t index) {
+    INTERRUPT_DECLARATION();DISABLE_INTERRUPTS();
+
+    openqueue_txRelink(index);
+    openqueue_drrReset(index);
+
+    ENABLE_INTERRUPTS();
+}
+
+//=========================== private =========================================
+
+/**
+\brief Return an allocated entry to the free list.
+
+Interrupts must be disabled by the caller.
+*/
+static void openqueue_release(uint8_t index) {
+    openqueue_txRemove(index);
+
+    if (openqueue_isLowPriority(openqueue_vars.queue[index].creator)) {
+        if (openqueue_vars.numLowPriority == 0) {
+            // the creator of this entry was changed without openqueue_setCreator()
+            LOG_ERROR(COMPONENT_OPENQUEUE, ERR_FREEING_ERROR,
+                      (errorparameter_t) openqueue_vars.queue[index].creator,
+                      (errorparameter_t) index);
+        } else {
+            openqueue_vars.numLowPriority--;
+        }
+    }
+
+    openqueue_detach(&(openqueue_vars.queue[index]));
+    openqueue_reset_entry(&(openqueue_vars.queue[index]));
+
+    openqueue_vars.next[index] = openqueue_vars.freeHead;
+    openqueue_vars.freeHead = index;
+}
+
+static bool openqueue_isLowPriority(uint8_t creator) {
+    return creator > COMPONENT_SIXTOP_RES;
+}
+
+//======= packet buffers
+
+/**
+\brief Give a newly allocated entry a buffer for its packet.
+
+Frames are received in a full size buffer. Packets built by the stack start in a small buffer, and move to a full size
+one when they outgrow it (see openqueue_growPacketBuffer()).
+*/
+static owerror_t openqueue_attachBuffer(OpenQueueEntry_t *entry, uint8_t creator) {
+    uint8_t *buffer;
+    uint16_t size;
+
+    if (creator != COMPONENT_IEEE802154E && openqueue_vars.numFreeSmall > 0) {
+        buffer = openqueue_vars.smallBuffers[openqueue_vars.freeSmall[--openqueue_vars.numFreeSmall]];
+        size = OPENQUEUE_SMALL_BUFFER_SIZE;
+    } else {
+        buffer = openqueue_takeFullBuffer(creator);
+        size = PACKET_BUFFER_SIZE;
+    }
+
+    if (buffer == NULL) {
+        return E_FAIL;
+    }
+
+    entry->packet = buffer;
+    entry->packet_size = size;
+
+    // Footer is longer if security is used
+    entry->payload = buffer + size - PACKET_BUFFER_TAIL - LENGTH_CRC - IEEE802154_SECURITY_TAG_LEN;
+
+    return E_SUCCESS;
+}
+
+/**
+\brief Return the buffer and the cell lists of an entry being freed.
+*/
+static void openqueue_detach(OpenQueueEntry_t *entry) {
+    uint8_t i;
+
+    if (entry->packet != NULL) {
+        openqueue_returnBuffer(entry->packet);
+        entry->packet = NULL;
+        entry->packet_size = 0;
+    }
+
+    if (entry->l2_sixtop_celllist_add != NULL) {
+        for (i = 0; i < OPENQUEUE_NUM_CELLLISTS; i++) {
+            if (entry->l2_sixtop_celllist_add == openqueue_vars.celllists[i].celllist_add) {
+                openqueue_vars.freeCelllists[openqueue_vars.numFreeCelllists++] = i;
+                break;
+            }
+        }
+        entry->l2_sixtop_celllist_add = NULL;
+        entry->l2_sixtop_celllist_delete = NULL;
+    }
+}
+
+static uint8_t *openqueue_takeFullBuffer(uint8_t creator) {
+    // low priority packets leave some full size buffers to receive frames
+    if (openqueue_isLowPriority(creator) && openqueue_vars.numFreeFull <= HIGH_PRIORITY_FULL_BUFFERS) {
+        return NULL;
+    }
+
+    if (openqueue_vars.numFreeFull == 0) {
+        return NULL;
+    }
+
+    return openqueue_vars.fullBuffers[openqueue_vars.freeFull[--openqueue_vars.numFreeFull]];
+}
+
+/**
+\brief Move a packet which is going to wait in the queue to a small buffer, if it fits in one.
+
+Frames are received in full size buffers, this releases the full size buffer of a relayed packet. The packet is placed
+where a new one would end, leaving room for the footers.
+
+Interrupts must be disabled by the caller.
+*/
+static void openqueue_compactBuffer(OpenQueueEntry_t *pkt) {
+    uint8_t *buffer;
+    uint8_t *full;
+    int16_t room;
+
+    room = OPENQUEUE_SMALL_BUFFER_SIZE - PACKET_BUFFER_TAIL - LENGTH_CRC - IEEE802154_SECURITY_TAG_LEN;
+
+    if (openqueue_isFullBuffer(pkt->packet) == FALSE || pkt->length > room || openqueue_vars.numFreeSmall == 0) {
+        return;
+    }
+
+    buffer = openqueue_vars.smallBuffers[openqueue_vars.freeSmall[--openqueue_vars.numFreeSmall]];
+    full = pkt->packet;
+    packetfunctions_movePacket(pkt, buffer, OPENQUEUE_SMALL_BUFFER_SIZE, buffer + room - pkt->length);
+    openqueue_returnBuffer(full);
+}
+
+static bool openqueue_isFullBuffer(const uint8_t *buffer) {
+    return buffer >= openqueue_vars.fullBuffers[0] && buffer < openqueue_vars.fullBuffers[OPENQUEUE_NUM_FULL_BUFFERS];
+}
+
+static void openqueue_returnBuffer(uint8_t *buffer) {
+    if (openqueue_isFullBuffer(buffer)) {
+        openqueue_vars.freeFull[openqueue_vars.numFreeFull++] =
+                (uint8_t) ((buffer - openqueue_vars.fullBuffers[0]) / PACKET_BUFFER_SIZE);
+    } else if (
+            buffer >= openqueue_vars.smallBuffers[0] &&
+            buffer < openqueue_vars.smallBuffers[OPENQUEUE_NUM_SMALL_BUFFERS]
+            ) {
+        openqueue_vars.freeSmall[openqueue_vars.numFreeSmall++] =
+                (uint8_t) ((buffer - openqueue_vars.smallBuffers[0]) / OPENQUEUE_SMALL_BUFFER_SIZE);
+    }
+}
+
+static uint8_t openqueue_classOf(uint8_t creator) {
+    if (openqueue_isLowPriority(creator) == FALSE || creator == COMPONENT_ICMPv6RPL) {
+        return OPENQUEUE_CLASS_CONTROL;
+    }
+    if (creator == COMPONENT_FORWARDING || creator == COMPONENT_FRAG) {
+        // fragments created by COMPONENT_FRAG are relayed for other motes, local fragments keep their creator
+        return OPENQUEUE_CLASS_FORWARDED;
+    }
+    return OPENQUEUE_CLASS_LOCAL;
+}
+
+static void openqueue_countDrop(uint8_t creator) {
+    // buffers for received frames are not part of the transmit queueing
+    if (creator > COMPONENT_IEEE802154E) {
+        openqueue_vars.numDropped[openqueue_classOf(creator)]++;
+    }
+}
+
+/**
+\brief Deficit round robin between the oldest local and the oldest forwarded packet.
+
+Each packet costs one cell, whatever its length and however many attempts it takes, so the deficit of a class counts
+packets and only the first attempt is charged. The class being served keeps the turn until it used its quantum or has
+nothing left to send.
+
+\param[in] drr        Round robin state to use, the row of the neighbor or MAXNUMNEIGHBORS outside the table.
+\param[in] candidates Oldest packet of each class, NULL if none.
+\param[in] consume    Whether to charge the transmission to the selected class, FALSE to only look.
+*/
+static OpenQueueEntry_t *openqueue_drrSelect(uint8_t drr, OpenQueueEntry_t *candidates[], bool consume) {
+    uint8_t *deficit;
+    uint8_t turn;
+    uint8_t other;
+
+    if (candidates[OPENQUEUE_CLASS_LOCAL] == NULL && candidates[OPENQUEUE_CLASS_FORWARDED] == NULL) {
+        return NULL;
+    }
+
+    deficit = openqueue_vars.drrDeficit[drr];
+    turn = openqueue_vars.drrTurn[drr];
+    other = (turn == OPENQUEUE_CLASS_LOCAL) ? OPENQUEUE_CLASS_FORWARDED : OPENQUEUE_CLASS_LOCAL;
+
+    if (candidates[turn] == NULL || deficit[turn] == 0) {
+        if (consume) {
+            // an idle class does not accumulate credit
+            deficit[turn] = 0;
+        }
+        if (candidates[other] != NULL) {
+            turn = other;
+        }
+        if (consume) {
+            openqueue_vars.drrTurn[drr] = turn;
+            deficit[turn] = (turn == OPENQUEUE_CLASS_LOCAL) ? OPENQUEUE_WEIGHT_LOCAL : OPENQUEUE_WEIGHT_FORWARDED;
+        }
+    }
+
+    if (consume && candidates[turn]->l2_numTxAttempts == 0 && deficit[turn] > 0) {
+        deficit[turn]--;
+    }
+    return candidates[turn];
+}
+
+/**
+\brief Start a round robin state over, serving local data first.
+*/
+static void openqueue_drrReset(uint8_t drr) {
+    openqueue_vars.drrTurn[drr] = OPENQUEUE_CLASS_LOCAL;
+    memset(openqueue_vars.drrDeficit[drr], 0, sizeof(openqueue_vars.drrDeficit[drr]));
+    openqueue_vars.drrDeficit[drr][OPENQUEUE_CLASS_LOCAL] = OPENQUEUE_WEIGHT_LOCAL;
+}
+
+//======= transmit lists
+
+static uint8_t openqueue_txListOf(OpenQueueEntry_t *entry) {
+    if (packetfunctions_isBroadcastMulticast(&entry->l2_nextORpreviousHop)) {
+        if (entry->creator == COMPONENT_SIXTOP) {
+            return OPENQUEUE_TXLIST_EB;
+        }
+        if (entry->creator == COMPONENT_ICMPv6RPL) {
+            return OPENQUEUE_TXLIST_DIO;
+        }
+        return OPENQUEUE_TXLIST_OTHER;
+    }
+
+    if (entry->creator == COMPONENT_SIXTOP_RES && entry->l2_sixtop_messageType == SIXTOP_CELL_RESPONSE) {
+        return OPENQUEUE_TXLIST_6PRESPONSE;
+    }
+
+    return openqueue_txListOfNeighbor(&entry->l2_nextORpreviousHop);
+}
+
+static uint8_t openqueue_txListOfNeighbor(open_addr_t *neighbor) {
+    uint8_t index;
+
+    if (neighbors_getIndex(neighbor, &index)) {
+        return index;
+    }
+    return OPENQUEUE_TXLIST_OTHER;
+}
+
+/**
+\brief Append the entries of a transmit list again, each to the list it now belongs to, keeping their order.
+
+Interrupts must be disabled by the caller.
+*/
+static void openqueue_txRelink(uint8_t list) {
+    uint8_t i;
+    uint8_t next;
+    uint8_t tail;
+
+    tail = openqueue_vars.txTail[list];
+    for (i = openqueue_vars.txHead[list]; i != OPENQUEUE_NONE; i = next) {
+        next = (i == tail) ? OPENQUEUE_NONE : openqueue_vars.next[i];
+        openqueue_txRemove(i);
+        openqueue_txAppend(i);
+    }
+}
+
+/**
+\brief Append an entry at the tail of the transmit list it belongs to.
+
+Interrupts must be disabled by the caller.
+*/
+static void openqueue_txAppend(uint8_t index) {
+    uint8_t list;
+
+    list = openqueue_txListOf(&openqueue_vars.queue[index]);
+
+    openqueue_vars.txList[index] = list;
+    openqueue_vars.next[index] = OPENQUEUE_NONE;
+    openqueue_vars.prev[index] = openqueue_vars.txTail[list];
+
+    if (openqueue_vars.txTail[list] == OPENQUEUE_NONE) {
+        openqueue_vars.txHead[list] = index;
+    } else {
+        openqueue_vars.next[openqueue_vars.txTail[list]] = index;
+    }
+    openqueue_vars.txTail[list] = index;
+}
+
+/**
+\brief Unlink an entry from its transmit list, if it is in one.
+
+Interrupts must be disabled by the caller.
+*/
+static void openqueue_txRemove(uint8_t index) {
+    uint8_t list;
+
+    list = openqueue_vars.txList[index];
+    if (list == OPENQUEUE_NONE) {
+        return;
+    }
+
+    if (openqueue_vars.prev[index] == OPENQUEUE_NONE) {
+        openqueue_vars.txHead[list] = openqueue_vars.next[index];
+    } else {
+        openqueue_vars.next[openqueue_vars.prev[index]] = openqueue_vars.next[index];
+    }
+    if (openqueue_vars.next[index] == OPENQUEUE_NONE) {
+        openqueue_vars.txTail[list] = openqueue_vars.prev[index];
+    } else {
+        openqueue_vars.prev[openqueue_vars.next[index]] = openqueue_vars.prev[index];
+    }
+
+    openqueue_vars.txList[index] = OPENQUEUE_NONE;
+    openqueue_vars.next[index] = OPENQUEUE_NONE;
+    openqueue_vars.prev[index] = OPENQUEUE_NONE;
+}
+
+/**
+\brief Oldest entry of a transmit list currently waiting for the MAC layer.
+
+Entries stay in their list while IEEE802154E transmits them, and are skipped until they are either handed back
+(retransmission) or freed.
+
+\param[in] list     The transmit list to look in.
+\param[in] neighbor Only return a packet to this next hop, NULL for any.
+\param[in] creator  Only return a packet created by this component, COMPONENT_NULL for any.
+*/
+static OpenQueueEntry_t *openqueue_txFind(uint8_t list, open_addr_t *neighbor, uint8_t creator) {
+    OpenQueueEntry_t *entry;
+    uint8_t i;
+
+    for (i = openqueue_vars.txHead[list]; i != OPENQUEUE_NONE; i = openqueue_vars.next[i]) {
+        entry = &openqueue_vars.queue[i];
         if (
-                openqueue_vars.queue[i].owner == COMPONENT_SIXTOP_TO_IEEE802154E &&
-                openqueue_vars.queue[i].creator == COMPONENT_SIXTOP_RES &&
-                (
-                        toNeighbor->type == ADDR_64B &&
-                        packetfunctions_sameAddress(toNeighbor, &openqueue_vars.queue[i].l2_nextORpreviousHop)
-                ) &&
-                openqueue_vars.queue[i].l2_sixtop_messageType == SIXTOP_CELL_RESPONSE
-                ) { ENABLE_INTERRUPTS();
-            return &openqueue_vars.queue[i];
+                entry->owner == COMPONENT_SIXTOP_TO_IEEE802154E &&
+                (creator == COMPONENT_NULL || entry->creator == creator) &&
+                (neighbor == NULL || packetfunctions_sameAddress(neighbor, &entry->l2_nextORpreviousHop))
+                ) {
+            return entry;
         }
     }
+    return NULL;
+}
 
-    // if reach here, then looking for other unicast packets
-    for (i = 0; i < QUEUELENGTH; i++) {
+/**
+\brief Packet of a transmit list to send to a neighbor, according to the queueing discipline.
+
+\param[in] list     The transmit list to look in.
+\param[in] neighbor The next hop of the packet.
+\param[in] consume  Whether the packet is about to be sent, see openqueue_drrSelect().
+*/
+static OpenQueueEntry_t *openqueue_txSelect(uint8_t list, open_addr_t *neighbor, bool consume) {
+    OpenQueueEntry_t *candidates[OPENQUEUE_NUM_CLASSES];
+    OpenQueueEntry_t *entry;
+    uint8_t class;
+    uint8_t i;
+
+    memset(candidates, 0, sizeof(candidates));
+
+    for (i = openqueue_vars.txHead[list]; i != OPENQUEUE_NONE; i = openqueue_vars.next[i]) {
+        entry = &openqueue_vars.queue[i];
         if (
-                openqueue_vars.queue[i].owner == COMPONENT_SIXTOP_TO_IEEE802154E &&
-                (
-                        toNeighbor->type == ADDR_64B &&
-                        packetfunctions_sameAddress(toNeighbor, &openqueue_vars.queue[i].l2_nextORpreviousHop)
-                )
-                ) { ENABLE_INTERRUPTS();
-            return &openqueue_vars.queue[i];
+                entry->owner != COMPONENT_SIXTOP_TO_IEEE802154E ||
+                packetfunctions_sameAddress(neighbor, &entry->l2_nextORpreviousHop) == FALSE
+                ) {
+            continue;
+        }
+
+        class = openqueue_classOf(entry->creator);
+        if (class == OPENQUEUE_CLASS_CONTROL) {
+            // control has strict priority, no need to look further
+            return entry;
+        }
+        if (candidates[class] == NULL) {
+            candidates[class] = entry;
         }
     }
 
+    return openqueue_drrSelect((list < MAXNUMNEIGHBORS) ? list : MAXNUMNEIGHBORS, candidates, consume);
+}
+
+/**
+\brief Unicast packet to send to a neighbor, see openqueue_macGetUnicastPacket(). Call with interrupts disabled.
+*/
+static OpenQueueEntry_t *openqueue_unicastSelect(open_addr_t *toNeighbor, bool consume) {
+    OpenQueueEntry_t *pkt;
+
+    if (toNeighbor->type != ADDR_64B) {
+        return NULL;
+    }
+
+    // first to look the sixtop RES packet
+    pkt = openqueue_txFind(OPENQUEUE_TXLIST_6PRESPONSE, toNeighbor, COMPONENT_NULL);
+    if (pkt != NULL) {
+        return pkt;
+    }
+
+    // if reach here, then looking for other unicast packets, according to their traffic class
+    pkt = openqueue_txSelect(openqueue_txListOfNeighbor(toNeighbor), toNeighbor, consume);
+
 #if OPENWSN_6LO_FRAGMENTATION_C
+    if (pkt == NULL) {
+        pkt = openqueue_bigFind(toNeighbor);
+    }
+#endif
+    return pkt;
+}
+
+#if OPENWSN_6LO_FRAGMENTATION_C
+static OpenQueueEntry_t *openqueue_bigFind(open_addr_t *neighbor) {
+    uint8_t i;
+
     for (i = 0; i < BIGQUEUELENGTH; i++) {
         if (
                 ((OpenQueueEntry_t*)&openqueue_vars.big_queue[i])->owner == COMPONENT_SIXTOP_TO_IEEE802154E &&
-                (
-                        toNeighbor->type == ADDR_64B &&
-                        packetfunctions_sameAddress(toNeighbor, &((OpenQueueEntry_t*)&openqueue_vars.big_queue[i])->l2_nextORpreviousHop)
-                )
+                packetfunctions_sameAddress(neighbor, &((OpenQueueEntry_t*)&openqueue_vars.big_queue[i])->l2_nextORpreviousHop)
                 ) {
-            ENABLE_INTERRUPTS();
             return (OpenQueueEntry_t*)&openqueue_vars.big_queue[i];
         }
     }
-#endif
-    ENABLE_INTERRUPTS();
     return NULL;
 }
-
-
-//=========================== private =========================================
+#endif
 
 void openqueue_reset_entry(OpenQueueEntry_t *entry) {
     //admin
     entry->creator = COMPONENT_NULL;
     entry->owner = COMPONENT_NULL;
 
-    // Footer is longer if security is used
-    entry->payload = &(entry->packet[IEEE802154_FRAME_SIZE - LENGTH_CRC - IEEE802154_SECURITY_TAG_LEN]);
+    entry->payload = NULL;
     entry->length = 0;
     entry->is_cjoin_response = FALSE;
 #if OPENWSN_6LO_FRAGMENTATION_C
@@ -493,6 +1156,7 @@ void openqueue_reset_entry(OpenQueueEntry_t *entry) {
     entry->l3_destinationAdd.type = ADDR_NONE;
     entry->l3_sourceAdd.type = ADDR_NONE;
     entry->l3_useSourceRouting = FALSE;
+    entry->l3_routedDownward = FALSE;
 #if OPENWSN_6LO_FRAGMENTATION_C
     entry->l3_isFragment = FALSE;
 #endif
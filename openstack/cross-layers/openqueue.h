@@ -19,6 +19,37 @@
 #define QUEUELENGTH  PACKETQUEUE_LENGTH
 #endif
 
+#if QUEUELENGTH >= 255
+#error 'openqueue indexes its entries on a single byte, PACKETQUEUE_LENGTH must be smaller than 255.'
+#endif
+
+#if OPENQUEUE_NUM_FULL_BUFFERS > QUEUELENGTH || OPENQUEUE_NUM_SMALL_BUFFERS > QUEUELENGTH
+#error 'There is no use for more packet buffers than queue entries.'
+#endif
+
+#define OPENQUEUE_NONE  0xff            // end of a list of queue entries
+
+// lists of packets handed to the MAC layer, in the order they were handed over
+// unicast packets to a neighbor in the neighbor table are in the list of its row, 0 to MAXNUMNEIGHBORS-1
+enum {
+    OPENQUEUE_TXLIST_EB = MAXNUMNEIGHBORS,              // Enhanced Beacons
+    OPENQUEUE_TXLIST_DIO,                               // broadcast DIOs
+    OPENQUEUE_TXLIST_6PRESPONSE,                        // 6P responses
+    OPENQUEUE_TXLIST_OTHER,                             // any other broadcast, or next hop not in the neighbor table
+    OPENQUEUE_NUM_TXLISTS
+};
+
+// deficit round robin state of each neighbor table row, the last one is shared by the next hops outside the table
+#define OPENQUEUE_NUM_DRR           (MAXNUMNEIGHBORS + 1)
+
+// traffic classes of the transmit queueing discipline
+enum {
+    OPENQUEUE_CLASS_CONTROL,                            // 6P and RPL, strict priority
+    OPENQUEUE_CLASS_LOCAL,                              // data originated by this mote
+    OPENQUEUE_CLASS_FORWARDED,                          // data relayed for other motes
+    OPENQUEUE_NUM_CLASSES
+};
+
 #if OPENWSN_6LO_FRAGMENTATION_C
 #define BIGQUEUELENGTH  MAX_NUM_BIGPKTS
 #else
@@ -27,15 +58,49 @@
 
 //=========================== typedef =========================================
 
+// cell lists of a 6P packet, only allocated for the few of them in the queue
+typedef struct {
+    cellInfo_ht celllist_add[CELLLIST_MAX_LEN];
+    cellInfo_ht celllist_delete[CELLLIST_MAX_LEN];
+} openqueueCelllists_t;
+
 typedef struct {
     uint8_t creator;
     uint8_t owner;
 } debugOpenQueueEntry_t;
 
+BEGIN_PACK
+typedef struct {
+    debugOpenQueueEntry_t entries[QUEUELENGTH];
+    uint16_t numDropped[OPENQUEUE_NUM_CLASSES];
+} debugOpenQueue_t;
+END_PACK
+
 //=========================== module variables ================================
 
 typedef struct {
     OpenQueueEntry_t queue[QUEUELENGTH];
+    uint8_t next[QUEUELENGTH];          // links the free entries together
+    uint8_t freeHead;                   // first free entry, OPENQUEUE_NONE if the queue is full
+    uint8_t numLowPriority;             // entries created by a component above COMPONENT_SIXTOP_RES
+    uint8_t prev[QUEUELENGTH];          // with next[], links the entries of a transmit list
+    uint8_t txList[QUEUELENGTH];        // transmit list an entry is in, OPENQUEUE_NONE if none
+    uint8_t txHead[OPENQUEUE_NUM_TXLISTS];
+    uint8_t txTail[OPENQUEUE_NUM_TXLISTS];
+    // deficit round robin state of each neighbor, so that every neighbor gets its own shares
+    uint8_t drrTurn[OPENQUEUE_NUM_DRR];                 // data class (local or forwarded) currently served
+    uint8_t drrDeficit[OPENQUEUE_NUM_DRR][OPENQUEUE_NUM_CLASSES];
+    uint16_t numDropped[OPENQUEUE_NUM_CLASSES];
+    // pool of buffers holding the packets of the entries
+    uint8_t fullBuffers[OPENQUEUE_NUM_FULL_BUFFERS][PACKET_BUFFER_SIZE];
+    uint8_t smallBuffers[OPENQUEUE_NUM_SMALL_BUFFERS][OPENQUEUE_SMALL_BUFFER_SIZE];
+    uint8_t freeFull[OPENQUEUE_NUM_FULL_BUFFERS];       // stack of the free full size buffers
+    uint8_t numFreeFull;
+    uint8_t freeSmall[OPENQUEUE_NUM_SMALL_BUFFERS];     // stack of the free small buffers
+    uint8_t numFreeSmall;
+    openqueueCelllists_t celllists[OPENQUEUE_NUM_CELLLISTS];
+    uint8_t freeCelllists[OPENQUEUE_NUM_CELLLISTS];     // stack of the free cell lists
+    uint8_t numFreeCelllists;
 #if OPENWSN_6LO_FRAGMENTATION_C
     OpenQueueBigEntry_t big_queue[BIGQUEUELENGTH];
 #endif
@@ -57,6 +122,12 @@ owerror_t openqueue_freePacketBuffer(OpenQueueEntry_t *pkt);
 
 void openqueue_removeAllCreatedBy(uint8_t creator);
 
+void openqueue_setCreator(OpenQueueEntry_t *pkt, uint8_t creator);
+
+void openqueue_dropPacketBuffer(OpenQueueEntry_t *pkt);
+
+owerror_t openqueue_growPacketBuffer(OpenQueueEntry_t *pkt);
+
 bool openqueue_isHighPriorityEntryEnough(void);
 
 // called by ICMPv6
@@ -73,6 +144,16 @@ uint8_t openqueue_getNum6PReq(open_addr_t *neighbor);
 
 void openqueue_remove6PrequestToNeighbor(open_addr_t *neighbor);
 
+owerror_t openqueue_getCelllists(OpenQueueEntry_t *pkt);
+
+// called by sixtop
+void openqueue_macEnqueue(OpenQueueEntry_t *pkt);
+
+// called by neighbors
+void openqueue_indicateNeighborAdded(uint8_t index);
+
+void openqueue_indicateNeighborRemoved(uint8_t index);
+
 // called by IEEE80215E
 OpenQueueEntry_t* openqueue_macGetEBPacket(void);
 
@@ -82,6 +163,10 @@ OpenQueueEntry_t* openqueue_macGetDIOPacket(void);
 
 OpenQueueEntry_t* openqueue_macGetUnicastPacket(open_addr_t *toNeighbor);
 
+OpenQueueEntry_t* openqueue_macPeekUnicastPacket(open_addr_t *toNeighbor);
+
+bool openqueue_macHasUnicastPacket(open_addr_t *toNeighbor);
+
 // called by transport layer
 OpenQueueEntry_t* openqueue_getPacketByComponent(uint8_t component);
 /**
@@ -4,7 +4,11 @@
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define random_vars MOTE_CTX_VAR(random_vars_t, random_vars)
+#else
 random_vars_t random_vars;
+#endif
 
 //=========================== prototypes ======================================
 
@@ -4,10 +4,7 @@
 #include "openserial.h"
 #include "idmanager.h"
 #include "radio.h"
-
-#if OPENWSN_6LO_FRAGMENTATION_C
 #include "openqueue.h"
-#endif
 
 //=========================== variables =======================================
 
@@ -15,6 +12,13 @@
 
 void onesComplementSum(uint8_t *global_sum, const uint8_t *ptr, int length);
 
+static uint8_t *packetfunctions_getFrameEnd(const OpenQueueEntry_t *pkt);
+
+static owerror_t packetfunctions_makeHeadroom(OpenQueueEntry_t *pkt, uint16_t header_length);
+
+static uint8_t *packetfunctions_rebase(const OpenQueueEntry_t *pkt, uint8_t *ptr, uint8_t *buffer, uint16_t size,
+                                       uint8_t *payload);
+
 //=========================== public ==========================================
 
 //======= address translation
@@ -321,10 +325,16 @@ owerror_t packetfunctions_reserveHeader(OpenQueueEntry_t **pkt, uint16_t header_
 
         memcpy(bpkt, (*pkt), sizeof(OpenQueueEntry_t));
 
-        // reset some packet metadata
+        // reset some packet metadata, the big packet keeps its own buffer
         bpkt->length = 0;
         bpkt->is_big_packet = TRUE;
-        bpkt->payload = &(((OpenQueueBigEntry_t *) bpkt)->packet_remainder[IPV6_PACKET_SIZE - IEEE802154_FRAME_SIZE]);
+        bpkt->packet = ((OpenQueueBigEntry_t *) bpkt)->buffer;
+        bpkt->packet_size = sizeof(((OpenQueueBigEntry_t *) bpkt)->buffer);
+        bpkt->payload = packetfunctions_getFrameEnd(bpkt);
+
+        // the cell lists, if any, now belong to the big packet
+        (*pkt)->l2_sixtop_celllist_add = NULL;
+        (*pkt)->l2_sixtop_celllist_delete = NULL;
 
         // copy contents from small packet to new packet
         if (packetfunctions_reserveHeader(&bpkt, (*pkt)->length) == E_FAIL) {
@@ -349,12 +359,16 @@ owerror_t packetfunctions_reserveHeader(OpenQueueEntry_t **pkt, uint16_t header_
         (*pkt) = bpkt;
     } else if ((*pkt)->is_big_packet == FALSE && (*pkt)->length + header_length <= available_bytes){
         // CASE 2: within boundaries small packet, do normal allocation
+        if (packetfunctions_makeHeadroom(*pkt, header_length) == E_FAIL) {
+            return E_FAIL;
+        }
+
         (*pkt)->payload -= header_length;
         (*pkt)->length += header_length;
 
         // check for buffer overflow on the left and on the right
         if ((uint8_t * )((*pkt)->payload) < (uint8_t * )((*pkt)->packet) ||
-            (*pkt)->payload + (*pkt)->length > &(*pkt)->packet[IEEE802154_FRAME_SIZE]) {
+            (*pkt)->payload + (*pkt)->length > packetfunctions_getFrameEnd(*pkt)) {
             LOG_CRITICAL(COMPONENT_PACKETFUNCTIONS, ERR_PACKET_TOO_LONG,
                          (errorparameter_t) (*pkt)->length,
                          (errorparameter_t) header_length);
@@ -374,8 +388,7 @@ owerror_t packetfunctions_reserveHeader(OpenQueueEntry_t **pkt, uint16_t header_
 
         // check for buffer overflow on the left and on the right
         if ((uint8_t * )((*pkt)->payload) < (uint8_t * )((*pkt)->packet) ||
-            (*pkt)->payload + (*pkt)->length >
-            &(((OpenQueueBigEntry_t *) (*pkt))->packet_remainder[IPV6_PACKET_SIZE - IEEE802154_FRAME_SIZE])) {
+            (*pkt)->payload + (*pkt)->length > packetfunctions_getFrameEnd(*pkt)) {
             LOG_CRITICAL(COMPONENT_PACKETFUNCTIONS, ERR_PACKET_TOO_LONG,
                          (errorparameter_t) (*pkt)->length,
                          (errorparameter_t) header_length);
@@ -395,12 +408,16 @@ owerror_t packetfunctions_reserveHeader(OpenQueueEntry_t **pkt, uint16_t header_
         return E_FAIL;
     }
 
+    if (packetfunctions_makeHeadroom(*pkt, header_length) == E_FAIL) {
+        return E_FAIL;
+    }
+
     (*pkt)->payload -= header_length;
     (*pkt)->length += header_length;
 
     // check for buffer overflow on the left and on the right
     if ((uint8_t * )((*pkt)->payload) < (uint8_t * )((*pkt)->packet) ||
-        (*pkt)->payload + (*pkt)->length > &(*pkt)->packet[IEEE802154_FRAME_SIZE]) {
+        (*pkt)->payload + (*pkt)->length > packetfunctions_getFrameEnd(*pkt)) {
         LOG_CRITICAL(COMPONENT_PACKETFUNCTIONS, ERR_PACKET_TOO_LONG,
                      (errorparameter_t) (*pkt)->length,
                      (errorparameter_t) header_length);
@@ -418,7 +435,7 @@ void packetfunctions_tossHeader(OpenQueueEntry_t **pkt, uint16_t header_length)
 
     if ((*pkt)->is_big_packet == FALSE) {
         // CASE 1: is a small packet, just toss bytes
-        if ((uint8_t * )((*pkt)->payload + header_length) > &((*pkt)->packet[IEEE802154_FRAME_SIZE]) ||
+        if ((uint8_t * )((*pkt)->payload + header_length) > packetfunctions_getFrameEnd(*pkt) ||
             (*pkt)->length - header_length < 0) {
             LOG_CRITICAL(COMPONENT_PACKETFUNCTIONS, ERR_PACKET_TOO_SHORT,
                          (errorparameter_t) (*pkt)->length,
@@ -430,8 +447,7 @@ void packetfunctions_tossHeader(OpenQueueEntry_t **pkt, uint16_t header_length)
         (*pkt)->length -= header_length;
     } else {
         // CASE 2: is a big packet
-        if ((uint8_t * )((*pkt)->payload + header_length) >
-            &(((OpenQueueBigEntry_t *) (*pkt))->packet_remainder[IPV6_PACKET_SIZE - IEEE802154_FRAME_SIZE]) ||
+        if ((uint8_t * )((*pkt)->payload + header_length) > packetfunctions_getFrameEnd(*pkt) ||
             (*pkt)->length - header_length < 0) {
             LOG_CRITICAL(COMPONENT_PACKETFUNCTIONS, ERR_PACKET_TOO_SHORT,
                          (errorparameter_t) (*pkt)->length,
@@ -446,15 +462,23 @@ void packetfunctions_tossHeader(OpenQueueEntry_t **pkt, uint16_t header_length)
 
             // try moving to a smaller packet
             OpenQueueEntry_t *spkt;
+            uint8_t *buffer;
+            uint16_t size;
             if ((spkt = openqueue_getFreePacketBuffer((*pkt)->creator)) == NULL) {
                 return;
             }
 
+            // the small packet keeps the buffer it was given
+            buffer = spkt->packet;
+            size = spkt->packet_size;
+
             memcpy(spkt, (*pkt), sizeof(OpenQueueEntry_t));
 
+            spkt->packet = buffer;
+            spkt->packet_size = size;
             spkt->length = 0;
             spkt->is_big_packet = FALSE;
-            spkt->payload = &spkt->packet[available_bytes];
+            spkt->payload = packetfunctions_getFrameEnd(spkt) - (IEEE802154_FRAME_SIZE - available_bytes);
 
             if (packetfunctions_reserveHeader(&spkt, (*pkt)->length) == E_FAIL) {
                 openqueue_freePacketBuffer(spkt);
@@ -477,7 +501,7 @@ void packetfunctions_tossHeader(OpenQueueEntry_t **pkt, uint16_t header_length)
         }
     }
 #else
-    if ((uint8_t * )((*pkt)->payload + header_length) > &(*pkt)->packet[IEEE802154_FRAME_SIZE] ||
+    if ((uint8_t * )((*pkt)->payload + header_length) > packetfunctions_getFrameEnd(*pkt) ||
         (*pkt)->length - header_length < 0) {
         LOG_CRITICAL(COMPONENT_PACKETFUNCTIONS, ERR_PACKET_TOO_SHORT,
                      (errorparameter_t) (*pkt)->length,
@@ -520,24 +544,53 @@ void packetfunctions_tossFooter(OpenQueueEntry_t **pkt, uint16_t footer_length)
 // updating pointers to the new memory location. Used to make a local copy of
 // the frame before transmission (where it can possibly be encrypted). 
 void packetfunctions_duplicatePacket(OpenQueueEntry_t *dst, const OpenQueueEntry_t *src) {
-    // make a copy of the frame
+    uint8_t *buffer;
+    uint16_t size;
 
-    memcpy(dst, src, sizeof(OpenQueueEntry_t));
+    // the copy keeps its own buffer
+    buffer = dst->packet;
+    size = dst->packet_size;
 
-    // Calculate where payload starts in the buffer
-    dst->payload = &dst->packet[src->payload - src->packet]; // update pointers
+    // make a copy of the frame
+    memcpy(dst, src, sizeof(OpenQueueEntry_t));
 
-    // update l2_FrameCounter pointer
-    dst->l2_FrameCounter = dst->payload + (src->l2_FrameCounter - src->payload);
+    // at the same distance from the end of the buffer, so the copy has the same room for footers
+    packetfunctions_movePacket(dst, buffer, size, buffer + size - (src->packet + src->packet_size - src->payload));
+}
 
-    // update l2_ASNpayload pointer
-    dst->l2_ASNpayload = dst->payload + (src->l2_ASNpayload - src->payload);
+//======= packet buffers
 
-    // update l2_payload pointer
-    dst->l2_payload = dst->payload + (src->l2_payload - src->payload);
+/**
+\brief Empty a packet, the next header reserved ends where the frame ends.
+*/
+void packetfunctions_resetPayload(OpenQueueEntry_t *pkt) {
+    pkt->payload = packetfunctions_getFrameEnd(pkt);
+    pkt->length = 0;
+}
 
-    // update l4_payload pointer
-    dst->l4_payload = dst->payload + (src->l4_payload - src->payload);
+/**
+\brief Move a packet to another buffer.
+
+The bytes of the packet are copied to payload, inside buffer, and all pointers of pkt into its previous buffer are
+updated. Pointers to bytes which do not fit in the new buffer (e.g. headers tossed before) are cleared.
+
+\param[in,out] pkt  The packet to move.
+\param[in] buffer   The new buffer of the packet.
+\param[in] size     The size of the new buffer.
+\param[in] payload  Where the packet starts in the new buffer.
+*/
+void packetfunctions_movePacket(OpenQueueEntry_t *pkt, uint8_t *buffer, uint16_t size, uint8_t *payload) {
+    memcpy(payload, pkt->payload, pkt->length);
+
+    pkt->l4_payload = packetfunctions_rebase(pkt, pkt->l4_payload, buffer, size, payload);
+    pkt->l2_payload = packetfunctions_rebase(pkt, pkt->l2_payload, buffer, size, payload);
+    pkt->l2_ASNpayload = packetfunctions_rebase(pkt, pkt->l2_ASNpayload, buffer, size, payload);
+    pkt->l2_nextHop_payload = packetfunctions_rebase(pkt, pkt->l2_nextHop_payload, buffer, size, payload);
+    pkt->l2_FrameCounter = packetfunctions_rebase(pkt, pkt->l2_FrameCounter, buffer, size, payload);
+
+    pkt->payload = payload;
+    pkt->packet = buffer;
+    pkt->packet_size = size;
 }
 
 //======= CRC calculation
@@ -708,3 +761,42 @@ void packetfunctions_reverseArrayByteOrder(uint8_t *start, uint8_t len) {
 }
 
 //=========================== private =========================================
+
+static uint8_t *packetfunctions_getFrameEnd(const OpenQueueEntry_t *pkt) {
+    return pkt->packet + pkt->packet_size - PACKET_BUFFER_TAIL;
+}
+
+/**
+\brief Make sure a header fits in front of a packet, moving the packet from a small to a full size buffer if needed.
+*/
+static owerror_t packetfunctions_makeHeadroom(OpenQueueEntry_t *pkt, uint16_t header_length) {
+    if ((uint16_t) (pkt->payload - pkt->packet) >= header_length || pkt->packet_size >= PACKET_BUFFER_SIZE) {
+        return E_SUCCESS;
+    }
+
+    if (openqueue_growPacketBuffer(pkt) == E_FAIL) {
+        LOG_ERROR(COMPONENT_PACKETFUNCTIONS, ERR_NO_FREE_PACKET_BUFFER,
+                  (errorparameter_t) pkt->length,
+                  (errorparameter_t) header_length);
+        return E_FAIL;
+    }
+
+    return E_SUCCESS;
+}
+
+static uint8_t *packetfunctions_rebase(const OpenQueueEntry_t *pkt, uint8_t *ptr, uint8_t *buffer, uint16_t size,
+                                       uint8_t *payload) {
+    int16_t index;
+
+    if (ptr < pkt->packet || ptr > pkt->packet + pkt->packet_size) {
+        // not pointing into the packet
+        return ptr;
+    }
+
+    index = (int16_t) ((payload - buffer) + (ptr - pkt->payload));
+    if (index < 0 || index > size) {
+        return NULL;
+    }
+
+    return buffer + index;
+}
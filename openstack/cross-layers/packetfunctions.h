@@ -55,6 +55,11 @@ void packetfunctions_tossFooter(OpenQueueEntry_t **pkt, uint16_t footer_length);
 // packet duplication
 void packetfunctions_duplicatePacket(OpenQueueEntry_t *dst, const OpenQueueEntry_t *src);
 
+// packet buffers
+void packetfunctions_resetPayload(OpenQueueEntry_t *pkt);
+
+void packetfunctions_movePacket(OpenQueueEntry_t *pkt, uint8_t *buffer, uint16_t size, uint8_t *payload);
+
 // calculate CRC
 void packetfunctions_calculateCRC(OpenQueueEntry_t *msg);
 
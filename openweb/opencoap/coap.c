@@ -11,7 +11,11 @@
 
 //=========================== variables =======================================
 
+#if BOARD_MULTI_MOTE_ENABLED
+#define coap_vars MOTE_CTX_VAR(coap_vars_t, coap_vars)
+#else
 coap_vars_t coap_vars;
+#endif
 
 //=========================== prototype =======================================
 
@@ -456,8 +460,7 @@ void coap_receive(OpenQueueEntry_t *msg) {
 	// resource not found but success in creating the response
         outcome = E_SUCCESS;
         // reset packet payload (DO NOT DELETE, we will reuse same buffer for response)
-        msg->payload = &(msg->packet[127]); // FIXME use packetfunctions to reset
-        msg->length = 0;
+        packetfunctions_resetPayload(msg);
         // set the CoAP header
         coap_header.TKL = 0;
         if (securityReturnCode) {
@@ -469,8 +472,7 @@ void coap_receive(OpenQueueEntry_t *msg) {
 
     if (outcome == E_FAIL) {
         // reset packet payload (DO NOT DELETE, we will reuse same buffer for response)
-        msg->payload = &(msg->packet[127]); // FIXME use packetfunctions to reset
-        msg->length = 0;
+        packetfunctions_resetPayload(msg);
         // set the CoAP header
         coap_header.TKL = 0;
         coap_header.Code = securityReturnCode;
@@ -500,11 +502,11 @@ void coap_receive(OpenQueueEntry_t *msg) {
 
     //=== step 5. send that packet back
 
-    // fill in packet metadata
+    // fill in packet metadata, the request becomes the response
     if (found == TRUE) {
-        msg->creator = temp_desc->componentID;
+        openqueue_setCreator(msg, temp_desc->componentID);
     } else {
-        msg->creator = COMPONENT_OPENCOAP;
+        openqueue_setCreator(msg, COMPONENT_OPENCOAP);
     }
     msg->l4_protocol = IANA_UDP;
     temp_l4_destination_port = msg->l4_destination_port;
@@ -11,6 +11,7 @@
 #include "config.h"
 #include "sock.h"
 #include "async.h"
+#include "aes128.h"
 
 //=========================== define ==========================================
 
@@ -155,11 +156,13 @@ typedef struct {
     uint8_t senderID[OSCOAP_MAX_ID_LEN];
     uint8_t senderIDLen;
     uint8_t senderKey[AES_CCM_16_64_128_KEY_LEN];
+    aes128_ctx_t senderKeyCtx;          // expanded senderKey
     uint16_t sequenceNumber;
     // recipient context
     uint8_t recipientID[OSCOAP_MAX_ID_LEN];
     uint8_t recipientIDLen;
     uint8_t recipientKey[AES_CCM_16_64_128_KEY_LEN];
+    aes128_ctx_t recipientKeyCtx;       // expanded recipientKey
     replay_window_t window;
 } oscore_security_context_t;
 
@@ -124,6 +124,7 @@ void oscore_init_security_context(oscore_security_context_t *ctx,
                           AES_CCM_16_64_128,
                           OSCOAP_DERIVATION_TYPE_KEY,
                           AES_CCM_16_64_128_KEY_LEN);
+    aes128_set_key(&ctx->senderKeyCtx, ctx->senderKey);
     ctx->sequenceNumber = 0;
 
     // recipient context
@@ -142,6 +143,7 @@ void oscore_init_security_context(oscore_security_context_t *ctx,
                           AES_CCM_16_64_128,
                           OSCOAP_DERIVATION_TYPE_KEY,
                           AES_CCM_16_64_128_KEY_LEN);
+    aes128_set_key(&ctx->recipientKeyCtx, ctx->recipientKey);
 
     ctx->window.bitArray = 0x01; // LSB set
     ctx->window.rightEdge = 0;
@@ -210,7 +212,9 @@ owerror_t oscore_protect_message(
     coap_options_encode(msg, incomingOptions, incomingOptionsLen, COAP_OPTION_CLASS_E);
 
     // encode CoAP code
-    packetfunctions_reserveHeader(&msg, 1);
+    if (packetfunctions_reserveHeader(&msg, 1) == E_FAIL){
+        return E_FAIL;
+    }
     msg->payload[0] = *code;
 
     payload = &msg->payload[0];
@@ -266,14 +270,14 @@ owerror_t oscore_protect_message(
 			   context->commonIV,
 			   AES_CCM_16_64_128_IV_LEN);
 
-    encStatus = aes128_ccms_enc(aad,
-                                aadLen,
-                                payload,
-                                &payloadLen,
-                                nonce,
-                                2, // L=2 in 15.4 std
-                                context->senderKey,
-                                AES_CCM_16_64_128_TAG_LEN);
+    encStatus = aes128_ccms_enc_ctx(aad,
+                                    aadLen,
+                                    payload,
+                                    &payloadLen,
+                                    nonce,
+                                    2, // L=2 in 15.4 std
+                                    &context->senderKeyCtx,
+                                    AES_CCM_16_64_128_TAG_LEN);
 
     if (encStatus != E_SUCCESS) {
         return E_FAIL;
@@ -373,14 +377,14 @@ owerror_t oscore_unprotect_message(
 			   context->commonIV,
 			   AES_CCM_16_64_128_IV_LEN);
 
-    decStatus = aes128_ccms_dec(aad,
-                                aadLen,
-                                ciphertext,
-                                &ciphertextLen,
-                                nonce,
-                                2,
-                                context->recipientKey,
-                                AES_CCM_16_64_128_TAG_LEN);
+    decStatus = aes128_ccms_dec_ctx(aad,
+                                    aadLen,
+                                    ciphertext,
+                                    &ciphertextLen,
+                                    nonce,
+                                    2,
+                                    &context->recipientKeyCtx,
+                                    AES_CCM_16_64_128_TAG_LEN);
 
     if (decStatus != E_SUCCESS) {
         LOG_ERROR(COMPONENT_OSCORE, ERR_DECRYPTION_FAILED, (errorparameter_t) 0, (errorparameter_t) 0);
@@ -0,0 +1,242 @@
+/**
+\brief Host benchmark of the software AES-128 backends.
+
+Checks every backend against the FIPS-197 test vector, then measures the cost of encrypting a single block at a time
+(as CBC-MAC does) and of two independent blocks at a time (as the key stream of CTR mode), in nanoseconds and, on x86,
+time stamp counter cycles per byte. Build it with -DPROJECT=drv_aes128_bench on the python board and run
+aes128_bench [iterations].
+*/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_TSC   1
+#else
+#define BENCH_HAS_TSC   0
+#endif
+
+#include "aes128_backends.h"
+
+//=========================== defines =========================================
+
+#define BENCH_DEFAULT_ITERATIONS    200000
+#define BENCH_BUFFER_BLOCKS         8       // a 127-byte frame spans 8 blocks
+
+//=========================== typedef =========================================
+
+typedef struct {
+    uint32_t words[88];                     // large enough for the schedule of any backend
+} bench_schedule_t;
+
+typedef struct {
+    const char *name;
+
+    void (*expandKey)(bench_schedule_t *schedule, uint8_t *key);
+
+    void (*enc)(uint8_t *blocks, uint8_t numBlocks, bench_schedule_t *schedule);
+} bench_backend_t;
+
+typedef struct {
+    double nsPerByte;
+    double cyclesPerByte;
+} bench_result_t;
+
+//=========================== prototypes ======================================
+
+static void byte_expandKey(bench_schedule_t *schedule, uint8_t *key);
+
+static void byte_enc(uint8_t *blocks, uint8_t numBlocks, bench_schedule_t *schedule);
+
+static void ttable_expandKey(bench_schedule_t *schedule, uint8_t *key);
+
+static void ttable_enc(uint8_t *blocks, uint8_t numBlocks, bench_schedule_t *schedule);
+
+static void bitsliced_expandKey(bench_schedule_t *schedule, uint8_t *key);
+
+static void bitsliced_enc(uint8_t *blocks, uint8_t numBlocks, bench_schedule_t *schedule);
+
+static int check_vector(const bench_backend_t *backend);
+
+static bench_result_t measure(const bench_backend_t *backend, uint8_t blocksPerCall, uint32_t iterations);
+
+static uint64_t now_ns(void);
+
+static uint64_t now_cycles(void);
+
+//=========================== variables =======================================
+
+static const bench_backend_t backends[] = {
+        {"byte", byte_expandKey, byte_enc},
+        {"ttable", ttable_expandKey, ttable_enc},
+        {"bitsliced", bitsliced_expandKey, bitsliced_enc},
+};
+
+//=========================== main ============================================
+
+int main(int argc, char **argv) {
+    uint32_t iterations;
+    bench_result_t single;
+    bench_result_t pair;
+    uint8_t i;
+    int failed;
+
+    iterations = argc > 1 ? (uint32_t) strtoul(argv[1], NULL, 0) : BENCH_DEFAULT_ITERATIONS;
+    if (iterations == 0) {
+        iterations = BENCH_DEFAULT_ITERATIONS;
+    }
+
+    failed = 0;
+    for (i = 0; i < sizeof(backends) / sizeof(backends[0]); i++) {
+        if (check_vector(&backends[i]) != 0) {
+            printf("%s: FIPS-197 test vector FAILED\n", backends[i].name);
+            failed = 1;
+        }
+    }
+    if (failed) {
+        return 1;
+    }
+
+    printf("%-10s %16s %16s\n", "backend", "1 block/call", "2 blocks/call");
+    for (i = 0; i < sizeof(backends) / sizeof(backends[0]); i++) {
+        single = measure(&backends[i], 1, iterations);
+        pair = measure(&backends[i], 2, iterations);
+        if (BENCH_HAS_TSC) {
+            printf("%-10s %6.2f ns %5.1f c/B %6.2f ns %5.1f c/B\n", backends[i].name,
+                   single.nsPerByte, single.cyclesPerByte, pair.nsPerByte, pair.cyclesPerByte);
+        } else {
+            printf("%-10s %9.2f ns/B %12.2f ns/B\n", backends[i].name, single.nsPerByte, pair.nsPerByte);
+        }
+    }
+
+    return 0;
+}
+
+//=========================== private =========================================
+
+static void byte_expandKey(bench_schedule_t *schedule, uint8_t *key) {
+    expand_key((unsigned char *) schedule->words, key);
+}
+
+static void byte_enc(uint8_t *blocks, uint8_t numBlocks, bench_schedule_t *schedule) {
+    uint8_t n;
+
+    for (n = 0; n < numBlocks; n++) {
+        aes_enc(&blocks[16 * n], (unsigned char *) schedule->words);
+    }
+}
+
+static void ttable_expandKey(bench_schedule_t *schedule, uint8_t *key) {
+    aes128_ttable_expandKey(schedule->words, key);
+}
+
+static void ttable_enc(uint8_t *blocks, uint8_t numBlocks, bench_schedule_t *schedule) {
+    uint8_t n;
+
+    for (n = 0; n < numBlocks; n++) {
+        aes128_ttable_enc(&blocks[16 * n], schedule->words);
+    }
+}
+
+static void bitsliced_expandKey(bench_schedule_t *schedule, uint8_t *key) {
+    aes128_bitsliced_expandKey(schedule->words, key);
+}
+
+static void bitsliced_enc(uint8_t *blocks, uint8_t numBlocks, bench_schedule_t *schedule) {
+    uint8_t n;
+
+    for (n = 0; n < numBlocks; n += 2) {
+        aes128_bitsliced_enc(&blocks[16 * n], numBlocks - n >= 2 ? 2 : 1, schedule->words);
+    }
+}
+
+// FIPS-197, appendix C.1, encrypted both alone and as the second block of a pair
+static int check_vector(const bench_backend_t *backend) {
+    uint8_t key[16] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+    uint8_t plaintext[16] = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee,
+                             0xff};
+    uint8_t ciphertext[16] = {0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5,
+                              0x5a};
+    bench_schedule_t schedule;
+    uint8_t buffer[32];
+
+    backend->expandKey(&schedule, key);
+
+    memcpy(buffer, plaintext, 16);
+    backend->enc(buffer, 1, &schedule);
+    if (memcmp(buffer, ciphertext, 16) != 0) {
+        return -1;
+    }
+
+    memset(buffer, 0x00, 16);
+    memcpy(&buffer[16], plaintext, 16);
+    backend->enc(buffer, 2, &schedule);
+    if (memcmp(&buffer[16], ciphertext, 16) != 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+static bench_result_t measure(const bench_backend_t *backend, uint8_t blocksPerCall, uint32_t iterations) {
+    bench_schedule_t schedule;
+    bench_result_t result;
+    uint8_t key[16];
+    uint8_t buffer[16 * BENCH_BUFFER_BLOCKS];
+    uint64_t startNs;
+    uint64_t startCycles;
+    uint64_t bytes;
+    uint32_t i;
+    uint8_t n;
+
+    for (n = 0; n < sizeof(key); n++) {
+        key[n] = (uint8_t) (n * 7 + 1);
+    }
+    for (n = 0; n < sizeof(buffer); n++) {
+        buffer[n] = (uint8_t) (n * 13 + 5);
+    }
+    backend->expandKey(&schedule, key);
+
+    startNs = now_ns();
+    startCycles = now_cycles();
+    for (i = 0; i < iterations; i++) {
+        for (n = 0; n < BENCH_BUFFER_BLOCKS; n += blocksPerCall) {
+            backend->enc(&buffer[16 * n], blocksPerCall, &schedule);
+        }
+    }
+    result.cyclesPerByte = (double) (now_cycles() - startCycles);
+    result.nsPerByte = (double) (now_ns() - startNs);
+
+    bytes = (uint64_t) iterations * sizeof(buffer);
+    result.nsPerByte /= (double) bytes;
+    result.cyclesPerByte /= (double) bytes;
+
+    // keep the compiler from dropping the work
+    if (buffer[0] == 0x5a && buffer[1] == 0xa5) {
+        printf(" ");
+    }
+
+    return result;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static uint64_t now_cycles(void) {
+#if BENCH_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
@@ -6,7 +6,7 @@
 
 #include "config.h"
 
-#if PYTHON_BOARD
+#if PYTHON_BOARD && !BOARD_NATIVE_SIM_ENABLED
 
 #include <Python.h>
 
@@ -15,6 +15,21 @@
 
 #endif
 
+#if BOARD_NATIVE_SIM_ENABLED
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include "simengine.h"
+#include "idmanager.h"
+#include "icmpv6rpl.h"
+#include "IEEE802154E.h"
+#include "opentimers.h"
+
+#endif
+
 #include "openserial.h"
 #include "board.h"
 #include "scheduler.h"
@@ -26,26 +41,56 @@
 
 // ========================= variables =========================
 
-#if PYTHON_BOARD
+#if PYTHON_BOARD && !BOARD_NATIVE_SIM_ENABLED
 #define PY_SSIZE_T_CLEAN
 #endif
 
-#if PYTHON_BOARD
+#if PYTHON_BOARD && !BOARD_NATIVE_SIM_ENABLED
 
 void INThandler(int sig) {
     signal(sig, SIG_IGN);
     scheduler_stop();
 }
 
-#if _WIN32
+#if _WIN32 && !BOARD_MULTI_MOTE_ENABLED
 DLL_EXPORT PyObject *callbacks[MOTE_NOTIF_LAST];
 #endif
 
+#if BOARD_MULTI_MOTE_ENABLED
+
+/**
+\brief A mote hosted by this instance of the extension, each with its own state.
+*/
+typedef struct {
+    PyObject_HEAD
+    mote_ctx_t *ctx;
+} OpenMote;
+
+static PyTypeObject OpenMote_Type;
+
+// run a method on the mote it is invoked on, module-level methods run on the default mote
+#define OPENMOTE_ENTER(self)    mote_ctx_t *prev_ctx = mote_ctx_switch(openmote_getCtx(self))
+#define OPENMOTE_EXIT()         mote_ctx_switch(prev_ctx)
+
+static mote_ctx_t *openmote_getCtx(PyObject *self) {
+    if (self != NULL && PyObject_TypeCheck(self, &OpenMote_Type)) {
+        return ((OpenMote *) self)->ctx;
+    }
+    return NULL;
+}
+
+#else
+
+#define OPENMOTE_ENTER(self)    (void) self
+#define OPENMOTE_EXIT()
+
+#endif
+
 #endif
 
 
 
-int mote_main(void) {
+static void mote_init(void) {
 
     // initialize
     board_init();
@@ -58,6 +103,11 @@ int mote_main(void) {
     openapps_init();
 
     LOG_SUCCESS(COMPONENT_OPENWSN, ERR_BOOTED, (errorparameter_t) 0, (errorparameter_t) 0);
+}
+
+int mote_main(void) {
+
+    mote_init();
 
     // start
     scheduler_start();
@@ -65,11 +115,9 @@ int mote_main(void) {
     return 0; // this line should never be reached
 }
 
-#if PYTHON_BOARD
+#if PYTHON_BOARD && !BOARD_NATIVE_SIM_ENABLED
 
 static PyObject *set_callback(PyObject *self, PyObject *args) {
-    (void) self;
-
     int cmdId;
     PyObject *tempCallback;
 
@@ -92,9 +140,11 @@ static PyObject *set_callback(PyObject *self, PyObject *args) {
 
 
     // record the callback
+    OPENMOTE_ENTER(self);
     Py_XINCREF(tempCallback);                       // add a reference to new callback
     Py_XDECREF(callbacks[cmdId]);              // dispose of previous callback
     callbacks[cmdId] = tempCallback;                // remember new callback
+    OPENMOTE_EXIT();
 
     // printf("callbacks: %d - %p \n", cmdId, tempCallback);
 
@@ -104,7 +154,6 @@ static PyObject *set_callback(PyObject *self, PyObject *args) {
 }
 
 static PyObject *radio_isr_startFrame(PyObject *self, PyObject *args) {
-    (void) self;
     long capturedTime;
 
     // parse the arguments
@@ -118,7 +167,10 @@ static PyObject *radio_isr_startFrame(PyObject *self, PyObject *args) {
     }
 
     // call the callback
+    OPENMOTE_ENTER(self);
     radio_intr_startOfFrame((uint32_t) capturedTime);
+    notif_flush();
+    OPENMOTE_EXIT();
 
     // return successfully
     Py_INCREF(Py_None);
@@ -126,7 +178,6 @@ static PyObject *radio_isr_startFrame(PyObject *self, PyObject *args) {
 }
 
 static PyObject *radio_isr_endFrame(PyObject *self, PyObject *args) {
-    (void) self;
     long capturedTime;
 
     // parse the arguments
@@ -140,7 +191,10 @@ static PyObject *radio_isr_endFrame(PyObject *self, PyObject *args) {
     }
 
     // call the callback
+    OPENMOTE_ENTER(self);
     radio_intr_endOfFrame((uint32_t) capturedTime);
+    notif_flush();
+    OPENMOTE_EXIT();
 
     // return successfully
     Py_INCREF(Py_None);
@@ -148,11 +202,13 @@ static PyObject *radio_isr_endFrame(PyObject *self, PyObject *args) {
 }
 
 static PyObject *sctimer_isr(PyObject *self, PyObject *args) {
-    (void) self;
     (void) args;
 
     // call the callback
+    OPENMOTE_ENTER(self);
     sctimer_intr_compare();
+    notif_flush();
+    OPENMOTE_EXIT();
 
     // return successfully
     Py_INCREF(Py_None);
@@ -160,11 +216,13 @@ static PyObject *sctimer_isr(PyObject *self, PyObject *args) {
 }
 
 static PyObject *uart_isr_tx(PyObject *self, PyObject *args) {
-    (void) self;
     (void) args;
 
     // call the callback
+    OPENMOTE_ENTER(self);
     uart_intr_tx();
+    notif_flush();
+    OPENMOTE_EXIT();
 
     // return successfully
     Py_INCREF(Py_None);
@@ -172,11 +230,13 @@ static PyObject *uart_isr_tx(PyObject *self, PyObject *args) {
 }
 
 static PyObject *uart_isr_rx(PyObject *self, PyObject* args) {
-    (void) self;
     (void) args;
 
     // call the callback
+    OPENMOTE_ENTER(self);
     uart_intr_rx();
+    notif_flush();
+    OPENMOTE_EXIT();
 
     // return successfully
     Py_INCREF(Py_None);
@@ -184,13 +244,22 @@ static PyObject *uart_isr_rx(PyObject *self, PyObject* args) {
 }
 
 static PyObject *supply_on(PyObject *self, PyObject* args) {
-    (void) self;
     (void) args;
 
     // start the mote's execution
 
     signal(SIGINT, INThandler);
+    OPENMOTE_ENTER(self);
+#if BOARD_MULTI_MOTE_ENABLED
+    mote_ctx_get()->running = TRUE;
+#endif
     mote_main();
+#if BOARD_MULTI_MOTE_ENABLED
+    // powered off, the next supply_on() boots from a clean state
+    mote_ctx_get()->running = FALSE;
+    mote_ctx_reset(mote_ctx_get());
+#endif
+    OPENMOTE_EXIT();
 
     // return successfully
     Py_INCREF(Py_None);
@@ -208,10 +277,18 @@ static PyObject *supply_init(PyObject *self, PyObject* args) {
 }
 
 static PyObject *supply_off(PyObject *self, PyObject* args) {
-    (void) self;
     (void) args;
 
-    // TODO
+    // stop the mote, its supply_on() returns once the task being executed completes
+    OPENMOTE_ENTER(self);
+    scheduler_stop();
+#if BOARD_MULTI_MOTE_ENABLED
+    if (mote_ctx_get()->running == FALSE) {
+        mote_ctx_reset(mote_ctx_get());
+    }
+#endif
+    OPENMOTE_EXIT();
+
     // return successfully
     Py_INCREF(Py_None);
     return Py_None;
@@ -234,6 +311,51 @@ static PyMethodDef OpenMote_Methods[] = {
         {"supply_off",           supply_off,           METH_NOARGS,  ""},
         {NULL, NULL,                                                 METH_NOARGS,  ""}
 };
+
+#if BOARD_MULTI_MOTE_ENABLED
+
+static PyObject *OpenMote_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+    (void) args;
+    (void) kwds;
+
+    OpenMote *self;
+
+    self = (OpenMote *) type->tp_alloc(type, 0);
+    if (self == NULL) {
+        return NULL;
+    }
+
+    self->ctx = mote_ctx_new();
+    if (self->ctx == NULL) {
+        Py_DECREF(self);
+        return PyErr_NoMemory();
+    }
+
+    return (PyObject *) self;
+}
+
+static void OpenMote_dealloc(OpenMote *self) {
+    mote_ctx_free(self->ctx);
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+/*
+\brief Type of the motes, it exposes the same methods as the module itself.
+*/
+static PyTypeObject OpenMote_Type = {
+        PyVarObject_HEAD_INIT(NULL, 0)
+        .tp_name = "openwsn.OpenMote",
+        .tp_doc = "An independent mote running the OpenWSN-firmware",
+        .tp_basicsize = sizeof(OpenMote),
+        .tp_itemsize = 0,
+        .tp_flags = Py_TPFLAGS_DEFAULT,
+        .tp_new = OpenMote_new,
+        .tp_dealloc = (destructor) OpenMote_dealloc,
+        .tp_methods = OpenMote_Methods,
+};
+
+#endif
+
 //=========================== openwsn module ==================================
 
 //===== members
@@ -257,6 +379,14 @@ PyMODINIT_FUNC PyInit_openmote(void) {
     if (m == NULL)
         return NULL;
 
+#if BOARD_MULTI_MOTE_ENABLED
+    if (PyType_Ready(&OpenMote_Type) < 0)
+        return NULL;
+
+    Py_INCREF(&OpenMote_Type);
+    PyModule_AddObject(m, "OpenMote", (PyObject *) &OpenMote_Type);
+#endif
+
     PyModule_AddIntMacro(m, MOTE_NOTIF_board_init);
     PyModule_AddIntMacro(m, MOTE_NOTIF_board_sleep);
     PyModule_AddIntMacro(m, MOTE_NOTIF_board_reset);
@@ -341,9 +471,158 @@ PyMODINIT_FUNC PyInit_openmote(void) {
     PyModule_AddIntMacro(m, MOTE_NOTIF_uart_writeBufferByLen_FASTSIM);
     PyModule_AddIntMacro(m, MOTE_NOTIF_uart_readByte);
     PyModule_AddIntMacro(m, MOTE_NOTIF_uart_setCTS);
+    PyModule_AddIntMacro(m, MOTE_NOTIF_batch);
     PyModule_AddIntMacro(m, MOTE_NOTIF_LAST);
 
     return m;
 }
 
-#endif
\ No newline at end of file
+#endif
+
+#if BOARD_NATIVE_SIM_ENABLED
+
+//=========================== native simulation ===============================
+
+#define NATIVE_SIM_STEP_US          1000000     // granularity at which SIGINT is checked
+
+static volatile sig_atomic_t native_sim_stopped;
+
+static void native_sim_stop(int sig) {
+    (void) sig;
+    native_sim_stopped = 1;
+}
+
+static void native_sim_setDAGroot(void) {
+    open_addr_t myPrefix;
+    uint8_t dodagid[16];
+
+    idmanager_setIsDAGroot(TRUE);
+
+    memset(&myPrefix, 0, sizeof(open_addr_t));
+    myPrefix.type = ADDR_PREFIX;
+    myPrefix.addr_type.prefix[0] = 0xbb;
+    myPrefix.addr_type.prefix[1] = 0xbb;
+    idmanager_setMyID(&myPrefix);
+
+    memcpy(&dodagid[0], myPrefix.addr_type.prefix, 8);
+    memcpy(&dodagid[8], idmanager_getMyID(ADDR_64B)->addr_type.addr_64b, 8);
+    icmpv6rpl_writeDODAGid(dodagid);
+}
+
+static uint16_t native_sim_numSynced;
+static uint16_t native_sim_numWithParent;
+static uint64_t native_sim_numWakeups;
+static uint64_t native_sim_numCoalesced;
+
+static void native_sim_collect(void) {
+    uint8_t parentIndex;
+    uint32_t numWakeups;
+    uint32_t numCoalesced;
+
+    if (ieee154e_isSynch()) {
+        native_sim_numSynced++;
+    }
+    if (idmanager_getIsDAGroot() == FALSE && icmpv6rpl_getPreferredParentIndex(&parentIndex)) {
+        native_sim_numWithParent++;
+    }
+    opentimers_getWakeupStats(&numWakeups, &numCoalesced);
+    native_sim_numWakeups += numWakeups;
+    native_sim_numCoalesced += numCoalesced;
+}
+
+static void native_sim_usage(const char *name) {
+    printf("usage: %s [-n motes] [-t seconds] [-s seed] [-m line|mesh]\n", name);
+}
+
+/**
+\brief Run a network of motes in a single process, without OpenVisualizer.
+
+Mote 0 is the DAG root. In a "line" topology each mote only hears its direct neighbors, in a "mesh" topology all motes
+hear each other.
+*/
+int main(int argc, char **argv) {
+    simengine_stats_t stats;
+    uint16_t numMotes;
+    uint32_t duration;
+    uint32_t seed;
+    bool mesh;
+    uint32_t elapsed;
+    uint16_t i;
+    uint16_t j;
+    int opt;
+    clock_t start;
+    double wall;
+
+    numMotes = 10;
+    duration = 600;
+    seed = 1;
+    mesh = FALSE;
+
+    for (opt = 1; opt < argc; opt++) {
+        if (opt + 1 < argc && strcmp(argv[opt], "-n") == 0) {
+            numMotes = (uint16_t) atoi(argv[++opt]);
+        } else if (opt + 1 < argc && strcmp(argv[opt], "-t") == 0) {
+            duration = (uint32_t) atoi(argv[++opt]);
+        } else if (opt + 1 < argc && strcmp(argv[opt], "-s") == 0) {
+            seed = (uint32_t) atoi(argv[++opt]);
+        } else if (opt + 1 < argc && strcmp(argv[opt], "-m") == 0) {
+            mesh = (strcmp(argv[++opt], "mesh") == 0);
+        } else {
+            native_sim_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (numMotes == 0) {
+        native_sim_usage(argv[0]);
+        return 1;
+    }
+
+    simengine_init(numMotes, seed, mote_init);
+
+    for (i = 0; i < numMotes; i++) {
+        for (j = 0; j < numMotes; j++) {
+            if (i != j && (mesh || i == j + 1 || j == i + 1)) {
+                simengine_setLink(i, j, 100, SIMENGINE_DEFAULT_RSSI);
+            }
+        }
+    }
+
+    for (i = 0; i < numMotes; i++) {
+        simengine_boot(i);
+    }
+    simengine_runOn(0, native_sim_setDAGroot);
+
+    signal(SIGINT, native_sim_stop);
+
+    start = clock();
+    for (elapsed = 0; elapsed < duration && native_sim_stopped == 0; elapsed++) {
+        simengine_run(NATIVE_SIM_STEP_US);
+    }
+    wall = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    for (i = 0; i < numMotes; i++) {
+        simengine_runOn(i, native_sim_collect);
+    }
+    simengine_getStats(&stats);
+
+    printf("simulated %u motes for %u s in %.2f s (%.1fx real time)\n",
+           numMotes, elapsed, wall, (wall > 0) ? elapsed / wall : 0);
+    printf("events: %llu, tx: %llu, rx: %llu, collisions: %llu, dropped: %llu, serial bytes: %llu\n",
+           (unsigned long long) stats.numEvents,
+           (unsigned long long) stats.numTx,
+           (unsigned long long) stats.numRx,
+           (unsigned long long) stats.numCollisions,
+           (unsigned long long) stats.numDropped,
+           (unsigned long long) stats.numUartBytes);
+    printf("synchronized: %u/%u, with a preferred parent: %u/%u\n",
+           native_sim_numSynced, numMotes, native_sim_numWithParent, numMotes - 1);
+    printf("timer wakeups: %llu, timers served by another timer's wakeup: %llu\n",
+           (unsigned long long) native_sim_numWakeups, (unsigned long long) native_sim_numCoalesced);
+
+    simengine_destroy();
+
+    return 0;
+}
+
+#endif